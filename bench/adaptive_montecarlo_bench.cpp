@@ -0,0 +1,34 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include <iostream>
+#include <cstdio>
+
+void run_adaptive_montecarlo_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(1, 10, 42);
+    DCA dca(tickers_yt, 10000.0, 1000.0, {{"BENCH_TICKER0", 1.0}}, 30, 0.01, "DCA_Bench");
+    dca.run_strategy();
+    dca.set_montecarlo_config(42, 0, get_bench_start_date(), false);
+
+    // Median within 1% and 5% quantile within 2% at 95% confidence, probability of loss within 1 point
+    MonteCarloStoppingRule stopping_rule = {{{MonteCarloStatistic::MEDIAN_END_VALUE, 0.01}, {MonteCarloStatistic::P5_END_VALUE, 0.02},
+                                             {MonteCarloStatistic::PROBABILITY_OF_LOSS, 0.01}}, 0.95, 256, 60.0};
+    size_t path_budget = 20000;
+    std::vector<std::pair<std::string, VarianceReduction>> modes = {{"plain", VarianceReduction::NONE}, {"antithetic variates", VarianceReduction::ANTITHETIC_VARIATES},
+                                                                    {"Sobol + Brownian bridge", VarianceReduction::SOBOL_BROWNIAN_BRIDGE}};
+    std::vector<std::string> lines;
+    for (const auto& mode: modes){
+        dca.set_montecarlo_variance_reduction(mode.second);
+        dca.set_montecarlo_stopping_rule(stopping_rule);
+        dca.run_montecarlo_simulations(path_budget);
+        const MonteCarloConvergence& convergence = dca.get_montecarlo_convergence();
+        lines.push_back(mode.first + ": " + std::to_string(convergence.nb_paths) + " paths in " + std::to_string(convergence.elapsed_seconds) + " s"
+                        + (convergence.stop_reason == MonteCarloStopReason::PRECISION_MET ? "" : " (budget reached)") + " | median +-" + std::to_string(100 * convergence.half_widths[0])
+                        + "% | 5% +-" + std::to_string(100 * convergence.half_widths[1]) + "% | P(loss) " + std::to_string(convergence.estimates[2]) + " +-" + std::to_string(convergence.half_widths[2]));
+    }
+    std::cout << "Adaptive runs (budget " << path_budget << " paths, batches of 256)" << std::endl;
+    for (const auto& line: lines)
+        std::cout << line << std::endl;
+    std::remove("../strat_outputs/DCA_Bench_MonteCarloSummary.csv");
+}
@@ -0,0 +1,45 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/batch_engine.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <iostream>
+#include <algorithm>
+
+void run_batch_engine_bench(){
+    // Monte Carlo like workload: one GBM path per DCA portfolio, stored [path][date]
+    size_t nb_paths = 100;
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(1, 10, 42);
+    std::vector<std::time_t> dates = tickers_yt[0].get_dates();
+    size_t nb_dates = dates.size();
+    std::mt19937 generator(7);
+    std::normal_distribution<double> normal_dist(0.0003, 0.012);
+    std::vector<double> paths(nb_paths * nb_dates);
+    for (size_t p = 0; p < nb_paths; ++p){
+        paths[p * nb_dates] = 100.0;
+        for (size_t d = 1; d < nb_dates; ++d)
+            paths[p * nb_dates + d] = paths[p * nb_dates + d - 1] * (1.0 + normal_dist(generator));
+    }
+    std::vector<std::time_t> first_month_dates = extract_first_dates_of_each_month(dates);
+    std::vector<char> is_contribution_dates(nb_dates);
+    for (size_t d = 0; d < nb_dates; ++d)
+        is_contribution_dates[d] = std::binary_search(first_month_dates.begin(), first_month_dates.end(), dates[d]);
+
+    double strategies = get_elapsed_seconds([&]{
+        for (size_t p = 0; p < nb_paths; ++p){
+            std::vector<double> prices(paths.begin() + p * nb_dates, paths.begin() + (p + 1) * nb_dates);
+            DCA dca({YahooTimeseries("PATH", dates, prices, prices, prices, prices, prices)}, 10000.0, 1000.0, {{"PATH", 1.0}}, 30, 0.01, "DCA_Bench");
+            dca.run_strategy();
+        }
+    }, 1);
+    double batched = get_elapsed_seconds([&]{
+        BatchEngine engine({10000.0, 1000.0, {1.0}, 30, 0.01}, nb_paths, RebalancingThreshold::ABSOLUTE);
+        for (size_t d = 0; d < nb_dates; ++d){
+            const double* asset_prices[] = {&paths[d]};
+            engine.step(asset_prices, nb_dates, nullptr, &is_contribution_dates[d]);
+        }
+    }, 10);
+
+    std::cout << "DCA " << nb_paths << " paths x " << nb_dates << " dates" << std::endl;
+    std::cout << "one Strategy per path: " << strategies * 1e3 << " ms | BatchEngine: " << batched * 1e3 << " ms | speedup x" << strategies / batched << std::endl;
+}
@@ -0,0 +1,62 @@
+#ifndef BENCH_UTILS
+#define BENCH_UTILS
+
+#include "../headers/yahoo_timeseries.hpp"
+#include <chrono>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+#include <cmath>
+
+inline std::time_t get_bench_date(int year, int month, int day, int hour, int minute){
+    std::tm tm_date{};
+    tm_date.tm_year = year - 1900;
+    tm_date.tm_mon = month - 1;
+    tm_date.tm_mday = day;
+    tm_date.tm_hour = hour;
+    tm_date.tm_min = minute;
+    return std::mktime(&tm_date);
+}
+
+// First date of the Monte Carlo simulations (Jan 1, 2025)
+inline std::time_t get_bench_start_date(){
+    return get_bench_date(2025, 1, 1, 12, 0);
+}
+
+// Synthetic daily GBM tickers (weekdays only, quarterly dividends) so benchmarks run without network access
+inline std::vector<YahooTimeseries> get_bench_tickers_yt(size_t nb_tickers, size_t nb_years, unsigned int seed){
+    std::time_t start = get_bench_date(2000, 1, 1, 12, 0);
+    std::mt19937 generator(seed);
+    std::normal_distribution<double> normal_dist(0.0003, 0.012);
+    std::vector<YahooTimeseries> tickers_yt;
+    for (size_t k = 0; k < nb_tickers; ++k){
+        std::vector<std::time_t> dates;
+        std::vector<double> prices;
+        std::map<std::time_t, double> dividends;
+        double price = 100.0;
+        for (size_t i = 0; i < nb_years * 365; ++i){
+            if (i % 7 == 5 || i % 7 == 6)
+                continue;
+            std::time_t date = start + i * 86400;
+            price *= 1.0 + normal_dist(generator);
+            dates.push_back(date);
+            prices.push_back(price);
+            if (i % 91 == 30)
+                dividends[date] = 0.004 * price;
+        }
+        tickers_yt.emplace_back("BENCH_TICKER" + std::to_string(k), dates, prices, prices, prices, prices, prices, dividends);
+    }
+    return tickers_yt;
+}
+
+template<class Function>
+double get_elapsed_seconds(Function function, size_t nb_repeats){
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nb_repeats; ++i)
+        function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / nb_repeats;
+}
+
+#endif
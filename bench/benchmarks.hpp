@@ -0,0 +1,23 @@
+#ifndef BENCHMARKS
+#define BENCHMARKS
+
+void run_static_strategy_bench();
+void run_vectorized_backtest_bench();
+void run_batch_engine_bench();
+void run_montecarlo_bench();
+void run_path_generator_bench();
+void run_multi_asset_bench();
+void run_block_bootstrap_bench();
+void run_variance_reduction_bench();
+void run_adaptive_montecarlo_bench();
+void run_montecarlo_context_bench();
+void run_distributed_bench();
+void run_rebalancer_bench();
+void run_event_engine_bench();
+void run_streaming_backtest_bench();
+void run_strategy_snapshot_bench();
+void run_csv_writer_bench();
+void run_result_file_bench();
+void run_data_pipeline_bench();
+
+#endif
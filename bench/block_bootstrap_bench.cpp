@@ -0,0 +1,32 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include <iostream>
+#include <thread>
+#include <cstdio>
+
+void run_block_bootstrap_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(5, 10, 42);
+    std::map<std::string, double> allocations;
+    for (const auto& ticker_yt: tickers_yt)
+        allocations[ticker_yt.get_ticker()] = 0.2;
+    DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+    dca.run_strategy();
+
+    size_t nb_paths = 2048;
+    size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::cout << nb_paths << " paths x 20 years, " << tickers_yt.size() << " tickers, DCA on the BatchEngine" << std::endl;
+    for (MonteCarloModel model: {MonteCarloModel::CORRELATED_ASSETS, MonteCarloModel::BLOCK_BOOTSTRAP}){
+        dca.set_montecarlo_model(model);
+        for (size_t nb_threads = 1; nb_threads <= max_threads; nb_threads *= 2){
+            dca.set_montecarlo_config(42, nb_threads, get_bench_start_date(), false);
+            dca.run_montecarlo_simulations(nb_paths);
+            const MonteCarloThroughput& throughput = dca.get_montecarlo_throughput();
+            std::cout << (model == MonteCarloModel::BLOCK_BOOTSTRAP ? "stationary block bootstrap" : "correlated normal returns") << " | "
+                      << nb_threads << " threads: " << throughput.paths_per_second << " paths/s (100k paths in "
+                      << 100000.0 / throughput.paths_per_second << " s)" << std::endl;
+        }
+    }
+    std::remove("../strat_outputs/DCA_Bench_MonteCarloSummary.csv");
+}
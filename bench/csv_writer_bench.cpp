@@ -0,0 +1,58 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/csv_writer.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+void run_csv_writer_bench(){
+    // 100 saved paths of 20 years of daily rows, as save_portfolio writes them
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(1, 20, 42);
+    std::vector<std::time_t> dates = tickers_yt[0].get_dates();
+    std::vector<double> rows;
+    for (const auto& date: dates){
+        double value = tickers_yt[0].get_closes().get_ts_value(date) * 137.0;
+        rows.insert(rows.end(), {value, value * 0.21, value * 0.79});
+    }
+    size_t nb_files = 100;
+    std::string filename = "/tmp/csv_writer_bench.csv";
+
+    double ostream_seconds = get_elapsed_seconds([&]{
+        std::ofstream file(filename);
+        file << "Date;Value;P&L;Investments" << std::endl;
+        for (size_t d = 0; d < dates.size(); ++d)
+            file << unix_timestamp_to_date_string(dates[d]) << ";" << rows[3 * d] << ";" << rows[3 * d + 1] << ";" << rows[3 * d + 2] << std::endl;
+    }, nb_files);
+    double buffered_seconds = get_elapsed_seconds([&]{
+        CsvWriter writer(filename, 1 << 16, false);
+        writer.write_line("Date;Value;P&L;Investments");
+        for (size_t d = 0; d < dates.size(); ++d)
+            writer.write_row(dates[d], &rows[3 * d], 3);
+        writer.close();
+    }, nb_files);
+    double background_seconds = get_elapsed_seconds([&]{
+        CsvWriter writer(filename, 1 << 16, true);
+        writer.write_line("Date;Value;P&L;Investments");
+        for (size_t d = 0; d < dates.size(); ++d)
+            writer.write_row(dates[d], &rows[3 * d], 3);
+        writer.close();
+    }, nb_files);
+    std::remove(filename.c_str());
+
+    // Whole save_portfolio, including the P&L series it writes
+    DCA dca(tickers_yt, 10000.0, 1000.0, {{"BENCH_TICKER0", 1.0}}, 30, 0.01, "CsvWriter_Bench");
+    dca.run_strategy();
+    double save_seconds = get_elapsed_seconds([&]{
+        dca.get_portfolio().save_portfolio("CsvWriter_Bench", false);
+    }, 3);
+    std::remove("../strat_outputs/CsvWriter_Bench.csv");
+
+    double to_nanoseconds = 1e9 / dates.size();
+    std::cout << nb_files << " files of " << dates.size() << " rows" << std::endl;
+    std::cout << "ostream + std::endl: " << ostream_seconds * to_nanoseconds << " ns/row | CsvWriter: " << buffered_seconds * to_nanoseconds
+              << " ns/row (x" << ostream_seconds / buffered_seconds << ") | CsvWriter background: " << background_seconds * to_nanoseconds
+              << " ns/row (x" << ostream_seconds / background_seconds << ")" << std::endl;
+    std::cout << "save_portfolio: " << save_seconds * 1e3 << " ms, " << save_seconds * to_nanoseconds << " ns/row" << std::endl;
+}
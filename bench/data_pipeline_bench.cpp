@@ -0,0 +1,67 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/data_pipeline.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <iostream>
+#include <thread>
+#include <algorithm>
+
+void run_data_pipeline_bench(){
+    // 500 tickers of 10 years: downloads simulated by a 10 ms latency returning the chart json, parsed with nlohmann,
+    // then 50/200 days moving averages and 14 days RSI of the closes
+    size_t nb_tickers = 500;
+    std::vector<YahooTimeseries> bench_tickers_yt = get_bench_tickers_yt(10, 10, 42);
+    std::vector<std::string> chart_jsons;
+    for (const auto& ticker_yt: bench_tickers_yt)
+        chart_jsons.push_back(get_ticker_chart_json(ticker_yt));
+    std::vector<std::string> tickers;
+    for (size_t i = 0; i < nb_tickers; ++i)
+        tickers.push_back(std::to_string(i));
+    TickerFetcher fetcher = [&chart_jsons](const std::string& ticker){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return chart_jsons[std::stoul(ticker) % chart_jsons.size()];
+    };
+    std::vector<std::pair<std::string, TickerIndicator>> indicators = {
+        {"SMA50", [](const YahooTimeseries& ticker_yt){ return Timeseries(ticker_yt.get_closes().get_ts_simple_moving_averages(50)); }},
+        {"SMA200", [](const YahooTimeseries& ticker_yt){ return Timeseries(ticker_yt.get_closes().get_ts_simple_moving_averages(200)); }},
+        {"RSI14", [](const YahooTimeseries& ticker_yt){ return Timeseries(ticker_yt.get_closes().get_ts_rsis(14)); }},
+    };
+
+    // Every download, then every parse, then the indicators
+    double stage_seconds[3] = {0.0, 0.0, 0.0};
+    double sequential_seconds = get_elapsed_seconds([&]{
+        std::vector<std::string> tickers_str_data;
+        stage_seconds[0] = get_elapsed_seconds([&]{
+            for (const auto& ticker: tickers)
+                tickers_str_data.push_back(fetcher(ticker));
+        }, 1);
+        std::vector<YahooTimeseries> tickers_yt;
+        stage_seconds[1] = get_elapsed_seconds([&]{
+            for (const auto& ticker_str_data: tickers_str_data)
+                tickers_yt.push_back(get_ticker_ts_data(ticker_str_data));
+        }, 1);
+        stage_seconds[2] = get_elapsed_seconds([&]{
+            for (const auto& ticker_yt: tickers_yt)
+                for (const auto& indicator: indicators)
+                    indicator.second(ticker_yt);
+        }, 1);
+    }, 1);
+    std::cout << nb_tickers << " tickers, sequential: " << sequential_seconds << " s (download " << stage_seconds[0] << " s, parse "
+              << stage_seconds[1] << " s, indicators " << stage_seconds[2] << " s)" << std::endl;
+
+    size_t nb_cores = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t nb_fetch_threads = 32;
+    size_t nb_parse_threads = std::max(nb_cores / 2, (size_t)1);
+    size_t nb_compute_threads = std::max(nb_cores - nb_parse_threads, (size_t)1);
+    DataPipeline pipeline(fetcher, nb_fetch_threads, nb_parse_threads, nb_compute_threads, 16);
+    for (const auto& indicator: indicators)
+        pipeline.add_indicator(indicator.first, indicator.second);
+    pipeline.run(tickers);
+    const DataPipelineStats& stats = pipeline.get_stats();
+    // Lower bound from the sequential stage times, the parse and compute threads sharing the cores
+    double slowest_stage_seconds = std::max({stage_seconds[0] / nb_fetch_threads, stage_seconds[1] / nb_parse_threads, stage_seconds[2] / nb_compute_threads,
+                                             (stage_seconds[1] + stage_seconds[2]) / nb_cores});
+    std::cout << "pipeline (" << nb_fetch_threads << " fetch, " << nb_parse_threads << " parse, " << nb_compute_threads << " compute threads): "
+              << stats.elapsed_seconds << " s (x" << sequential_seconds / stats.elapsed_seconds << ") for a slowest stage of " << slowest_stage_seconds
+              << " s, queues at most " << stats.max_fetched_queue_size << " fetched / " << stats.max_parsed_queue_size << " parsed" << std::endl;
+}
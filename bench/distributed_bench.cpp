@@ -0,0 +1,29 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/parameter_sweep.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include <iostream>
+#include <thread>
+#include <cstdio>
+
+void run_distributed_bench(){
+    size_t max_workers = std::max<size_t>(4, std::thread::hardware_concurrency());
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(3, 10, 42);
+    std::map<std::string, double> allocations = {{"BENCH_TICKER0", 0.5}, {"BENCH_TICKER1", 0.3}, {"BENCH_TICKER2", 0.2}};
+    LocalCluster cluster(1);
+
+    // One thread per worker process so the scaling is the one of the processes
+    DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+    dca.run_strategy();
+    dca.set_montecarlo_config(42, 1, get_bench_start_date(), false);
+    dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    std::cout << "Monte Carlo: 4096 paths, shards of 256" << std::endl;
+    cluster.benchmark_scaling([&](LocalCluster& workers){ dca.run_distributed_montecarlo_simulations(4096, workers, 256); }, max_workers);
+    std::remove("../strat_outputs/DCA_Bench_MonteCarloSummary.csv");
+
+    ParameterSweep sweep(tickers_yt, get_dca_factory(10000.0, 1000.0, allocations, 30, 0.01),
+                         {{"rebalancing_freq", 5, 60, 8, true}, {"rebalancing_threshold", 0.01, 0.2, 8, false}});
+    std::vector<std::map<std::string, double>> parameter_sets = sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1);
+    std::cout << "Sweep: " << parameter_sets.size() << " backtests, shards of 4" << std::endl;
+    cluster.benchmark_scaling([&](LocalCluster& workers){ sweep.run_distributed(parameter_sets, workers, 4); }, max_workers);
+}
@@ -0,0 +1,84 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/event_engine.hpp"
+#include "../headers/strategy.hpp"
+#include <iostream>
+
+// Minute bars (390 per session, weekdays) of a GBM ticker, dividends every quarter
+static void get_minute_bars(size_t nb_bars, unsigned int seed, std::vector<std::time_t>& times, std::vector<double>& closes,
+                            std::vector<std::time_t>& dividend_times, std::vector<double>& dividends){
+    std::time_t start = get_bench_date(2000, 1, 3, 9, 30);
+    std::mt19937 generator(seed);
+    std::normal_distribution<double> normal_dist(0.0, 0.0006);
+    times.resize(nb_bars);
+    closes.resize(nb_bars);
+    double price = 100.0;
+    size_t day = 0;
+    for (size_t i = 0; i < nb_bars; ++i){
+        size_t minute = i % 390;
+        if (i > 0 && minute == 0){
+            day += (day % 7 == 4) ? 3 : 1;
+            if (day % 91 < 3){
+                dividend_times.push_back(start + day * 86400 + 600);
+                dividends.push_back(0.004 * price);
+            }
+        }
+        price *= 1.0 + normal_dist(generator);
+        times[i] = start + day * 86400 + minute * 60;
+        closes[i] = price;
+    }
+}
+
+void run_event_engine_bench(){
+    size_t nb_tickers = 4, nb_bars = 2000000;
+    std::vector<std::vector<std::time_t>> times(nb_tickers), dividend_times(nb_tickers);
+    std::vector<std::vector<double>> closes(nb_tickers), dividends(nb_tickers);
+    for (size_t t = 0; t < nb_tickers; ++t)
+        get_minute_bars(nb_bars, 5 + t, times[t], closes[t], dividend_times[t], dividends[t]);
+    auto add_tickers = [&](EventEngine& engine){
+        for (size_t t = 0; t < nb_tickers; ++t){
+            engine.add_ticker("BENCH_TICKER" + std::to_string(t), times[t].data(), closes[t].data(), nb_bars);
+            engine.add_dividends(t, dividend_times[t].data(), dividends[t].data(), dividend_times[t].size());
+        }
+    };
+
+    // Merge only: every bar goes through the heap and the handler
+    EventEngine merge_engine;
+    add_tickers(merge_engine);
+    double sum = 0.0;
+    merge_engine.set_bar_handler([&](size_t, std::time_t, double close){ sum += close; });
+    merge_engine.run();
+    const EventThroughput& merge = merge_engine.get_throughput();
+
+    // DCA: monthly contributions, hourly rebalancing check, daily valuation
+    EventEngine dca_engine;
+    add_tickers(dca_engine);
+    EventDrivenDCA event_dca(dca_engine, 10000.0, 500.0, std::vector<double>(nb_tickers, 1.0 / nb_tickers),
+                             {ScheduleCadence::SECONDS, 3600}, RebalancingThreshold::BAND, 0.02, {ScheduleCadence::DAYS, 1});
+    event_dca.run();
+    const EventThroughput& dca = dca_engine.get_throughput();
+
+    // Strategy::run_strategy (YahooTimeseries maps, one make_transactions per date) on the first bars
+    size_t nb_strategy_bars = 20000;
+    std::vector<YahooTimeseries> tickers_yt;
+    std::map<std::string, double> allocations;
+    for (size_t t = 0; t < nb_tickers; ++t){
+        std::vector<std::time_t> strategy_times(times[t].begin(), times[t].begin() + nb_strategy_bars);
+        std::vector<double> strategy_closes(closes[t].begin(), closes[t].begin() + nb_strategy_bars);
+        tickers_yt.emplace_back("BENCH_TICKER" + std::to_string(t), strategy_times, strategy_closes, strategy_closes, strategy_closes, strategy_closes, strategy_closes);
+        allocations[tickers_yt.back().get_ticker()] = 1.0 / nb_tickers;
+    }
+    double strategy = get_elapsed_seconds([&]{
+        DCA strategy_dca(tickers_yt, 10000.0, 500.0, allocations, 60, 0.02, "DCA_Bench");
+        strategy_dca.run_strategy();
+    }, 1);
+
+    std::cout << nb_tickers << " tickers x " << nb_bars << " minute bars (" << sum / (nb_tickers * nb_bars) << " mean close)" << std::endl;
+    std::cout << "Heap merge + bar handler: " << merge.nb_events << " events in " << merge.elapsed_seconds << " s, "
+              << merge.events_per_second / 1e6 << " M events/s" << std::endl;
+    std::cout << "EventDrivenDCA: " << dca.nb_events << " events in " << dca.elapsed_seconds << " s, "
+              << dca.events_per_second / 1e6 << " M events/s, " << event_dca.get_nb_rebalancings() << " rebalancings, "
+              << event_dca.get_values().size() << " daily values" << std::endl;
+    std::cout << "DCA::run_strategy on " << nb_tickers << " x " << nb_strategy_bars << " bars: "
+              << nb_tickers * nb_strategy_bars / strategy / 1e6 << " M bars/s" << std::endl;
+}
@@ -0,0 +1,38 @@
+#include "./benchmarks.hpp"
+#include <iostream>
+#include <map>
+#include <string>
+#include <functional>
+
+//g++ -O3 *.cpp $(ls ../src/*.cpp | grep -v main.cpp) -o main -lcurl -pthread
+//./main [benchmark name]
+
+int main(int argc, char **argv){
+    std::map<std::string, std::function<void()>> benchmarks = {
+        {"static_strategy", run_static_strategy_bench},
+        {"vectorized_backtest", run_vectorized_backtest_bench},
+        {"batch_engine", run_batch_engine_bench},
+        {"montecarlo", run_montecarlo_bench},
+        {"path_generator", run_path_generator_bench},
+        {"multi_asset", run_multi_asset_bench},
+        {"block_bootstrap", run_block_bootstrap_bench},
+        {"variance_reduction", run_variance_reduction_bench},
+        {"adaptive_montecarlo", run_adaptive_montecarlo_bench},
+        {"montecarlo_context", run_montecarlo_context_bench},
+        {"distributed", run_distributed_bench},
+        {"rebalancer", run_rebalancer_bench},
+        {"event_engine", run_event_engine_bench},
+        {"streaming_backtest", run_streaming_backtest_bench},
+        {"strategy_snapshot", run_strategy_snapshot_bench},
+        {"csv_writer", run_csv_writer_bench},
+        {"result_file", run_result_file_bench},
+        {"data_pipeline", run_data_pipeline_bench},
+    };
+    for (const auto& pair: benchmarks){
+        if (argc > 1 && pair.first != argv[1])
+            continue;
+        std::cout << "=== " << pair.first << " ===" << std::endl;
+        pair.second();
+    }
+    return EXIT_SUCCESS;
+}
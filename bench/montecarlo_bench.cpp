@@ -0,0 +1,33 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include <iostream>
+#include <thread>
+
+void run_montecarlo_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(1, 10, 42);
+    DCA dca(tickers_yt, 10000.0, 1000.0, {{"BENCH_TICKER0", 1.0}}, 30, 0.01, "DCA_Bench");
+    dca.run_strategy();
+
+    size_t nb_paths = 32;
+    size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<double> reference_end_values;
+    double reference_paths_per_second = 0.0;
+    std::vector<MonteCarloThroughput> throughputs;
+    std::vector<bool> are_identical;
+    for (size_t nb_threads = 1; nb_threads <= max_threads; nb_threads *= 2){
+        dca.set_montecarlo_config(42, nb_threads, get_bench_start_date(), false);
+        dca.run_montecarlo_simulations(nb_paths);
+        if (reference_end_values.empty()){
+            reference_end_values = dca.get_montecarlo_end_values();
+            reference_paths_per_second = dca.get_montecarlo_throughput().paths_per_second;
+        }
+        throughputs.push_back(dca.get_montecarlo_throughput());
+        are_identical.push_back(dca.get_montecarlo_end_values() == reference_end_values);
+    }
+    for (size_t i = 0; i < throughputs.size(); ++i)
+        std::cout << throughputs[i].nb_threads << " threads: " << throughputs[i].paths_per_second << " paths/s | speedup x"
+                  << throughputs[i].paths_per_second / reference_paths_per_second
+                  << " | end values identical to 1 thread: " << (are_identical[i] ? "yes" : "no") << std::endl;
+}
@@ -0,0 +1,78 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/montecarlo_context.hpp"
+#include "../headers/montecarlo_aggregator.hpp"
+#include "../headers/path_generator.hpp"
+#include "../headers/strategy.hpp"
+#include <iostream>
+
+void run_montecarlo_context_bench(){
+    size_t nb_paths = 2048, chunk_size = 16;
+    size_t nb_steps = 1 + 252 * 20;
+    std::vector<std::time_t> dates(nb_steps);
+    std::time_t start = get_bench_start_date();
+    for (size_t s = 0; s < nb_steps; ++s)
+        dates[s] = start + s * 86400;
+    std::vector<std::vector<char>> is_contribution_dates(1, std::vector<char>(nb_steps, 0));
+    for (size_t s = 0; s < nb_steps; s += 30)
+        is_contribution_dates[0][s] = 1;
+    PathGenerator path_generator(PathModel::ARITHMETIC_RETURNS, 100.0, 0.0003, 0.012, 42);
+    BatchPortfolio portfolio = {10000.0, 1000.0, {1.0}, 30, 0.01};
+
+    // Price generation alone, the floor of every route
+    std::vector<double> paths(chunk_size * nb_steps);
+    double generation = get_elapsed_seconds([&]{
+        for (size_t first_path = 0; first_path < nb_paths; first_path += chunk_size)
+            path_generator.generate(first_path, chunk_size, nb_steps, paths.data());
+    }, 3);
+
+    // One YahooTimeseries and one DCA built and run per path (the saved paths route), on a subset of the paths
+    size_t nb_strategy_paths = 64;
+    double strategy = get_elapsed_seconds([&]{
+        for (size_t first_path = 0; first_path < nb_strategy_paths; first_path += chunk_size){
+            path_generator.generate(first_path, chunk_size, nb_steps, paths.data());
+            for (size_t p = 0; p < chunk_size; ++p){
+                std::vector<double> prices(paths.begin() + p * nb_steps, paths.begin() + (p + 1) * nb_steps);
+                std::vector<YahooTimeseries> path_tickers_yt = {YahooTimeseries("MonteCarloSimulationTicker", dates, prices, prices, prices, prices, prices)};
+                DCA dca(path_tickers_yt, 10000.0, 1000.0, {{"MonteCarloSimulationTicker", 1.0}}, 30, 0.01, "DCA_Bench");
+                dca.run_strategy();
+            }
+        }
+    }, 1) * nb_paths / nb_strategy_paths;
+
+    // Buffers, engine, calendar and aggregator allocated for every chunk
+    double per_chunk = get_elapsed_seconds([&]{
+        for (size_t first_path = 0; first_path < nb_paths; first_path += chunk_size){
+            std::vector<double> chunk_paths(chunk_size * nb_steps);
+            path_generator.generate(first_path, chunk_size, nb_steps, chunk_paths.data());
+            std::vector<double> values(chunk_size * nb_steps);
+            BatchEngine engine(portfolio, chunk_size, RebalancingThreshold::ABSOLUTE);
+            engine.run_paths({chunk_paths.data()}, nb_steps, std::vector<std::vector<char>>(1, is_contribution_dates[0]), values.data());
+            MonteCarloAggregator aggregator(dates, 100.0);
+            for (size_t p = 0; p < chunk_size; ++p)
+                aggregator.add_path(&values[p * nb_steps]);
+        }
+    }, 3);
+
+    // Per-thread context and aggregator allocated once and reset between chunks
+    MonteCarloPathContext context(1, chunk_size, nb_steps);
+    MonteCarloAggregator aggregator(dates, 100.0);
+    double reused = get_elapsed_seconds([&]{
+        for (size_t first_path = 0; first_path < nb_paths; first_path += chunk_size){
+            path_generator.generate(first_path, chunk_size, nb_steps, context.get_asset_paths()[0]);
+            BatchEngine& engine = context.get_engine(portfolio, chunk_size, RebalancingThreshold::ABSOLUTE);
+            engine.run_paths(context.get_const_asset_paths(), nb_steps, is_contribution_dates, context.get_values());
+            for (size_t p = 0; p < chunk_size; ++p)
+                aggregator.add_path(&context.get_values()[p * nb_steps]);
+            aggregator.reset();
+        }
+    }, 3);
+
+    double to_microseconds = 1e6 / nb_paths;
+    std::cout << nb_paths << " paths x " << nb_steps << " steps, chunks of " << chunk_size << " (1 thread)" << std::endl;
+    std::cout << "Generation only: " << generation * to_microseconds << " us/path" << std::endl;
+    std::cout << "Per-path overhead beyond generation (simulation + setup):" << std::endl;
+    std::cout << "  YahooTimeseries + DCA per path: " << (strategy - generation) * to_microseconds << " us/path" << std::endl;
+    std::cout << "  allocation per chunk: " << (per_chunk - generation) * to_microseconds << " us/path" << std::endl;
+    std::cout << "  reused context: " << (reused - generation) * to_microseconds << " us/path" << std::endl;
+}
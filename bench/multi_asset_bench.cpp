@@ -0,0 +1,38 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/multi_asset_simulator.hpp"
+#include "../headers/batch_engine.hpp"
+#include <iostream>
+
+void run_multi_asset_bench(){
+    size_t nb_paths = 256;
+    size_t chunk_size = 16;
+    size_t nb_steps = 1 + 252 * 20;
+    std::vector<char> is_contribution_dates(nb_steps, 0);
+    for (size_t s = 0; s < nb_steps; s += 21)
+        is_contribution_dates[s] = 1;
+
+    std::cout << nb_paths << " paths x " << nb_steps << " steps, chunks of " << chunk_size << " paths" << std::endl;
+    for (size_t nb_assets: {1, 2, 10, 30}){
+        MultiAssetSimulator simulator(get_bench_tickers_yt(nb_assets, 10, 42), PathModel::ARITHMETIC_RETURNS, 42);
+        std::vector<std::vector<double>> paths(nb_assets, std::vector<double>(chunk_size * nb_steps));
+        std::vector<double*> asset_paths;
+        for (auto& asset_path: paths)
+            asset_paths.push_back(asset_path.data());
+        std::vector<const double*> const_asset_paths(asset_paths.begin(), asset_paths.end());
+        BatchEngine engine({10000.0, 1000.0, std::vector<double>(nb_assets, 1.0 / nb_assets), 30, 0.01}, chunk_size, RebalancingThreshold::ABSOLUTE);
+
+        double generation = get_elapsed_seconds([&]{
+            for (size_t first_path = 0; first_path < nb_paths; first_path += chunk_size)
+                simulator.generate(first_path, chunk_size, nb_steps, asset_paths);
+        }, 1);
+        double simulation = get_elapsed_seconds([&]{
+            for (size_t first_path = 0; first_path < nb_paths; first_path += chunk_size){
+                simulator.generate(first_path, chunk_size, nb_steps, asset_paths);
+                engine.run_paths(const_asset_paths, nb_steps, std::vector<std::vector<char>>(nb_assets, is_contribution_dates), nullptr);
+            }
+        }, 1);
+        std::cout << nb_assets << " assets | correlated paths: " << nb_paths / generation << " paths/s (" << nb_paths * nb_assets / generation << " asset paths/s)"
+                  << " | paths + BatchEngine DCA: " << nb_paths / simulation << " paths/s" << std::endl;
+    }
+}
@@ -0,0 +1,46 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/path_generator.hpp"
+#include "../headers/batch_engine.hpp"
+#include <iostream>
+
+void run_path_generator_bench(){
+    size_t nb_paths = 1000;
+    size_t nb_steps = 1 + 252 * 20;
+
+    // Former model: one std::normal_distribution draw at a time, one YahooTimeseries per path
+    std::vector<std::time_t> dates(nb_steps);
+    for (size_t s = 0; s < nb_steps; ++s)
+        dates[s] = s * 86400;
+    double scalar = get_elapsed_seconds([&]{
+        std::mt19937 generator(42);
+        std::normal_distribution<double> normal_dist(0.0003, 0.012);
+        for (size_t p = 0; p < nb_paths / 10; ++p){
+            std::vector<double> prices(nb_steps);
+            prices[0] = 100.0;
+            for (size_t s = 1; s < nb_steps; ++s)
+                prices[s] = prices[s-1] + prices[s-1] * normal_dist(generator);
+            YahooTimeseries yt("MonteCarloSimulationTicker", dates, prices, prices, prices, prices, prices);
+        }
+    }, 1) * 10;
+
+    std::vector<double> paths(nb_paths * nb_steps);
+    PathGenerator gbm_generator(PathModel::GEOMETRIC_BROWNIAN_MOTION, 100.0, 0.0003, 0.012, 42);
+    double gbm = get_elapsed_seconds([&]{ gbm_generator.generate(0, nb_paths, nb_steps, paths.data()); }, 3);
+    PathGenerator arithmetic_generator(PathModel::ARITHMETIC_RETURNS, 100.0, 0.0003, 0.012, 42);
+    double arithmetic = get_elapsed_seconds([&]{ arithmetic_generator.generate(0, nb_paths, nb_steps, paths.data()); }, 3);
+
+    std::vector<char> is_contribution_dates(nb_steps, 0);
+    for (size_t s = 0; s < nb_steps; s += 21)
+        is_contribution_dates[s] = 1;
+    BatchEngine engine({10000.0, 1000.0, {1.0}, 30, 0.01}, nb_paths, RebalancingThreshold::ABSOLUTE);
+    double simulation = get_elapsed_seconds([&]{
+        arithmetic_generator.generate(0, nb_paths, nb_steps, paths.data());
+        engine.run_paths({paths.data()}, nb_steps, {is_contribution_dates}, nullptr);
+    }, 3);
+
+    std::cout << nb_paths << " paths x " << nb_steps << " steps" << std::endl;
+    std::cout << "std::normal_distribution + YahooTimeseries: " << nb_paths / scalar << " paths/s" << std::endl;
+    std::cout << "PathGenerator GBM: " << nb_paths / gbm << " paths/s | arithmetic returns: " << nb_paths / arithmetic << " paths/s" << std::endl;
+    std::cout << "PathGenerator + BatchEngine DCA: " << nb_paths / simulation << " paths/s" << std::endl;
+}
@@ -0,0 +1,82 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/rebalancer.hpp"
+#include "../headers/portfolio_builder.hpp"
+#include "../headers/strategy.hpp"
+#include <iostream>
+
+void run_rebalancer_bench(){
+    size_t nb_tickers = 20, nb_years = 10;
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(nb_tickers, nb_years, 11);
+    const std::vector<std::time_t>& dates = tickers_yt[0].get_dates();
+    std::map<std::string, double> allocations;
+    std::vector<double> target_weights(nb_tickers, 1.0 / nb_tickers);
+    for (const auto& ticker_yt: tickers_yt)
+        allocations[ticker_yt.get_ticker()] = 1.0 / nb_tickers;
+    double threshold = 0.001;
+
+    // Every ticker bought on the first date, then a rebalancing at each date
+    auto get_portfolio = [&](){
+        PortfolioBuilder ptf;
+        for (const auto& ticker_yt: tickers_yt)
+            ptf.buy(ticker_yt, 1000.0 / ticker_yt.get_closes().get_ts_value(dates[0]), dates[0]);
+        return ptf;
+    };
+
+    // Previous route: allocation map, per-ticker share lookups and one buy / sell per order
+    PortfolioBuilder map_ptf = get_portfolio();
+    double map_based = get_elapsed_seconds([&]{
+        for (size_t d = 1; d < dates.size(); ++d){
+            std::time_t date = dates[d];
+            std::map<std::string, double> ptf_alloc = map_ptf.get_portfolio_percentage_allocations(date);
+            for (auto& ticker_yt: tickers_yt){
+                std::string ticker = ticker_yt.get_ticker();
+                double ticker_shares = map_ptf.get_ticker_shares(ticker, date);
+                double target_alloc = allocations[ticker];
+                double ticker_alloc = ptf_alloc[ticker];
+                if (ticker_alloc - target_alloc > threshold)
+                    map_ptf.sell(ticker_yt, ticker_shares - ticker_shares * target_alloc / ticker_alloc, date);
+                if (target_alloc - ticker_alloc > threshold && ticker_alloc > 0)
+                    map_ptf.buy(ticker_yt, ticker_shares * target_alloc / ticker_alloc - ticker_shares, date);
+            }
+        }
+    }, 1);
+
+    // Dense arrays and one ledger update per date
+    PortfolioBuilder dense_ptf = get_portfolio();
+    Rebalancer rebalancer(target_weights, RebalancingThreshold::ABSOLUTE, threshold);
+    std::vector<int> asset_indices = dense_ptf.get_asset_indices(tickers_yt);
+    std::vector<double> shares(nb_tickers), prices(nb_tickers);
+    size_t nb_orders = 0;
+    double dense = get_elapsed_seconds([&]{
+        for (size_t d = 1; d < dates.size(); ++d){
+            std::time_t date = dates[d];
+            dense_ptf.get_last_shares(asset_indices, shares.data());
+            for (size_t a = 0; a < nb_tickers; ++a)
+                prices[a] = tickers_yt[a].get_closes().get_ts_value(date);
+            size_t nb_date_orders = rebalancer.compute_orders(shares.data(), prices.data());
+            if (nb_date_orders > 0)
+                dense_ptf.apply_orders(asset_indices, rebalancer.get_orders().data(), prices.data(), date);
+            nb_orders += nb_date_orders;
+        }
+    }, 1);
+
+    // Orders alone, without the price lookups and ledger writes
+    double orders_only = get_elapsed_seconds([&]{
+        for (size_t d = 1; d < dates.size(); ++d)
+            rebalancer.compute_orders(shares.data(), prices.data());
+    }, 3);
+
+    // Whole backtest with a daily rebalancing check
+    double dca_run = get_elapsed_seconds([&]{
+        DCA dca(tickers_yt, 20000.0, 1000.0, allocations, 1, threshold, "DCA_Bench");
+        dca.run_strategy();
+    }, 1);
+
+    double to_microseconds = 1e6 / (dates.size() - 1);
+    std::cout << nb_tickers << " tickers, " << dates.size() - 1 << " rebalancing dates, " << nb_orders << " orders" << std::endl;
+    std::cout << "Map-based rebalancing: " << map_based * to_microseconds << " us/date" << std::endl;
+    std::cout << "Rebalancer + batched orders: " << dense * to_microseconds << " us/date (x" << map_based / dense << ")" << std::endl;
+    std::cout << "  compute_orders only: " << orders_only * to_microseconds << " us/date" << std::endl;
+    std::cout << "DCA backtest, daily rebalancing: " << dca_run << " s" << std::endl;
+}
@@ -0,0 +1,88 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/result_file.hpp"
+#include "../headers/csv_writer.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+
+static double get_file_megabytes(std::string filename){
+    struct stat file_stat;
+    return (stat(filename.c_str(), &file_stat) == 0) ? file_stat.st_size / double(1 << 20) : 0.0;
+}
+
+void run_result_file_bench(){
+    // 1000 saved Monte Carlo paths of 20 years: one Date;Value csv per path against one result file
+    size_t nb_paths = 1000, nb_rows = 5041, chunk_size = 16;
+    std::time_t start = get_bench_start_date();
+    std::vector<std::time_t> dates;
+    for (size_t r = 0; r < nb_rows; ++r)
+        dates.push_back(start + r * 86400);
+    std::vector<double> paths(nb_paths * nb_rows);
+    std::mt19937 generator(7);
+    std::normal_distribution<double> normal_dist(0.0003, 0.012);
+    for (size_t p = 0; p < nb_paths; ++p){
+        double value = 10000.0;
+        for (size_t r = 0; r < nb_rows; ++r){
+            value *= 1.0 + normal_dist(generator);
+            paths[p * nb_rows + r] = value;
+        }
+    }
+    std::string csv_prefix = "/tmp/result_file_bench_", res_filename = "/tmp/result_file_bench.res";
+
+    double csv_megabytes = 0.0;
+    double csv_write = get_elapsed_seconds([&]{
+        for (size_t p = 0; p < nb_paths; ++p){
+            CsvWriter writer(csv_prefix + std::to_string(p) + ".csv", 1 << 16, false);
+            writer.write_line("Date;Value");
+            for (size_t r = 0; r < nb_rows; ++r)
+                writer.write_row(dates[r], &paths[p * nb_rows + r], 1);
+            writer.close();
+        }
+    }, 1);
+    double res_write = get_elapsed_seconds([&]{
+        ResultFileWriter writer(res_filename, dates, 0);
+        for (size_t p = 0; p < nb_paths; p += chunk_size){
+            std::vector<std::string> names;
+            for (size_t i = p; i < std::min(nb_paths, p + chunk_size); ++i)
+                names.push_back("Path_n" + std::to_string(i + 1));
+            writer.append_columns(names, &paths[p * nb_rows]);
+        }
+        writer.close();
+    }, 1);
+
+    // Sum of the end values
+    double csv_sum = 0.0, res_sum = 0.0;
+    double csv_read = get_elapsed_seconds([&]{
+        for (size_t p = 0; p < nb_paths; ++p){
+            std::string filename = csv_prefix + std::to_string(p) + ".csv";
+            std::ifstream file(filename);
+            std::string line;
+            std::getline(file, line);
+            double value = 0.0;
+            while (std::getline(file, line))
+                value = std::strtod(line.c_str() + line.find(';') + 1, nullptr);
+            csv_sum += value;
+        }
+    }, 1);
+    double res_read = get_elapsed_seconds([&]{
+        ResultFile results(res_filename);
+        for (size_t c = 0; c < results.get_nb_columns(); ++c)
+            res_sum += results.get_column(c)[results.get_nb_rows() - 1];
+    }, 1);
+    for (size_t p = 0; p < nb_paths; ++p){
+        std::string filename = csv_prefix + std::to_string(p) + ".csv";
+        csv_megabytes += get_file_megabytes(filename);
+        std::remove(filename.c_str());
+    }
+    double res_megabytes = get_file_megabytes(res_filename);
+    std::remove(res_filename.c_str());
+
+    std::cout << nb_paths << " paths x " << nb_rows << " rows (end values " << csv_sum / nb_paths << " csv, " << res_sum / nb_paths << " binary)" << std::endl;
+    std::cout << "csv files: " << csv_megabytes << " MB, written in " << csv_write * 1e3 << " ms, read in " << csv_read * 1e3 << " ms" << std::endl;
+    std::cout << "result file: " << res_megabytes << " MB, written in " << res_write * 1e3 << " ms (x" << csv_write / res_write << "), read in "
+              << res_read * 1e3 << " ms (x" << csv_read / res_read << ")" << std::endl;
+}
@@ -0,0 +1,36 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/static_strategy.hpp"
+#include <iostream>
+
+void run_static_strategy_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(2, 20, 42);
+    std::map<std::string, double> allocations = {{"BENCH_TICKER0", 0.75}, {"BENCH_TICKER1", 0.25}};
+    std::vector<std::time_t> dates = get_unique_dates(tickers_yt);
+
+    double virtual_loop = get_elapsed_seconds([&]{
+        DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+        for (const auto& date: dates)
+            dca.make_transactions(date);
+    }, 3);
+    double virtual_run = get_elapsed_seconds([&]{
+        DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+        dca.run_strategy();
+    }, 3);
+
+    MarketData market_data = get_market_data(tickers_yt);
+    double compiled_loop = get_elapsed_seconds([&]{
+        StaticStrategy<MonthlyContribution, NoDipBuy, ReinvestDividends<DefaultDividendReinvestmentRatio>, PeriodicRebalancing<30, AbsoluteThreshold<std::ratio<1, 100>>>>
+            static_dca(MonthlyContribution(10000.0, 1000.0), NoDipBuy(), ReinvestDividends<DefaultDividendReinvestmentRatio>(), PeriodicRebalancing<30, AbsoluteThreshold<std::ratio<1, 100>>>());
+        static_dca.init(market_data, tickers_yt, allocations);
+        static_dca.run();
+    }, 100);
+    double compiled_run = get_elapsed_seconds([&]{
+        CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, allocations, MonthlyContribution(10000.0, 1000.0), NoDipBuy(), "CompiledDCA_Bench");
+        compiled_dca.run_strategy();
+    }, 3);
+
+    std::cout << "DCA 2 tickers x " << dates.size() << " dates" << std::endl;
+    std::cout << "date loop - virtual DCA: " << virtual_loop * 1e3 << " ms | compiled StaticStrategy: " << compiled_loop * 1e3 << " ms | speedup x" << virtual_loop / compiled_loop << std::endl;
+    std::cout << "run_strategy (incl. PortfolioBuilder values) - virtual DCA: " << virtual_run * 1e3 << " ms | CompiledDCA: " << compiled_run * 1e3 << " ms | speedup x" << virtual_run / compiled_run << std::endl;
+}
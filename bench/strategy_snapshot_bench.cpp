@@ -0,0 +1,50 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/checkpoint.hpp"
+#include <iostream>
+#include <fstream>
+
+// Same ticker without its last quote
+static YahooTimeseries get_previous_day_ticker_yt(const YahooTimeseries& ticker_yt){
+    std::vector<std::time_t> dates = ticker_yt.get_dates();
+    dates.pop_back();
+    std::vector<double> closes;
+    for (const auto& date: dates)
+        closes.push_back(ticker_yt.get_closes().get_ts_value(date));
+    std::map<std::time_t, double> dividends = ticker_yt.get_dividends().get_ts_values();
+    dividends.erase(dividends.upper_bound(dates.back()), dividends.end());
+    return YahooTimeseries(ticker_yt.get_ticker(), dates, closes, closes, closes, closes, closes, dividends);
+}
+
+void run_strategy_snapshot_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(2, 10, 42);
+    std::vector<YahooTimeseries> previous_tickers_yt = {get_previous_day_ticker_yt(tickers_yt[0]), get_previous_day_ticker_yt(tickers_yt[1])};
+    std::map<std::string, double> allocations = {{"BENCH_TICKER0", 0.75}, {"BENCH_TICKER1", 0.25}};
+    std::string filename = "/tmp/strategy_snapshot_bench.bin";
+
+    // Yesterday's run, kept as a snapshot
+    DCA previous_dca(previous_tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+    previous_dca.run_strategy();
+    double save = get_elapsed_seconds([&]{
+        previous_dca.save_snapshot(filename);
+    }, 10);
+    std::ifstream snapshot_file(filename, std::ios::binary | std::ios::ate);
+    double snapshot_kilobytes = snapshot_file.tellg() / 1024.0;
+
+    // Today: whole history again, or the snapshot and the new bar
+    double full_run = get_elapsed_seconds([&]{
+        DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+        dca.run_strategy();
+    }, 3);
+    double continued_run = get_elapsed_seconds([&]{
+        DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+        dca.load_snapshot(filename);
+        dca.run_strategy();
+    }, 3);
+    remove_checkpoint(filename);
+
+    std::cout << "DCA 2 tickers x " << tickers_yt[0].get_dates().size() << " dates, one new date" << std::endl;
+    std::cout << "Snapshot: " << snapshot_kilobytes << " KB saved in " << save * 1e3 << " ms" << std::endl;
+    std::cout << "Full run_strategy: " << full_run * 1e3 << " ms | load_snapshot + run_strategy: " << continued_run * 1e3 << " ms | speedup x" << full_run / continued_run << std::endl;
+}
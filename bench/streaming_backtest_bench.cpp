@@ -0,0 +1,67 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/streaming_backtest.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <unistd.h>
+
+static double get_resident_megabytes(){
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    statm >> total_pages >> resident_pages;
+    return resident_pages * double(sysconf(_SC_PAGESIZE)) / (1 << 20);
+}
+
+void run_streaming_backtest_bench(){
+    size_t nb_tickers = 100, nb_bars = 1000000, block_size = 8192;
+    std::string filename = "/tmp/streaming_backtest_bench.bin";
+
+    // Minute bars written row by row, the writer only holding one block
+    std::vector<std::string> tickers;
+    for (size_t t = 0; t < nb_tickers; ++t)
+        tickers.push_back("BENCH_TICKER" + std::to_string(t));
+    std::time_t start = get_bench_date(2000, 1, 3, 9, 30);
+    std::mt19937 generator(3);
+    std::normal_distribution<double> normal_dist(0.0, 0.0006);
+    double write_seconds = get_elapsed_seconds([&]{
+        BarFileWriter writer(filename, tickers, block_size);
+        std::vector<double> closes(nb_tickers, 100.0), dividends(nb_tickers, 0.0);
+        size_t day = 0;
+        for (size_t i = 0; i < nb_bars; ++i){
+            if (i > 0 && i % 390 == 0)
+                day += (day % 7 == 4) ? 3 : 1;
+            for (size_t t = 0; t < nb_tickers; ++t){
+                closes[t] *= 1.0 + normal_dist(generator);
+                dividends[t] = (i % (390 * 63) == 30) ? 0.004 * closes[t] : 0.0;
+            }
+            writer.append(start + day * 86400 + (i % 390) * 60, closes.data(), dividends.data());
+        }
+        writer.close();
+    }, 1);
+    double file_megabytes = (sizeof(int64_t) + 2 * nb_tickers * sizeof(double)) * double(nb_bars) / (1 << 20);
+
+    std::vector<BatchPortfolio> portfolios;
+    for (size_t p = 0; p < 16; ++p)
+        portfolios.push_back({10000.0, 500.0, std::vector<double>(nb_tickers, 1.0 / nb_tickers), int(390 * (p + 1)), 0.01});
+    StreamingBacktest backtest(portfolios, BatchContribution::MONTHLY, RebalancingThreshold::ABSOLUTE, 390);
+    BarSource source(filename);
+    double start_megabytes = get_resident_megabytes();
+    double peak_megabytes = start_megabytes;
+    double stream_seconds = get_elapsed_seconds([&]{
+        backtest.reset(nb_tickers);
+        source.stream([&](const BarChunk& chunk){
+            backtest.process_chunk(chunk);
+            peak_megabytes = std::max(peak_megabytes, get_resident_megabytes());
+        });
+    }, 1);
+    std::remove(filename.c_str());
+
+    double chunk_megabytes = block_size * (sizeof(int64_t) + 2 * nb_tickers * sizeof(double)) / double(1 << 20);
+    std::cout << nb_tickers << " tickers x " << nb_bars << " minute bars, " << file_megabytes << " MB file, chunks of "
+              << block_size << " rows (" << chunk_megabytes << " MB)" << std::endl;
+    std::cout << "Write: " << nb_bars / write_seconds / 1e6 << " M rows/s" << std::endl;
+    std::cout << "Stream " << portfolios.size() << " portfolios + SMA: " << nb_bars / stream_seconds / 1e6 << " M rows/s, "
+              << nb_bars * nb_tickers / stream_seconds / 1e6 << " M bars/s" << std::endl;
+    std::cout << "Resident memory growth while streaming: " << peak_megabytes - start_megabytes << " MB" << std::endl;
+}
@@ -0,0 +1,37 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include <iostream>
+#include <cstdio>
+
+void run_variance_reduction_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(3, 10, 42);
+    std::map<std::string, double> allocations = {{"BENCH_TICKER0", 0.5}, {"BENCH_TICKER1", 0.3}, {"BENCH_TICKER2", 0.2}};
+    DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+    dca.run_strategy();
+    dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+
+    size_t nb_paths = 1024;
+    dca.set_montecarlo_config(42, 0, get_bench_start_date(), false);
+    std::vector<std::pair<std::string, VarianceReduction>> modes = {{"plain", VarianceReduction::NONE}, {"antithetic variates", VarianceReduction::ANTITHETIC_VARIATES},
+                                                                    {"control variate", VarianceReduction::CONTROL_VARIATE}, {"Sobol + Brownian bridge", VarianceReduction::SOBOL_BROWNIAN_BRIDGE}};
+    MonteCarloEstimates plain;
+    std::vector<std::string> lines;
+    for (const auto& mode: modes){
+        dca.set_montecarlo_variance_reduction(mode.second);
+        dca.run_montecarlo_simulations(nb_paths);
+        const MonteCarloEstimates& estimates = dca.get_montecarlo_estimates();
+        if (mode.second == VarianceReduction::NONE)
+            plain = estimates;
+        // Paths needed for the plain standard error shrink with the variance ratio
+        double mean_ratio = std::pow(plain.mean_standard_error / estimates.mean_standard_error, 2);
+        double median_ratio = std::pow(plain.quantile_standard_errors[2] / estimates.quantile_standard_errors[2], 2);
+        lines.push_back(mode.first + ": mean " + std::to_string(estimates.mean) + " +- " + std::to_string(estimates.mean_standard_error) + " (x" + std::to_string(mean_ratio)
+                        + " fewer paths) | median " + std::to_string(estimates.quantiles[2]) + " +- " + std::to_string(estimates.quantile_standard_errors[2]) + " (x" + std::to_string(median_ratio) + " fewer paths)");
+    }
+    std::cout << nb_paths << " paths x 20 years, DCA on 3 correlated tickers" << std::endl;
+    for (const auto& line: lines)
+        std::cout << line << std::endl;
+    std::remove("../strat_outputs/DCA_Bench_MonteCarloSummary.csv");
+}
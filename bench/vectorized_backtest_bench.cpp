@@ -0,0 +1,22 @@
+#include "./benchmarks.hpp"
+#include "./bench_utils.hpp"
+#include "../headers/vectorized_backtest.hpp"
+#include "../headers/strategy.hpp"
+#include <iostream>
+
+void run_vectorized_backtest_bench(){
+    std::vector<YahooTimeseries> tickers_yt = get_bench_tickers_yt(2, 20, 42);
+    std::map<std::string, double> allocations = {{"BENCH_TICKER0", 0.75}, {"BENCH_TICKER1", 0.25}};
+    VectorizedBacktest backtest(tickers_yt, allocations, 30, 0.01);
+
+    double event_loop = get_elapsed_seconds([&]{
+        DCA dca(tickers_yt, 10000.0, 1000.0, allocations, 30, 0.01, "DCA_Bench");
+        dca.run_strategy();
+    }, 3);
+    double vectorized = get_elapsed_seconds([&]{
+        backtest.run_dca(10000.0, 1000.0);
+    }, 100);
+
+    std::cout << "DCA 2 tickers x " << backtest.get_market_data().dates.size() << " dates" << std::endl;
+    std::cout << "run_strategy: " << event_loop * 1e3 << " ms | VectorizedBacktest::run_dca: " << vectorized * 1e3 << " ms | speedup x" << event_loop / vectorized << std::endl;
+}
@@ -0,0 +1,38 @@
+#ifndef ADAPTIVE_MONTECARLO
+#define ADAPTIVE_MONTECARLO
+
+#include "./montecarlo_aggregator.hpp"
+
+enum class MonteCarloStatistic { MEDIAN_END_VALUE, P5_END_VALUE, PROBABILITY_OF_LOSS };
+enum class MonteCarloStopReason { PRECISION_MET, PATH_BUDGET, TIME_BUDGET };
+
+struct MonteCarloPrecisionTarget {
+    MonteCarloStatistic statistic;
+    double max_half_width; // of the confidence interval: relative to the estimate for end values, absolute for the probability of loss
+};
+
+// Paths are run by batches; after each batch the confidence intervals of the targets are checked and the run stops
+// once every target is met, the time budget (max_seconds, 0 for none) is spent or the path budget (nb_simu) is used
+struct MonteCarloStoppingRule {
+    std::vector<MonteCarloPrecisionTarget> targets;
+    double confidence_level;
+    size_t batch_size;
+    double max_seconds;
+};
+
+struct MonteCarloConvergence {
+    size_t nb_paths;
+    size_t nb_batches;
+    double elapsed_seconds;
+    MonteCarloStopReason stop_reason;
+    std::vector<double> estimates;   // one per target
+    std::vector<double> half_widths; // achieved, in the unit of the target
+};
+
+// Cornish-Fisher expansion of the Student t quantile around the normal one (error < 1e-4 for dof >= 5)
+double get_student_t_quantile(double p, double dof);
+std::string get_statistic_name(MonteCarloStatistic statistic);
+// Estimates and achieved confidence interval half widths of the targets; has_converged when every target is met
+MonteCarloConvergence get_montecarlo_convergence(const MonteCarloEstimates& estimates, const MonteCarloStoppingRule& stopping_rule, bool& has_converged);
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef BAR_FILE
+#define BAR_FILE
+
+#include "./yahoo_timeseries.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+
+// Aligned bar files: a header (magic, block size, number of bars, header size, tickers) padded to pages, then blocks of block_size rows
+// stored column by column: the times, the closes of each ticker, the dividends of each ticker. A ticker without a bar at a row
+// has a NaN close, a row without dividend a 0. Blocks are page-aligned so each window of the history can be mapped,
+// prefetched and released on its own.
+class BarFileWriter {
+public:
+    // block_size is a multiple of 512 rows
+    BarFileWriter(std::string filename, const std::vector<std::string>& tickers, size_t block_size);
+    // closes[t] is NaN when ticker t has no bar at time, dividends may be nullptr
+    void append(std::time_t time, const double* closes, const double* dividends);
+    bool close(); // false when the file could not be written
+    ~BarFileWriter();
+
+private:
+    std::string filename;
+    size_t nb_tickers;
+    size_t block_size;
+    size_t nb_bars;
+    size_t block_row;
+    std::vector<int64_t> block_times;
+    std::vector<double> block_values; // [2 * nb_tickers][block_size]: closes then dividends
+    FILE* file;
+    bool is_written;
+
+    void write_block();
+};
+
+// Rows on the union calendar of the tickers
+bool write_bar_file(std::string filename, const std::vector<YahooTimeseries>& tickers_yt, size_t block_size);
+
+// Rows [first_bar, first_bar + nb_bars) of a bar file, pointing into its mapping
+struct BarChunk {
+    size_t first_bar;
+    size_t nb_bars;
+    const std::time_t* times;
+    std::vector<const double*> closes;    // [ticker]
+    std::vector<const double*> dividends; // [ticker]
+};
+
+// Read-only mapping of a bar file streamed one block at a time: while the consumer processes chunk k the prefetch thread
+// of the stream faults in the pages of chunk k + 1, and the pages of chunk k are released once it is processed, so the resident memory
+// stays about two chunks whatever the length of the history.
+class BarSource {
+public:
+    explicit BarSource(std::string filename);
+    BarSource(const BarSource&) = delete;
+    BarSource& operator=(const BarSource&) = delete;
+
+    bool is_open() const;
+    size_t get_nb_bars() const;
+    size_t get_chunk_size() const;
+    size_t get_nb_chunks() const;
+    const std::vector<std::string>& get_tickers() const;
+    BarChunk get_chunk(size_t chunk_idx) const;
+    void stream(const std::function<void(const BarChunk&)>& consumer) const;
+
+    ~BarSource();
+
+private:
+    std::vector<std::string> tickers;
+    size_t nb_bars;
+    size_t block_size;
+    size_t data_offset;
+    size_t block_bytes;
+    int fd;
+    char* mapping;
+    size_t mapping_size;
+
+    void prefetch(size_t chunk_idx) const;
+    void release(size_t chunk_idx) const;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef BATCH_ENGINE
+#define BATCH_ENGINE
+
+#include "./market_data.hpp"
+#include "./rebalancer.hpp"
+
+enum class BatchContribution { MONTHLY, LUMP_SUM };
+
+struct BatchPortfolio {
+    double starting_amount;
+    double recurrent_investment_amount; // 0 for a lump sum
+    std::vector<double> allocations;    // one per asset
+    int rebalancing_freq;
+    double rebalancing_threshold;
+};
+
+// N portfolios (DCA / LumpSum semantics, no dip trigger) advanced together one date at a time.
+// The state is stored [asset][portfolio] so every inner loop runs over contiguous portfolios.
+class BatchEngine {
+public:
+    BatchEngine(const std::vector<BatchPortfolio>& portfolios, RebalancingThreshold rebalancing_mode);
+    BatchEngine(const BatchPortfolio& portfolio, size_t nb_portfolios, RebalancingThreshold rebalancing_mode);
+
+    void reset();
+    // asset_prices[a][p * price_stride] is the close of asset a seen by portfolio p at this date:
+    // price_stride = 0 shares one price, 1 reads a [date][portfolio] buffer, nb_dates reads a [portfolio][date] buffer.
+    // dividends (one per asset, may be nullptr) are shared by every portfolio.
+    void step(const double* const* asset_prices, size_t price_stride, const double* dividends, const char* is_contribution_dates);
+    void get_portfolio_values(const double* const* asset_prices, size_t price_stride, double* values) const;
+    // Runs the whole calendar on shared historical prices, values is filled [date][portfolio]
+    void run(const MarketData& market_data, BatchContribution contribution, std::vector<double>& values);
+    // Runs simulated paths: asset_paths[a] is a [portfolio x nb_steps] buffer (e.g. from PathGenerator), portfolio p reading row p.
+    // values, when not nullptr, is filled [portfolio][step] like the paths.
+    void run_paths(const std::vector<const double*>& asset_paths, size_t nb_steps, const std::vector<std::vector<char>>& is_contribution_dates, double* values);
+
+    size_t get_nb_portfolios() const;
+    size_t get_nb_assets() const;
+    const double* get_shares(size_t asset_idx) const;
+    const double* get_expenses(size_t asset_idx) const;
+    const double* get_cash_flows() const; // cash flows of the last step, < 0 when money is invested
+    const double* get_net_investments() const; // money put in since the first step, net of sales
+
+    ~BatchEngine();
+
+private:
+    size_t nb_portfolios;
+    size_t nb_assets;
+    RebalancingThreshold rebalancing_mode;
+    std::vector<double> starting_amounts;
+    std::vector<double> recurrent_investment_amounts;
+    std::vector<double> allocations;             // [asset][portfolio]
+    std::vector<int> rebalancing_freqs;
+    std::vector<double> rebalancing_thresholds;
+
+    std::vector<double> shares;                  // [asset][portfolio]
+    std::vector<double> expenses;                // [asset][portfolio]
+    std::vector<double> pending_starting_amounts; // [asset][portfolio]
+    std::vector<int> last_rebalancing_nb_days;
+    std::vector<double> cash_flows;
+    std::vector<double> net_investments;
+    std::vector<double> ptf_values;
+    std::vector<char> is_rebalancing;
+    std::vector<char> is_band_breached;
+
+    void rebalance(const double* const* asset_prices, size_t price_stride);
+};
+
+#endif
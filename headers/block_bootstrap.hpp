@@ -0,0 +1,37 @@
+#ifndef BLOCK_BOOTSTRAP_HPP
+#define BLOCK_BOOTSTRAP_HPP
+
+#include "./multi_asset_simulator.hpp"
+
+// FIXED_BLOCKS: blocks of exactly mean_block_length returns.
+// STATIONARY_BLOCKS (Politis & Romano): a new block starts at each step with probability 1 / mean_block_length.
+enum class BootstrapScheme { FIXED_BLOCKS, STATIONARY_BLOCKS };
+
+// Historical paths: blocks of consecutive dates are resampled (circularly) from the tickers' daily return vectors,
+// every asset reading the same dates so the cross-asset dependence, fat tails and volatility clusters are kept.
+class BlockBootstrapSimulator {
+public:
+    BlockBootstrapSimulator(const std::vector<YahooTimeseries>& tickers_yt, BootstrapScheme scheme, double mean_block_length, uint64_t seed);
+
+    // asset_paths[a] is a [paths x steps] buffer, path i drawn from the Philox stream (seed, i)
+    void generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps, const std::vector<double*>& asset_paths) const;
+    std::vector<std::vector<double>> generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps) const;
+    // Historical date index of every step return of path path_idx
+    std::vector<size_t> get_resampled_indices(size_t path_idx, size_t nb_returns) const;
+
+    const std::vector<std::string>& get_tickers() const;
+    size_t get_nb_historical_returns() const;
+
+    ~BlockBootstrapSimulator();
+
+private:
+    BootstrapScheme scheme;
+    double mean_block_length;
+    uint64_t seed;
+    std::vector<std::string> tickers;
+    Eigen::VectorXd start_prices;
+    std::vector<double> returns; // [date][asset]: the cross-sectional vector of a date is contiguous
+    size_t nb_historical_returns;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef CHECKPOINT
+#define CHECKPOINT
+
+#include <string>
+
+// Checkpoint files: magic, payload size, FNV-1a checksum, then the payload (see ./serialization.hpp).
+// They are written to <filename>.tmp, flushed to disk and renamed over <filename>, so an interrupted write
+// leaves the previous checkpoint intact.
+bool write_checkpoint(const std::string& filename, const std::string& payload);
+// False when there is no checkpoint or when it is truncated or corrupted
+bool read_checkpoint(const std::string& filename, std::string& payload);
+void remove_checkpoint(const std::string& filename);
+
+#endif
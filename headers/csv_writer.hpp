@@ -0,0 +1,52 @@
+#ifndef CSV_WRITER
+#define CSV_WRITER
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// unix_timestamp_to_date_string of date, formatted once per date and thread
+const std::string& get_cached_date_string(std::time_t date);
+
+// ';' separated rows formatted into a buffer of buffer_size bytes, written when it is full: doubles through std::to_chars
+// give the text of ostream << (6 significant digits), dates come from get_cached_date_string.
+// With a background writer, full buffers are written by a thread while the next one is filled.
+class CsvWriter {
+public:
+    CsvWriter(std::string filename, size_t buffer_size, bool is_background_writer);
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    bool is_open() const;
+    // Lines and rows must fit in the buffer
+    void write_line(const std::string& line);
+    // date;values[0];...;values[nb_values - 1]
+    void write_row(std::time_t date, const double* values, size_t nb_values);
+    bool close(); // false when the file could not be written
+    ~CsvWriter();
+
+private:
+    FILE* file;
+    std::vector<char> buffer;
+    size_t buffer_used;
+    bool is_written;
+
+    bool is_background_writer;
+    std::thread writer_thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<char> pending_buffer; // owned by the writer thread while is_pending
+    size_t pending_used;
+    bool is_pending;
+    bool is_closing;
+
+    void reserve(size_t nb_bytes);
+    void flush_buffer();
+    void run_writer();
+};
+
+#endif
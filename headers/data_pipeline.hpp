@@ -0,0 +1,132 @@
+#ifndef DATA_PIPELINE
+#define DATA_PIPELINE
+
+#include "./yahoo_timeseries.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <optional>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+// Blocking FIFO holding at most capacity items: push waits while it is full, pop while it is empty.
+// Once closed, push drops its item and returns false, and pop returns false when the queue is drained.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity);
+
+    bool push(T item);
+    bool pop(T& item);
+    void close();
+    size_t get_max_size() const; // largest number of items queued at once
+
+private:
+    std::deque<T> items;
+    size_t capacity;
+    size_t max_size;
+    bool is_closed;
+    mutable std::mutex mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity): capacity(capacity), max_size(0), is_closed(false){}
+
+template <typename T>
+bool BoundedQueue<T>::push(T item){
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->not_full.wait(lock, [this]{ return this->items.size() < this->capacity || this->is_closed; });
+    if (this->is_closed)
+        return false;
+    this->items.push_back(std::move(item));
+    this->max_size = std::max(this->max_size, this->items.size());
+    this->not_empty.notify_one();
+    return true;
+}
+
+template <typename T>
+bool BoundedQueue<T>::pop(T& item){
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->not_empty.wait(lock, [this]{ return !this->items.empty() || this->is_closed; });
+    if (this->items.empty())
+        return false;
+    item = std::move(this->items.front());
+    this->items.pop_front();
+    this->not_full.notify_one();
+    return true;
+}
+
+template <typename T>
+void BoundedQueue<T>::close(){
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->is_closed = true;
+    this->not_empty.notify_all();
+    this->not_full.notify_all();
+}
+
+template <typename T>
+size_t BoundedQueue<T>::get_max_size() const{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->max_size;
+}
+
+struct TickerData {
+    std::string ticker;                          // as requested
+    std::optional<YahooTimeseries> ticker_yt;    // empty when the download could not be parsed
+    std::map<std::string, Timeseries> indicators;
+};
+
+// Busy time of each stage summed over its threads, against the elapsed time of the run
+struct DataPipelineStats {
+    size_t nb_tickers;
+    size_t nb_failed_tickers;
+    double fetch_seconds;
+    double parse_seconds;
+    double compute_seconds; // indicators and consumer
+    double elapsed_seconds;
+    size_t max_fetched_queue_size;
+    size_t max_parsed_queue_size;
+};
+
+typedef std::function<std::string(const std::string&)> TickerFetcher;
+typedef std::function<Timeseries(const YahooTimeseries&)> TickerIndicator;
+
+// get_ticker_str_data over the period
+TickerFetcher get_yahoo_fetcher(std::string start_date, std::string end_date, std::string freq);
+
+// Ticker data loaded as a pipeline: downloads run on the fetch threads, each completed download is parsed by the next free
+// parse thread, then the compute threads evaluate its indicators and hand it to the consumer. Network latency, json parsing
+// and computation overlap, so a batch takes about the time of its slowest stage instead of their sum.
+// The stages are linked by BoundedQueues of queue_capacity tickers: a faster stage waits for the next one instead of
+// buffering the whole batch.
+class DataPipeline {
+public:
+    DataPipeline(const TickerFetcher& fetcher, size_t nb_fetch_threads, size_t nb_parse_threads, size_t nb_compute_threads, size_t queue_capacity);
+
+    void add_indicator(std::string name, const TickerIndicator& indicator);
+    // Called from the compute threads for every parsed ticker once its indicators are set, in completion order
+    void set_consumer(const std::function<void(size_t ticker_idx, const TickerData& ticker_data)>& consumer);
+    // Data of the tickers in their order. A download that can't be parsed only fails its ticker; an exception thrown by the
+    // fetcher, an indicator or the consumer stops every stage and is rethrown once the threads are joined.
+    std::vector<TickerData> run(const std::vector<std::string>& tickers);
+    const DataPipelineStats& get_stats() const;
+
+    ~DataPipeline();
+
+private:
+    TickerFetcher fetcher;
+    size_t nb_fetch_threads;
+    size_t nb_parse_threads;
+    size_t nb_compute_threads;
+    size_t queue_capacity;
+    std::vector<std::pair<std::string, TickerIndicator>> indicators;
+    std::function<void(size_t, const TickerData&)> consumer;
+    DataPipelineStats stats;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef DISTRIBUTED_RUNNER
+#define DISTRIBUTED_RUNNER
+
+#include <string>
+#include <vector>
+#include <functional>
+
+// Length-prefixed messages over a connected stream socket (socketpair, Unix or TCP socket), false when the peer is gone
+bool send_message(int fd, const std::string& message);
+bool receive_message(int fd, std::string& message);
+
+// Items [first_item, first_item + nb_items) of a job, run by a worker: returns the serialized partial result
+typedef std::function<std::string(size_t first_item, size_t nb_items)> ShardTask;
+
+// Serves shard requests on fd until the coordinator sends a stop request. The loop only needs the connected socket:
+// a worker started on another node with the same job and connected over TCP runs it unchanged.
+void run_worker_loop(int fd, const ShardTask& task);
+
+struct DistributedThroughput {
+    size_t nb_workers;
+    size_t nb_items;
+    double elapsed_seconds;
+    double items_per_second;
+};
+
+// Coordinator of local worker processes. Each run forks the workers with a socketpair to the coordinator, so they inherit
+// the job (tickers, strategy, settings) copy-on-write and only shard ranges and partial results cross the sockets.
+// Shards are dealt to idle workers; the results are returned in shard order so merging them is deterministic.
+class LocalCluster {
+public:
+    explicit LocalCluster(size_t nb_workers); // 0 means std::thread::hardware_concurrency()
+
+    std::vector<std::string> run(size_t nb_items, size_t shard_size, const ShardTask& task);
+    size_t get_nb_workers() const;
+    const DistributedThroughput& get_throughput() const;
+    // Runs a job using this cluster (e.g. a distributed Monte Carlo) on 1, 2, 4, ... max_workers workers
+    // and prints the speedup and efficiency against one worker
+    std::vector<DistributedThroughput> benchmark_scaling(const std::function<void(LocalCluster&)>& job, size_t max_workers);
+
+    ~LocalCluster();
+
+private:
+    size_t nb_workers;
+    DistributedThroughput throughput;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef EVENT_ENGINE
+#define EVENT_ENGINE
+
+#include "./rebalancer.hpp"
+#include <ctime>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+// TICKS fires on every period-th timestamp of its clock, the calendar cadences on the first timestamp
+// at or after each boundary (every period seconds, local days or months from the first timestamp)
+enum class ScheduleCadence { TICKS, SECONDS, DAYS, MONTHS };
+
+struct Schedule {
+    ScheduleCadence cadence;
+    size_t period;
+};
+
+typedef std::function<void(size_t ticker_idx, std::time_t time, double value)> TickerEventHandler;
+typedef std::function<void(std::time_t time)> ScheduledAction;
+
+struct EventThroughput {
+    size_t nb_events;
+    double elapsed_seconds;
+    double events_per_second;
+};
+
+// Event-driven core for any bar frequency: the bar and dividend streams of every ticker are merged by a min-heap
+// holding one cursor per stream, so memory does not grow with the number of events and bars are read in place
+// from the caller's arrays (which must outlive the engine).
+// At one timestamp the bars first update the last closes, then the schedules of the tickers that traded fire,
+// then the dividends and finally the market clock schedules, each in the order they were added.
+class EventEngine {
+public:
+    EventEngine();
+
+    // Bars at increasing times, returns the ticker index
+    size_t add_ticker(std::string ticker, const std::time_t* times, const double* closes, size_t nb_bars);
+    void add_dividends(size_t ticker_idx, const std::time_t* times, const double* amounts, size_t nb_dividends);
+    void set_bar_handler(const TickerEventHandler& handler);
+    void set_dividend_handler(const TickerEventHandler& handler);
+    // ticker_idx -1 follows the market clock (every timestamp), otherwise the bars of that ticker
+    void add_schedule(const Schedule& schedule, int ticker_idx, const ScheduledAction& action);
+
+    void run();
+
+    size_t get_nb_tickers() const;
+    const std::vector<std::string>& get_tickers() const;
+    const double* get_last_closes() const; // 0 before the first bar of a ticker
+    const EventThroughput& get_throughput() const;
+
+    ~EventEngine();
+
+private:
+    enum EventKind { BAR = 0, DIVIDEND = 1 };
+
+    struct EventStream {
+        const std::time_t* times;
+        const double* values;
+        size_t nb_events;
+        size_t position;
+    };
+
+    struct HeapEntry {
+        std::time_t time;
+        int kind;
+        size_t ticker_idx;
+    };
+
+    struct ScheduleState {
+        Schedule schedule;
+        ScheduledAction action;
+        std::time_t next_time;
+        std::time_t anchor_time;
+        size_t nb_ticks;
+    };
+
+    std::vector<std::string> tickers;
+    std::vector<EventStream> bar_streams;
+    std::vector<EventStream> dividend_streams;
+    TickerEventHandler bar_handler;
+    TickerEventHandler dividend_handler;
+    std::vector<ScheduleState> schedules;
+    std::vector<std::vector<size_t>> ticker_schedules; // [ticker] schedule indices
+    std::vector<size_t> clock_schedules;
+
+    std::vector<HeapEntry> heap;
+    std::vector<double> last_closes;
+    std::vector<size_t> traded_tickers;
+    size_t nb_events;
+    EventThroughput throughput;
+
+    // Min-heap order: earlier first, bars before dividends, then ticker order
+    static bool is_later(const HeapEntry& a, const HeapEntry& b);
+    void push_stream(int kind, size_t ticker_idx);
+    void advance_top();
+    void fire_if_due(ScheduleState& state, std::time_t time);
+};
+
+// DCA on the EventEngine (no dip trigger): the starting amount and the monthly contributions are invested at the first bar
+// of each ticker's month, 70% of the dividends are reinvested, the portfolio is rebalanced to its targets and valued
+// on its own schedules. The state is one share count per ticker, so intraday bars cost the same as daily ones.
+class EventDrivenDCA {
+public:
+    // allocations in the engine's ticker order; the engine must not be run by another strategy
+    EventDrivenDCA(EventEngine& engine, double starting_amount, double recurrent_investment_amount, const std::vector<double>& allocations,
+                   const Schedule& rebalancing_schedule, RebalancingThreshold rebalancing_mode, double rebalancing_threshold,
+                   const Schedule& valuation_schedule);
+    EventDrivenDCA(const EventDrivenDCA&) = delete;
+    EventDrivenDCA& operator=(const EventDrivenDCA&) = delete;
+
+    void run();
+
+    const std::vector<std::time_t>& get_value_dates() const;
+    const std::vector<double>& get_values() const;
+    const std::vector<double>& get_shares() const;
+    double get_net_investment() const; // money put in since the first bar, net of sales
+    size_t get_nb_rebalancings() const;
+
+    ~EventDrivenDCA();
+
+private:
+    EventEngine& engine;
+    double starting_amount;
+    double recurrent_investment_amount;
+    std::vector<double> allocations;
+    Rebalancer rebalancer;
+
+    std::vector<double> shares;
+    std::vector<double> pending_starting_amounts;
+    double net_investment;
+    size_t nb_rebalancings;
+    std::vector<std::time_t> value_dates;
+    std::vector<double> values;
+
+    void contribute(size_t ticker_idx);
+    void reinvest_dividend(size_t ticker_idx, double amount);
+    void rebalance();
+    void record_value(std::time_t time);
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef MARKET_DATA
+#define MARKET_DATA
+
+#include "./yahoo_timeseries.hpp"
+
+// Dense [ticker][date] view of the tickers on their union calendar, with the same lookup rules as
+// Timeseries::get_ts_value (closes are carried forward, 0 before the first quote).
+struct MarketData {
+    std::vector<std::string> tickers;
+    std::vector<std::time_t> dates;
+    std::vector<std::vector<double>> closes;
+    std::vector<std::vector<double>> dividends;
+    std::vector<std::vector<char>> is_first_month_dates;
+    std::vector<std::vector<char>> is_last_month_dates;
+    std::vector<size_t> first_date_indices;
+};
+
+MarketData get_market_data(const std::vector<YahooTimeseries>& tickers_yt);
+std::vector<double> get_dense_values(const Timeseries& ts, const std::vector<std::time_t>& dates);
+size_t get_ticker_index(const MarketData& market_data, std::string ticker);
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef MONTECARLO_AGGREGATOR
+#define MONTECARLO_AGGREGATOR
+
+#include <vector>
+#include <string>
+#include <ctime>
+#include "./serialization.hpp"
+
+struct Centroid {
+    double mean;
+    double weight;
+};
+
+// Merging t-digest (Dunning & Ertl): quantile sketch of bounded size, accurate in the tails, whose merge is
+// just a re-compression of both centroid lists
+class TDigest {
+public:
+    explicit TDigest(double compression);
+
+    void add(double value);
+    void merge(const TDigest& other);
+    void compress();
+    void reset(); // empty again, keeping the allocated buffers
+    // Exact binary copy of the digest, buffer included
+    void write(ByteWriter& writer) const;
+    void read(ByteReader& reader);
+    double get_quantile(double q) const;
+    double get_cdf(double value) const;
+    double get_count() const;
+    const std::vector<Centroid>& get_centroids() const;
+
+    ~TDigest();
+
+private:
+    double compression;
+    std::vector<Centroid> centroids;
+    std::vector<Centroid> buffer;
+    double count;
+    double min_value;
+    double max_value;
+
+    // quantile/cdf queries flush the buffer of a const digest on a copy
+    const TDigest& get_compressed(TDigest& copy) const;
+};
+
+// Welford accumulator, merged with Chan's parallel formula
+struct RunningMoments {
+    double count;
+    double mean;
+    double m2;
+
+    void add(double value);
+    void merge(const RunningMoments& other);
+    double get_std() const;
+};
+
+struct HistogramBin {
+    double lower_bound;
+    double upper_bound;
+    double nb_paths;
+};
+
+// Streaming summary of Monte Carlo portfolio paths: per-date quantile bands, mean and standard deviation.
+// Aggregators filled by different threads are combined with merge; merging in a fixed order gives identical results.
+class MonteCarloAggregator {
+public:
+    MonteCarloAggregator(const std::vector<std::time_t>& dates, double compression);
+
+    void add_path(const double* values); // one value per date
+    void merge(const MonteCarloAggregator& other);
+    void reset();
+    // Exact binary copy, e.g. to merge the partial aggregates of other processes
+    void write(ByteWriter& writer) const;
+    void read(ByteReader& reader);
+
+    size_t get_nb_paths() const;
+    const std::vector<std::time_t>& get_dates() const;
+    double get_quantile(size_t date_idx, double q) const;
+    double get_mean(size_t date_idx) const;
+    double get_std(size_t date_idx) const;
+    std::vector<HistogramBin> get_end_value_histogram(size_t nb_bins) const;
+    void save(std::string filename, size_t nb_bins) const;
+
+    ~MonteCarloAggregator();
+
+private:
+    std::vector<std::time_t> dates;
+    std::vector<TDigest> digests;
+    std::vector<RunningMoments> moments;
+    size_t nb_paths;
+};
+
+struct MonteCarloEstimates {
+    size_t nb_replicates;
+    double mean;
+    double mean_standard_error;
+    std::vector<double> quantile_levels;
+    std::vector<double> quantiles;
+    std::vector<double> quantile_standard_errors;
+    double probability_of_loss;          // end value below the net invested amount
+    double probability_of_loss_standard_error;
+};
+
+// End value mean and quantiles with their standard errors from independent replicates (batch means):
+// replicates[i] is the replicate of end_values[i]. With control_values, the mean is the control variate
+// estimator mean(y - beta * (x - control_expectation)), beta = cov(x, y) / var(x).
+// net_investments (may be nullptr) gives the probability of loss.
+MonteCarloEstimates get_montecarlo_estimates(const std::vector<double>& end_values, const std::vector<size_t>& replicates, size_t nb_replicates,
+                                             const std::vector<double>* control_values, double control_expectation, const std::vector<double>& quantile_levels,
+                                             const std::vector<double>* net_investments);
+
+#endif
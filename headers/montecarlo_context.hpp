@@ -0,0 +1,37 @@
+#ifndef MONTECARLO_CONTEXT
+#define MONTECARLO_CONTEXT
+
+#include "./batch_engine.hpp"
+#include <memory>
+
+// Per-thread state of a Monte Carlo run, allocated once and reused by every chunk of paths the thread runs:
+// the per-asset price buffers, the portfolio values and the BatchEngine (reset between chunks).
+// The per-path work is then only generating the prices and stepping the portfolios.
+class MonteCarloPathContext {
+public:
+    MonteCarloPathContext(size_t nb_assets, size_t chunk_size, size_t nb_steps);
+    // The buffer pointers stay valid through a move, not through a copy
+    MonteCarloPathContext(const MonteCarloPathContext&) = delete;
+    MonteCarloPathContext(MonteCarloPathContext&&) = default;
+
+    // asset_paths[a] is a [chunk_size x nb_steps] buffer
+    const std::vector<double*>& get_asset_paths();
+    const std::vector<const double*>& get_const_asset_paths() const;
+    double* get_values();
+    // The engine is only rebuilt when the number of paths changes (the last chunk of a run)
+    BatchEngine& get_engine(const BatchPortfolio& portfolio, size_t nb_paths, RebalancingThreshold rebalancing_mode);
+    size_t get_nb_engine_constructions() const;
+
+    ~MonteCarloPathContext();
+
+private:
+    size_t nb_steps;
+    std::vector<std::vector<double>> paths;
+    std::vector<double*> asset_paths;
+    std::vector<const double*> const_asset_paths;
+    std::vector<double> values;
+    std::unique_ptr<BatchEngine> engine;
+    size_t nb_engine_constructions;
+};
+
+#endif
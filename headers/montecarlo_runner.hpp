@@ -0,0 +1,107 @@
+#ifndef MONTECARLO_RUNNER
+#define MONTECARLO_RUNNER
+
+#include "./portfolio_builder.hpp"
+#include "./montecarlo_aggregator.hpp"
+#include "./batch_engine.hpp"
+#include "./rebalancer.hpp"
+#include "./block_bootstrap.hpp"
+#include "./adaptive_montecarlo.hpp"
+#include "./distributed_runner.hpp"
+#include "./result_file.hpp"
+#include <functional>
+#include <cstdint>
+
+class Strategy;
+
+struct MonteCarloThroughput {
+    size_t nb_threads;
+    size_t nb_paths;
+    double elapsed_seconds;
+    double paths_per_second;
+};
+
+// Per-path samples of a Monte Carlo run, index i being path first_path + i: the estimates are computed from them
+struct MonteCarloSamples {
+    size_t first_path;
+    std::vector<double> end_values;
+    std::vector<double> control_values; // lump-sum growth of each path
+    double control_expectation;
+    std::vector<double> net_investments;
+    std::vector<size_t> replicates;
+    bool has_control;
+};
+
+// PORTFOLIO_PRICE simulates the portfolio price as one synthetic ticker, CORRELATED_ASSETS simulates every ticker
+// with the historical covariance so the allocations and rebalancing of the strategy are exercised,
+// BLOCK_BOOTSTRAP resamples blocks of the tickers' historical returns
+enum class MonteCarloModel { PORTFOLIO_PRICE, CORRELATED_ASSETS, BLOCK_BOOTSTRAP };
+
+// Settings of the runs, set through the set_montecarlo_* methods of the strategy
+struct MonteCarloConfig {
+    uint64_t seed;
+    size_t nb_threads;
+    std::time_t start_date; // 0 for the current date
+    bool save_paths;        // one csv per path on top of the run summary
+    MonteCarloModel model;
+    BootstrapScheme bootstrap_scheme;
+    double mean_block_length;
+    VarianceReduction variance_reduction;
+    MonteCarloStoppingRule stopping_rule;
+    std::string checkpoint_filename;
+    double checkpoint_interval;
+    size_t shard_first_path;
+    bool is_shard;          // paths [shard_first_path, shard_first_path + nb_simu): no stopping rule, nothing printed nor saved
+};
+
+typedef std::function<Strategy*(const std::vector<YahooTimeseries>&, const std::map<std::string, double>&, std::string)> MonteCarloStrategyFactory;
+
+// The strategy run on each path. batch_portfolio (may be nullptr) describes it for the BatchEngine: when paths are not saved
+// they are then generated by chunks in one buffer and simulated together instead of one Strategy per path.
+// Its allocations are filled from assets_desired_pct_allocations for the simulated tickers.
+struct MonteCarloPathStrategy {
+    MonteCarloStrategyFactory path_strategy_factory;
+    std::map<std::string, double> assets_desired_pct_allocations;
+    const BatchPortfolio* batch_portfolio;
+    BatchContribution batch_contribution;
+    RebalancingThreshold rebalancing_mode;
+};
+
+// Monte Carlo runs of a strategy: future paths of its tickers (or of its portfolio price) are simulated on the thread pool,
+// run through the path strategy and aggregated; the samples, summary and estimates of the last run are kept
+class MonteCarloRunner {
+public:
+    MonteCarloRunner();
+    MonteCarloRunner(const MonteCarloRunner&) = delete;
+    MonteCarloRunner& operator=(const MonteCarloRunner&) = delete;
+
+    MonteCarloConfig& get_config();
+    const MonteCarloConfig& get_config() const;
+    // tickers_yt and ptf are the history of the strategy strategy_name; the paths it saves use output_format
+    void run(size_t nb_simu, std::string strategy_name, const std::vector<YahooTimeseries>& tickers_yt, const PortfolioBuilder& ptf,
+             OutputFormat output_format, bool is_background_output, const MonteCarloPathStrategy& path_strategy);
+    // Shards of shard_size paths are run by run_shard(nb_paths) on the worker processes of the cluster, the runner being in
+    // shard mode: the merged samples and summary are those of run
+    void run_distributed(size_t nb_simu, std::string strategy_name, LocalCluster& cluster, size_t shard_size, const std::function<void(size_t)>& run_shard);
+
+    const MonteCarloSamples& get_samples() const;
+    const MonteCarloAggregator* get_aggregator() const;
+    const MonteCarloThroughput& get_throughput() const;
+    const MonteCarloEstimates& get_estimates() const;
+    const MonteCarloConvergence& get_convergence() const;
+
+    ~MonteCarloRunner();
+
+private:
+    MonteCarloConfig config;
+    MonteCarloSamples samples;
+    MonteCarloAggregator* aggregator;
+    MonteCarloThroughput throughput;
+    MonteCarloEstimates estimates;
+    MonteCarloConvergence convergence;
+
+    void set_results(std::string strategy_name, const MonteCarloSamples& samples, const MonteCarloAggregator& aggregator, const MonteCarloThroughput& throughput);
+    void report_results(std::string strategy_name) const; // prints the run and saves its summary
+};
+
+#endif
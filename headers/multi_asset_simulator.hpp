@@ -0,0 +1,43 @@
+#ifndef MULTI_ASSET_SIMULATOR
+#define MULTI_ASSET_SIMULATOR
+
+#include "./path_generator.hpp"
+#include "./yahoo_timeseries.hpp"
+#include <eigen3/Eigen/Dense>
+
+// Daily close returns [dates x assets] of the tickers on their common dates, last_prices gets the last close of each ticker
+Eigen::MatrixXd get_common_dates_returns(const std::vector<YahooTimeseries>& tickers_yt, Eigen::VectorXd& last_prices);
+
+// Correlated per-asset paths: daily close returns of the tickers (on their common dates) give the mean vector mu
+// and covariance C = LL' factored once; each step's shocks are L * z with z i.i.d. standard normals.
+// The shocks of a batch of paths are produced by one triangular matrix product over a [assets x (paths * steps)] block.
+class MultiAssetSimulator {
+public:
+    MultiAssetSimulator(const std::vector<YahooTimeseries>& tickers_yt, PathModel model, uint64_t seed);
+    void set_variance_reduction(VarianceReduction variance_reduction);
+
+    // asset_paths[a] is a [paths x steps] buffer, path i drawn from the Philox stream (seed, i)
+    void generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps, const std::vector<double*>& asset_paths) const;
+    std::vector<std::vector<double>> generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps) const;
+    // Analytic E[p_t / p_0] of every asset at the last step
+    Eigen::VectorXd get_expected_growths(size_t nb_steps) const;
+
+    const std::vector<std::string>& get_tickers() const;
+    const Eigen::VectorXd& get_mean_returns() const;
+    const Eigen::MatrixXd& get_covariance() const;
+    const Eigen::MatrixXd& get_cholesky_factor() const;
+
+    ~MultiAssetSimulator();
+
+private:
+    PathModel model;
+    uint64_t seed;
+    VarianceReduction variance_reduction;
+    std::vector<std::string> tickers;
+    Eigen::VectorXd start_prices;
+    Eigen::VectorXd mean_returns;
+    Eigen::MatrixXd covariance;
+    Eigen::MatrixXd cholesky_factor;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef PARAMETER_SWEEP
+#define PARAMETER_SWEEP
+
+#include "./strategy.hpp"
+#include "./distributed_runner.hpp"
+#include <functional>
+
+enum class SweepSampling { CARTESIAN, RANDOM, LATIN_HYPERCUBE };
+
+// Parameter names understood by the strategy factories below:
+// "rebalancing_freq", "rebalancing_threshold", "sma_window_size" and "weight:<TICKER>" (weights are normalized to 1)
+struct ParameterRange {
+    std::string name;
+    double min_value;
+    double max_value;
+    size_t nb_values; // only used by the cartesian sampling
+    bool is_integer;
+};
+
+struct SweepResult {
+    std::map<std::string, double> parameters;
+    double total_return;
+    double xirr;
+    double volatility;
+    double max_drawdown;
+};
+
+struct SweepThroughput {
+    size_t nb_threads;
+    size_t nb_backtests;
+    double elapsed_seconds;
+    double backtests_per_second;
+};
+
+// Strategies built on the tickers shared by every backtest of a sweep or walk-forward
+typedef std::function<Strategy*(SharedTickers, const std::map<std::string, double>&)> StrategyFactory;
+
+StrategyFactory get_dca_factory(double starting_amount, double recurrent_investment_amount, const std::map<std::string, double>& assets_desired_pct_allocations, int rebalancing_freq, double rebalancing_threshold);
+StrategyFactory get_sma_optimized_dca_factory(double starting_amount, double recurrent_investment_amount, const std::map<std::string, double>& assets_desired_pct_allocations, int rebalancing_freq, double rebalancing_threshold, int sma_window_size);
+StrategyFactory get_lump_sum_factory(double initial_investment_amount, const std::map<std::string, double>& assets_desired_pct_allocations, int rebalancing_freq, double rebalancing_threshold);
+std::map<std::string, double> get_swept_allocations(const std::map<std::string, double>& default_allocations, const std::map<std::string, double>& parameters);
+
+class ParameterSweep {
+public:
+    ParameterSweep(const std::vector<YahooTimeseries>& tickers_yt, StrategyFactory strategy_factory, const std::vector<ParameterRange>& parameter_ranges);
+
+    std::vector<std::map<std::string, double>> get_parameter_sets(SweepSampling sampling, size_t nb_samples, unsigned int seed) const;
+    // The metrics of the completed backtests are saved to filename (empty disables it) at most every interval_seconds:
+    // an interrupted run of the same parameter sets resumes from there; the file is removed once the run completes
+    void set_checkpoint(std::string filename, double interval_seconds);
+    const std::vector<SweepResult>& run(const std::vector<std::map<std::string, double>>& parameter_sets, size_t nb_threads);
+    // Parameter sets split in shards over the worker processes of the cluster (one thread each), results in the order of parameter_sets
+    const std::vector<SweepResult>& run_distributed(const std::vector<std::map<std::string, double>>& parameter_sets, LocalCluster& cluster, size_t shard_size);
+    std::vector<SweepThroughput> benchmark_scaling(const std::vector<std::map<std::string, double>>& parameter_sets, size_t max_threads);
+
+    const std::vector<SweepResult>& get_results() const;
+    const SweepThroughput& get_throughput() const;
+    void save_results(std::string filename) const;
+    void print_throughput() const;
+
+    ~ParameterSweep();
+
+private:
+    SharedTickers tickers_yt; // one copy shared read-only by every backtest
+    StrategyFactory strategy_factory;
+    std::vector<ParameterRange> parameter_ranges;
+    std::vector<SweepResult> results;
+    SweepThroughput throughput;
+    std::string checkpoint_filename;
+    double checkpoint_interval;
+
+    SweepResult run_backtest(const std::map<std::string, double>& parameters) const;
+};
+
+#endif
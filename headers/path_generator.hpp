@@ -0,0 +1,66 @@
+#ifndef PATH_GENERATOR
+#define PATH_GENERATOR
+
+#include "./philox.hpp"
+#include "./quasi_random.hpp"
+#include <vector>
+#include <cstddef>
+
+enum class PathModel { GEOMETRIC_BROWNIAN_MOTION, ARITHMETIC_RETURNS };
+
+// Fills out[0..n) with standard normals: uniforms are drawn by blocks, then Box-Muller runs over whole arrays.
+// The values are the same, in the same order, as n calls to Philox4x32::next_normal.
+void fill_normals(Philox4x32& generator, double* normals, size_t nb_normals);
+
+// NONE and CONTROL_VARIATE draw i.i.d. normals (the control variate only changes the estimators),
+// ANTITHETIC_VARIATES pairs path 2k + 1 with the negated normals of path 2k,
+// SOBOL_BROWNIAN_BRIDGE drives the coarsest Brownian bridge points with scrambled Sobol coordinates (the rest stays pseudo-random)
+enum class VarianceReduction { NONE, ANTITHETIC_VARIATES, CONTROL_VARIATE, SOBOL_BROWNIAN_BRIDGE };
+
+// Standard normal increments of a path made of nb_series correlated series, stored normals[k * nb_series + s].
+// Paths are split in NB_REPLICATES independent replicates (each with its own Sobol scrambling) for the standard errors.
+class PathNormalSource {
+public:
+    static const size_t NB_REPLICATES = 16;
+
+    PathNormalSource(VarianceReduction variance_reduction, uint64_t seed, size_t nb_series, size_t nb_increments);
+    void fill(uint64_t path_idx, double* normals) const;
+    static size_t get_replicate(VarianceReduction variance_reduction, uint64_t path_idx);
+
+    ~PathNormalSource();
+
+private:
+    VarianceReduction variance_reduction;
+    uint64_t seed;
+    size_t nb_series;
+    size_t nb_increments;
+    SobolSequence sobol_sequence;
+    BrownianBridge brownian_bridge;
+    std::vector<uint32_t> digital_shifts; // [replicate][dimension]
+};
+
+// Batches of price paths in one contiguous [paths x steps] buffer, path i drawn from the Philox stream (seed, i).
+// GEOMETRIC_BROWNIAN_MOTION: p_t = p_0 * exp(cumsum((mu - sigma^2 / 2) + sigma * z))
+// ARITHMETIC_RETURNS:        p_t = p_t-1 * (1 + mu + sigma * z)  (historical Monte Carlo model)
+class PathGenerator {
+public:
+    PathGenerator(PathModel model, double start_price, double mean_return, double volatility, uint64_t seed);
+    void set_variance_reduction(VarianceReduction variance_reduction);
+
+    void generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps, double* paths) const;
+    std::vector<double> generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps) const;
+    // Analytic E[p_t / p_0] at the last step, the expectation of a lump sum position used as control variate
+    double get_expected_growth(size_t nb_steps) const;
+
+    ~PathGenerator();
+
+private:
+    PathModel model;
+    double start_price;
+    double mean_return;
+    double volatility;
+    uint64_t seed;
+    VarianceReduction variance_reduction;
+};
+
+#endif
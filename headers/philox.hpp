@@ -0,0 +1,76 @@
+#ifndef PHILOX
+#define PHILOX
+
+#include <array>
+#include <cstdint>
+#include <cmath>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Each 128-bit output block is a bijection of (counter, key): the stream of a (seed, stream index) pair
+// can be drawn on any thread, in any order, without sharing or advancing a global state.
+class Philox4x32 {
+public:
+    typedef std::array<uint32_t, 4> Counter;
+    typedef std::array<uint32_t, 2> Key;
+
+    Philox4x32(uint64_t seed, uint64_t stream)
+    : key{uint32_t(seed), uint32_t(seed >> 32)}, counter{0, 0, uint32_t(stream), uint32_t(stream >> 32)}, buffer_idx(4), has_normal(false){}
+
+    static inline Counter get_block(Counter counter, Key key){
+        for (int round = 0; round < 10; ++round){
+            if (round > 0){
+                key[0] += 0x9E3779B9;
+                key[1] += 0xBB67AE85;
+            }
+            uint64_t product0 = uint64_t(0xD2511F53) * counter[0];
+            uint64_t product1 = uint64_t(0xCD9E8D57) * counter[2];
+            counter = {uint32_t(product1 >> 32) ^ counter[1] ^ key[0], uint32_t(product1),
+                       uint32_t(product0 >> 32) ^ counter[3] ^ key[1], uint32_t(product0)};
+        }
+        return counter;
+    }
+
+    inline uint32_t next_uint32(){
+        if (this->buffer_idx == 4){
+            this->buffer = get_block(this->counter, this->key);
+            if (++this->counter[0] == 0)
+                ++this->counter[1];
+            this->buffer_idx = 0;
+        }
+        return this->buffer[this->buffer_idx++];
+    }
+
+    // Uniform in the open interval (0, 1) with 53 random bits
+    inline double next_uniform(){
+        uint64_t high_bits = this->next_uint32();
+        uint64_t bits = (high_bits << 32) | this->next_uint32();
+        return ((bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+
+    inline bool has_cached_normal() const{
+        return this->has_normal;
+    }
+
+    // Standard normal (Box-Muller, the second value of each pair is kept for the next call)
+    inline double next_normal(){
+        if (this->has_normal){
+            this->has_normal = false;
+            return this->normal;
+        }
+        double radius = std::sqrt(-2.0 * std::log(this->next_uniform()));
+        double angle = 2.0 * M_PI * this->next_uniform();
+        this->normal = radius * std::sin(angle);
+        this->has_normal = true;
+        return radius * std::cos(angle);
+    }
+
+private:
+    Key key;
+    Counter counter;
+    Counter buffer;
+    int buffer_idx;
+    bool has_normal;
+    double normal;
+};
+
+#endif
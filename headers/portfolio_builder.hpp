@@ -3,6 +3,7 @@
 
 #include <vector>
 #include "./yahoo_timeseries.hpp"
+#include "./serialization.hpp"
 #include <map>
 #include <set>
 
@@ -23,8 +24,26 @@ public:
 
     void buy(const YahooTimeseries& ticker_yt, double shares_amt, std::time_t date);
     void sell(const YahooTimeseries& ticker_yt, double shares_amt, std::time_t date);
+    // Dense access for batched updates: position of each ticker in the holdings, -1 while it is not held.
+    // Positions never change once held, so they can be cached.
+    std::vector<int> get_asset_indices(const std::vector<YahooTimeseries>& tickers_yt) const;
+    void get_last_shares(const std::vector<int>& asset_indices, double* shares) const;
+    // orders[a] shares of tickers_yt[a] bought (> 0) or sold (< 0) at prices[a], every asset held,
+    // written as one ledger update: one cash flow and one total shares entry for the date
+    void apply_orders(const std::vector<int>& asset_indices, const double* orders, const double* prices, std::time_t date);
     void set_portfolio_values_and_prices();
-    void save_portfolio(std::string filename) const;
+    // Same values and prices when the ledger only changed from first_date on: the earlier dates already set are kept
+    void update_portfolio_values_and_prices(std::time_t first_date);
+    // Buffered CsvWriter, the file being written by a background thread when is_background_writer
+    void save_portfolio(std::string filename, bool is_background_writer) const;
+    // Same Value, P&L and Investments columns in a binary result file (<filename>.res, ./result_file.hpp)
+    void save_portfolio_results(std::string filename) const;
+    // Value, P&L and Investments of the saved portfolios, column after column (columns[c * dates.size() + d])
+    void get_saved_columns(std::vector<std::time_t>& dates, std::vector<double>& columns) const;
+    // Ledger of the dates before end_date; the holdings are read back with the timeseries of the same tickers in tickers_yt,
+    // false when one is missing
+    void write(ByteWriter& writer, std::time_t end_date) const;
+    bool read(ByteReader& reader, const std::vector<YahooTimeseries>& tickers_yt);
     
     double get_ticker_value(std::string ticker, std::time_t date) const;
     double get_ticker_shares(std::string ticker, std::time_t date) const;
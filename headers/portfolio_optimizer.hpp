@@ -0,0 +1,48 @@
+#ifndef PORTFOLIO_OPTIMIZER
+#define PORTFOLIO_OPTIMIZER
+
+#include "./yahoo_timeseries.hpp"
+#include <eigen3/Eigen/Dense>
+#include <functional>
+
+struct FrontierPoint {
+    double expected_return;
+    double volatility;
+    double sharpe_ratio;
+    std::map<std::string, double> allocations;
+};
+
+// Long-only mean-variance optimizer on annualized statistics of the tickers' adjusted closes.
+// Allocations are returned as ticker -> weight maps summing to 1, ready for the DCA and LumpSum constructors.
+class PortfolioOptimizer {
+public:
+    PortfolioOptimizer(const std::vector<YahooTimeseries>& tickers_yt, double risk_free_rate);
+
+    const Eigen::VectorXd& get_expected_returns() const;
+    const Eigen::MatrixXd& get_covariance() const;
+
+    std::map<std::string, double> get_min_variance_allocations() const;
+    std::map<std::string, double> get_max_sharpe_allocations() const;
+    std::vector<FrontierPoint> get_efficient_frontier(size_t nb_points, size_t nb_threads) const;
+
+    ~PortfolioOptimizer();
+
+private:
+    std::vector<std::string> tickers;
+    double risk_free_rate;
+    Eigen::VectorXd expected_returns;
+    Eigen::MatrixXd covariance;
+    double covariance_max_eigenvalue;
+
+    Eigen::VectorXd get_min_variance_weights() const;
+    Eigen::VectorXd get_max_sharpe_weights() const;
+    void solve_constrained_min_variance(const Eigen::VectorXd& constraint, double target,
+                                        const std::function<Eigen::VectorXd(const Eigen::VectorXd&)>& projection,
+                                        Eigen::VectorXd& weights, double& multiplier) const;
+    FrontierPoint get_frontier_point(const Eigen::VectorXd& weights) const;
+    std::map<std::string, double> get_allocations(const Eigen::VectorXd& weights) const;
+};
+
+Eigen::VectorXd project_on_simplex(const Eigen::VectorXd& weights);
+
+#endif
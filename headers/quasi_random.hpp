@@ -0,0 +1,50 @@
+#ifndef QUASI_RANDOM
+#define QUASI_RANDOM
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Sobol low-discrepancy sequence (Joe & Kuo direction numbers, first 21 dimensions), 32-bit points.
+// Each dimension can be scrambled by a random digital shift (XOR), which keeps the (t, s)-net properties.
+class SobolSequence {
+public:
+    static const size_t MAX_DIMENSIONS = 21;
+
+    explicit SobolSequence(size_t nb_dimensions);
+    // Point of the sequence at index, in the open interval (0, 1); digital_shifts (one per dimension) may be nullptr
+    void get_point(uint64_t index, const uint32_t* digital_shifts, double* point) const;
+    size_t get_nb_dimensions() const;
+
+    ~SobolSequence();
+
+private:
+    size_t nb_dimensions;
+    std::vector<uint32_t> direction_numbers; // [dimension][bit]
+};
+
+// Acklam's rational approximation refined by one Halley step on erfc (relative error ~1e-15)
+double get_inverse_normal_cdf(double p);
+
+// Brownian bridge over nb_increments unit steps: the first normal fixes the end point W_n, the next ones the midpoints
+// of the coarsest intervals first, so the first (quasi-random) coordinates carry most of the path variance.
+class BrownianBridge {
+public:
+    explicit BrownianBridge(size_t nb_increments);
+    // normals[j * stride] is the j-th normal in construction order, increments[k * stride] = W_k+1 - W_k (i.i.d. N(0, 1))
+    void build(const double* normals, double* increments, size_t stride) const;
+    size_t get_nb_increments() const;
+
+    ~BrownianBridge();
+
+private:
+    size_t nb_increments;
+    std::vector<size_t> point_indices;   // point built by the j-th normal
+    std::vector<size_t> left_indices;    // known points around it (0 is W_0 = 0)
+    std::vector<size_t> right_indices;
+    std::vector<double> left_weights;
+    std::vector<double> right_weights;
+    std::vector<double> std_devs;
+};
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef REBALANCER
+#define REBALANCER
+
+#include <vector>
+#include <cstddef>
+#include <ratio>
+
+// Share of the dividends reinvested in the paying ticker, the same for every strategy and engine
+typedef std::ratio<7, 10> DefaultDividendReinvestmentRatio;
+static const double DIVIDEND_REINVESTMENT_RATIO = static_cast<double>(DefaultDividendReinvestmentRatio::num) / DefaultDividendReinvestmentRatio::den;
+
+// ABSOLUTE trades the assets whose weight drifts from its target by more than the threshold,
+// RELATIVE the assets drifting by more than threshold * target,
+// BAND trades every held asset back to its target as soon as one weight leaves its target +- threshold band
+enum class RebalancingThreshold { ABSOLUTE, RELATIVE, BAND };
+
+// Drift compared with the threshold
+inline double get_weight_drift(double weight, double target_weight, RebalancingThreshold mode){
+    return (mode == RebalancingThreshold::RELATIVE) ? (weight - target_weight) / target_weight : weight - target_weight;
+}
+
+// Target-weight rebalancing over dense per-asset arrays: the weights, drifts and orders of every asset are computed
+// in one pass into buffers allocated once, so rebalancing a date allocates nothing.
+// An asset is brought back to target * portfolio value; assets not held yet are left to the contributions.
+class Rebalancer {
+public:
+    Rebalancer(const std::vector<double>& target_weights, RebalancingThreshold mode, double threshold);
+    void set_threshold(RebalancingThreshold mode, double threshold);
+
+    // shares and prices are [asset] arrays; returns the number of orders, orders[a] in shares (> 0 buys, < 0 sells)
+    size_t compute_orders(const double* shares, const double* prices);
+
+    size_t get_nb_assets() const;
+    RebalancingThreshold get_mode() const;
+    const std::vector<double>& get_weights() const;
+    const std::vector<double>& get_drifts() const;
+    const std::vector<double>& get_orders() const;
+
+    ~Rebalancer();
+
+private:
+    std::vector<double> target_weights;
+    RebalancingThreshold mode;
+    double threshold;
+    std::vector<double> weights;
+    std::vector<double> drifts;
+    std::vector<double> orders;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef RESULT_FILE
+#define RESULT_FILE
+
+#include <string>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+#include <cstdint>
+
+// Output format of the saved portfolios and Monte Carlo paths
+enum class OutputFormat { CSV, BINARY };
+
+// Binary columnar results (native endian, .res): a header (magic, number of rows), the date column as 64-bit times,
+// then records appended one chunk of columns at a time: magic, number of columns, size of the names, the '\0' separated
+// names padded to 8 bytes, and the columns one after the other. Every column is a contiguous array of doubles at an
+// 8-byte aligned offset, so the file is read in place (ResultFile, numpy.memmap in src/plot_portfolio.py).
+// A record cut by an interruption is ignored by the readers.
+class ResultFileWriter {
+public:
+    // With nb_kept_columns > 0, filename was written with the same dates by an interrupted run: its first nb_kept_columns
+    // columns are kept and the next appends follow them. It is started over when it does not hold them.
+    ResultFileWriter(std::string filename, const std::vector<std::time_t>& dates, size_t nb_kept_columns);
+    ResultFileWriter(const ResultFileWriter&) = delete;
+    ResultFileWriter& operator=(const ResultFileWriter&) = delete;
+
+    bool is_open() const;
+    size_t get_nb_rows() const;
+    size_t get_nb_columns() const;
+    // columns[c * nb_rows + r] is row r of the column names[c]
+    void append_columns(const std::vector<std::string>& names, const double* columns);
+    bool close(); // false when the file could not be written
+    ~ResultFileWriter();
+
+private:
+    std::string filename;
+    size_t nb_rows;
+    size_t nb_columns;
+    FILE* file;
+    bool is_written;
+
+    void create(const std::vector<std::time_t>& dates);
+    bool reopen(const std::vector<std::time_t>& dates, size_t nb_kept_columns);
+};
+
+// Read-only mapping of a result file
+class ResultFile {
+public:
+    explicit ResultFile(std::string filename);
+    ResultFile(const ResultFile&) = delete;
+    ResultFile& operator=(const ResultFile&) = delete;
+
+    bool is_open() const;
+    size_t get_nb_rows() const;
+    size_t get_nb_columns() const;
+    const std::time_t* get_dates() const;
+    const std::vector<std::string>& get_column_names() const;
+    const double* get_column(size_t column_idx) const;
+    int get_column_index(std::string name) const; // -1 when there is no such column
+    // Date;<names> rows through CsvWriter, the text of the csv outputs
+    bool export_csv(std::string filename) const;
+
+    ~ResultFile();
+
+private:
+    friend class ResultFileWriter;
+
+    std::vector<std::string> column_names;
+    std::vector<const double*> columns;
+    std::vector<size_t> record_end_offsets; // of the complete records
+    std::vector<size_t> record_end_columns; // number of columns up to the end of each record
+    size_t nb_rows;
+    char* mapping;
+    size_t mapping_size;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef SERIALIZATION
+#define SERIALIZATION
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+// Native-endian binary encoding of trivially copyable values, vectors of them, strings and ordered maps of both,
+// for messages between processes of the same build (distributed runs, checkpoints, snapshots)
+class ByteWriter {
+public:
+    template <typename T>
+    void put(const T& value){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written");
+        this->bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void put_vector(const std::vector<T>& values){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written");
+        this->put<uint64_t>(values.size());
+        this->bytes.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void put_string(const std::string& value){
+        this->put<uint64_t>(value.size());
+        this->bytes.append(value);
+    }
+
+    template <typename K, typename V>
+    void put_map(const std::map<K, V>& values){
+        this->put<uint64_t>(values.size());
+        for (const auto& pair: values){
+            this->put_item(pair.first);
+            this->put_item(pair.second);
+        }
+    }
+
+    const std::string& get_bytes() const{
+        return this->bytes;
+    }
+
+private:
+    std::string bytes;
+
+    template <typename T>
+    void put_item(const T& value){
+        this->put(value);
+    }
+
+    void put_item(const std::string& value){
+        this->put_string(value);
+    }
+};
+
+// Reading past the end returns zero values and empty containers, moves the reader to the end and marks it truncated
+class ByteReader {
+public:
+    explicit ByteReader(const std::string& bytes): bytes(bytes), offset(0), is_truncated_message(false){}
+
+    template <typename T>
+    T get(){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read");
+        T value = T();
+        if (!this->has_items(1, sizeof(T)))
+            return value;
+        std::memcpy(&value, this->bytes.data() + this->offset, sizeof(T));
+        this->offset += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> get_vector(){
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read");
+        size_t size = this->get<uint64_t>();
+        if (!this->has_items(size, sizeof(T)))
+            return std::vector<T>();
+        std::vector<T> values(size);
+        if (size > 0)
+            std::memcpy(values.data(), this->bytes.data() + this->offset, size * sizeof(T));
+        this->offset += size * sizeof(T);
+        return values;
+    }
+
+    std::string get_string(){
+        size_t size = this->get<uint64_t>();
+        if (!this->has_items(size, 1))
+            return std::string();
+        std::string value = this->bytes.substr(this->offset, size);
+        this->offset += size;
+        return value;
+    }
+
+    template <typename K, typename V>
+    std::map<K, V> get_map(){
+        size_t size = this->get<uint64_t>();
+        std::map<K, V> values;
+        for (size_t i = 0; i < size && !this->is_truncated_message; ++i){
+            K key;
+            V value;
+            this->get_item(key);
+            this->get_item(value);
+            if (!this->is_truncated_message)
+                values.emplace_hint(values.end(), key, value);
+        }
+        return values;
+    }
+
+    bool is_done() const{
+        return this->offset == this->bytes.size();
+    }
+
+    bool is_truncated() const{
+        return this->is_truncated_message;
+    }
+
+private:
+    const std::string& bytes;
+    size_t offset;
+    bool is_truncated_message;
+
+    bool has_items(size_t nb_items, size_t item_size){
+        if (nb_items <= (this->bytes.size() - this->offset) / item_size)
+            return true;
+        this->offset = this->bytes.size();
+        this->is_truncated_message = true;
+        return false;
+    }
+
+    template <typename T>
+    void get_item(T& value){
+        value = this->get<T>();
+    }
+
+    void get_item(std::string& value){
+        value = this->get_string();
+    }
+};
+
+#endif
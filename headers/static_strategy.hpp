@@ -0,0 +1,403 @@
+#ifndef STATIC_STRATEGY
+#define STATIC_STRATEGY
+
+#include "./strategy.hpp"
+#include "./rebalancer.hpp"
+#include "./batch_engine.hpp"
+#include "./montecarlo_runner.hpp"
+#include "./market_data.hpp"
+#include "./yahoo_utils.hpp"
+#include <ratio>
+#include <cassert>
+#include <cstdio>
+#include <algorithm>
+
+// Policy based strategies: contribution schedule, dip-buy trigger, dividend handling and rebalance rule are
+// template parameters so the whole date loop is inlined and specialized by the compiler.
+// Each policy exposes init(market_data, state) and a hook called by StaticStrategy::step.
+
+struct StaticTransaction {
+    size_t date_idx;
+    size_t ticker_idx;
+    double shares_amt; // < 0 for a sale
+};
+
+struct StaticPortfolioState {
+    const MarketData* market_data;
+    std::vector<double> allocations;
+    std::vector<double> shares;
+    std::vector<StaticTransaction> transactions;
+
+    inline void buy(size_t ticker_idx, size_t date_idx, double shares_amt){
+        this->shares[ticker_idx] += shares_amt;
+        this->transactions.push_back({date_idx, ticker_idx, shares_amt});
+    }
+
+    inline void sell(size_t ticker_idx, size_t date_idx, double shares_amt){
+        if (shares_amt <= this->shares[ticker_idx]){
+            this->shares[ticker_idx] -= shares_amt;
+            this->transactions.push_back({date_idx, ticker_idx, -shares_amt});
+        }
+        else
+            fprintf(stderr, "not enough shares available to sell this volume of shares\n");
+    }
+};
+
+// Contribution schedules: tell whether (and how much) cash is made available for a ticker at a date
+
+class MonthlyContribution {
+public:
+    MonthlyContribution(double starting_amount, double recurrent_investment_amount)
+    : starting_amount(starting_amount), recurrent_investment_amount(recurrent_investment_amount){}
+
+    void init(const StaticPortfolioState& state){
+        this->starting_amounts.resize(state.allocations.size());
+        for (size_t k = 0; k < state.allocations.size(); ++k)
+            this->starting_amounts[k] = state.allocations[k] * this->starting_amount;
+    }
+
+    inline bool get_contribution(const StaticPortfolioState& state, size_t ticker_idx, size_t date_idx, double& amount){
+        if (!state.market_data->is_first_month_dates[ticker_idx][date_idx])
+            return false;
+        amount = state.allocations[ticker_idx] * this->recurrent_investment_amount + this->starting_amounts[ticker_idx];
+        this->starting_amounts[ticker_idx] = 0.0;
+        return true;
+    }
+
+    bool get_batch_contribution(BatchPortfolio& batch_portfolio, BatchContribution& batch_contribution) const{
+        batch_portfolio.starting_amount = this->starting_amount;
+        batch_portfolio.recurrent_investment_amount = this->recurrent_investment_amount;
+        batch_contribution = BatchContribution::MONTHLY;
+        return true;
+    }
+
+private:
+    double starting_amount;
+    double recurrent_investment_amount;
+    std::vector<double> starting_amounts;
+};
+
+class InitialLumpSum {
+public:
+    explicit InitialLumpSum(double initial_investment_amount): initial_investment_amount(initial_investment_amount){}
+
+    void init(const StaticPortfolioState&){}
+
+    inline bool get_contribution(const StaticPortfolioState& state, size_t ticker_idx, size_t date_idx, double& amount){
+        if (date_idx != state.market_data->first_date_indices[ticker_idx])
+            return false;
+        amount = state.allocations[ticker_idx] * this->initial_investment_amount;
+        return true;
+    }
+
+    bool get_batch_contribution(BatchPortfolio& batch_portfolio, BatchContribution& batch_contribution) const{
+        batch_portfolio.starting_amount = this->initial_investment_amount;
+        batch_portfolio.recurrent_investment_amount = 0.0;
+        batch_contribution = BatchContribution::LUMP_SUM;
+        return true;
+    }
+
+private:
+    double initial_investment_amount;
+};
+
+// Dip-buy triggers: decide when the contributed cash is invested
+
+class NoDipBuy {
+public:
+    void init(const StaticPortfolioState&){}
+
+    inline void invest(StaticPortfolioState& state, size_t ticker_idx, size_t date_idx, bool has_contribution, double amount){
+        if (!has_contribution)
+            return;
+        double shares_amt = amount / state.market_data->closes[ticker_idx][date_idx];
+        if (shares_amt > 0)
+            state.buy(ticker_idx, date_idx, shares_amt);
+    }
+};
+
+// Invests the month's cash when the close drops DipRatio below its simple moving average, or on the last date of the month
+template<class DipRatio>
+class SmaDipBuy {
+public:
+    explicit SmaDipBuy(size_t sma_window_size): sma_window_size(sma_window_size){}
+
+    void init(const StaticPortfolioState& state, const std::vector<YahooTimeseries>& tickers_yt){
+        this->smas.clear();
+        for (const auto& ticker_yt: tickers_yt)
+            this->smas.push_back(get_dense_values(Timeseries(ticker_yt.get_closes().get_ts_simple_moving_averages(this->sma_window_size)), state.market_data->dates));
+        this->remaining_investment_amounts.assign(tickers_yt.size(), 0.0);
+    }
+
+    inline void invest(StaticPortfolioState& state, size_t ticker_idx, size_t date_idx, bool has_contribution, double amount){
+        constexpr double dip_ratio = double(DipRatio::num) / DipRatio::den;
+        double& remaining_amount = this->remaining_investment_amounts[ticker_idx];
+        if (has_contribution)
+            remaining_amount = amount;
+        double ticker_value = state.market_data->closes[ticker_idx][date_idx];
+        double sma_value = this->smas[ticker_idx][date_idx];
+        if (sma_value > 0.0 && (sma_value - ticker_value) / sma_value > dip_ratio){
+            state.buy(ticker_idx, date_idx, remaining_amount / ticker_value);
+            remaining_amount = 0.0;
+        }
+        if (state.market_data->is_last_month_dates[ticker_idx][date_idx] && remaining_amount > 0.0)
+            state.buy(ticker_idx, date_idx, remaining_amount / ticker_value);
+    }
+
+private:
+    size_t sma_window_size;
+    std::vector<std::vector<double>> smas;
+    std::vector<double> remaining_investment_amounts;
+};
+
+// Dividend handling
+
+template<class ReinvestmentRatio>
+class ReinvestDividends {
+public:
+    void init(const StaticPortfolioState&){}
+
+    inline void on_date(StaticPortfolioState& state, size_t ticker_idx, size_t date_idx){
+        constexpr double reinvestment_ratio = double(ReinvestmentRatio::num) / ReinvestmentRatio::den;
+        double dividend = state.market_data->dividends[ticker_idx][date_idx];
+        if (dividend > 0)
+            state.buy(ticker_idx, date_idx, reinvestment_ratio * dividend * state.shares[ticker_idx] / state.market_data->closes[ticker_idx][date_idx]);
+    }
+};
+
+class IgnoreDividends {
+public:
+    void init(const StaticPortfolioState&){}
+    inline void on_date(StaticPortfolioState&, size_t, size_t){}
+};
+
+// Rebalance rules
+
+// Threshold rules of the Rebalancer (./rebalancer.hpp), the threshold being a std::ratio
+template<class Threshold>
+struct AbsoluteThreshold {
+    static constexpr RebalancingThreshold mode = RebalancingThreshold::ABSOLUTE;
+    static constexpr double threshold = double(Threshold::num) / Threshold::den;
+};
+
+template<class Threshold>
+struct RelativeThreshold {
+    static constexpr RebalancingThreshold mode = RebalancingThreshold::RELATIVE;
+    static constexpr double threshold = double(Threshold::num) / Threshold::den;
+};
+
+template<class Threshold>
+struct BandThreshold {
+    static constexpr RebalancingThreshold mode = RebalancingThreshold::BAND;
+    static constexpr double threshold = double(Threshold::num) / Threshold::den;
+};
+
+class NoRebalancing {
+public:
+    void init(const StaticPortfolioState&){}
+    inline void on_date_end(StaticPortfolioState&, size_t){}
+};
+
+// Every RebalancingFreq + 1 dates the Rebalancer orders of the threshold rule are applied at the closes
+template<int RebalancingFreq, class ThresholdRule>
+class PeriodicRebalancing {
+public:
+    PeriodicRebalancing(): rebalancer({}, ThresholdRule::mode, ThresholdRule::threshold){}
+
+    void init(const StaticPortfolioState& state){
+        this->last_rebalancing_nb_days = 0;
+        this->rebalancer = Rebalancer(state.allocations, ThresholdRule::mode, ThresholdRule::threshold);
+        this->prices.assign(state.allocations.size(), 0.0);
+    }
+
+    inline void on_date_end(StaticPortfolioState& state, size_t date_idx){
+        if (this->last_rebalancing_nb_days != RebalancingFreq){
+            this->last_rebalancing_nb_days++;
+            return;
+        }
+        this->last_rebalancing_nb_days = 0;
+
+        const MarketData& market_data = *state.market_data;
+        for (size_t k = 0; k < state.shares.size(); ++k)
+            this->prices[k] = market_data.closes[k][date_idx];
+        if (this->rebalancer.compute_orders(state.shares.data(), this->prices.data()) == 0)
+            return;
+        const std::vector<double>& orders = this->rebalancer.get_orders();
+        for (size_t k = 0; k < state.shares.size(); ++k){
+            if (orders[k] < 0)
+                state.sell(k, date_idx, -orders[k]);
+            else if (orders[k] > 0)
+                state.buy(k, date_idx, orders[k]);
+        }
+    }
+
+private:
+    int last_rebalancing_nb_days;
+    Rebalancer rebalancer;
+    std::vector<double> prices;
+};
+
+template<class Contribution, class DipBuy, class Dividend, class Rebalance>
+class StaticStrategy {
+public:
+    StaticStrategy(const Contribution& contribution, const DipBuy& dip_buy, const Dividend& dividend, const Rebalance& rebalance)
+    : contribution(contribution), dip_buy(dip_buy), dividend(dividend), rebalance(rebalance){}
+
+    void init(const MarketData& market_data, const std::vector<YahooTimeseries>& tickers_yt, const std::map<std::string, double>& assets_desired_pct_allocations){
+        this->state.market_data = &market_data;
+        this->state.allocations.assign(market_data.tickers.size(), 0.0);
+        for (const auto& pair: assets_desired_pct_allocations){
+            size_t ticker_idx = get_ticker_index(market_data, pair.first);
+            assert(ticker_idx < market_data.tickers.size() && "pct allocation ticker name not in the passed YahooTimeries tickers list\n");
+            this->state.allocations[ticker_idx] = pair.second;
+        }
+        this->state.shares.assign(market_data.tickers.size(), 0.0);
+        this->state.transactions.clear();
+        this->contribution.init(this->state);
+        this->init_dip_buy(this->dip_buy, tickers_yt);
+        this->dividend.init(this->state);
+        this->rebalance.init(this->state);
+    }
+
+    inline void step(size_t date_idx){
+        for (size_t k = 0; k < this->state.shares.size(); ++k){
+            double amount = 0.0;
+            bool has_contribution = this->contribution.get_contribution(this->state, k, date_idx, amount);
+            this->dip_buy.invest(this->state, k, date_idx, has_contribution, amount);
+            this->dividend.on_date(this->state, k, date_idx);
+        }
+        this->rebalance.on_date_end(this->state, date_idx);
+    }
+
+    void run(){
+        size_t nb_dates = this->state.market_data->dates.size();
+        for (size_t d = 0; d < nb_dates; ++d)
+            this->step(d);
+    }
+
+    const StaticPortfolioState& get_state() const{
+        return this->state;
+    }
+
+    StaticPortfolioState& get_state(){
+        return this->state;
+    }
+
+private:
+    Contribution contribution;
+    DipBuy dip_buy;
+    Dividend dividend;
+    Rebalance rebalance;
+    StaticPortfolioState state;
+
+    template<class Policy>
+    auto init_dip_buy(Policy& policy, const std::vector<YahooTimeseries>& tickers_yt) -> decltype(policy.init(this->state, tickers_yt), void()){
+        policy.init(this->state, tickers_yt);
+    }
+    template<class Policy>
+    auto init_dip_buy(Policy& policy, const std::vector<YahooTimeseries>&) -> decltype(policy.init(this->state), void()){
+        policy.init(this->state);
+    }
+};
+
+typedef std::ratio<7, 100> DefaultDipRatio;
+
+// Description of the policies for the BatchEngine, which only has the DCA / LumpSum semantics: a monthly or initial
+// contribution invested at once, dividends reinvested at the default ratio and periodic threshold rebalancing.
+// Other policies are not batched, their Monte Carlo paths being run one CompiledStrategy per path.
+template<class Contribution, class DipBuy, class Dividend, class Rebalance>
+bool get_batch_portfolio(const Contribution&, const DipBuy&, const Dividend&, const Rebalance&,
+                         BatchPortfolio&, BatchContribution&, RebalancingThreshold&){
+    return false;
+}
+
+template<class Contribution, class ReinvestmentRatio, int RebalancingFreq, class ThresholdRule>
+bool get_batch_portfolio(const Contribution& contribution, const NoDipBuy&, const ReinvestDividends<ReinvestmentRatio>&, const PeriodicRebalancing<RebalancingFreq, ThresholdRule>&,
+                         BatchPortfolio& batch_portfolio, BatchContribution& batch_contribution, RebalancingThreshold& rebalancing_mode){
+    if (!std::ratio_equal<ReinvestmentRatio, DefaultDividendReinvestmentRatio>::value)
+        return false;
+    batch_portfolio.rebalancing_freq = RebalancingFreq;
+    batch_portfolio.rebalancing_threshold = ThresholdRule::threshold;
+    rebalancing_mode = ThresholdRule::mode;
+    return contribution.get_batch_contribution(batch_portfolio, batch_contribution);
+}
+
+// Type-erased wrapper: a StaticStrategy behind the virtual Strategy interface. The transactions of the
+// compiled loop are replayed into the PortfolioBuilder so saving, returns and XIRR work unchanged.
+template<class Contribution, class DipBuy, class Dividend, class Rebalance>
+class CompiledStrategy : public Strategy {
+public:
+    CompiledStrategy(const std::vector<YahooTimeseries>& tickers_yt,
+                     const std::map<std::string, double>& assets_desired_pct_allocations,
+                     const Contribution& contribution,
+                     const DipBuy& dip_buy,
+                     std::string strategy_name)
+    : Strategy(tickers_yt, strategy_name),
+      assets_desired_pct_allocations(assets_desired_pct_allocations),
+      market_data(get_market_data(tickers_yt)),
+      static_strategy(contribution, dip_buy, Dividend(), Rebalance()),
+      contribution(contribution),
+      dip_buy(dip_buy),
+      nb_replayed_transactions(0){
+        this->static_strategy.init(this->market_data, this->tickers_yt, assets_desired_pct_allocations);
+    }
+
+    virtual void make_transactions(std::time_t date) override{
+        auto it = std::lower_bound(this->market_data.dates.begin(), this->market_data.dates.end(), date);
+        if (it == this->market_data.dates.end() || *it != date)
+            return;
+        this->static_strategy.step(it - this->market_data.dates.begin());
+        this->replay_transactions();
+    }
+
+    virtual void run_strategy() override{
+        this->static_strategy.run();
+        this->replay_transactions();
+        this->ptf->set_portfolio_values_and_prices();
+    }
+
+    virtual void run_montecarlo_simulations(size_t nb_simu) override{
+        MonteCarloStrategyFactory path_strategy_factory = [this](const std::vector<YahooTimeseries>& path_tickers_yt, const std::map<std::string, double>& allocations, std::string strategy_name) -> Strategy* {
+            return new CompiledStrategy(path_tickers_yt, allocations, this->contribution, this->dip_buy, strategy_name);
+        };
+        BatchPortfolio batch_portfolio = {0.0, 0.0, {}, 0, 0.0};
+        BatchContribution batch_contribution = BatchContribution::MONTHLY;
+        RebalancingThreshold rebalancing_mode = RebalancingThreshold::ABSOLUTE;
+        bool is_batched = get_batch_portfolio(this->contribution, this->dip_buy, Dividend(), Rebalance(), batch_portfolio, batch_contribution, rebalancing_mode);
+        this->run_montecarlo_paths(nb_simu, {path_strategy_factory, this->assets_desired_pct_allocations, is_batched ? &batch_portfolio : nullptr,
+                                             batch_contribution, rebalancing_mode});
+    }
+
+private:
+    std::map<std::string, double> assets_desired_pct_allocations;
+    MarketData market_data;
+    StaticStrategy<Contribution, DipBuy, Dividend, Rebalance> static_strategy;
+    Contribution contribution;
+    DipBuy dip_buy;
+    size_t nb_replayed_transactions;
+
+    void replay_transactions(){
+        const std::vector<StaticTransaction>& transactions = this->static_strategy.get_state().transactions;
+        for (size_t i = this->nb_replayed_transactions; i < transactions.size(); ++i){
+            const StaticTransaction& transaction = transactions[i];
+            const YahooTimeseries& ticker_yt = this->tickers_yt[transaction.ticker_idx];
+            std::time_t date = this->market_data.dates[transaction.date_idx];
+            if (transaction.shares_amt >= 0)
+                this->ptf->buy(ticker_yt, transaction.shares_amt, date);
+            else
+                this->ptf->sell(ticker_yt, -transaction.shares_amt, date);
+        }
+        this->nb_replayed_transactions = transactions.size();
+    }
+};
+
+template<int RebalancingFreq, class Threshold>
+using CompiledDCA = CompiledStrategy<MonthlyContribution, NoDipBuy, ReinvestDividends<DefaultDividendReinvestmentRatio>, PeriodicRebalancing<RebalancingFreq, AbsoluteThreshold<Threshold>>>;
+
+template<int RebalancingFreq, class Threshold>
+using CompiledSmaOptimizedDCA = CompiledStrategy<MonthlyContribution, SmaDipBuy<DefaultDipRatio>, ReinvestDividends<DefaultDividendReinvestmentRatio>, PeriodicRebalancing<RebalancingFreq, AbsoluteThreshold<Threshold>>>;
+
+template<int RebalancingFreq, class Threshold>
+using CompiledLumpSum = CompiledStrategy<InitialLumpSum, NoDipBuy, ReinvestDividends<DefaultDividendReinvestmentRatio>, PeriodicRebalancing<RebalancingFreq, RelativeThreshold<Threshold>>>;
+
+#endif
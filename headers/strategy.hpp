@@ -2,25 +2,107 @@
 #define STRATEGY_HPP
 
 #include "./portfolio_builder.hpp"
+#include "./rebalancer.hpp"
+#include <memory>
+
+// Monte Carlo types of ./montecarlo_runner.hpp, which the simulations need
+class MonteCarloRunner;
+class MonteCarloAggregator;
+class LocalCluster;
+struct MonteCarloSamples;
+struct MonteCarloThroughput;
+struct MonteCarloEstimates;
+struct MonteCarloConvergence;
+struct MonteCarloStoppingRule;
+struct MonteCarloPathStrategy;
+enum class MonteCarloModel;
+enum class BootstrapScheme;
+enum class VarianceReduction;
+enum class OutputFormat;
+
+// Market data read by strategies without copying it: the backtests of a parameter sweep or walk-forward share one copy
+typedef std::shared_ptr<const std::vector<YahooTimeseries>> SharedTickers;
 
 class Strategy {
 public:
+    // The vector overloads of the constructors copy the tickers
     explicit Strategy(const std::vector<YahooTimeseries>& tickers_yt, std::string strategy_name);
+    explicit Strategy(SharedTickers tickers_yt, std::string strategy_name);
     virtual void make_transactions(std::time_t date) = 0;
     virtual void run_strategy();
 
     virtual const std::map<std::time_t, double> get_strategy_values() const;
     virtual double get_strategy_total_returns() const;
     virtual double get_strategy_extended_internal_return_rate(double tolerance, int max_iterations) const;
+    virtual double get_strategy_volatility() const;
+    virtual double get_strategy_max_drawdown() const;
     virtual void save_end_portfolio();
+    // save_end_portfolio (and the saved Monte Carlo paths) write their csv from a background thread
+    void set_background_output(bool is_background_output);
+    // CSV by default. BINARY saves the portfolio to <strategy_name>.res and the saved Monte Carlo paths as the value columns
+    // of <strategy_name>_MonteCarloPaths.res (one file per shard of a distributed run), ResultFile::export_csv converting them back
+    void set_output_format(OutputFormat output_format);
+    const PortfolioBuilder& get_portfolio() const;
+    // Binary snapshot of the state after run_strategy (ledger, pending amounts, rebalancing counters). A strategy of the same
+    // type, name, settings and tickers loading it, built on a longer history, then only processes the dates after the snapshot
+    // with the values of a full run. The transactions of the last date may depend on the history ending there
+    // (SmaOptimizedDCA invests its pending amounts at month ends): the snapshot holds the state before it and the last date
+    // is processed again after loading
+    bool save_snapshot(std::string filename) const;
+    bool load_snapshot(std::string filename);
 
-    virtual const YahooTimeseries montecarlo_simulation(const std::vector<std::time_t>& future_dates);
+    // Monte Carlo runs are delegated to a MonteCarloRunner, set and read through the methods below.
+    // Path path_idx of a seed is drawn from its own Philox stream: it does not depend on the other paths nor on the thread running it
+    virtual const YahooTimeseries montecarlo_simulation(const std::vector<std::time_t>& future_dates, double start_price, double mean_return, double volatility, uint64_t seed, uint64_t path_idx) const;
     virtual void run_montecarlo_simulations(size_t nb_simu) = 0;
+    void set_montecarlo_config(uint64_t seed, size_t nb_threads, std::time_t start_date, bool save_paths);
+    void set_montecarlo_model(MonteCarloModel model);
+    void set_montecarlo_bootstrap(BootstrapScheme scheme, double mean_block_length);
+    // Variance reduction of the normal models (PORTFOLIO_PRICE, CORRELATED_ASSETS)
+    void set_montecarlo_variance_reduction(VarianceReduction variance_reduction);
+    // With targets, nb_simu of run_montecarlo_simulations becomes the path budget of an adaptive run
+    void set_montecarlo_stopping_rule(const MonteCarloStoppingRule& stopping_rule);
+    // Progress, per-path samples and summary are saved to filename (empty disables it) at most every interval_seconds:
+    // an interrupted run of the same settings resumes from there with identical results; the file is removed once the run completes
+    void set_montecarlo_checkpoint(std::string filename, double interval_seconds);
+    // Paths split in shards of shard_size over the worker processes of the cluster (no stopping rule): the merged samples and
+    // summary are those of run_montecarlo_simulations, each worker using the threads of set_montecarlo_config (1 for local workers)
+    void run_distributed_montecarlo_simulations(size_t nb_simu, LocalCluster& cluster, size_t shard_size);
+    const std::vector<double>& get_montecarlo_end_values() const;
+    const MonteCarloSamples& get_montecarlo_samples() const;
+    const MonteCarloAggregator* get_montecarlo_aggregator() const;
+    const MonteCarloThroughput& get_montecarlo_throughput() const;
+    const MonteCarloEstimates& get_montecarlo_estimates() const;
+    const MonteCarloConvergence& get_montecarlo_convergence() const;
     virtual ~Strategy();
 protected:
     std::string strategy_name;
-    std::vector<YahooTimeseries> tickers_yt;
+    SharedTickers shared_tickers_yt;
+    const std::vector<YahooTimeseries>& tickers_yt; // *shared_tickers_yt
     PortfolioBuilder* ptf;
+    std::time_t last_processed_date; // numeric min until the first run_strategy
+    std::string last_date_state;     // write_state before last_processed_date was processed
+    bool is_background_output;
+    OutputFormat output_format;
+    MonteCarloRunner* montecarlo_runner;
+
+    // Runs the Monte Carlo paths of the strategy with the settings of its runner
+    void run_montecarlo_paths(size_t nb_simu, const MonteCarloPathStrategy& path_strategy);
+
+    // Dense per-ticker buffers (tickers_yt order) of rebalance_to_targets, reused at every rebalancing date
+    std::vector<int> rebalancing_asset_indices;
+    std::vector<double> rebalancing_shares;
+    std::vector<double> rebalancing_prices;
+    // Orders of the rebalancer at date applied to the portfolio as one ledger update
+    void rebalance_to_targets(Rebalancer& rebalancer, std::time_t date);
+
+    // Stable type tag and settings of the snapshots: a snapshot only loads into a strategy with the same ones.
+    // Strategies without a tag (the default) can't be snapshotted
+    virtual std::string get_snapshot_tag() const;
+    virtual void write_settings(ByteWriter& writer) const;
+    // Subclass state of the snapshots besides the ledger, read back in write order
+    virtual void write_state(ByteWriter& writer) const;
+    virtual void read_state(ByteReader& reader);
 };
 
 class DCA : public Strategy {
@@ -32,12 +114,26 @@ public:
         int rebalancing_freq,
         double rebalancing_threshold,
         std::string strategy_name);
+    DCA(SharedTickers tickers_yt,
+        double starting_amount,
+        double recurrent_investment_amount,
+        const std::map<std::string, double>& assets_desired_pct_allocations,
+        int rebalancing_freq,
+        double rebalancing_threshold,
+        std::string strategy_name);
+    // ABSOLUTE by default
+    void set_rebalancing_mode(RebalancingThreshold rebalancing_mode);
     void rebalance_portfolio(std::time_t date);
     void make_transaction(const YahooTimeseries& ticker_yt, std::time_t date);
     virtual void make_transactions(std::time_t date) override;
     virtual void run_montecarlo_simulations(size_t nb_simu) override;
 
 protected:
+    virtual std::string get_snapshot_tag() const override;
+    virtual void write_settings(ByteWriter& writer) const override;
+    virtual void write_state(ByteWriter& writer) const override;
+    virtual void read_state(ByteReader& reader) override;
+
     double starting_amount;
     double recurrent_investment_amount;
     std::map<std::string, double> assets_desired_pct_allocations;
@@ -45,6 +141,7 @@ protected:
     double rebalancing_threshold;
     int rebalancing_freq;
     int last_rebalancing_nb_days;
+    Rebalancer rebalancer;
     std::map<std::string, std::vector<std::time_t>> tickers_first_month_dates;
     std::map<std::string, std::vector<std::time_t>> tickers_last_month_dates;
 };
@@ -59,10 +156,26 @@ public:
                  double rebalancing_threshold,
                  int sma_window_size,
                  std::string strategy_name);
+    SmaOptimizedDCA(SharedTickers tickers_yt,
+                 double starting_amount,
+                 double recurrent_investment_amount,
+                 const std::map<std::string, double>& assets_desired_pct_allocations,
+                 int rebalancing_freq,
+                 double rebalancing_threshold,
+                 int sma_window_size,
+                 std::string strategy_name);
     void make_transaction(const YahooTimeseries& ticker_yt, std::time_t date, const Timeseries& simple_moving_avergages);
     virtual void make_transactions(std::time_t date) override;
 
+protected:
+    virtual std::string get_snapshot_tag() const override;
+    virtual void write_settings(ByteWriter& writer) const override;
+    // The moving averages are recomputed from the closes, only the amounts waiting for a dip are saved
+    virtual void write_state(ByteWriter& writer) const override;
+    virtual void read_state(ByteReader& reader) override;
+
 private:
+    int sma_window_size;
     std::map<std::string, double> current_tickers_remaining_investment_amount;
     std::map<std::string, std::vector<std::time_t>> tickers_last_month_dates;
     std::map<std::string, Timeseries> tickers_sma; 
@@ -76,9 +189,24 @@ public:
             int rebalancing_freq,
             double rebalancing_threshold,
             std::string strategy_name);
+    LumpSum(SharedTickers tickers_yt,
+            double initial_investment_amount,
+            const std::map<std::string, double>& assets_desired_pct_allocations,
+            int rebalancing_freq,
+            double rebalancing_threshold,
+            std::string strategy_name);
+    // RELATIVE by default
+    void set_rebalancing_mode(RebalancingThreshold rebalancing_mode);
     void rebalance_portfolio(std::time_t date);
     void make_transaction(const YahooTimeseries& ticker_yt, std::time_t date);
     void make_transactions(std::time_t date) override;
+    virtual void run_montecarlo_simulations(size_t nb_simu) override;
+
+protected:
+    virtual std::string get_snapshot_tag() const override;
+    virtual void write_settings(ByteWriter& writer) const override;
+    virtual void write_state(ByteWriter& writer) const override;
+    virtual void read_state(ByteReader& reader) override;
 
 private:
     double initial_investment_amount;
@@ -86,6 +214,7 @@ private:
     double rebalancing_threshold;
     int rebalancing_freq;
     int last_rebalancing_nb_days;
+    Rebalancer rebalancer;
     std::map<std::string, std::time_t> tickers_first_date;
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef STREAMING_BACKTEST
+#define STREAMING_BACKTEST
+
+#include "./bar_file.hpp"
+#include "./batch_engine.hpp"
+
+// Simple moving average updated one value at a time over a ring buffer of the window
+class IncrementalSma {
+public:
+    explicit IncrementalSma(size_t window_size);
+    void reset();
+    void add(double value);
+    double get_value() const; // mean of the last window_size values, 0 until window_size values were added
+
+private:
+    std::vector<double> window;
+    size_t position;
+    size_t nb_values;
+    double sum;
+};
+
+// Row of the stream as seen by the row handler
+struct StreamingRow {
+    std::time_t time;
+    const double* closes;  // [ticker], carried forward, 0 before the first bar
+    const double* smas;    // [ticker], simple moving average of the bars before this row (Timeseries::get_ts_simple_moving_averages)
+    const double* values;  // [portfolio]
+};
+
+// DCA / LumpSum portfolios (BatchEngine semantics) and per-ticker moving averages advanced over the chunks of a BarSource.
+// Only the last closes, the average windows and the portfolio state outlive a chunk: the memory is bounded by the chunk size
+// and the number of portfolios, not by the length of the history.
+class StreamingBacktest {
+public:
+    StreamingBacktest(const std::vector<BatchPortfolio>& portfolios, BatchContribution contribution, RebalancingThreshold rebalancing_mode, size_t sma_window_size);
+
+    void set_row_handler(const std::function<void(const StreamingRow&)>& handler);
+    void reset(size_t nb_tickers);
+    void process_chunk(const BarChunk& chunk);
+    // reset, then every chunk of source
+    void run(const BarSource& source);
+
+    size_t get_nb_bars() const;
+    const std::vector<double>& get_values() const;        // [portfolio] at the last bar
+    const std::vector<double>& get_max_drawdowns() const; // [portfolio]
+    const BatchEngine& get_engine() const;
+
+    ~StreamingBacktest();
+
+private:
+    BatchEngine engine;
+    BatchContribution contribution;
+    size_t sma_window_size;
+    std::function<void(const StreamingRow&)> row_handler;
+
+    size_t nb_bars;
+    std::vector<double> last_closes;
+    std::vector<const double*> asset_prices;
+    std::vector<double> row_dividends;
+    std::vector<char> is_contribution_dates;
+    std::vector<std::time_t> next_contribution_times;
+    std::vector<IncrementalSma> smas;
+    std::vector<double> sma_values;
+    std::vector<double> values;
+    std::vector<double> peak_values;
+    std::vector<double> max_drawdowns;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <exception>
+
+// Work-stealing pool: each worker pops from the back of its own queue and steals from the front of the others
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t nb_threads); // 0 means std::thread::hardware_concurrency()
+
+    void submit(std::function<void()> task);
+    // Must not be called from a task. Rethrows the first exception thrown by a task since the last wait,
+    // once every task is done (the other tasks still run).
+    void wait();
+    void parallel_for(size_t nb_tasks, const std::function<void(size_t)>& task);
+    size_t get_nb_threads() const;
+    // Index in [0, nb_threads) of the worker running the calling task, for per-thread state
+    static size_t get_worker_index();
+
+    ~ThreadPool();
+
+private:
+    struct WorkerQueue {
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    // Only taken to sleep and wake up: tasks are popped and completed under their queue lock and the atomic counters
+    std::mutex mutex;
+    std::condition_variable tasks_available;
+    std::condition_variable tasks_done;
+    std::atomic<size_t> nb_pending_tasks; // submitted and not completed
+    // Pushed and not popped, published under mutex once the task is in its queue: briefly negative when a worker pops
+    // a task before it is published
+    std::atomic<long> nb_queued_tasks;
+    bool stopping;
+    std::exception_ptr task_exception;
+    std::atomic<size_t> next_queue;
+
+    bool pop_task(size_t worker_index, std::function<void()>& task);
+    void worker_loop(size_t worker_index);
+};
+
+#endif
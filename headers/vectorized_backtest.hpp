@@ -0,0 +1,44 @@
+#ifndef VECTORIZED_BACKTEST
+#define VECTORIZED_BACKTEST
+
+#include "./market_data.hpp"
+#include "./rebalancer.hpp"
+
+struct VectorizedBacktestResult {
+    std::vector<std::time_t> dates;
+    std::vector<std::vector<double>> shares;   // [ticker][date] cumulative shares
+    std::vector<std::vector<double>> expenses;  // [ticker][date] cumulative expenses
+    std::vector<double> values;
+    std::vector<double> profits_and_losses;
+    std::vector<double> cash_flows;             // < 0 when money is invested
+};
+
+// Whole-series backtest of the schedule-driven strategies (DCA without dip trigger, LumpSum).
+// Between two rebalancing dates every ticker is independent: shares follow s_d = (s_d-1 + bought_d) * dividend_growth_d,
+// which is computed with cumulative product/sum kernels over the aligned columns; rebalancing is applied at the segment ends.
+class VectorizedBacktest {
+public:
+    VectorizedBacktest(const std::vector<YahooTimeseries>& tickers_yt,
+                       const std::map<std::string, double>& assets_desired_pct_allocations,
+                       int rebalancing_freq,
+                       double rebalancing_threshold);
+
+    // The rebalancing orders are those of the Rebalancer, ABSOLUTE for DCA and RELATIVE for LumpSum by default like the strategies
+    VectorizedBacktestResult run_dca(double starting_amount, double recurrent_investment_amount) const;
+    VectorizedBacktestResult run_dca(double starting_amount, double recurrent_investment_amount, RebalancingThreshold rebalancing_mode) const;
+    VectorizedBacktestResult run_lump_sum(double initial_investment_amount) const;
+    VectorizedBacktestResult run_lump_sum(double initial_investment_amount, RebalancingThreshold rebalancing_mode) const;
+    const MarketData& get_market_data() const;
+
+    ~VectorizedBacktest();
+
+private:
+    MarketData market_data;
+    std::vector<double> allocations;
+    int rebalancing_freq;
+    double rebalancing_threshold;
+
+    VectorizedBacktestResult run(const std::vector<std::vector<double>>& contributions, RebalancingThreshold rebalancing_mode) const;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef WALK_FORWARD
+#define WALK_FORWARD
+
+#include "./parameter_sweep.hpp"
+
+struct WalkForwardFold {
+    std::time_t in_sample_start;
+    std::time_t in_sample_end;
+    std::time_t out_of_sample_start;
+    std::time_t out_of_sample_end;
+    std::map<std::string, double> chosen_parameters;
+    double in_sample_xirr;
+    double out_of_sample_xirr;
+};
+
+// Each parameter set is backtested once over the whole calendar: indicators are warmed up once and every
+// fold window is then evaluated on a slice of that single ledger instead of re-running the strategy from the first date.
+class WalkForwardOptimizer {
+public:
+    WalkForwardOptimizer(const std::vector<YahooTimeseries>& tickers_yt,
+                         StrategyFactory strategy_factory,
+                         const std::vector<std::map<std::string, double>>& parameter_sets,
+                         size_t in_sample_nb_days,
+                         size_t out_of_sample_nb_days,
+                         bool anchored);
+
+    const std::vector<WalkForwardFold>& run(size_t nb_threads);
+    const std::vector<WalkForwardFold>& get_folds() const;
+    const std::map<std::time_t, double>& get_out_of_sample_equity() const; // stitched time-weighted equity, starts at 1
+    void save_results(std::string filename) const;
+
+    ~WalkForwardOptimizer();
+
+private:
+    struct Ledger {
+        std::vector<double> values;      // portfolio value per calendar date
+        std::vector<double> cash_flows;  // portfolio cash flow per calendar date (< 0 when money is invested)
+    };
+
+    SharedTickers tickers_yt; // one copy shared read-only by every backtest
+    StrategyFactory strategy_factory;
+    std::vector<std::map<std::string, double>> parameter_sets;
+    size_t in_sample_nb_days;
+    size_t out_of_sample_nb_days;
+    bool anchored;
+    std::vector<std::time_t> dates;
+    std::vector<double> year_fractions;
+    std::vector<Ledger> ledgers;
+    std::vector<WalkForwardFold> folds;
+    std::map<std::time_t, double> out_of_sample_equity;
+
+    Ledger run_ledger(const std::map<std::string, double>& parameters) const;
+    double get_window_xirr(const Ledger& ledger, size_t start_idx, size_t end_idx) const;
+};
+
+#endif
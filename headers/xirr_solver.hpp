@@ -0,0 +1,30 @@
+#ifndef XIRR_SOLVER
+#define XIRR_SOLVER
+
+#include <vector>
+#include <ctime>
+
+std::vector<double> get_year_fractions(const std::vector<std::time_t>& dates);
+
+class XirrSolver {
+public:
+    XirrSolver(double tolerance, int max_iterations);
+
+    // Returns NaN when the cash flows have no sign change (no rate solves NPV = 0)
+    double solve(const std::vector<double>& cash_flows, const std::vector<double>& year_fractions) const;
+    double solve(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows) const;
+
+    // cash_flows is a contiguous [nb_streams x year_fractions.size()] buffer, one row per stream (e.g. Monte Carlo path)
+    std::vector<double> solve_batch(const std::vector<double>& cash_flows, const std::vector<double>& year_fractions, size_t nb_streams) const;
+
+    ~XirrSolver();
+
+private:
+    double tolerance;
+    int max_iterations;
+
+    double solve_newton(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows, double log_rate, bool& converged) const;
+    double solve_brent(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows) const;
+};
+
+#endif
@@ -11,9 +11,17 @@ public:
     Timeseries();
     Timeseries(const std::vector<std::time_t>& dates, const std::vector<double>& values);
     Timeseries(const std::map<std::time_t, double>& map_values);
+    // Moves do not copy the columns despite the user-declared destructor
+    Timeseries(const Timeseries&) = default;
+    Timeseries(Timeseries&&) = default;
+    Timeseries& operator=(const Timeseries&) = default;
+    Timeseries& operator=(Timeseries&&) = default;
     bool operator==(const Timeseries& other) const;
     
     std::map<std::time_t, double> get_ts_values() const;
+    // Contiguous columns in construction order, valid as long as the timeseries
+    const std::vector<std::time_t>& get_dates() const;
+    const std::vector<double>& get_values() const;
     double get_ts_value(std::time_t date) const;
     double get_mean_returns() const;
 
@@ -59,6 +67,11 @@ public:
                     const std::vector<double> highs, 
                     const std::vector<double> closes,
                     const std::vector<double> adjcloses);
+    // Moves do not copy the columns despite the user-declared destructor
+    YahooTimeseries(const YahooTimeseries&) = default;
+    YahooTimeseries(YahooTimeseries&&) = default;
+    YahooTimeseries& operator=(const YahooTimeseries&) = default;
+    YahooTimeseries& operator=(YahooTimeseries&&) = default;
     std::string get_ticker() const;
     const std::vector<std::time_t>& get_dates() const;
     const Timeseries& get_opens() const;
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <ctime>
+#include <cstdint>
 #include <set>
 #include "../headers/yahoo_finance.hpp"
 #include <eigen3/Eigen/Dense>
@@ -13,10 +14,13 @@ std::string unix_timestamp_to_date_string(time_t ts_date);
 std::vector<std::string> unix_timestamps_to_date_strings(const std::vector<time_t> ts_dates);
 std::string get_ticker_str_data(std::string ticker, std::string start_date, std::string end_date, std::string freq);
 YahooTimeseries get_ticker_ts_data(std::string ticker_str_data);
+// Chart json of the Yahoo API read back by get_ticker_ts_data
+std::string get_ticker_chart_json(const YahooTimeseries& ticker_yt);
 std::vector<double> get_exponential_moving_average(std::vector<double> prices, double alpha);
 size_t get_date_index(std::time_t date, std::vector<std::time_t> dates);
 std::map<std::time_t, double> init_map(const YahooTimeseries& ticker_yt);
 std::vector<std::time_t> generate_random_dates(size_t count, std::time_t start, std::time_t end);
+std::vector<std::time_t> generate_random_dates(size_t count, std::time_t start, std::time_t end, uint64_t seed);
 std::vector<std::time_t> get_unique_dates(std::vector<YahooTimeseries> tickers_yt);
 std::vector<std::time_t> extract_first_dates_of_each_month(const std::vector<std::time_t>& dates);
 std::vector<std::time_t> extract_last_dates_of_each_month(const std::vector<std::time_t>& dates);
@@ -0,0 +1,1381 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+#include "../headers/yahoo_finance.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include "../headers/result_file.hpp"
+
+#include <vector>
+#include <string>
+#include <map>
+#include <ctime>
+#include <utility>
+#include <exception>
+#include <new>
+
+// CPython and NumPy C API bindings. Columns are NumPy arrays: read-only views of immutable C++ buffers (Timeseries,
+// YahooTimeseries, ResultFile mappings) keeping their owner alive, or arrays owning a computed copy. Results of a strategy,
+// which change at its next run, are always copied; its portfolio and Monte Carlo aggregator are looked up at each call.
+// The runs release the GIL: strategies built in different Python threads are backtested and simulated in parallel.
+// A strategy used from another thread while it runs raises a RuntimeError.
+
+static_assert(sizeof(std::time_t) == 8, "Error: dates are exposed as datetime64[s]\n");
+
+static PyArray_Descr* date_descr;  // datetime64[s]
+static PyArray_Descr* value_descr; // float64
+static PyObject* simple_namespace; // types.SimpleNamespace
+
+static PyTypeObject* timeseries_type;
+static PyTypeObject* yahoo_timeseries_type;
+static PyTypeObject* yahoo_finance_type;
+static PyTypeObject* portfolio_type;
+static PyTypeObject* aggregator_type;
+static PyTypeObject* strategy_type;
+static PyTypeObject* dca_type;
+static PyTypeObject* sma_optimized_dca_type;
+static PyTypeObject* lump_sum_type;
+static PyTypeObject* result_file_type;
+
+static const std::vector<const char*> output_format_names = {"CSV", "BINARY"};
+static const std::vector<const char*> rebalancing_threshold_names = {"ABSOLUTE", "RELATIVE", "BAND"};
+static const std::vector<const char*> montecarlo_model_names = {"PORTFOLIO_PRICE", "CORRELATED_ASSETS", "BLOCK_BOOTSTRAP"};
+static const std::vector<const char*> bootstrap_scheme_names = {"FIXED_BLOCKS", "STATIONARY_BLOCKS"};
+static const std::vector<const char*> variance_reduction_names = {"NONE", "ANTITHETIC_VARIATES", "CONTROL_VARIATE", "SOBOL_BROWNIAN_BRIDGE"};
+
+// A C++ exception becomes a RuntimeError (MemoryError for std::bad_alloc) instead of crossing the interpreter
+static void set_error(const std::exception& e){
+    if (dynamic_cast<const std::bad_alloc*>(&e))
+        PyErr_NoMemory();
+    else
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+}
+
+template <typename F>
+static PyObject* call(F f){
+    try {
+        return f();
+    }
+    catch (const std::exception& e){
+        set_error(e);
+        return nullptr;
+    }
+}
+
+// The GIL is released for the lifetime of the object, and reacquired when f returns or throws
+struct GilRelease {
+    PyThreadState* state;
+    GilRelease(): state(PyEval_SaveThread()){}
+    ~GilRelease(){ PyEval_RestoreThread(this->state); }
+};
+
+template <typename F>
+static auto run_without_gil(F f) -> decltype(f()){
+    GilRelease release;
+    return f();
+}
+
+// Python to C++, as PyArg_ParseTuple "O&" converters
+
+// object (ints or datetime64) as a C contiguous array of seconds since the epoch
+static PyArrayObject* get_seconds_array(PyObject* object, int ndim){
+    PyObject* array = PyArray_FROM_O(object);
+    if (!array)
+        return nullptr;
+    PyArray_Descr* descr = date_descr;
+    if (PyArray_TYPE((PyArrayObject*)array) == NPY_DATETIME)
+        Py_INCREF(descr);
+    else
+        descr = PyArray_DescrFromType(NPY_INT64);
+    PyObject* seconds = PyArray_FromAny(array, descr, ndim, ndim, NPY_ARRAY_CARRAY_RO | NPY_ARRAY_FORCECAST, nullptr);
+    Py_DECREF(array);
+    return (PyArrayObject*)seconds;
+}
+
+static int convert_date(PyObject* object, void* date){
+    PyArrayObject* seconds = get_seconds_array(object, 0);
+    if (!seconds)
+        return 0;
+    *static_cast<std::time_t*>(date) = *static_cast<const int64_t*>(PyArray_DATA(seconds));
+    Py_DECREF(seconds);
+    return 1;
+}
+
+static int convert_dates(PyObject* object, void* dates){
+    PyArrayObject* seconds = get_seconds_array(object, 1);
+    if (!seconds)
+        return 0;
+    try {
+        const int64_t* data = static_cast<const int64_t*>(PyArray_DATA(seconds));
+        static_cast<std::vector<std::time_t>*>(dates)->assign(data, data + PyArray_SIZE(seconds));
+    }
+    catch (const std::exception& e){
+        set_error(e);
+    }
+    Py_DECREF(seconds);
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+static int convert_values(PyObject* object, void* values){
+    PyObject* array = PyArray_FROMANY(object, NPY_DOUBLE, 1, 1, NPY_ARRAY_CARRAY_RO);
+    if (!array)
+        return 0;
+    try {
+        const double* data = static_cast<const double*>(PyArray_DATA((PyArrayObject*)array));
+        static_cast<std::vector<double>*>(values)->assign(data, data + PyArray_SIZE((PyArrayObject*)array));
+    }
+    catch (const std::exception& e){
+        set_error(e);
+    }
+    Py_DECREF(array);
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+static int convert_size(PyObject* object, void* size){
+    size_t value = PyLong_AsSize_t(object);
+    if (value == (size_t)-1 && PyErr_Occurred())
+        return 0;
+    *static_cast<size_t*>(size) = value;
+    return 1;
+}
+
+static int convert_strings(PyObject* object, void* strings){
+    PyObject* items = PySequence_Fast(object, "a sequence of str is expected");
+    if (!items)
+        return 0;
+    try {
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(items); ++i){
+            const char* item = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(items, i));
+            if (!item)
+                break;
+            static_cast<std::vector<std::string>*>(strings)->push_back(item);
+        }
+    }
+    catch (const std::exception& e){
+        set_error(e);
+    }
+    Py_DECREF(items);
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+// {ticker: weight}
+static int convert_allocations(PyObject* object, void* allocations){
+    if (!PyDict_Check(object)){
+        PyErr_SetString(PyExc_TypeError, "a dict of {str: float} is expected");
+        return 0;
+    }
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+    try {
+        while (PyDict_Next(object, &pos, &key, &value)){
+            const char* ticker = PyUnicode_AsUTF8(key);
+            double weight = PyFloat_AsDouble(value);
+            if (!ticker || (weight == -1.0 && PyErr_Occurred()))
+                return 0;
+            (*static_cast<std::map<std::string, double>*>(allocations))[ticker] = weight;
+        }
+    }
+    catch (const std::exception& e){
+        set_error(e);
+        return 0;
+    }
+    return 1;
+}
+
+// {date: value}, dates as ints or datetime64
+static int convert_ts_values(PyObject* object, void* ts_values){
+    if (!PyDict_Check(object)){
+        PyErr_SetString(PyExc_TypeError, "a dict of {date: float} is expected");
+        return 0;
+    }
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+    try {
+        while (PyDict_Next(object, &pos, &key, &value)){
+            std::time_t date;
+            if (!convert_date(key, &date))
+                return 0;
+            double ts_value = PyFloat_AsDouble(value);
+            if (ts_value == -1.0 && PyErr_Occurred())
+                return 0;
+            (*static_cast<std::map<std::time_t, double>*>(ts_values))[date] = ts_value;
+        }
+    }
+    catch (const std::exception& e){
+        set_error(e);
+        return 0;
+    }
+    return 1;
+}
+
+// Value of one of the enums exported as int constants
+template <typename T>
+static int convert_enum(PyObject* object, const std::vector<const char*>& names, void* value){
+    long index = PyLong_AsLong(object);
+    if (index == -1 && PyErr_Occurred())
+        return 0;
+    if (index < 0 || index >= (long)names.size()){
+        PyErr_Format(PyExc_ValueError, "%ld is not a valid enum value", index);
+        return 0;
+    }
+    *static_cast<T*>(value) = static_cast<T>(index);
+    return 1;
+}
+
+static int convert_output_format(PyObject* object, void* value){ return convert_enum<OutputFormat>(object, output_format_names, value); }
+static int convert_rebalancing_threshold(PyObject* object, void* value){ return convert_enum<RebalancingThreshold>(object, rebalancing_threshold_names, value); }
+static int convert_montecarlo_model(PyObject* object, void* value){ return convert_enum<MonteCarloModel>(object, montecarlo_model_names, value); }
+static int convert_bootstrap_scheme(PyObject* object, void* value){ return convert_enum<BootstrapScheme>(object, bootstrap_scheme_names, value); }
+static int convert_variance_reduction(PyObject* object, void* value){ return convert_enum<VarianceReduction>(object, variance_reduction_names, value); }
+
+// C++ to Python
+
+// NumPy array of the size values at data, which it does not copy: owner keeps them alive
+static PyObject* get_array(PyArray_Descr* descr, const void* data, size_t size, PyObject* owner, bool is_writeable){
+    npy_intp dims[1] = {(npy_intp)size};
+    Py_INCREF(descr);
+    if (!data) // empty vector
+        return PyArray_NewFromDescr(&PyArray_Type, descr, 1, dims, nullptr, nullptr, 0, nullptr);
+    PyObject* array = PyArray_NewFromDescr(&PyArray_Type, descr, 1, dims, nullptr, const_cast<void*>(data), is_writeable ? NPY_ARRAY_WRITEABLE : 0, nullptr);
+    if (!array)
+        return nullptr;
+    Py_INCREF(owner);
+    if (PyArray_SetBaseObject((PyArrayObject*)array, owner) < 0){
+        Py_DECREF(array);
+        return nullptr;
+    }
+    return array;
+}
+
+// Read-only view of a buffer of owner, an immutable bound object
+static PyObject* get_borrowed_array(PyArray_Descr* descr, const void* data, size_t size, PyObject* owner){
+    return get_array(descr, data, size, owner, false);
+}
+
+template <typename T>
+static void delete_vector(PyObject* capsule){
+    delete static_cast<std::vector<T>*>(PyCapsule_GetPointer(capsule, nullptr));
+}
+
+// A computed column handed to NumPy: the vector is moved into the capsule owning the array memory
+template <typename T>
+static PyObject* get_owned_array(PyArray_Descr* descr, std::vector<T>&& values){
+    std::vector<T>* owned_values = new std::vector<T>(std::move(values));
+    PyObject* capsule = PyCapsule_New(owned_values, nullptr, delete_vector<T>);
+    if (!capsule){
+        delete owned_values;
+        return nullptr;
+    }
+    PyObject* array = get_array(descr, owned_values->data(), owned_values->size(), capsule, true);
+    Py_DECREF(capsule);
+    return array;
+}
+
+static PyObject* get_dict(const std::map<std::time_t, double>& ts_values){
+    PyObject* dict = PyDict_New();
+    for (auto it = ts_values.begin(); dict && it != ts_values.end(); ++it){
+        PyObject* date = PyLong_FromLongLong(it->first);
+        PyObject* value = PyFloat_FromDouble(it->second);
+        if (!date || !value || PyDict_SetItem(dict, date, value) < 0)
+            Py_CLEAR(dict);
+        Py_XDECREF(date);
+        Py_XDECREF(value);
+    }
+    return dict;
+}
+
+static PyObject* get_dict(const std::map<std::string, double>& allocations){
+    PyObject* dict = PyDict_New();
+    for (auto it = allocations.begin(); dict && it != allocations.end(); ++it){
+        PyObject* value = PyFloat_FromDouble(it->second);
+        if (!value || PyDict_SetItemString(dict, it->first.c_str(), value) < 0)
+            Py_CLEAR(dict);
+        Py_XDECREF(value);
+    }
+    return dict;
+}
+
+static PyObject* get_list(const std::vector<double>& values){
+    PyObject* list = PyList_New(values.size());
+    for (size_t i = 0; list && i < values.size(); ++i){
+        PyObject* value = PyFloat_FromDouble(values[i]);
+        if (!value)
+            Py_CLEAR(list);
+        else
+            PyList_SET_ITEM(list, i, value);
+    }
+    return list;
+}
+
+static PyObject* get_list(const std::vector<std::string>& strings){
+    PyObject* list = PyList_New(strings.size());
+    for (size_t i = 0; list && i < strings.size(); ++i){
+        PyObject* string = PyUnicode_FromStringAndSize(strings[i].data(), strings[i].size());
+        if (!string)
+            Py_CLEAR(list);
+        else
+            PyList_SET_ITEM(list, i, string);
+    }
+    return list;
+}
+
+// types.SimpleNamespace(**fields), the fields dict being consumed
+static PyObject* get_namespace(PyObject* fields){
+    if (!fields)
+        return nullptr;
+    PyObject* args = PyTuple_New(0);
+    PyObject* result = args ? PyObject_Call(simple_namespace, args, fields) : nullptr;
+    Py_XDECREF(args);
+    Py_DECREF(fields);
+    return result;
+}
+
+template <typename T>
+static T* new_object(PyTypeObject* type){
+    return reinterpret_cast<T*>(type->tp_alloc(type, 0));
+}
+
+static void free_object(PyObject* self){
+    PyTypeObject* type = Py_TYPE(self);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static bool has_no_kwargs(PyObject* kwargs){
+    if (kwargs && PyDict_GET_SIZE(kwargs) > 0){
+        PyErr_SetString(PyExc_TypeError, "keyword arguments are not supported");
+        return false;
+    }
+    return true;
+}
+
+// Timeseries: owned, or borrowed from the YahooTimeseries object owner
+
+struct TimeseriesObject {
+    PyObject_HEAD
+    const Timeseries* ts;
+    PyObject* owner; // nullptr when ts is owned
+};
+
+static const Timeseries& get_timeseries(PyObject* self){
+    return *reinterpret_cast<TimeseriesObject*>(self)->ts;
+}
+
+static PyObject* new_timeseries(const Timeseries* ts, PyObject* owner){
+    TimeseriesObject* object = new_object<TimeseriesObject>(timeseries_type);
+    if (!object){
+        if (!owner)
+            delete ts;
+        return nullptr;
+    }
+    object->ts = ts;
+    object->owner = owner;
+    Py_XINCREF(owner);
+    return (PyObject*)object;
+}
+
+static PyObject* new_owned_timeseries(Timeseries&& ts){
+    return new_timeseries(new Timeseries(std::move(ts)), nullptr);
+}
+
+// Timeseries(dates, values) or Timeseries({date: value})
+static PyObject* timeseries_new(PyTypeObject*, PyObject* args, PyObject* kwargs){
+    if (!has_no_kwargs(kwargs))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        if (PyTuple_GET_SIZE(args) == 1){
+            std::map<std::time_t, double> ts_values;
+            if (!PyArg_ParseTuple(args, "O&", convert_ts_values, &ts_values))
+                return nullptr;
+            return new_owned_timeseries(Timeseries(ts_values));
+        }
+        std::vector<std::time_t> dates;
+        std::vector<double> values;
+        if (!PyArg_ParseTuple(args, "O&O&", convert_dates, &dates, convert_values, &values))
+            return nullptr;
+        if (dates.size() != values.size()){
+            PyErr_SetString(PyExc_ValueError, "dates and values have different sizes");
+            return nullptr;
+        }
+        return new_owned_timeseries(Timeseries(dates, values));
+    });
+}
+
+static void timeseries_dealloc(PyObject* self){
+    TimeseriesObject* object = reinterpret_cast<TimeseriesObject*>(self);
+    if (object->owner)
+        Py_DECREF(object->owner);
+    else
+        delete object->ts;
+    free_object(self);
+}
+
+static PyObject* timeseries_get_dates(PyObject* self, PyObject*){
+    const std::vector<std::time_t>& dates = get_timeseries(self).get_dates();
+    return get_borrowed_array(date_descr, dates.data(), dates.size(), self);
+}
+
+static PyObject* timeseries_get_values(PyObject* self, PyObject*){
+    const std::vector<double>& values = get_timeseries(self).get_values();
+    return get_borrowed_array(value_descr, values.data(), values.size(), self);
+}
+
+static PyObject* timeseries_get_ts_values(PyObject* self, PyObject*){
+    return call([&]{ return get_dict(get_timeseries(self).get_ts_values()); });
+}
+
+static PyObject* timeseries_get_ts_value(PyObject* self, PyObject* args){
+    std::time_t date;
+    if (!PyArg_ParseTuple(args, "O&", convert_date, &date))
+        return nullptr;
+    return call([&]{ return PyFloat_FromDouble(get_timeseries(self).get_ts_value(date)); });
+}
+
+static PyObject* timeseries_get_mean_returns(PyObject* self, PyObject*){
+    return call([&]{ return PyFloat_FromDouble(get_timeseries(self).get_mean_returns()); });
+}
+
+// Owned array of a Timeseries method of window_size
+template <std::vector<double> (Timeseries::*method)(size_t) const>
+static PyObject* timeseries_get_window_values(PyObject* self, PyObject* args){
+    size_t window_size;
+    if (!PyArg_ParseTuple(args, "O&", convert_size, &window_size))
+        return nullptr;
+    return call([&]{ return get_owned_array(value_descr, (get_timeseries(self).*method)(window_size)); });
+}
+
+template <std::vector<double> (Timeseries::*method)() const>
+static PyObject* timeseries_get_computed_values(PyObject* self, PyObject*){
+    return call([&]{ return get_owned_array(value_descr, (get_timeseries(self).*method)()); });
+}
+
+static Py_ssize_t timeseries_len(PyObject* self){
+    return get_timeseries(self).get_dates().size();
+}
+
+static PyMethodDef timeseries_methods[] = {
+    {"get_dates", timeseries_get_dates, METH_NOARGS, nullptr},
+    {"get_values", timeseries_get_values, METH_NOARGS, nullptr},
+    {"get_ts_values", timeseries_get_ts_values, METH_NOARGS, nullptr},
+    {"get_ts_value", timeseries_get_ts_value, METH_VARARGS, nullptr},
+    {"get_mean_returns", timeseries_get_mean_returns, METH_NOARGS, nullptr},
+    {"get_simple_moving_averages", timeseries_get_window_values<&Timeseries::get_simple_moving_averages>, METH_VARARGS, nullptr},
+    {"get_exponential_moving_averages", timeseries_get_window_values<&Timeseries::get_exponential_moving_averages>, METH_VARARGS, nullptr},
+    {"get_maximum_drawdowns", timeseries_get_window_values<&Timeseries::get_maximum_drawdowns>, METH_VARARGS, nullptr},
+    {"get_pct_changes", timeseries_get_computed_values<&Timeseries::get_pct_changes>, METH_NOARGS, nullptr},
+    {"get_log_returns", timeseries_get_computed_values<&Timeseries::get_log_returns>, METH_NOARGS, nullptr},
+    {"get_volatilities", timeseries_get_window_values<&Timeseries::get_volatilities>, METH_VARARGS, nullptr},
+    {"get_rsis", timeseries_get_window_values<&Timeseries::get_rsis>, METH_VARARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot timeseries_slots[] = {
+    {Py_tp_new, (void*)timeseries_new},
+    {Py_tp_dealloc, (void*)timeseries_dealloc},
+    {Py_tp_methods, timeseries_methods},
+    {Py_sq_length, (void*)timeseries_len},
+    {Py_tp_doc, (void*)"Timeseries(dates, values) or Timeseries({date: value}), dates as ints or datetime64"},
+    {0, nullptr}
+};
+
+static PyType_Spec timeseries_spec = {"portfolio_simulator.Timeseries", sizeof(TimeseriesObject), 0, Py_TPFLAGS_DEFAULT, timeseries_slots};
+
+// YahooTimeseries: its Timeseries objects keep it alive
+
+struct YahooTimeseriesObject {
+    PyObject_HEAD
+    const YahooTimeseries* ticker_yt;
+};
+
+static const YahooTimeseries& get_yahoo_timeseries(PyObject* self){
+    return *reinterpret_cast<YahooTimeseriesObject*>(self)->ticker_yt;
+}
+
+static PyObject* new_yahoo_timeseries(YahooTimeseries&& ticker_yt){
+    YahooTimeseriesObject* object = new_object<YahooTimeseriesObject>(yahoo_timeseries_type);
+    if (!object)
+        return nullptr;
+    object->ticker_yt = new YahooTimeseries(std::move(ticker_yt));
+    return (PyObject*)object;
+}
+
+// YahooTimeseries(ticker, dates, opens, lows, highs, closes, adjcloses[, {date: dividend}])
+static PyObject* yahoo_timeseries_new(PyTypeObject*, PyObject* args, PyObject* kwargs){
+    if (!has_no_kwargs(kwargs))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        const char* ticker;
+        std::vector<std::time_t> dates;
+        std::vector<double> opens, lows, highs, closes, adjcloses;
+        std::map<std::time_t, double> dividends;
+        if (!PyArg_ParseTuple(args, "sO&O&O&O&O&O&|O&", &ticker, convert_dates, &dates, convert_values, &opens, convert_values, &lows,
+                              convert_values, &highs, convert_values, &closes, convert_values, &adjcloses, convert_ts_values, &dividends))
+            return nullptr;
+        for (const std::vector<double>* values: {&opens, &lows, &highs, &closes, &adjcloses}){
+            if (values->size() != dates.size()){
+                PyErr_SetString(PyExc_ValueError, "dates and values have different sizes");
+                return nullptr;
+            }
+        }
+        return new_yahoo_timeseries(YahooTimeseries(ticker, dates, opens, lows, highs, closes, adjcloses, dividends));
+    });
+}
+
+static void yahoo_timeseries_dealloc(PyObject* self){
+    delete reinterpret_cast<YahooTimeseriesObject*>(self)->ticker_yt;
+    free_object(self);
+}
+
+static PyObject* yahoo_timeseries_get_ticker(PyObject* self, PyObject*){
+    return call([&]{ return PyUnicode_FromString(get_yahoo_timeseries(self).get_ticker().c_str()); });
+}
+
+static PyObject* yahoo_timeseries_get_dates(PyObject* self, PyObject*){
+    const std::vector<std::time_t>& dates = get_yahoo_timeseries(self).get_dates();
+    return get_borrowed_array(date_descr, dates.data(), dates.size(), self);
+}
+
+template <const Timeseries& (YahooTimeseries::*method)() const>
+static PyObject* yahoo_timeseries_get_column(PyObject* self, PyObject*){
+    return new_timeseries(&(get_yahoo_timeseries(self).*method)(), self);
+}
+
+template <Timeseries (YahooTimeseries::*method)() const>
+static PyObject* yahoo_timeseries_get_spreads(PyObject* self, PyObject*){
+    return call([&]{ return new_owned_timeseries((get_yahoo_timeseries(self).*method)()); });
+}
+
+static PyMethodDef yahoo_timeseries_methods[] = {
+    {"get_ticker", yahoo_timeseries_get_ticker, METH_NOARGS, nullptr},
+    {"get_dates", yahoo_timeseries_get_dates, METH_NOARGS, nullptr},
+    {"get_opens", yahoo_timeseries_get_column<&YahooTimeseries::get_opens>, METH_NOARGS, nullptr},
+    {"get_lows", yahoo_timeseries_get_column<&YahooTimeseries::get_lows>, METH_NOARGS, nullptr},
+    {"get_highs", yahoo_timeseries_get_column<&YahooTimeseries::get_highs>, METH_NOARGS, nullptr},
+    {"get_closes", yahoo_timeseries_get_column<&YahooTimeseries::get_closes>, METH_NOARGS, nullptr},
+    {"get_adjcloses", yahoo_timeseries_get_column<&YahooTimeseries::get_adjcloses>, METH_NOARGS, nullptr},
+    {"get_dividends", yahoo_timeseries_get_column<&YahooTimeseries::get_dividends>, METH_NOARGS, nullptr},
+    {"get_open_close_spreads", yahoo_timeseries_get_spreads<&YahooTimeseries::get_open_close_spreads>, METH_NOARGS, nullptr},
+    {"get_high_low_spreads", yahoo_timeseries_get_spreads<&YahooTimeseries::get_high_low_spreads>, METH_NOARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot yahoo_timeseries_slots[] = {
+    {Py_tp_new, (void*)yahoo_timeseries_new},
+    {Py_tp_dealloc, (void*)yahoo_timeseries_dealloc},
+    {Py_tp_methods, yahoo_timeseries_methods},
+    {Py_tp_doc, (void*)"YahooTimeseries(ticker, dates, opens, lows, highs, closes, adjcloses[, {date: dividend}])"},
+    {0, nullptr}
+};
+
+static PyType_Spec yahoo_timeseries_spec = {"portfolio_simulator.YahooTimeseries", sizeof(YahooTimeseriesObject), 0, Py_TPFLAGS_DEFAULT, yahoo_timeseries_slots};
+
+static int convert_tickers_yt(PyObject* object, void* tickers_yt){
+    PyObject* items = PySequence_Fast(object, "a sequence of YahooTimeseries is expected");
+    if (!items)
+        return 0;
+    try {
+        for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(items); ++i){
+            PyObject* item = PySequence_Fast_GET_ITEM(items, i);
+            if (!PyObject_TypeCheck(item, yahoo_timeseries_type)){
+                PyErr_SetString(PyExc_TypeError, "a sequence of YahooTimeseries is expected");
+                break;
+            }
+            static_cast<std::vector<YahooTimeseries>*>(tickers_yt)->push_back(get_yahoo_timeseries(item));
+        }
+    }
+    catch (const std::exception& e){
+        set_error(e);
+    }
+    Py_DECREF(items);
+    return PyErr_Occurred() ? 0 : 1;
+}
+
+// YahooFinance
+
+struct YahooFinanceObject {
+    PyObject_HEAD
+    const YahooFinance* yahoo_finance;
+};
+
+// YahooFinance(tickers, start_date, end_date, freq)
+static PyObject* yahoo_finance_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    if (!has_no_kwargs(kwargs))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        std::vector<std::string> tickers;
+        const char* start_date;
+        const char* end_date;
+        const char* freq;
+        if (!PyArg_ParseTuple(args, "O&sss", convert_strings, &tickers, &start_date, &end_date, &freq))
+            return nullptr;
+        YahooFinanceObject* object = new_object<YahooFinanceObject>(type);
+        if (object)
+            object->yahoo_finance = new YahooFinance(tickers, start_date, end_date, freq);
+        return (PyObject*)object;
+    });
+}
+
+static void yahoo_finance_dealloc(PyObject* self){
+    delete reinterpret_cast<YahooFinanceObject*>(self)->yahoo_finance;
+    free_object(self);
+}
+
+// Downloads without the GIL; a ticker that can't be loaded raises a RuntimeError
+static PyObject* yahoo_finance_get_tickers_ts_data(PyObject* self, PyObject*){
+    const YahooFinance* yahoo_finance = reinterpret_cast<YahooFinanceObject*>(self)->yahoo_finance;
+    return call([&]() -> PyObject* {
+        std::vector<YahooTimeseries> tickers_yt = run_without_gil([yahoo_finance]{ return yahoo_finance->get_tickers_ts_data(); });
+        PyObject* list = PyList_New(tickers_yt.size());
+        for (size_t i = 0; list && i < tickers_yt.size(); ++i){
+            PyObject* ticker_yt = new_yahoo_timeseries(std::move(tickers_yt[i]));
+            if (!ticker_yt)
+                Py_CLEAR(list);
+            else
+                PyList_SET_ITEM(list, i, ticker_yt);
+        }
+        return list;
+    });
+}
+
+static PyMethodDef yahoo_finance_methods[] = {
+    {"get_tickers_ts_data", yahoo_finance_get_tickers_ts_data, METH_NOARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot yahoo_finance_slots[] = {
+    {Py_tp_new, (void*)yahoo_finance_new},
+    {Py_tp_dealloc, (void*)yahoo_finance_dealloc},
+    {Py_tp_methods, yahoo_finance_methods},
+    {Py_tp_doc, (void*)"YahooFinance(tickers, start_date, end_date, freq)"},
+    {0, nullptr}
+};
+
+static PyType_Spec yahoo_finance_spec = {"portfolio_simulator.YahooFinance", sizeof(YahooFinanceObject), 0, Py_TPFLAGS_DEFAULT, yahoo_finance_slots};
+
+// Strategies
+
+struct StrategyObject {
+    PyObject_HEAD
+    Strategy* strategy;
+    bool is_running; // while a call using it releases the GIL, only read and written with the GIL held
+};
+
+static Strategy* get_strategy(PyObject* self){
+    return reinterpret_cast<StrategyObject*>(self)->strategy;
+}
+
+// The strategy is marked as running for the lifetime of the object, which is created and destroyed with the GIL held
+struct StrategyRun {
+    StrategyObject* object;
+    explicit StrategyRun(PyObject* self): object(reinterpret_cast<StrategyObject*>(self)){ this->object->is_running = true; }
+    ~StrategyRun(){ this->object->is_running = false; }
+};
+
+template <typename F>
+static auto run_without_gil(PyObject* strategy, F f) -> decltype(f()){
+    StrategyRun run(strategy);
+    return run_without_gil(f);
+}
+
+static bool check_idle(PyObject* strategy){
+    if (reinterpret_cast<StrategyObject*>(strategy)->is_running){
+        PyErr_SetString(PyExc_RuntimeError, "the strategy is running in another thread");
+        return false;
+    }
+    return true;
+}
+
+// Methods of a strategy, and of its portfolio and aggregator below, raise a RuntimeError while it runs in another thread
+template <PyCFunction method>
+static PyObject* if_idle(PyObject* self, PyObject* args){
+    return check_idle(self) ? method(self, args) : nullptr;
+}
+
+template <typename F>
+static PyObject* new_strategy(PyTypeObject* type, F strategy_factory){
+    StrategyObject* object = new_object<StrategyObject>(type);
+    if (!object)
+        return nullptr;
+    try {
+        object->strategy = strategy_factory();
+    }
+    catch (const std::exception& e){
+        set_error(e);
+        Py_DECREF(object);
+        return nullptr;
+    }
+    return (PyObject*)object;
+}
+
+static void strategy_dealloc(PyObject* self){
+    delete get_strategy(self);
+    free_object(self);
+}
+
+// The PortfolioBuilder and MonteCarloAggregator objects of a strategy keep it alive and look its current ones up at each call
+
+struct StrategyMemberObject {
+    PyObject_HEAD
+    PyObject* strategy;
+};
+
+static PyObject* new_strategy_member(PyTypeObject* type, PyObject* strategy){
+    StrategyMemberObject* object = new_object<StrategyMemberObject>(type);
+    if (!object)
+        return nullptr;
+    object->strategy = strategy;
+    Py_INCREF(strategy);
+    return (PyObject*)object;
+}
+
+template <PyCFunction method>
+static PyObject* if_strategy_idle(PyObject* self, PyObject* args){
+    return check_idle(reinterpret_cast<StrategyMemberObject*>(self)->strategy) ? method(self, args) : nullptr;
+}
+
+static void strategy_member_dealloc(PyObject* self){
+    Py_XDECREF(reinterpret_cast<StrategyMemberObject*>(self)->strategy);
+    free_object(self);
+}
+
+static const PortfolioBuilder& get_portfolio(PyObject* self){
+    return get_strategy(reinterpret_cast<StrategyMemberObject*>(self)->strategy)->get_portfolio();
+}
+
+// {"Date", "Value", "P&L", "Investments"} arrays of PortfolioBuilder::get_saved_columns, the value columns sharing one buffer
+static PyObject* portfolio_get_results(PyObject* self, PyObject*){
+    return call([&]() -> PyObject* {
+        std::vector<std::time_t> dates;
+        std::vector<double> columns;
+        get_portfolio(self).get_saved_columns(dates, columns);
+        size_t nb_dates = dates.size();
+        PyObject* results = PyDict_New();
+        if (!results)
+            return nullptr;
+        PyObject* date_array = get_owned_array(date_descr, std::move(dates));
+        PyObject* values = get_owned_array(value_descr, std::move(columns));
+        if (!date_array || !values || PyDict_SetItemString(results, "Date", date_array) < 0)
+            Py_CLEAR(results);
+        const double* values_data = values ? static_cast<const double*>(PyArray_DATA((PyArrayObject*)values)) : nullptr;
+        std::vector<const char*> names = {"Value", "P&L", "Investments"};
+        for (size_t c = 0; results && c < names.size(); ++c){
+            PyObject* column = get_array(value_descr, nb_dates ? values_data + c * nb_dates : nullptr, nb_dates, values, true);
+            if (!column || PyDict_SetItemString(results, names[c], column) < 0)
+                Py_CLEAR(results);
+            Py_XDECREF(column);
+        }
+        Py_XDECREF(date_array);
+        Py_XDECREF(values);
+        return results;
+    });
+}
+
+static PyObject* portfolio_save_portfolio(PyObject* self, PyObject* args){
+    const char* filename;
+    int is_background_writer;
+    if (!PyArg_ParseTuple(args, "sp", &filename, &is_background_writer))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        const PortfolioBuilder& ptf = get_portfolio(self);
+        run_without_gil(reinterpret_cast<StrategyMemberObject*>(self)->strategy, [&]{ ptf.save_portfolio(filename, is_background_writer); });
+        Py_RETURN_NONE;
+    });
+}
+
+static PyObject* portfolio_save_portfolio_results(PyObject* self, PyObject* args){
+    const char* filename;
+    if (!PyArg_ParseTuple(args, "s", &filename))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        const PortfolioBuilder& ptf = get_portfolio(self);
+        run_without_gil(reinterpret_cast<StrategyMemberObject*>(self)->strategy, [&]{ ptf.save_portfolio_results(filename); });
+        Py_RETURN_NONE;
+    });
+}
+
+template <double (PortfolioBuilder::*method)(std::string, std::time_t) const>
+static PyObject* portfolio_get_ticker_amount(PyObject* self, PyObject* args){
+    const char* ticker;
+    std::time_t date;
+    if (!PyArg_ParseTuple(args, "sO&", &ticker, convert_date, &date))
+        return nullptr;
+    return call([&]{ return PyFloat_FromDouble((get_portfolio(self).*method)(ticker, date)); });
+}
+
+static PyObject* portfolio_get_portfolio_value(PyObject* self, PyObject* args){
+    std::time_t date;
+    if (!PyArg_ParseTuple(args, "O&", convert_date, &date))
+        return nullptr;
+    return call([&]{ return PyFloat_FromDouble(get_portfolio(self).get_portfolio_value(date)); });
+}
+
+static PyObject* portfolio_get_unique_portfolio_dates(PyObject* self, PyObject*){
+    return call([&]{ return get_owned_array(date_descr, get_portfolio(self).get_unique_portfolio_dates()); });
+}
+
+static PyObject* portfolio_get_portfolio_percentage_allocations(PyObject* self, PyObject* args){
+    std::time_t date;
+    if (!PyArg_ParseTuple(args, "O&", convert_date, &date))
+        return nullptr;
+    return call([&]{ return get_dict(get_portfolio(self).get_portfolio_percentage_allocations(date)); });
+}
+
+static PyObject* portfolio_get_portfolio_values(PyObject* self, PyObject*){
+    return call([&]{ return get_dict(get_portfolio(self).get_portfolio_values()); });
+}
+
+template <Timeseries (PortfolioBuilder::*method)(std::string) const>
+static PyObject* portfolio_get_ticker_timeseries(PyObject* self, PyObject* args){
+    const char* ticker;
+    if (!PyArg_ParseTuple(args, "s", &ticker))
+        return nullptr;
+    return call([&]{ return new_owned_timeseries((get_portfolio(self).*method)(ticker)); });
+}
+
+template <Timeseries (PortfolioBuilder::*method)() const>
+static PyObject* portfolio_get_timeseries(PyObject* self, PyObject*){
+    return call([&]{ return new_owned_timeseries((get_portfolio(self).*method)()); });
+}
+
+static PyMethodDef portfolio_methods[] = {
+    {"get_results", if_strategy_idle<portfolio_get_results>, METH_NOARGS, nullptr},
+    {"save_portfolio", if_strategy_idle<portfolio_save_portfolio>, METH_VARARGS, nullptr},
+    {"save_portfolio_results", if_strategy_idle<portfolio_save_portfolio_results>, METH_VARARGS, nullptr},
+    {"get_ticker_value", if_strategy_idle<portfolio_get_ticker_amount<&PortfolioBuilder::get_ticker_value>>, METH_VARARGS, nullptr},
+    {"get_ticker_shares", if_strategy_idle<portfolio_get_ticker_amount<&PortfolioBuilder::get_ticker_shares>>, METH_VARARGS, nullptr},
+    {"get_portfolio_value", if_strategy_idle<portfolio_get_portfolio_value>, METH_VARARGS, nullptr},
+    {"get_unique_portfolio_dates", if_strategy_idle<portfolio_get_unique_portfolio_dates>, METH_NOARGS, nullptr},
+    {"get_portfolio_percentage_allocations", if_strategy_idle<portfolio_get_portfolio_percentage_allocations>, METH_VARARGS, nullptr},
+    {"get_portfolio_values", if_strategy_idle<portfolio_get_portfolio_values>, METH_NOARGS, nullptr},
+    {"get_ticker_values", if_strategy_idle<portfolio_get_ticker_timeseries<&PortfolioBuilder::get_ticker_values>>, METH_VARARGS, nullptr},
+    {"get_ts_portfolio_values", if_strategy_idle<portfolio_get_timeseries<&PortfolioBuilder::get_ts_portfolio_values>>, METH_NOARGS, nullptr},
+    {"get_ts_portfolio_prices", if_strategy_idle<portfolio_get_timeseries<&PortfolioBuilder::get_ts_portfolio_prices>>, METH_NOARGS, nullptr},
+    {"get_ticker_profits_and_losses", if_strategy_idle<portfolio_get_ticker_timeseries<&PortfolioBuilder::get_ticker_profits_and_losses>>, METH_VARARGS, nullptr},
+    {"get_portfolio_profits_and_losses", if_strategy_idle<portfolio_get_timeseries<&PortfolioBuilder::get_portfolio_profits_and_losses>>, METH_NOARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot portfolio_slots[] = {
+    {Py_tp_dealloc, (void*)strategy_member_dealloc},
+    {Py_tp_methods, portfolio_methods},
+    {Py_tp_doc, (void*)"Portfolio of a strategy, from Strategy.get_portfolio()"},
+    {0, nullptr}
+};
+
+static PyType_Spec portfolio_spec = {"portfolio_simulator.PortfolioBuilder", sizeof(StrategyMemberObject), 0,
+                                     Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION, portfolio_slots};
+
+// Aggregator of the last Monte Carlo run of the strategy, replaced by its next run
+static const MonteCarloAggregator* get_aggregator(PyObject* self){
+    const MonteCarloAggregator* aggregator = get_strategy(reinterpret_cast<StrategyMemberObject*>(self)->strategy)->get_montecarlo_aggregator();
+    if (!aggregator)
+        PyErr_SetString(PyExc_RuntimeError, "the strategy has no Monte Carlo run");
+    return aggregator;
+}
+
+static bool check_date_idx(const MonteCarloAggregator* aggregator, size_t date_idx){
+    if (date_idx >= aggregator->get_dates().size()){
+        PyErr_SetString(PyExc_IndexError, "date index out of range");
+        return false;
+    }
+    return true;
+}
+
+static PyObject* aggregator_get_nb_paths(PyObject* self, PyObject*){
+    const MonteCarloAggregator* aggregator = get_aggregator(self);
+    return aggregator ? PyLong_FromSize_t(aggregator->get_nb_paths()) : nullptr;
+}
+
+static PyObject* aggregator_get_dates(PyObject* self, PyObject*){
+    const MonteCarloAggregator* aggregator = get_aggregator(self);
+    if (!aggregator)
+        return nullptr;
+    return call([&]{ return get_owned_array(date_descr, std::vector<std::time_t>(aggregator->get_dates())); });
+}
+
+static PyObject* aggregator_get_quantile(PyObject* self, PyObject* args){
+    size_t date_idx;
+    double q;
+    if (!PyArg_ParseTuple(args, "O&d", convert_size, &date_idx, &q))
+        return nullptr;
+    const MonteCarloAggregator* aggregator = get_aggregator(self);
+    if (!aggregator || !check_date_idx(aggregator, date_idx))
+        return nullptr;
+    return call([&]{ return PyFloat_FromDouble(aggregator->get_quantile(date_idx, q)); });
+}
+
+template <double (MonteCarloAggregator::*method)(size_t) const>
+static PyObject* aggregator_get_moment(PyObject* self, PyObject* args){
+    size_t date_idx;
+    if (!PyArg_ParseTuple(args, "O&", convert_size, &date_idx))
+        return nullptr;
+    const MonteCarloAggregator* aggregator = get_aggregator(self);
+    if (!aggregator || !check_date_idx(aggregator, date_idx))
+        return nullptr;
+    return call([&]{ return PyFloat_FromDouble((aggregator->*method)(date_idx)); });
+}
+
+static PyMethodDef aggregator_methods[] = {
+    {"get_nb_paths", if_strategy_idle<aggregator_get_nb_paths>, METH_NOARGS, nullptr},
+    {"get_dates", if_strategy_idle<aggregator_get_dates>, METH_NOARGS, nullptr},
+    {"get_quantile", if_strategy_idle<aggregator_get_quantile>, METH_VARARGS, nullptr},
+    {"get_mean", if_strategy_idle<aggregator_get_moment<&MonteCarloAggregator::get_mean>>, METH_VARARGS, nullptr},
+    {"get_std", if_strategy_idle<aggregator_get_moment<&MonteCarloAggregator::get_std>>, METH_VARARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot aggregator_slots[] = {
+    {Py_tp_dealloc, (void*)strategy_member_dealloc},
+    {Py_tp_methods, aggregator_methods},
+    {Py_tp_doc, (void*)"Summary of the last Monte Carlo run of a strategy, from Strategy.get_montecarlo_aggregator()"},
+    {0, nullptr}
+};
+
+static PyType_Spec aggregator_spec = {"portfolio_simulator.MonteCarloAggregator", sizeof(StrategyMemberObject), 0,
+                                      Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION, aggregator_slots};
+
+static PyObject* strategy_run_strategy(PyObject* self, PyObject*){
+    Strategy* strategy = get_strategy(self);
+    return call([&]() -> PyObject* {
+        run_without_gil(self, [strategy]{ strategy->run_strategy(); });
+        Py_RETURN_NONE;
+    });
+}
+
+static PyObject* strategy_get_strategy_values(PyObject* self, PyObject*){
+    return call([&]{ return get_dict(get_strategy(self)->get_strategy_values()); });
+}
+
+template <double (Strategy::*method)() const>
+static PyObject* strategy_get_metric(PyObject* self, PyObject*){
+    return call([&]{ return PyFloat_FromDouble((get_strategy(self)->*method)()); });
+}
+
+static PyObject* strategy_get_strategy_extended_internal_return_rate(PyObject* self, PyObject* args){
+    double tolerance;
+    int max_iterations;
+    if (!PyArg_ParseTuple(args, "di", &tolerance, &max_iterations))
+        return nullptr;
+    return call([&]{ return PyFloat_FromDouble(get_strategy(self)->get_strategy_extended_internal_return_rate(tolerance, max_iterations)); });
+}
+
+static PyObject* strategy_save_end_portfolio(PyObject* self, PyObject*){
+    Strategy* strategy = get_strategy(self);
+    return call([&]() -> PyObject* {
+        run_without_gil(self, [strategy]{ strategy->save_end_portfolio(); });
+        Py_RETURN_NONE;
+    });
+}
+
+static PyObject* strategy_set_background_output(PyObject* self, PyObject* args){
+    int is_background_output;
+    if (!PyArg_ParseTuple(args, "p", &is_background_output))
+        return nullptr;
+    get_strategy(self)->set_background_output(is_background_output);
+    Py_RETURN_NONE;
+}
+
+static PyObject* strategy_set_output_format(PyObject* self, PyObject* args){
+    OutputFormat output_format;
+    if (!PyArg_ParseTuple(args, "O&", convert_output_format, &output_format))
+        return nullptr;
+    get_strategy(self)->set_output_format(output_format);
+    Py_RETURN_NONE;
+}
+
+static PyObject* strategy_get_portfolio(PyObject* self, PyObject*){
+    return new_strategy_member(portfolio_type, self);
+}
+
+static PyObject* strategy_save_snapshot(PyObject* self, PyObject* args){
+    const char* filename;
+    if (!PyArg_ParseTuple(args, "s", &filename))
+        return nullptr;
+    const Strategy* strategy = get_strategy(self);
+    return call([&]{ return PyBool_FromLong(run_without_gil(self, [&]{ return strategy->save_snapshot(filename); })); });
+}
+
+static PyObject* strategy_load_snapshot(PyObject* self, PyObject* args){
+    const char* filename;
+    if (!PyArg_ParseTuple(args, "s", &filename))
+        return nullptr;
+    Strategy* strategy = get_strategy(self);
+    return call([&]{ return PyBool_FromLong(run_without_gil(self, [&]{ return strategy->load_snapshot(filename); })); });
+}
+
+// set_montecarlo_config(seed, nb_threads, start_date, save_paths)
+static PyObject* strategy_set_montecarlo_config(PyObject* self, PyObject* args){
+    unsigned long long seed;
+    size_t nb_threads;
+    std::time_t start_date;
+    int save_paths;
+    if (!PyArg_ParseTuple(args, "KO&O&p", &seed, convert_size, &nb_threads, convert_date, &start_date, &save_paths))
+        return nullptr;
+    get_strategy(self)->set_montecarlo_config(seed, nb_threads, start_date, save_paths);
+    Py_RETURN_NONE;
+}
+
+static PyObject* strategy_set_montecarlo_model(PyObject* self, PyObject* args){
+    MonteCarloModel model;
+    if (!PyArg_ParseTuple(args, "O&", convert_montecarlo_model, &model))
+        return nullptr;
+    get_strategy(self)->set_montecarlo_model(model);
+    Py_RETURN_NONE;
+}
+
+static PyObject* strategy_set_montecarlo_bootstrap(PyObject* self, PyObject* args){
+    BootstrapScheme scheme;
+    double mean_block_length;
+    if (!PyArg_ParseTuple(args, "O&d", convert_bootstrap_scheme, &scheme, &mean_block_length))
+        return nullptr;
+    get_strategy(self)->set_montecarlo_bootstrap(scheme, mean_block_length);
+    Py_RETURN_NONE;
+}
+
+static PyObject* strategy_set_montecarlo_variance_reduction(PyObject* self, PyObject* args){
+    VarianceReduction variance_reduction;
+    if (!PyArg_ParseTuple(args, "O&", convert_variance_reduction, &variance_reduction))
+        return nullptr;
+    get_strategy(self)->set_montecarlo_variance_reduction(variance_reduction);
+    Py_RETURN_NONE;
+}
+
+static PyObject* strategy_set_montecarlo_checkpoint(PyObject* self, PyObject* args){
+    const char* filename;
+    double interval_seconds;
+    if (!PyArg_ParseTuple(args, "sd", &filename, &interval_seconds))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        get_strategy(self)->set_montecarlo_checkpoint(filename, interval_seconds);
+        Py_RETURN_NONE;
+    });
+}
+
+static PyObject* strategy_run_montecarlo_simulations(PyObject* self, PyObject* args){
+    size_t nb_simu;
+    if (!PyArg_ParseTuple(args, "O&", convert_size, &nb_simu))
+        return nullptr;
+    Strategy* strategy = get_strategy(self);
+    return call([&]() -> PyObject* {
+        run_without_gil(self, [strategy, nb_simu]{ strategy->run_montecarlo_simulations(nb_simu); });
+        Py_RETURN_NONE;
+    });
+}
+
+// A copy: the end values of the strategy are replaced by its next run
+static PyObject* strategy_get_montecarlo_end_values(PyObject* self, PyObject*){
+    return call([&]{ return get_owned_array(value_descr, std::vector<double>(get_strategy(self)->get_montecarlo_end_values())); });
+}
+
+// None before the first Monte Carlo run
+static PyObject* strategy_get_montecarlo_aggregator(PyObject* self, PyObject*){
+    if (!get_strategy(self)->get_montecarlo_aggregator())
+        Py_RETURN_NONE;
+    return new_strategy_member(aggregator_type, self);
+}
+
+static PyObject* strategy_get_montecarlo_throughput(PyObject* self, PyObject*){
+    const MonteCarloThroughput& throughput = get_strategy(self)->get_montecarlo_throughput();
+    return get_namespace(Py_BuildValue("{s:n,s:n,s:d,s:d}", "nb_threads", (Py_ssize_t)throughput.nb_threads, "nb_paths", (Py_ssize_t)throughput.nb_paths,
+                                       "elapsed_seconds", throughput.elapsed_seconds, "paths_per_second", throughput.paths_per_second));
+}
+
+static PyObject* strategy_get_montecarlo_estimates(PyObject* self, PyObject*){
+    return call([&]{
+        const MonteCarloEstimates& estimates = get_strategy(self)->get_montecarlo_estimates();
+        return get_namespace(Py_BuildValue("{s:n,s:d,s:d,s:N,s:N,s:N,s:d,s:d}", "nb_replicates", (Py_ssize_t)estimates.nb_replicates,
+                                           "mean", estimates.mean, "mean_standard_error", estimates.mean_standard_error,
+                                           "quantile_levels", get_list(estimates.quantile_levels), "quantiles", get_list(estimates.quantiles),
+                                           "quantile_standard_errors", get_list(estimates.quantile_standard_errors),
+                                           "probability_of_loss", estimates.probability_of_loss,
+                                           "probability_of_loss_standard_error", estimates.probability_of_loss_standard_error));
+    });
+}
+
+static PyMethodDef strategy_methods[] = {
+    {"run_strategy", if_idle<strategy_run_strategy>, METH_NOARGS, nullptr},
+    {"get_strategy_values", if_idle<strategy_get_strategy_values>, METH_NOARGS, nullptr},
+    {"get_strategy_total_returns", if_idle<strategy_get_metric<&Strategy::get_strategy_total_returns>>, METH_NOARGS, nullptr},
+    {"get_strategy_extended_internal_return_rate", if_idle<strategy_get_strategy_extended_internal_return_rate>, METH_VARARGS, nullptr},
+    {"get_strategy_volatility", if_idle<strategy_get_metric<&Strategy::get_strategy_volatility>>, METH_NOARGS, nullptr},
+    {"get_strategy_max_drawdown", if_idle<strategy_get_metric<&Strategy::get_strategy_max_drawdown>>, METH_NOARGS, nullptr},
+    {"save_end_portfolio", if_idle<strategy_save_end_portfolio>, METH_NOARGS, nullptr},
+    {"set_background_output", if_idle<strategy_set_background_output>, METH_VARARGS, nullptr},
+    {"set_output_format", if_idle<strategy_set_output_format>, METH_VARARGS, nullptr},
+    {"get_portfolio", if_idle<strategy_get_portfolio>, METH_NOARGS, nullptr},
+    {"save_snapshot", if_idle<strategy_save_snapshot>, METH_VARARGS, nullptr},
+    {"load_snapshot", if_idle<strategy_load_snapshot>, METH_VARARGS, nullptr},
+    {"set_montecarlo_config", if_idle<strategy_set_montecarlo_config>, METH_VARARGS, nullptr},
+    {"set_montecarlo_model", if_idle<strategy_set_montecarlo_model>, METH_VARARGS, nullptr},
+    {"set_montecarlo_bootstrap", if_idle<strategy_set_montecarlo_bootstrap>, METH_VARARGS, nullptr},
+    {"set_montecarlo_variance_reduction", if_idle<strategy_set_montecarlo_variance_reduction>, METH_VARARGS, nullptr},
+    {"set_montecarlo_checkpoint", if_idle<strategy_set_montecarlo_checkpoint>, METH_VARARGS, nullptr},
+    {"run_montecarlo_simulations", if_idle<strategy_run_montecarlo_simulations>, METH_VARARGS, nullptr},
+    {"get_montecarlo_end_values", if_idle<strategy_get_montecarlo_end_values>, METH_NOARGS, nullptr},
+    {"get_montecarlo_aggregator", if_idle<strategy_get_montecarlo_aggregator>, METH_NOARGS, nullptr},
+    {"get_montecarlo_throughput", if_idle<strategy_get_montecarlo_throughput>, METH_NOARGS, nullptr},
+    {"get_montecarlo_estimates", if_idle<strategy_get_montecarlo_estimates>, METH_NOARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot strategy_slots[] = {
+    {Py_tp_dealloc, (void*)strategy_dealloc},
+    {Py_tp_methods, strategy_methods},
+    {Py_tp_doc, (void*)"Base of the DCA, SmaOptimizedDCA and LumpSum strategies"},
+    {0, nullptr}
+};
+
+static PyType_Spec strategy_spec = {"portfolio_simulator.Strategy", sizeof(StrategyObject), 0,
+                                    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_DISALLOW_INSTANTIATION, strategy_slots};
+
+// DCA(tickers_yt, starting_amount, recurrent_amount, allocations, rebalancing_freq, rebalancing_threshold, name)
+static PyObject* dca_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    std::vector<YahooTimeseries> tickers_yt;
+    double starting_amount, recurrent_amount, rebalancing_threshold;
+    std::map<std::string, double> allocations;
+    int rebalancing_freq;
+    const char* name;
+    if (!has_no_kwargs(kwargs) || !PyArg_ParseTuple(args, "O&ddO&ids", convert_tickers_yt, &tickers_yt, &starting_amount, &recurrent_amount,
+                                                    convert_allocations, &allocations, &rebalancing_freq, &rebalancing_threshold, &name))
+        return nullptr;
+    return new_strategy(type, [&]{ return new DCA(tickers_yt, starting_amount, recurrent_amount, allocations, rebalancing_freq, rebalancing_threshold, name); });
+}
+
+template <typename T>
+static PyObject* set_rebalancing_mode(PyObject* self, PyObject* args){
+    RebalancingThreshold rebalancing_mode;
+    if (!PyArg_ParseTuple(args, "O&", convert_rebalancing_threshold, &rebalancing_mode))
+        return nullptr;
+    static_cast<T*>(get_strategy(self))->set_rebalancing_mode(rebalancing_mode);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef dca_methods[] = {
+    {"set_rebalancing_mode", if_idle<set_rebalancing_mode<DCA>>, METH_VARARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot dca_slots[] = {
+    {Py_tp_new, (void*)dca_new},
+    {Py_tp_methods, dca_methods},
+    {Py_tp_doc, (void*)"DCA(tickers_yt, starting_amount, recurrent_amount, allocations, rebalancing_freq, rebalancing_threshold, name)"},
+    {0, nullptr}
+};
+
+static PyType_Spec dca_spec = {"portfolio_simulator.DCA", sizeof(StrategyObject), 0, Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, dca_slots};
+
+// SmaOptimizedDCA(tickers_yt, starting_amount, recurrent_amount, allocations, rebalancing_freq, rebalancing_threshold, sma_window_size, name)
+static PyObject* sma_optimized_dca_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    std::vector<YahooTimeseries> tickers_yt;
+    double starting_amount, recurrent_amount, rebalancing_threshold;
+    std::map<std::string, double> allocations;
+    int rebalancing_freq, sma_window_size;
+    const char* name;
+    if (!has_no_kwargs(kwargs) || !PyArg_ParseTuple(args, "O&ddO&idis", convert_tickers_yt, &tickers_yt, &starting_amount, &recurrent_amount,
+                                                    convert_allocations, &allocations, &rebalancing_freq, &rebalancing_threshold, &sma_window_size, &name))
+        return nullptr;
+    return new_strategy(type, [&]{
+        return new SmaOptimizedDCA(tickers_yt, starting_amount, recurrent_amount, allocations, rebalancing_freq, rebalancing_threshold, sma_window_size, name);
+    });
+}
+
+static PyType_Slot sma_optimized_dca_slots[] = {
+    {Py_tp_new, (void*)sma_optimized_dca_new},
+    {Py_tp_doc, (void*)"SmaOptimizedDCA(tickers_yt, starting_amount, recurrent_amount, allocations, rebalancing_freq, rebalancing_threshold, sma_window_size, name)"},
+    {0, nullptr}
+};
+
+static PyType_Spec sma_optimized_dca_spec = {"portfolio_simulator.SmaOptimizedDCA", sizeof(StrategyObject), 0, Py_TPFLAGS_DEFAULT, sma_optimized_dca_slots};
+
+// LumpSum(tickers_yt, initial_amount, allocations, rebalancing_freq, rebalancing_threshold, name)
+static PyObject* lump_sum_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    std::vector<YahooTimeseries> tickers_yt;
+    double initial_amount, rebalancing_threshold;
+    std::map<std::string, double> allocations;
+    int rebalancing_freq;
+    const char* name;
+    if (!has_no_kwargs(kwargs) || !PyArg_ParseTuple(args, "O&dO&ids", convert_tickers_yt, &tickers_yt, &initial_amount,
+                                                    convert_allocations, &allocations, &rebalancing_freq, &rebalancing_threshold, &name))
+        return nullptr;
+    return new_strategy(type, [&]{ return new LumpSum(tickers_yt, initial_amount, allocations, rebalancing_freq, rebalancing_threshold, name); });
+}
+
+static PyMethodDef lump_sum_methods[] = {
+    {"set_rebalancing_mode", if_idle<set_rebalancing_mode<LumpSum>>, METH_VARARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot lump_sum_slots[] = {
+    {Py_tp_new, (void*)lump_sum_new},
+    {Py_tp_methods, lump_sum_methods},
+    {Py_tp_doc, (void*)"LumpSum(tickers_yt, initial_amount, allocations, rebalancing_freq, rebalancing_threshold, name)"},
+    {0, nullptr}
+};
+
+static PyType_Spec lump_sum_spec = {"portfolio_simulator.LumpSum", sizeof(StrategyObject), 0, Py_TPFLAGS_DEFAULT, lump_sum_slots};
+
+// ResultFile: saved portfolios and Monte Carlo paths read in place from the mapping
+
+struct ResultFileObject {
+    PyObject_HEAD
+    const ResultFile* results;
+};
+
+static const ResultFile& get_result_file(PyObject* self){
+    return *reinterpret_cast<ResultFileObject*>(self)->results;
+}
+
+static PyObject* result_file_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    const char* filename;
+    if (!has_no_kwargs(kwargs) || !PyArg_ParseTuple(args, "s", &filename))
+        return nullptr;
+    return call([&]() -> PyObject* {
+        ResultFileObject* object = new_object<ResultFileObject>(type);
+        if (object)
+            object->results = new ResultFile(filename);
+        return (PyObject*)object;
+    });
+}
+
+static void result_file_dealloc(PyObject* self){
+    delete reinterpret_cast<ResultFileObject*>(self)->results;
+    free_object(self);
+}
+
+static PyObject* result_file_is_open(PyObject* self, PyObject*){
+    return PyBool_FromLong(get_result_file(self).is_open());
+}
+
+static PyObject* result_file_get_nb_rows(PyObject* self, PyObject*){
+    return PyLong_FromSize_t(get_result_file(self).get_nb_rows());
+}
+
+static PyObject* result_file_get_nb_columns(PyObject* self, PyObject*){
+    return PyLong_FromSize_t(get_result_file(self).get_nb_columns());
+}
+
+static PyObject* result_file_get_column_names(PyObject* self, PyObject*){
+    return call([&]{ return get_list(get_result_file(self).get_column_names()); });
+}
+
+static PyObject* result_file_get_column_index(PyObject* self, PyObject* args){
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name))
+        return nullptr;
+    return call([&]{ return PyLong_FromLong(get_result_file(self).get_column_index(name)); });
+}
+
+static PyObject* result_file_get_dates(PyObject* self, PyObject*){
+    const ResultFile& results = get_result_file(self);
+    return get_borrowed_array(date_descr, results.get_dates(), results.get_nb_rows(), self);
+}
+
+static PyObject* result_file_get_column(PyObject* self, PyObject* args){
+    size_t column_idx;
+    if (!PyArg_ParseTuple(args, "O&", convert_size, &column_idx))
+        return nullptr;
+    const ResultFile& results = get_result_file(self);
+    if (column_idx >= results.get_nb_columns()){
+        PyErr_SetString(PyExc_IndexError, "column index out of range");
+        return nullptr;
+    }
+    return get_borrowed_array(value_descr, results.get_column(column_idx), results.get_nb_rows(), self);
+}
+
+static PyObject* result_file_export_csv(PyObject* self, PyObject* args){
+    const char* filename;
+    if (!PyArg_ParseTuple(args, "s", &filename))
+        return nullptr;
+    const ResultFile& results = get_result_file(self);
+    return call([&]{ return PyBool_FromLong(run_without_gil([&]{ return results.export_csv(filename); })); });
+}
+
+static PyMethodDef result_file_methods[] = {
+    {"is_open", result_file_is_open, METH_NOARGS, nullptr},
+    {"get_nb_rows", result_file_get_nb_rows, METH_NOARGS, nullptr},
+    {"get_nb_columns", result_file_get_nb_columns, METH_NOARGS, nullptr},
+    {"get_column_names", result_file_get_column_names, METH_NOARGS, nullptr},
+    {"get_column_index", result_file_get_column_index, METH_VARARGS, nullptr},
+    {"get_dates", result_file_get_dates, METH_NOARGS, nullptr},
+    {"get_column", result_file_get_column, METH_VARARGS, nullptr},
+    {"export_csv", result_file_export_csv, METH_VARARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot result_file_slots[] = {
+    {Py_tp_new, (void*)result_file_new},
+    {Py_tp_dealloc, (void*)result_file_dealloc},
+    {Py_tp_methods, result_file_methods},
+    {Py_tp_doc, (void*)"ResultFile(filename)"},
+    {0, nullptr}
+};
+
+static PyType_Spec result_file_spec = {"portfolio_simulator.ResultFile", sizeof(ResultFileObject), 0, Py_TPFLAGS_DEFAULT, result_file_slots};
+
+// Module
+
+// The type is kept in type and added to the module under name
+static bool add_type(PyObject* module, const char* name, PyType_Spec* spec, PyTypeObject* base, PyTypeObject*& type){
+    type = (PyTypeObject*)(base ? PyType_FromSpecWithBases(spec, (PyObject*)base) : PyType_FromSpec(spec));
+    return type && PyModule_AddObjectRef(module, name, (PyObject*)type) == 0;
+}
+
+// The enum values as int constants of a types.SimpleNamespace
+static bool add_enum(PyObject* module, const char* name, const std::vector<const char*>& value_names){
+    PyObject* values = PyDict_New();
+    for (size_t i = 0; values && i < value_names.size(); ++i){
+        PyObject* value = PyLong_FromSize_t(i);
+        if (!value || PyDict_SetItemString(values, value_names[i], value) < 0)
+            Py_CLEAR(values);
+        Py_XDECREF(value);
+    }
+    PyObject* enum_namespace = get_namespace(values);
+    bool is_added = enum_namespace && PyModule_AddObjectRef(module, name, enum_namespace) == 0;
+    Py_XDECREF(enum_namespace);
+    return is_added;
+}
+
+static struct PyModuleDef module_def = {
+    PyModuleDef_HEAD_INIT, "portfolio_simulator", "Backtests and Monte Carlo simulations of the portfolio simulator, columns exposed as NumPy arrays",
+    -1, nullptr, nullptr, nullptr, nullptr, nullptr
+};
+
+PyMODINIT_FUNC PyInit_portfolio_simulator(){
+    import_array();
+    PyObject* types_module = PyImport_ImportModule("types");
+    if (!types_module)
+        return nullptr;
+    simple_namespace = PyObject_GetAttrString(types_module, "SimpleNamespace");
+    Py_DECREF(types_module);
+    PyObject* date_dtype = PyUnicode_FromString("M8[s]");
+    if (!simple_namespace || !date_dtype || !PyArray_DescrConverter(date_dtype, &date_descr)){
+        Py_XDECREF(date_dtype);
+        return nullptr;
+    }
+    Py_DECREF(date_dtype);
+    value_descr = PyArray_DescrFromType(NPY_DOUBLE);
+
+    PyObject* module = PyModule_Create(&module_def);
+    if (!module)
+        return nullptr;
+    if (!add_enum(module, "OutputFormat", output_format_names) || !add_enum(module, "RebalancingThreshold", rebalancing_threshold_names) ||
+        !add_enum(module, "MonteCarloModel", montecarlo_model_names) || !add_enum(module, "BootstrapScheme", bootstrap_scheme_names) ||
+        !add_enum(module, "VarianceReduction", variance_reduction_names) ||
+        !add_type(module, "Timeseries", &timeseries_spec, nullptr, timeseries_type) ||
+        !add_type(module, "YahooTimeseries", &yahoo_timeseries_spec, nullptr, yahoo_timeseries_type) ||
+        !add_type(module, "YahooFinance", &yahoo_finance_spec, nullptr, yahoo_finance_type) ||
+        !add_type(module, "PortfolioBuilder", &portfolio_spec, nullptr, portfolio_type) ||
+        !add_type(module, "MonteCarloAggregator", &aggregator_spec, nullptr, aggregator_type) ||
+        !add_type(module, "Strategy", &strategy_spec, nullptr, strategy_type) ||
+        !add_type(module, "DCA", &dca_spec, strategy_type, dca_type) ||
+        !add_type(module, "SmaOptimizedDCA", &sma_optimized_dca_spec, dca_type, sma_optimized_dca_type) ||
+        !add_type(module, "LumpSum", &lump_sum_spec, strategy_type, lump_sum_type) ||
+        !add_type(module, "ResultFile", &result_file_spec, nullptr, result_file_type)){
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,149 @@
+import gc
+import os
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+import portfolio_simulator as ps
+
+
+def get_test_tickers_yt():
+    dates = np.datetime64("2020-01-01T12:00:00", "s") + np.arange(300) * np.timedelta64(1, "D")
+    rng = np.random.default_rng(11)
+    prices_a = 100.0 * np.cumprod(1.0 + 0.0005 + 0.02 * rng.standard_normal(300))
+    prices_b = 50.0 * np.cumprod(1.0 + 0.0001 + 0.005 * rng.standard_normal(300))
+    return [ps.YahooTimeseries("TICKER_A", dates, prices_a, prices_a, prices_a, prices_a, prices_a),
+            ps.YahooTimeseries("TICKER_B", dates, prices_b, prices_b, prices_b, prices_b, prices_b, {int(dates[100].astype(int)): 0.5})]
+
+
+def get_test_dca(name):
+    return ps.DCA(get_test_tickers_yt(), 1000.0, 100.0, {"TICKER_A": 0.6, "TICKER_B": 0.4}, 30, 0.01, name)
+
+
+class TimeseriesTests(unittest.TestCase):
+    def test_views(self):
+        # Read-only views of the C++ buffers, keeping the Timeseries alive
+        dates = np.arange(5) * 86400 + 1577880000
+        ts = ps.Timeseries(dates, [1.0, 2.0, 4.0, 8.0, 16.0])
+        values = ts.get_values()
+        ts_dates = ts.get_dates()
+        self.assertEqual(len(ts), 5)
+        self.assertEqual(ts_dates.dtype, np.dtype("datetime64[s]"))
+        self.assertFalse(values.flags.writeable)
+        with self.assertRaises(ValueError):
+            values[0] = 3.0
+        del ts
+        gc.collect()
+        np.testing.assert_array_equal(values, [1.0, 2.0, 4.0, 8.0, 16.0])
+        np.testing.assert_array_equal(ts_dates.astype(np.int64), dates)
+
+        ts = ps.Timeseries(dict(zip(dates.tolist(), values.tolist())))
+        self.assertEqual(ts.get_ts_values(), dict(zip(dates.tolist(), values.tolist())))
+        np.testing.assert_allclose(ts.get_pct_changes(), [1.0, 1.0, 1.0, 1.0])
+        self.assertEqual(len(ts.get_simple_moving_averages(2)), 4)
+
+    def test_yahoo_timeseries_columns(self):
+        # The Timeseries of a YahooTimeseries keep it alive
+        ticker_yt = get_test_tickers_yt()[1]
+        closes = ticker_yt.get_closes()
+        expected = closes.get_values().copy()
+        self.assertEqual(ticker_yt.get_ticker(), "TICKER_B")
+        self.assertEqual(len(ticker_yt.get_dividends()), 1)
+        del ticker_yt
+        gc.collect()
+        np.testing.assert_array_equal(closes.get_values(), expected)
+
+    def test_errors(self):
+        with self.assertRaises(ValueError):
+            ps.Timeseries([1, 2], [1.0])
+        with self.assertRaises(TypeError):
+            ps.DCA([1.0], 1000.0, 100.0, {}, 30, 0.01, "DCA_Error_Test")
+        with self.assertRaises(TypeError):
+            ps.Strategy()
+        with self.assertRaises(ValueError):
+            get_test_dca("DCA_Error_Test").set_montecarlo_model(7)
+        results = ps.ResultFile("../strat_outputs/missing.res")
+        self.assertFalse(results.is_open())
+        with self.assertRaises(IndexError):
+            results.get_column(0)
+
+
+class StrategyTests(unittest.TestCase):
+    def test_portfolio_results(self):
+        dca = get_test_dca("DCA_Python_Test")
+        dca.run_strategy()
+        ptf = dca.get_portfolio()
+        values = dca.get_strategy_values()
+        del dca
+        gc.collect()
+        # The portfolio keeps its strategy alive
+        results = ptf.get_results()
+        self.assertEqual(list(results), ["Date", "Value", "P&L", "Investments"])
+        self.assertEqual(results["Date"].dtype, np.dtype("datetime64[s]"))
+        for column in ("Value", "P&L", "Investments"):
+            self.assertEqual(len(results[column]), len(results["Date"]))
+        self.assertEqual(len(values), 300)
+        self.assertAlmostEqual(ptf.get_ts_portfolio_values().get_values()[-1], list(values.values())[-1])
+
+    def test_montecarlo_results(self):
+        # End values are copies and the aggregator follows the last run
+        dca = get_test_dca("DCA_Python_MonteCarlo_Test")
+        dca.run_strategy()
+        self.assertIsNone(dca.get_montecarlo_aggregator())
+        dca.set_montecarlo_config(9, 2, np.datetime64("2025-01-01T12:00:00", "s"), False)
+        dca.set_montecarlo_model(ps.MonteCarloModel.CORRELATED_ASSETS)
+        dca.run_montecarlo_simulations(8)
+        end_values = dca.get_montecarlo_end_values()
+        first_end_values = end_values.copy()
+        aggregator = dca.get_montecarlo_aggregator()
+        self.assertEqual(aggregator.get_nb_paths(), 8)
+        self.assertEqual(dca.get_montecarlo_throughput().nb_paths, 8)
+        estimates = dca.get_montecarlo_estimates()
+        self.assertEqual(len(estimates.quantiles), len(estimates.quantile_levels))
+
+        dca.set_montecarlo_config(10, 2, np.datetime64("2025-01-01T12:00:00", "s"), False)
+        dca.run_montecarlo_simulations(4)
+        del dca
+        gc.collect()
+        os.remove("../strat_outputs/DCA_Python_MonteCarlo_Test_MonteCarloSummary.csv")
+        np.testing.assert_array_equal(end_values, first_end_values)
+        self.assertEqual(aggregator.get_nb_paths(), 4)
+        self.assertGreater(aggregator.get_mean(len(aggregator.get_dates()) - 1), 0.0)
+        with self.assertRaises(IndexError):
+            aggregator.get_std(len(aggregator.get_dates()))
+
+    def test_threads(self):
+        # Strategies run in parallel from Python threads give the sequential results
+        dcas = [get_test_dca("DCA_Thread_Test_%d" % i) for i in range(4)]
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            list(executor.map(lambda dca: dca.run_strategy(), dcas))
+        expected = get_test_dca("DCA_Thread_Test")
+        expected.run_strategy()
+        for dca in dcas:
+            self.assertEqual(dca.get_strategy_values(), expected.get_strategy_values())
+
+    def test_running_strategy(self):
+        # A strategy running in another thread raises instead of being read or run again
+        dca = get_test_dca("DCA_Running_Test")
+        dca.run_strategy()
+        dca.set_montecarlo_config(9, 1, np.datetime64("2025-01-01T12:00:00", "s"), False)
+        portfolio = dca.get_portfolio()
+        nb_errors = 0
+        with ThreadPoolExecutor(max_workers=1) as executor:
+            future = executor.submit(dca.run_montecarlo_simulations, 2000)
+            while not future.done():
+                for method in (dca.get_strategy_values, dca.run_strategy, portfolio.get_results):
+                    try:
+                        method()
+                    except RuntimeError:
+                        nb_errors += 1
+            future.result()
+        os.remove("../strat_outputs/DCA_Running_Test_MonteCarloSummary.csv")
+        self.assertGreater(nb_errors, 0)
+        dca.run_strategy()
+        self.assertEqual(len(dca.get_strategy_values()), 300)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,59 @@
+#include "../headers/adaptive_montecarlo.hpp"
+#include "../headers/quasi_random.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+double get_student_t_quantile(double p, double dof){
+    assert(dof > 0 && "Error: the degrees of freedom must be > 0\n");
+    double z = get_inverse_normal_cdf(p);
+    double z2 = z * z;
+    return z + z * (z2 + 1.0) / (4.0 * dof)
+             + z * ((5.0 * z2 + 16.0) * z2 + 3.0) / (96.0 * dof * dof)
+             + z * (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) / (384.0 * dof * dof * dof)
+             + z * ((((79.0 * z2 + 776.0) * z2 + 1482.0) * z2 - 1920.0) * z2 - 945.0) / (92160.0 * dof * dof * dof * dof);
+}
+
+std::string get_statistic_name(MonteCarloStatistic statistic){
+    switch (statistic){
+        case MonteCarloStatistic::MEDIAN_END_VALUE: return "median end value";
+        case MonteCarloStatistic::P5_END_VALUE: return "5% end value";
+        default: return "probability of loss";
+    }
+}
+
+static size_t get_quantile_idx(const MonteCarloEstimates& estimates, double level){
+    auto it = std::find(estimates.quantile_levels.begin(), estimates.quantile_levels.end(), level);
+    assert(it != estimates.quantile_levels.end() && "Error: the quantile is not estimated\n");
+    return it - estimates.quantile_levels.begin();
+}
+
+MonteCarloConvergence get_montecarlo_convergence(const MonteCarloEstimates& estimates, const MonteCarloStoppingRule& stopping_rule, bool& has_converged){
+    assert(stopping_rule.confidence_level > 0 && stopping_rule.confidence_level < 1 && "Error: the confidence level must be in (0, 1)\n");
+    MonteCarloConvergence convergence = {0, 0, 0.0, MonteCarloStopReason::PRECISION_MET, {}, {}};
+    has_converged = estimates.nb_replicates >= 2;
+    double critical_value = (estimates.nb_replicates >= 2) ? get_student_t_quantile(0.5 + 0.5 * stopping_rule.confidence_level, estimates.nb_replicates - 1.0)
+                                                           : std::numeric_limits<double>::infinity();
+    for (const auto& target: stopping_rule.targets){
+        double estimate, standard_error;
+        bool is_relative = target.statistic != MonteCarloStatistic::PROBABILITY_OF_LOSS;
+        if (target.statistic == MonteCarloStatistic::PROBABILITY_OF_LOSS){
+            estimate = estimates.probability_of_loss;
+            standard_error = estimates.probability_of_loss_standard_error;
+        }
+        else {
+            size_t idx = get_quantile_idx(estimates, target.statistic == MonteCarloStatistic::MEDIAN_END_VALUE ? 0.5 : 0.05);
+            estimate = estimates.quantiles[idx];
+            standard_error = estimates.quantile_standard_errors[idx];
+        }
+        double half_width = critical_value * standard_error;
+        if (is_relative)
+            half_width /= std::abs(estimate);
+        // NaN (no replicate spread yet) never meets a target
+        has_converged = has_converged && half_width <= target.max_half_width;
+        convergence.estimates.push_back(estimate);
+        convergence.half_widths.push_back(half_width);
+    }
+    return convergence;
+}
@@ -0,0 +1,291 @@
+#include "../headers/bar_file.hpp"
+#include "../headers/serialization.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(sizeof(std::time_t) == sizeof(int64_t), "Bar files store 64-bit times");
+
+static const uint64_t BAR_FILE_MAGIC = 0x31454C4946524142; // "BARFILE1"
+// Alignment of the header and blocks in the file, part of the format whatever the page size of the reading system
+static const size_t BAR_FILE_ALIGNMENT = 4096;
+static const size_t HEADER_FIELDS_SIZE = 5 * sizeof(uint64_t);
+static const size_t NB_BARS_OFFSET = 2 * sizeof(uint64_t);
+
+static size_t get_aligned(size_t size){
+    return (size + BAR_FILE_ALIGNMENT - 1) / BAR_FILE_ALIGNMENT * BAR_FILE_ALIGNMENT;
+}
+
+static size_t get_page_size(){
+    static const size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+BarFileWriter::BarFileWriter(std::string filename, const std::vector<std::string>& tickers, size_t block_size)
+: filename(filename), nb_tickers(tickers.size()), block_size(block_size), nb_bars(0), block_row(0),
+  block_times(block_size, 0), block_values(2 * tickers.size() * block_size, 0.0), is_written(true){
+    assert(block_size > 0 && block_size % (BAR_FILE_ALIGNMENT / sizeof(double)) == 0 && "Error: the block size must be a multiple of 512 rows\n");
+    size_t header_size = HEADER_FIELDS_SIZE;
+    for (const auto& ticker: tickers)
+        header_size += sizeof(uint64_t) + ticker.size();
+    ByteWriter writer;
+    writer.put(BAR_FILE_MAGIC);
+    writer.put<uint64_t>(block_size);
+    writer.put<uint64_t>(0); // number of bars, written by close()
+    writer.put<uint64_t>(get_aligned(header_size));
+    writer.put<uint64_t>(tickers.size());
+    for (const auto& ticker: tickers)
+        writer.put_string(ticker);
+    std::string header = writer.get_bytes();
+    header.resize(get_aligned(header_size), '\0');
+
+    this->file = fopen(filename.c_str(), "wb");
+    if (this->file == nullptr){
+        fprintf(stderr, "Error: can't write the bar file %s\n", filename.c_str());
+        this->is_written = false;
+        return;
+    }
+    this->is_written = fwrite(header.data(), 1, header.size(), this->file) == header.size();
+}
+
+void BarFileWriter::append(std::time_t time, const double* closes, const double* dividends){
+    assert((this->nb_bars == 0 || time > this->block_times[(this->block_row + this->block_size - 1) % this->block_size]) && "Error: bar times must be increasing\n");
+    size_t n = this->block_size;
+    this->block_times[this->block_row] = time;
+    for (size_t t = 0; t < this->nb_tickers; ++t){
+        this->block_values[t * n + this->block_row] = closes[t];
+        this->block_values[(this->nb_tickers + t) * n + this->block_row] = (dividends != nullptr) ? dividends[t] : 0.0;
+    }
+    ++this->nb_bars;
+    if (++this->block_row == n)
+        this->write_block();
+}
+
+void BarFileWriter::write_block(){
+    if (this->file != nullptr && this->is_written){
+        this->is_written = fwrite(this->block_times.data(), sizeof(int64_t), this->block_size, this->file) == this->block_size
+                           && fwrite(this->block_values.data(), sizeof(double), this->block_values.size(), this->file) == this->block_values.size();
+    }
+    this->block_row = 0;
+}
+
+bool BarFileWriter::close(){
+    if (this->file == nullptr)
+        return false;
+    if (this->block_row > 0){
+        // The last block is padded to the full block size
+        std::fill(this->block_times.begin() + this->block_row, this->block_times.end(), 0);
+        for (size_t column = 0; column < 2 * this->nb_tickers; ++column)
+            std::fill(this->block_values.begin() + column * this->block_size + this->block_row, this->block_values.begin() + (column + 1) * this->block_size, 0.0);
+        this->write_block();
+    }
+    uint64_t nb_bars = this->nb_bars;
+    this->is_written = this->is_written && fseek(this->file, NB_BARS_OFFSET, SEEK_SET) == 0 && fwrite(&nb_bars, sizeof(uint64_t), 1, this->file) == 1;
+    this->is_written = (fclose(this->file) == 0) && this->is_written;
+    this->file = nullptr;
+    if (!this->is_written)
+        fprintf(stderr, "Error: can't write the bar file %s\n", this->filename.c_str());
+    return this->is_written;
+}
+
+BarFileWriter::~BarFileWriter(){
+    if (this->file != nullptr)
+        this->close();
+}
+
+bool write_bar_file(std::string filename, const std::vector<YahooTimeseries>& tickers_yt, size_t block_size){
+    std::vector<std::string> tickers;
+    std::vector<std::map<std::time_t, double>> closes, dividends;
+    for (const auto& ticker_yt: tickers_yt){
+        tickers.push_back(ticker_yt.get_ticker());
+        closes.push_back(ticker_yt.get_closes().get_ts_values());
+        dividends.push_back(ticker_yt.get_dividends().get_ts_values());
+    }
+    BarFileWriter writer(filename, tickers, block_size);
+    std::vector<double> row_closes(tickers.size()), row_dividends(tickers.size());
+    for (const auto& date: get_unique_dates(tickers_yt)){
+        for (size_t t = 0; t < tickers.size(); ++t){
+            auto close_it = closes[t].find(date);
+            row_closes[t] = (close_it != closes[t].end()) ? close_it->second : std::numeric_limits<double>::quiet_NaN();
+            auto dividend_it = dividends[t].find(date);
+            row_dividends[t] = (dividend_it != dividends[t].end()) ? dividend_it->second : 0.0;
+        }
+        writer.append(date, row_closes.data(), row_dividends.data());
+    }
+    return writer.close();
+}
+
+
+BarSource::BarSource(std::string filename)
+: nb_bars(0), block_size(0), data_offset(0), block_bytes(0), fd(-1), mapping(nullptr), mapping_size(0){
+    this->fd = open(filename.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (this->fd < 0 || fstat(this->fd, &file_stat) != 0 || file_stat.st_size < off_t(HEADER_FIELDS_SIZE)){
+        fprintf(stderr, "Error: can't read the bar file %s\n", filename.c_str());
+        return;
+    }
+    void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, this->fd, 0);
+    if (mapping == MAP_FAILED){
+        fprintf(stderr, "Error: can't map the bar file %s\n", filename.c_str());
+        return;
+    }
+    this->mapping = static_cast<char*>(mapping);
+    this->mapping_size = file_stat.st_size;
+
+    // The sizes of the header are checked against the file before anything is read past the fixed fields
+    const uint64_t* fields = reinterpret_cast<const uint64_t*>(this->mapping);
+    uint64_t block_size = fields[1], nb_bars = fields[2], data_offset = fields[3], nb_tickers = fields[4];
+    bool is_valid = fields[0] == BAR_FILE_MAGIC && data_offset >= HEADER_FIELDS_SIZE && data_offset <= this->mapping_size
+                    && data_offset % BAR_FILE_ALIGNMENT == 0 && block_size > 0 && block_size % (BAR_FILE_ALIGNMENT / sizeof(double)) == 0
+                    && nb_tickers <= (data_offset - HEADER_FIELDS_SIZE) / sizeof(uint64_t);
+    if (is_valid){
+        std::string header(this->mapping + HEADER_FIELDS_SIZE, data_offset - HEADER_FIELDS_SIZE);
+        ByteReader reader(header);
+        for (size_t t = 0; t < nb_tickers; ++t)
+            this->tickers.push_back(reader.get_string());
+        // Every block must lie in the file, without overflowing the products
+        size_t data_size = this->mapping_size - data_offset;
+        size_t row_bytes = sizeof(int64_t) + 2 * nb_tickers * sizeof(double);
+        size_t nb_blocks = nb_bars / block_size + (nb_bars % block_size != 0);
+        is_valid = !reader.is_truncated() && (nb_blocks == 0 || (block_size <= data_size / row_bytes
+                                                                 && nb_blocks <= data_size / (block_size * row_bytes)));
+    }
+    if (!is_valid){
+        fprintf(stderr, "Error: the bar file %s is corrupted\n", filename.c_str());
+        munmap(this->mapping, this->mapping_size);
+        this->mapping = nullptr;
+        this->tickers.clear();
+        return;
+    }
+    this->block_size = block_size;
+    this->nb_bars = nb_bars;
+    this->data_offset = data_offset;
+    this->block_bytes = block_size * (sizeof(int64_t) + 2 * nb_tickers * sizeof(double));
+    madvise(this->mapping, this->mapping_size, MADV_SEQUENTIAL);
+}
+
+bool BarSource::is_open() const{
+    return this->mapping != nullptr;
+}
+
+size_t BarSource::get_nb_bars() const{
+    return this->nb_bars;
+}
+
+size_t BarSource::get_chunk_size() const{
+    return this->block_size;
+}
+
+size_t BarSource::get_nb_chunks() const{
+    return (this->block_size > 0) ? (this->nb_bars + this->block_size - 1) / this->block_size : 0;
+}
+
+const std::vector<std::string>& BarSource::get_tickers() const{
+    return this->tickers;
+}
+
+BarChunk BarSource::get_chunk(size_t chunk_idx) const{
+    assert(chunk_idx < this->get_nb_chunks() && "Error: chunk index out of range\n");
+    size_t nb_tickers = this->tickers.size();
+    const char* block = this->mapping + this->data_offset + chunk_idx * this->block_bytes;
+    const double* columns = reinterpret_cast<const double*>(block + this->block_size * sizeof(int64_t));
+    BarChunk chunk;
+    chunk.first_bar = chunk_idx * this->block_size;
+    chunk.nb_bars = std::min(this->block_size, this->nb_bars - chunk.first_bar);
+    chunk.times = reinterpret_cast<const std::time_t*>(block);
+    for (size_t t = 0; t < nb_tickers; ++t){
+        chunk.closes.push_back(columns + t * this->block_size);
+        chunk.dividends.push_back(columns + (nb_tickers + t) * this->block_size);
+    }
+    return chunk;
+}
+
+void BarSource::prefetch(size_t chunk_idx) const{
+    // madvise needs page-aligned addresses: the block is widened to whole pages, which are only read
+    size_t page_size = get_page_size();
+    size_t begin = (this->data_offset + chunk_idx * this->block_bytes) / page_size * page_size;
+    size_t end = this->data_offset + (chunk_idx + 1) * this->block_bytes;
+    madvise(this->mapping + begin, end - begin, MADV_WILLNEED);
+    // Touching one byte per page waits for the reads here rather than in the consumer
+    volatile char sink = 0;
+    for (size_t offset = begin; offset < end; offset += page_size)
+        sink += this->mapping[offset];
+}
+
+void BarSource::release(size_t chunk_idx) const{
+    // Only the pages lying entirely in the block are dropped, the pages shared with chunk k + 1 being prefetched
+    size_t page_size = get_page_size();
+    size_t begin = (this->data_offset + chunk_idx * this->block_bytes + page_size - 1) / page_size * page_size;
+    size_t end = (this->data_offset + (chunk_idx + 1) * this->block_bytes) / page_size * page_size;
+    if (begin < end)
+        madvise(this->mapping + begin, end - begin, MADV_DONTNEED);
+}
+
+void BarSource::stream(const std::function<void(const BarChunk&)>& consumer) const{
+    size_t nb_chunks = this->get_nb_chunks();
+    if (nb_chunks == 0)
+        return;
+    this->prefetch(0);
+    // One prefetch thread for the whole stream: chunks [0, nb_requested) may be prefetched, [0, nb_prefetched) are
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t nb_requested = 1, nb_prefetched = 1;
+    bool is_stopped = false;
+    std::thread prefetcher([&](){
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true){
+            condition.wait(lock, [&](){ return is_stopped || nb_prefetched < nb_requested; });
+            if (is_stopped)
+                return;
+            size_t chunk_idx = nb_prefetched;
+            lock.unlock();
+            this->prefetch(chunk_idx);
+            lock.lock();
+            ++nb_prefetched;
+            condition.notify_all();
+        }
+    });
+    auto stop_prefetcher = [&](){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            is_stopped = true;
+        }
+        condition.notify_all();
+        prefetcher.join();
+    };
+    try {
+        for (size_t k = 0; k < nb_chunks; ++k){
+            size_t nb_needed = std::min(k + 2, nb_chunks);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                nb_requested = nb_needed;
+            }
+            condition.notify_all();
+            consumer(this->get_chunk(k));
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&](){ return nb_prefetched >= nb_needed; });
+            }
+            this->release(k);
+        }
+    } catch (...){
+        stop_prefetcher();
+        throw;
+    }
+    stop_prefetcher();
+}
+
+BarSource::~BarSource(){
+    if (this->mapping != nullptr)
+        munmap(this->mapping, this->mapping_size);
+    if (this->fd >= 0)
+        ::close(this->fd);
+}
@@ -0,0 +1,217 @@
+#include "../headers/batch_engine.hpp"
+#include <cassert>
+#include <algorithm>
+
+BatchEngine::BatchEngine(const std::vector<BatchPortfolio>& portfolios, RebalancingThreshold rebalancing_mode)
+: nb_portfolios(portfolios.size()), nb_assets(portfolios.empty() ? 0 : portfolios[0].allocations.size()), rebalancing_mode(rebalancing_mode){
+    assert(!portfolios.empty() && "Error: at least one portfolio is needed\n");
+    this->allocations.resize(this->nb_assets * this->nb_portfolios);
+    for (size_t p = 0; p < this->nb_portfolios; ++p){
+        const BatchPortfolio& portfolio = portfolios[p];
+        assert(portfolio.allocations.size() == this->nb_assets && "Error: every portfolio must have one allocation per asset\n");
+        this->starting_amounts.push_back(portfolio.starting_amount);
+        this->recurrent_investment_amounts.push_back(portfolio.recurrent_investment_amount);
+        this->rebalancing_freqs.push_back(portfolio.rebalancing_freq);
+        this->rebalancing_thresholds.push_back(portfolio.rebalancing_threshold);
+        for (size_t a = 0; a < this->nb_assets; ++a)
+            this->allocations[a * this->nb_portfolios + p] = portfolio.allocations[a];
+    }
+    this->reset();
+}
+
+BatchEngine::BatchEngine(const BatchPortfolio& portfolio, size_t nb_portfolios, RebalancingThreshold rebalancing_mode)
+: BatchEngine(std::vector<BatchPortfolio>(nb_portfolios, portfolio), rebalancing_mode){}
+
+void BatchEngine::reset(){
+    size_t nb_states = this->nb_assets * this->nb_portfolios;
+    this->shares.assign(nb_states, 0.0);
+    this->expenses.assign(nb_states, 0.0);
+    this->pending_starting_amounts.resize(nb_states);
+    for (size_t a = 0; a < this->nb_assets; ++a)
+        for (size_t p = 0; p < this->nb_portfolios; ++p)
+            this->pending_starting_amounts[a * this->nb_portfolios + p] = this->starting_amounts[p];
+    this->last_rebalancing_nb_days.assign(this->nb_portfolios, 0);
+    this->cash_flows.assign(this->nb_portfolios, 0.0);
+    this->net_investments.assign(this->nb_portfolios, 0.0);
+    this->ptf_values.assign(this->nb_portfolios, 0.0);
+    this->is_rebalancing.assign(this->nb_portfolios, 0);
+    this->is_band_breached.assign(this->nb_portfolios, 0);
+}
+
+void BatchEngine::step(const double* const* asset_prices, size_t price_stride, const double* dividends, const char* is_contribution_dates){
+    size_t n = this->nb_portfolios;
+    double* cash_flows = this->cash_flows.data();
+    std::fill(this->cash_flows.begin(), this->cash_flows.end(), 0.0);
+
+    for (size_t a = 0; a < this->nb_assets; ++a){
+        const double* prices = asset_prices[a];
+        double* shares = this->shares.data() + a * n;
+        double* expenses = this->expenses.data() + a * n;
+
+        if (is_contribution_dates[a]){
+            const double* allocations = this->allocations.data() + a * n;
+            const double* recurrent_amounts = this->recurrent_investment_amounts.data();
+            double* pending_amounts = this->pending_starting_amounts.data() + a * n;
+            for (size_t p = 0; p < n; ++p){
+                double price = prices[p * price_stride];
+                double amount = allocations[p] * (recurrent_amounts[p] + pending_amounts[p]);
+                double invested = (price > 0 && amount > 0) ? amount : 0.0;
+                shares[p] += (price > 0) ? invested / price : 0.0;
+                expenses[p] += invested;
+                cash_flows[p] -= invested;
+                pending_amounts[p] = 0.0;
+            }
+        }
+
+        if (dividends != nullptr && dividends[a] > 0){
+            double dividend = DIVIDEND_REINVESTMENT_RATIO * dividends[a];
+            for (size_t p = 0; p < n; ++p){
+                double price = prices[p * price_stride];
+                // the reinvested cash is dividend * shares whatever the price
+                double invested = (price > 0) ? dividend * shares[p] : 0.0;
+                shares[p] += (price > 0) ? invested / price : 0.0;
+                expenses[p] += invested;
+                cash_flows[p] -= invested;
+            }
+        }
+    }
+
+    bool has_rebalancing = false;
+    for (size_t p = 0; p < n; ++p){
+        bool is_rebalancing = this->last_rebalancing_nb_days[p] == this->rebalancing_freqs[p];
+        this->is_rebalancing[p] = is_rebalancing;
+        this->last_rebalancing_nb_days[p] = is_rebalancing ? 0 : this->last_rebalancing_nb_days[p] + 1;
+        has_rebalancing |= is_rebalancing;
+    }
+    if (has_rebalancing)
+        this->rebalance(asset_prices, price_stride);
+    for (size_t p = 0; p < n; ++p)
+        this->net_investments[p] -= cash_flows[p];
+}
+
+void BatchEngine::rebalance(const double* const* asset_prices, size_t price_stride){
+    size_t n = this->nb_portfolios;
+    this->get_portfolio_values(asset_prices, price_stride, this->ptf_values.data());
+    const double* ptf_values = this->ptf_values.data();
+    const char* is_rebalancing = this->is_rebalancing.data();
+    const double* thresholds = this->rebalancing_thresholds.data();
+    double* cash_flows = this->cash_flows.data();
+
+    // BAND: a first pass flags the portfolios with at least one asset out of its band, all their assets are then traded
+    bool is_band = this->rebalancing_mode == RebalancingThreshold::BAND;
+    char* is_band_breached = this->is_band_breached.data();
+    if (is_band){
+        std::fill(this->is_band_breached.begin(), this->is_band_breached.end(), 0);
+        for (size_t a = 0; a < this->nb_assets; ++a){
+            const double* prices = asset_prices[a];
+            const double* allocations = this->allocations.data() + a * n;
+            const double* shares = this->shares.data() + a * n;
+            for (size_t p = 0; p < n; ++p){
+                double ticker_alloc = shares[p] * prices[p * price_stride] / ptf_values[p];
+                double gap = ticker_alloc - allocations[p];
+                is_band_breached[p] |= gap > thresholds[p] || (ticker_alloc > 0 && -gap > thresholds[p]);
+            }
+        }
+    }
+    for (size_t a = 0; a < this->nb_assets; ++a){
+        const double* prices = asset_prices[a];
+        const double* allocations = this->allocations.data() + a * n;
+        double* shares = this->shares.data() + a * n;
+        double* expenses = this->expenses.data() + a * n;
+        for (size_t p = 0; p < n; ++p){
+            double price = prices[p * price_stride];
+            double target_alloc = allocations[p];
+            double ticker_alloc = shares[p] * price / ptf_values[p];
+            double gap = get_weight_drift(ticker_alloc, target_alloc, this->rebalancing_mode);
+            bool is_overweight = gap > thresholds[p];
+            bool is_underweight = ticker_alloc > 0 && -gap > thresholds[p];
+            bool is_traded = is_band ? is_band_breached[p] && ticker_alloc > 0 : is_overweight || is_underweight;
+            double delta_shares = (is_rebalancing[p] && is_traded) ? shares[p] * target_alloc / ticker_alloc - shares[p] : 0.0;
+            shares[p] += delta_shares;
+            expenses[p] += delta_shares * price;
+            cash_flows[p] -= delta_shares * price;
+        }
+    }
+}
+
+void BatchEngine::get_portfolio_values(const double* const* asset_prices, size_t price_stride, double* values) const{
+    size_t n = this->nb_portfolios;
+    std::fill(values, values + n, 0.0);
+    for (size_t a = 0; a < this->nb_assets; ++a){
+        const double* prices = asset_prices[a];
+        const double* shares = this->shares.data() + a * n;
+        for (size_t p = 0; p < n; ++p)
+            values[p] += shares[p] * prices[p * price_stride];
+    }
+}
+
+void BatchEngine::run(const MarketData& market_data, BatchContribution contribution, std::vector<double>& values){
+    assert(market_data.tickers.size() == this->nb_assets && "Error: the market data must have one ticker per asset\n");
+    size_t nb_dates = market_data.dates.size();
+    size_t n = this->nb_portfolios;
+    this->reset();
+    values.resize(nb_dates * n);
+
+    std::vector<const double*> asset_prices(this->nb_assets);
+    std::vector<double> dividends(this->nb_assets);
+    std::vector<char> is_contribution_dates(this->nb_assets);
+    for (size_t d = 0; d < nb_dates; ++d){
+        for (size_t a = 0; a < this->nb_assets; ++a){
+            asset_prices[a] = &market_data.closes[a][d];
+            dividends[a] = market_data.dividends[a][d];
+            if (contribution == BatchContribution::MONTHLY)
+                is_contribution_dates[a] = market_data.is_first_month_dates[a][d];
+            else
+                is_contribution_dates[a] = (market_data.first_date_indices[a] == d);
+        }
+        this->step(asset_prices.data(), 0, dividends.data(), is_contribution_dates.data());
+        this->get_portfolio_values(asset_prices.data(), 0, &values[d * n]);
+    }
+}
+
+void BatchEngine::run_paths(const std::vector<const double*>& asset_paths, size_t nb_steps, const std::vector<std::vector<char>>& is_contribution_dates, double* values){
+    assert(asset_paths.size() == this->nb_assets && is_contribution_dates.size() == this->nb_assets && "Error: one path buffer and one calendar per asset are needed\n");
+    size_t n = this->nb_portfolios;
+    this->reset();
+
+    std::vector<const double*> asset_prices(this->nb_assets);
+    std::vector<char> step_contributions(this->nb_assets);
+    for (size_t s = 0; s < nb_steps; ++s){
+        for (size_t a = 0; a < this->nb_assets; ++a){
+            asset_prices[a] = asset_paths[a] + s;
+            step_contributions[a] = is_contribution_dates[a][s];
+        }
+        this->step(asset_prices.data(), nb_steps, nullptr, step_contributions.data());
+        if (values != nullptr){
+            this->get_portfolio_values(asset_prices.data(), nb_steps, this->ptf_values.data());
+            for (size_t p = 0; p < n; ++p)
+                values[p * nb_steps + s] = this->ptf_values[p];
+        }
+    }
+}
+
+size_t BatchEngine::get_nb_portfolios() const{
+    return this->nb_portfolios;
+}
+
+size_t BatchEngine::get_nb_assets() const{
+    return this->nb_assets;
+}
+
+const double* BatchEngine::get_shares(size_t asset_idx) const{
+    return this->shares.data() + asset_idx * this->nb_portfolios;
+}
+
+const double* BatchEngine::get_expenses(size_t asset_idx) const{
+    return this->expenses.data() + asset_idx * this->nb_portfolios;
+}
+
+const double* BatchEngine::get_cash_flows() const{
+    return this->cash_flows.data();
+}
+
+const double* BatchEngine::get_net_investments() const{
+    return this->net_investments.data();
+}
+
+BatchEngine::~BatchEngine(){}
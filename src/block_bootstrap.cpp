@@ -0,0 +1,72 @@
+#include "../headers/block_bootstrap.hpp"
+#include <cassert>
+#include <algorithm>
+
+BlockBootstrapSimulator::BlockBootstrapSimulator(const std::vector<YahooTimeseries>& tickers_yt, BootstrapScheme scheme, double mean_block_length, uint64_t seed)
+: scheme(scheme), mean_block_length(mean_block_length), seed(seed){
+    assert(mean_block_length >= 1.0 && "Error: the mean block length must be >= 1\n");
+    for (const auto& ticker_yt: tickers_yt)
+        this->tickers.push_back(ticker_yt.get_ticker());
+    Eigen::MatrixXd returns = get_common_dates_returns(tickers_yt, this->start_prices);
+    this->nb_historical_returns = returns.rows();
+    this->returns.resize(returns.size());
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(this->returns.data(), returns.rows(), returns.cols()) = returns;
+}
+
+std::vector<size_t> BlockBootstrapSimulator::get_resampled_indices(size_t path_idx, size_t nb_returns) const{
+    Philox4x32 generator(this->seed, path_idx);
+    size_t n = this->nb_historical_returns;
+    size_t block_length = std::max<size_t>(1, size_t(this->mean_block_length));
+    double new_block_probability = 1.0 / this->mean_block_length;
+    std::vector<size_t> indices(nb_returns);
+    size_t idx = 0, remaining_block_length = 0;
+    for (size_t s = 0; s < nb_returns; ++s){
+        bool is_new_block = (this->scheme == BootstrapScheme::FIXED_BLOCKS) ? remaining_block_length == 0 : (s == 0 || generator.next_uniform() < new_block_probability);
+        if (is_new_block){
+            idx = std::min(n - 1, size_t(generator.next_uniform() * n));
+            remaining_block_length = block_length;
+        }
+        else
+            idx = (idx + 1 == n) ? 0 : idx + 1;
+        indices[s] = idx;
+        --remaining_block_length;
+    }
+    return indices;
+}
+
+void BlockBootstrapSimulator::generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps, const std::vector<double*>& asset_paths) const{
+    size_t nb_assets = this->tickers.size();
+    assert(asset_paths.size() == nb_assets && "Error: one path buffer per asset is needed\n");
+    if (nb_steps == 0)
+        return;
+
+    for (size_t p = 0; p < nb_paths; ++p){
+        std::vector<size_t> indices = this->get_resampled_indices(first_path_idx + p, nb_steps - 1);
+        for (size_t a = 0; a < nb_assets; ++a){
+            double* path = asset_paths[a] + p * nb_steps;
+            const double* returns = this->returns.data() + a;
+            path[0] = this->start_prices(a);
+            for (size_t s = 1; s < nb_steps; ++s)
+                path[s] = path[s - 1] * (1.0 + returns[indices[s - 1] * nb_assets]);
+        }
+    }
+}
+
+std::vector<std::vector<double>> BlockBootstrapSimulator::generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps) const{
+    std::vector<std::vector<double>> paths(this->tickers.size(), std::vector<double>(nb_paths * nb_steps));
+    std::vector<double*> asset_paths;
+    for (auto& asset_path: paths)
+        asset_paths.push_back(asset_path.data());
+    this->generate(first_path_idx, nb_paths, nb_steps, asset_paths);
+    return paths;
+}
+
+const std::vector<std::string>& BlockBootstrapSimulator::get_tickers() const{
+    return this->tickers;
+}
+
+size_t BlockBootstrapSimulator::get_nb_historical_returns() const{
+    return this->nb_historical_returns;
+}
+
+BlockBootstrapSimulator::~BlockBootstrapSimulator(){}
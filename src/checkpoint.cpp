@@ -0,0 +1,68 @@
+#include "../headers/checkpoint.hpp"
+#include "../headers/serialization.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+
+static const uint64_t CHECKPOINT_MAGIC = 0x31544E494F504B43; // "CKPOINT1"
+
+static uint64_t get_checksum(const std::string& bytes){
+    uint64_t hash = 0xCBF29CE484222325;
+    for (unsigned char byte: bytes){
+        hash ^= byte;
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+bool write_checkpoint(const std::string& filename, const std::string& payload){
+    ByteWriter writer;
+    writer.put(CHECKPOINT_MAGIC);
+    writer.put<uint64_t>(payload.size());
+    writer.put(get_checksum(payload));
+    std::string tmp_filename = filename + ".tmp";
+    FILE* file = fopen(tmp_filename.c_str(), "wb");
+    if (file == nullptr){
+        fprintf(stderr, "Error: can't write the checkpoint %s\n", tmp_filename.c_str());
+        return false;
+    }
+    bool is_written = fwrite(writer.get_bytes().data(), 1, writer.get_bytes().size(), file) == writer.get_bytes().size()
+                      && fwrite(payload.data(), 1, payload.size(), file) == payload.size()
+                      && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    is_written = (fclose(file) == 0) && is_written;
+    if (!is_written || rename(tmp_filename.c_str(), filename.c_str()) != 0){
+        fprintf(stderr, "Error: can't write the checkpoint %s\n", filename.c_str());
+        std::remove(tmp_filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool read_checkpoint(const std::string& filename, std::string& payload){
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        return false;
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t header_size = 3 * sizeof(uint64_t);
+    if (bytes.size() < header_size){
+        fprintf(stderr, "Error: the checkpoint %s is truncated\n", filename.c_str());
+        return false;
+    }
+    std::string header = bytes.substr(0, header_size);
+    ByteReader reader(header);
+    uint64_t magic = reader.get<uint64_t>();
+    uint64_t payload_size = reader.get<uint64_t>();
+    uint64_t checksum = reader.get<uint64_t>();
+    payload = bytes.substr(header_size);
+    if (magic != CHECKPOINT_MAGIC || payload_size != payload.size() || checksum != get_checksum(payload)){
+        fprintf(stderr, "Error: the checkpoint %s is corrupted\n", filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+void remove_checkpoint(const std::string& filename){
+    std::remove(filename.c_str());
+}
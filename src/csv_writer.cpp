@@ -0,0 +1,121 @@
+#include "../headers/csv_writer.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <unordered_map>
+#include <charconv>
+#include <cassert>
+#include <cstring>
+
+const std::string& get_cached_date_string(std::time_t date){
+    thread_local std::unordered_map<std::time_t, std::string> date_strings;
+    auto it = date_strings.find(date);
+    if (it != date_strings.end())
+        return it->second;
+    if (date_strings.size() >= (1 << 16))
+        date_strings.clear();
+    return date_strings.emplace(date, unix_timestamp_to_date_string(date)).first->second;
+}
+
+CsvWriter::CsvWriter(std::string filename, size_t buffer_size, bool is_background_writer)
+: buffer(buffer_size), buffer_used(0), is_background_writer(is_background_writer), pending_buffer(is_background_writer ? buffer_size : 0), pending_used(0), is_pending(false), is_closing(false){
+    assert(buffer_size >= 1024 && "Error: the buffer size must be >= 1024 bytes\n");
+    this->file = fopen(filename.c_str(), "wb");
+    this->is_written = this->file != nullptr;
+    if (this->file == nullptr){
+        fprintf(stderr, "Error: can't write %s\n", filename.c_str());
+        return;
+    }
+    setvbuf(this->file, nullptr, _IONBF, 0); // the rows are already buffered
+    if (this->is_background_writer)
+        this->writer_thread = std::thread(&CsvWriter::run_writer, this);
+}
+
+bool CsvWriter::is_open() const{
+    return this->file != nullptr;
+}
+
+void CsvWriter::write_line(const std::string& line){
+    if (this->file == nullptr)
+        return;
+    this->reserve(line.size() + 1);
+    std::memcpy(this->buffer.data() + this->buffer_used, line.data(), line.size());
+    this->buffer_used += line.size();
+    this->buffer[this->buffer_used++] = '\n';
+}
+
+void CsvWriter::write_row(std::time_t date, const double* values, size_t nb_values){
+    if (this->file == nullptr)
+        return;
+    const std::string& date_string = get_cached_date_string(date);
+    // A double takes at most 13 characters with 6 significant digits ("-1.23457e-308")
+    this->reserve(date_string.size() + nb_values * 16 + 1);
+    char* position = this->buffer.data() + this->buffer_used;
+    char* end = this->buffer.data() + this->buffer.size();
+    std::memcpy(position, date_string.data(), date_string.size());
+    position += date_string.size();
+    for (size_t i = 0; i < nb_values; ++i){
+        *position++ = ';';
+        position = std::to_chars(position, end, values[i], std::chars_format::general, 6).ptr;
+    }
+    *position++ = '\n';
+    this->buffer_used = position - this->buffer.data();
+}
+
+void CsvWriter::reserve(size_t nb_bytes){
+    if (this->buffer_used + nb_bytes > this->buffer.size())
+        this->flush_buffer();
+    assert(nb_bytes <= this->buffer.size() - this->buffer_used && "Error: the line does not fit in the buffer\n");
+}
+
+void CsvWriter::flush_buffer(){
+    if (this->buffer_used == 0)
+        return;
+    if (!this->is_background_writer){
+        this->is_written = fwrite(this->buffer.data(), 1, this->buffer_used, this->file) == this->buffer_used && this->is_written;
+        this->buffer_used = 0;
+        return;
+    }
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->condition.wait(lock, [this]{ return !this->is_pending; });
+    std::swap(this->buffer, this->pending_buffer);
+    this->pending_used = this->buffer_used;
+    this->buffer_used = 0;
+    this->is_pending = true;
+    this->condition.notify_all();
+}
+
+void CsvWriter::run_writer(){
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true){
+        this->condition.wait(lock, [this]{ return this->is_pending || this->is_closing; });
+        if (!this->is_pending)
+            return;
+        lock.unlock();
+        bool is_written = fwrite(this->pending_buffer.data(), 1, this->pending_used, this->file) == this->pending_used;
+        lock.lock();
+        this->is_written = is_written && this->is_written;
+        this->is_pending = false;
+        this->condition.notify_all();
+    }
+}
+
+bool CsvWriter::close(){
+    if (this->file == nullptr)
+        return false;
+    this->flush_buffer();
+    if (this->is_background_writer){
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->is_closing = true;
+        }
+        this->condition.notify_all();
+        this->writer_thread.join();
+    }
+    this->is_written = (fclose(this->file) == 0) && this->is_written;
+    this->file = nullptr;
+    return this->is_written;
+}
+
+CsvWriter::~CsvWriter(){
+    if (this->file != nullptr)
+        this->close();
+}
@@ -0,0 +1,151 @@
+#include "../headers/data_pipeline.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <cassert>
+#include <cstdio>
+
+static double get_seconds_since(std::chrono::steady_clock::time_point start){
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+TickerFetcher get_yahoo_fetcher(std::string start_date, std::string end_date, std::string freq){
+    return [start_date, end_date, freq](const std::string& ticker){
+        return get_ticker_str_data(ticker, start_date, end_date, freq);
+    };
+}
+
+DataPipeline::DataPipeline(const TickerFetcher& fetcher, size_t nb_fetch_threads, size_t nb_parse_threads, size_t nb_compute_threads, size_t queue_capacity)
+: fetcher(fetcher), nb_fetch_threads(nb_fetch_threads), nb_parse_threads(nb_parse_threads), nb_compute_threads(nb_compute_threads), queue_capacity(queue_capacity), stats(){
+    assert(nb_fetch_threads > 0 && nb_parse_threads > 0 && nb_compute_threads > 0 && "Error: every stage needs a thread\n");
+    assert(queue_capacity > 0 && "Error: the queue capacity must be > 0\n");
+}
+
+void DataPipeline::add_indicator(std::string name, const TickerIndicator& indicator){
+    this->indicators.emplace_back(name, indicator);
+}
+
+void DataPipeline::set_consumer(const std::function<void(size_t ticker_idx, const TickerData& ticker_data)>& consumer){
+    this->consumer = consumer;
+}
+
+std::vector<TickerData> DataPipeline::run(const std::vector<std::string>& tickers){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<TickerData> tickers_data(tickers.size());
+    for (size_t i = 0; i < tickers.size(); ++i)
+        tickers_data[i].ticker = tickers[i];
+
+    BoundedQueue<std::pair<size_t, std::string>> fetched_queue(this->queue_capacity);
+    BoundedQueue<size_t> parsed_queue(this->queue_capacity);
+    std::atomic<size_t> next_ticker_idx(0);
+    std::atomic<size_t> nb_running_fetchers(this->nb_fetch_threads);
+    std::atomic<size_t> nb_running_parsers(this->nb_parse_threads);
+    std::atomic<size_t> nb_failed_tickers(0);
+    std::mutex stats_mutex;
+    double stage_seconds[3] = {0.0, 0.0, 0.0};
+    auto add_stage_seconds = [&](size_t stage, double seconds){
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stage_seconds[stage] += seconds;
+    };
+    // The first exception of a stage is kept; closing both queues wakes the threads blocked on them so every stage stops
+    std::atomic<bool> is_stopped(false);
+    std::exception_ptr stage_exception;
+    auto stop_stages = [&](std::exception_ptr exception){
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            if (!stage_exception)
+                stage_exception = exception;
+        }
+        is_stopped = true;
+        fetched_queue.close();
+        parsed_queue.close();
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < this->nb_fetch_threads; ++t)
+        threads.emplace_back([&]{
+            double busy_seconds = 0.0;
+            try {
+                for (size_t i = next_ticker_idx++; i < tickers.size() && !is_stopped; i = next_ticker_idx++){
+                    std::chrono::steady_clock::time_point fetch_start = std::chrono::steady_clock::now();
+                    std::string ticker_str_data = this->fetcher(tickers[i]);
+                    busy_seconds += get_seconds_since(fetch_start);
+                    if (!fetched_queue.push({i, std::move(ticker_str_data)}))
+                        break;
+                }
+            } catch (...) {
+                stop_stages(std::current_exception());
+            }
+            add_stage_seconds(0, busy_seconds);
+            if (--nb_running_fetchers == 0)
+                fetched_queue.close();
+        });
+    for (size_t t = 0; t < this->nb_parse_threads; ++t)
+        threads.emplace_back([&]{
+            double busy_seconds = 0.0;
+            std::pair<size_t, std::string> fetched;
+            try {
+                while (!is_stopped && fetched_queue.pop(fetched)){
+                    std::chrono::steady_clock::time_point parse_start = std::chrono::steady_clock::now();
+                    TickerData& ticker_data = tickers_data[fetched.first];
+                    try {
+                        ticker_data.ticker_yt.emplace(get_ticker_ts_data(std::move(fetched.second)));
+                    } catch (const std::exception& e) {
+                        fprintf(stderr, "Error: can't parse the data of %s (%s)\n", ticker_data.ticker.c_str(), e.what());
+                    }
+                    busy_seconds += get_seconds_since(parse_start);
+                    if (!ticker_data.ticker_yt)
+                        nb_failed_tickers++;
+                    else if (!parsed_queue.push(fetched.first))
+                        break;
+                }
+            } catch (...) {
+                stop_stages(std::current_exception());
+            }
+            add_stage_seconds(1, busy_seconds);
+            if (--nb_running_parsers == 0)
+                parsed_queue.close();
+        });
+    for (size_t t = 0; t < this->nb_compute_threads; ++t)
+        threads.emplace_back([&]{
+            double busy_seconds = 0.0;
+            size_t ticker_idx;
+            try {
+                while (!is_stopped && parsed_queue.pop(ticker_idx)){
+                    std::chrono::steady_clock::time_point compute_start = std::chrono::steady_clock::now();
+                    TickerData& ticker_data = tickers_data[ticker_idx];
+                    for (const auto& indicator: this->indicators)
+                        ticker_data.indicators[indicator.first] = indicator.second(*ticker_data.ticker_yt);
+                    if (this->consumer)
+                        this->consumer(ticker_idx, ticker_data);
+                    busy_seconds += get_seconds_since(compute_start);
+                }
+            } catch (...) {
+                stop_stages(std::current_exception());
+            }
+            add_stage_seconds(2, busy_seconds);
+        });
+    for (auto& thread: threads)
+        thread.join();
+
+    this->stats.nb_tickers = tickers.size();
+    this->stats.nb_failed_tickers = nb_failed_tickers;
+    this->stats.fetch_seconds = stage_seconds[0];
+    this->stats.parse_seconds = stage_seconds[1];
+    this->stats.compute_seconds = stage_seconds[2];
+    this->stats.elapsed_seconds = get_seconds_since(start);
+    this->stats.max_fetched_queue_size = fetched_queue.get_max_size();
+    this->stats.max_parsed_queue_size = parsed_queue.get_max_size();
+    if (stage_exception)
+        std::rethrow_exception(stage_exception);
+    return tickers_data;
+}
+
+const DataPipelineStats& DataPipeline::get_stats() const{
+    return this->stats;
+}
+
+DataPipeline::~DataPipeline(){}
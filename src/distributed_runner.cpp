@@ -0,0 +1,230 @@
+#include "../headers/distributed_runner.hpp"
+#include "../headers/serialization.hpp"
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+
+static bool send_bytes(int fd, const char* bytes, size_t size){
+    while (size > 0){
+        ssize_t nb_sent = send(fd, bytes, size, MSG_NOSIGNAL);
+        if (nb_sent < 0 && errno == EINTR)
+            continue;
+        if (nb_sent <= 0)
+            return false;
+        bytes += nb_sent;
+        size -= nb_sent;
+    }
+    return true;
+}
+
+static bool receive_bytes(int fd, char* bytes, size_t size){
+    while (size > 0){
+        ssize_t nb_received = recv(fd, bytes, size, 0);
+        if (nb_received < 0 && errno == EINTR)
+            continue;
+        if (nb_received <= 0)
+            return false;
+        bytes += nb_received;
+        size -= nb_received;
+    }
+    return true;
+}
+
+bool send_message(int fd, const std::string& message){
+    uint64_t size = message.size();
+    return send_bytes(fd, reinterpret_cast<const char*>(&size), sizeof(size)) && send_bytes(fd, message.data(), message.size());
+}
+
+bool receive_message(int fd, std::string& message){
+    uint64_t size = 0;
+    if (!receive_bytes(fd, reinterpret_cast<char*>(&size), sizeof(size)))
+        return false;
+    message.resize(size);
+    return receive_bytes(fd, &message[0], size);
+}
+
+static std::string get_shard_request(size_t shard_idx, size_t first_item, size_t nb_items){
+    ByteWriter writer;
+    writer.put<uint64_t>(shard_idx);
+    writer.put<uint64_t>(first_item);
+    writer.put<uint64_t>(nb_items);
+    return writer.get_bytes();
+}
+
+void run_worker_loop(int fd, const ShardTask& task){
+    std::string request;
+    while (receive_message(fd, request)){
+        ByteReader reader(request);
+        size_t shard_idx = reader.get<uint64_t>();
+        size_t first_item = reader.get<uint64_t>();
+        size_t nb_items = reader.get<uint64_t>();
+        if (nb_items == 0)
+            return;
+        ByteWriter writer;
+        writer.put<uint64_t>(shard_idx);
+        writer.put_string(task(first_item, nb_items));
+        if (!send_message(fd, writer.get_bytes()))
+            return;
+    }
+}
+
+LocalCluster::LocalCluster(size_t nb_workers): nb_workers(nb_workers), throughput{0, 0, 0.0, 0.0}{
+    if (this->nb_workers == 0)
+        this->nb_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+std::vector<std::string> LocalCluster::run(size_t nb_items, size_t shard_size, const ShardTask& task){
+    assert(shard_size > 0 && "Error: shards must hold at least one item\n");
+    size_t nb_shards = (nb_items + shard_size - 1) / shard_size;
+    std::vector<std::string> results(nb_shards);
+    auto start = std::chrono::steady_clock::now();
+
+    // Buffered output would otherwise be written again by every child
+    std::cout << std::flush;
+    fflush(stdout);
+    std::vector<int> fds;
+    std::vector<pid_t> pids;
+    for (size_t w = 0; w < std::min(this->nb_workers, nb_shards); ++w){
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0){
+            fprintf(stderr, "Error: can't create the socket of worker %zu\n", w);
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0){
+            close(sockets[0]);
+            for (int fd: fds)
+                close(fd);
+            // An exception must not unwind the coordinator's stack copied in the child: the worker is then lost
+            // and its shard is run by the coordinator
+            try {
+                run_worker_loop(sockets[1], task);
+            } catch (...){
+                _exit(1);
+            }
+            close(sockets[1]);
+            _exit(0);
+        }
+        close(sockets[1]);
+        if (pid < 0){
+            fprintf(stderr, "Error: can't fork worker %zu\n", w);
+            close(sockets[0]);
+            break;
+        }
+        fds.push_back(sockets[0]);
+        pids.push_back(pid);
+    }
+
+    // shard of each worker, nb_shards when idle or lost
+    std::vector<size_t> worker_shards(fds.size(), nb_shards);
+    size_t next_shard = 0;
+    auto dispatch = [&](size_t w){
+        worker_shards[w] = nb_shards;
+        if (next_shard == nb_shards)
+            return;
+        size_t first_item = next_shard * shard_size;
+        if (send_message(fds[w], get_shard_request(next_shard, first_item, std::min(nb_items, first_item + shard_size) - first_item)))
+            worker_shards[w] = next_shard++;
+    };
+    for (size_t w = 0; w < fds.size(); ++w)
+        dispatch(w);
+    std::vector<char> is_done(nb_shards, 0);
+    while (true){
+        std::vector<pollfd> poll_fds;
+        std::vector<size_t> poll_workers;
+        for (size_t w = 0; w < fds.size(); ++w){
+            if (worker_shards[w] < nb_shards){
+                poll_fds.push_back({fds[w], POLLIN, 0});
+                poll_workers.push_back(w);
+            }
+        }
+        if (poll_fds.empty())
+            break;
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0){
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "Error: polling the workers failed\n");
+            break;
+        }
+        for (size_t i = 0; i < poll_fds.size(); ++i){
+            if (poll_fds[i].revents == 0)
+                continue;
+            size_t w = poll_workers[i];
+            std::string message;
+            if (!receive_message(fds[w], message)){
+                fprintf(stderr, "Error: worker %zu was lost, its shard %zu is run by the coordinator\n", w, worker_shards[w]);
+                worker_shards[w] = nb_shards;
+                continue;
+            }
+            ByteReader reader(message);
+            size_t shard_idx = reader.get<uint64_t>();
+            std::string result = reader.get_string();
+            if (shard_idx != worker_shards[w] || !reader.is_done()){
+                fprintf(stderr, "Error: worker %zu sent an invalid result, its shard %zu is run by the coordinator\n", w, worker_shards[w]);
+                worker_shards[w] = nb_shards;
+                continue;
+            }
+            results[shard_idx] = result;
+            is_done[shard_idx] = 1;
+            dispatch(w);
+        }
+    }
+    for (size_t w = 0; w < fds.size(); ++w){
+        send_message(fds[w], get_shard_request(0, 0, 0));
+        close(fds[w]);
+        waitpid(pids[w], nullptr, 0);
+    }
+    // Shards of lost workers, or every shard when no worker could be started
+    for (size_t shard_idx = 0; shard_idx < nb_shards; ++shard_idx){
+        if (!is_done[shard_idx]){
+            size_t first_item = shard_idx * shard_size;
+            results[shard_idx] = task(first_item, std::min(nb_items, first_item + shard_size) - first_item);
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    this->throughput = {std::max<size_t>(1, fds.size()), nb_items, elapsed.count(), nb_items / elapsed.count()};
+    return results;
+}
+
+size_t LocalCluster::get_nb_workers() const{
+    return this->nb_workers;
+}
+
+const DistributedThroughput& LocalCluster::get_throughput() const{
+    return this->throughput;
+}
+
+std::vector<DistributedThroughput> LocalCluster::benchmark_scaling(const std::function<void(LocalCluster&)>& job, size_t max_workers){
+    if (max_workers == 0)
+        max_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> worker_counts;
+    for (size_t nb_workers = 1; nb_workers < max_workers; nb_workers *= 2)
+        worker_counts.push_back(nb_workers);
+    worker_counts.push_back(max_workers);
+
+    size_t nb_workers = this->nb_workers;
+    std::vector<DistributedThroughput> throughputs;
+    for (size_t worker_count: worker_counts){
+        this->nb_workers = worker_count;
+        job(*this);
+        throughputs.push_back(this->throughput);
+    }
+    this->nb_workers = nb_workers;
+    for (const auto& throughput: throughputs)
+        std::cout << "Distributed scaling: " << throughput.nb_workers << " workers - " << throughput.items_per_second << " items/s - speedup x"
+                  << throughput.items_per_second / throughputs[0].items_per_second << " - efficiency "
+                  << 100 * throughput.items_per_second / throughputs[0].items_per_second / throughput.nb_workers << "%" << std::endl;
+    return throughputs;
+}
+
+LocalCluster::~LocalCluster(){}
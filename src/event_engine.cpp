@@ -0,0 +1,269 @@
+#include "../headers/event_engine.hpp"
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+static const std::time_t FIRST_TIME = std::numeric_limits<std::time_t>::min();
+
+// First boundary of a calendar cadence after time
+static std::time_t get_next_boundary(std::time_t time, std::time_t anchor_time, const Schedule& schedule){
+    if (schedule.cadence == ScheduleCadence::SECONDS){
+        std::time_t period = schedule.period;
+        return time + period - (time - anchor_time) % period;
+    }
+    std::tm time_info;
+    localtime_r(&time, &time_info);
+    time_info.tm_hour = 0;
+    time_info.tm_min = 0;
+    time_info.tm_sec = 0;
+    time_info.tm_isdst = -1;
+    if (schedule.cadence == ScheduleCadence::DAYS)
+        time_info.tm_mday += schedule.period;
+    else {
+        time_info.tm_mday = 1;
+        time_info.tm_mon += schedule.period;
+    }
+    return std::mktime(&time_info);
+}
+
+EventEngine::EventEngine(): nb_events(0), throughput({0, 0.0, 0.0}){}
+
+bool EventEngine::is_later(const HeapEntry& a, const HeapEntry& b){
+    if (a.time != b.time)
+        return a.time > b.time;
+    if (a.kind != b.kind)
+        return a.kind > b.kind;
+    return a.ticker_idx > b.ticker_idx;
+}
+
+size_t EventEngine::add_ticker(std::string ticker, const std::time_t* times, const double* closes, size_t nb_bars){
+    for (size_t i = 1; i < nb_bars; ++i)
+        assert(times[i] > times[i - 1] && "Error: bar times must be increasing\n");
+    this->tickers.push_back(ticker);
+    this->bar_streams.push_back({times, closes, nb_bars, 0});
+    this->dividend_streams.push_back({nullptr, nullptr, 0, 0});
+    this->ticker_schedules.emplace_back();
+    return this->tickers.size() - 1;
+}
+
+void EventEngine::add_dividends(size_t ticker_idx, const std::time_t* times, const double* amounts, size_t nb_dividends){
+    assert(ticker_idx < this->tickers.size() && "Error: unknown ticker index\n");
+    for (size_t i = 1; i < nb_dividends; ++i)
+        assert(times[i] > times[i - 1] && "Error: dividend times must be increasing\n");
+    this->dividend_streams[ticker_idx] = {times, amounts, nb_dividends, 0};
+}
+
+void EventEngine::set_bar_handler(const TickerEventHandler& handler){
+    this->bar_handler = handler;
+}
+
+void EventEngine::set_dividend_handler(const TickerEventHandler& handler){
+    this->dividend_handler = handler;
+}
+
+void EventEngine::add_schedule(const Schedule& schedule, int ticker_idx, const ScheduledAction& action){
+    assert(schedule.period > 0 && "Error: a schedule period must be > 0\n");
+    assert(ticker_idx < int(this->tickers.size()) && "Error: unknown ticker index\n");
+    this->schedules.push_back({schedule, action, FIRST_TIME, FIRST_TIME, 0});
+    if (ticker_idx < 0)
+        this->clock_schedules.push_back(this->schedules.size() - 1);
+    else
+        this->ticker_schedules[ticker_idx].push_back(this->schedules.size() - 1);
+}
+
+void EventEngine::push_stream(int kind, size_t ticker_idx){
+    const EventStream& stream = (kind == BAR) ? this->bar_streams[ticker_idx] : this->dividend_streams[ticker_idx];
+    if (stream.position == stream.nb_events)
+        return;
+    this->heap.push_back({stream.times[stream.position], kind, ticker_idx});
+    std::push_heap(this->heap.begin(), this->heap.end(), is_later);
+}
+
+void EventEngine::advance_top(){
+    HeapEntry top = this->heap.front();
+    std::pop_heap(this->heap.begin(), this->heap.end(), is_later);
+    this->heap.pop_back();
+    EventStream& stream = (top.kind == BAR) ? this->bar_streams[top.ticker_idx] : this->dividend_streams[top.ticker_idx];
+    ++stream.position;
+    this->push_stream(top.kind, top.ticker_idx);
+}
+
+void EventEngine::fire_if_due(ScheduleState& state, std::time_t time){
+    if (state.schedule.cadence == ScheduleCadence::TICKS){
+        if (++state.nb_ticks < state.schedule.period)
+            return;
+        state.nb_ticks = 0;
+    }
+    else {
+        if (time < state.next_time)
+            return;
+        if (state.anchor_time == FIRST_TIME)
+            state.anchor_time = time;
+        state.next_time = get_next_boundary(time, state.anchor_time, state.schedule);
+    }
+    state.action(time);
+    ++this->nb_events;
+}
+
+void EventEngine::run(){
+    auto start = std::chrono::steady_clock::now();
+    size_t nb_tickers = this->tickers.size();
+    this->last_closes.assign(nb_tickers, 0.0);
+    this->nb_events = 0;
+    for (auto& state: this->schedules){
+        state.next_time = FIRST_TIME;
+        state.anchor_time = FIRST_TIME;
+        state.nb_ticks = 0;
+    }
+    this->heap.clear();
+    this->heap.reserve(2 * nb_tickers);
+    for (size_t t = 0; t < nb_tickers; ++t){
+        this->bar_streams[t].position = 0;
+        this->dividend_streams[t].position = 0;
+        this->push_stream(BAR, t);
+        this->push_stream(DIVIDEND, t);
+    }
+
+    while (!this->heap.empty()){
+        std::time_t time = this->heap.front().time;
+        this->traded_tickers.clear();
+        while (!this->heap.empty() && this->heap.front().time == time && this->heap.front().kind == BAR){
+            size_t ticker_idx = this->heap.front().ticker_idx;
+            const EventStream& stream = this->bar_streams[ticker_idx];
+            double close = stream.values[stream.position];
+            this->last_closes[ticker_idx] = close;
+            if (this->bar_handler)
+                this->bar_handler(ticker_idx, time, close);
+            this->traded_tickers.push_back(ticker_idx);
+            ++this->nb_events;
+            this->advance_top();
+        }
+        for (size_t ticker_idx: this->traded_tickers)
+            for (size_t schedule_idx: this->ticker_schedules[ticker_idx])
+                this->fire_if_due(this->schedules[schedule_idx], time);
+        while (!this->heap.empty() && this->heap.front().time == time){
+            size_t ticker_idx = this->heap.front().ticker_idx;
+            const EventStream& stream = this->dividend_streams[ticker_idx];
+            if (this->dividend_handler)
+                this->dividend_handler(ticker_idx, time, stream.values[stream.position]);
+            ++this->nb_events;
+            this->advance_top();
+        }
+        for (size_t schedule_idx: this->clock_schedules)
+            this->fire_if_due(this->schedules[schedule_idx], time);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    this->throughput = {this->nb_events, elapsed.count(), this->nb_events / std::max(elapsed.count(), 1e-12)};
+}
+
+size_t EventEngine::get_nb_tickers() const{
+    return this->tickers.size();
+}
+
+const std::vector<std::string>& EventEngine::get_tickers() const{
+    return this->tickers;
+}
+
+const double* EventEngine::get_last_closes() const{
+    return this->last_closes.data();
+}
+
+const EventThroughput& EventEngine::get_throughput() const{
+    return this->throughput;
+}
+
+EventEngine::~EventEngine(){}
+
+
+EventDrivenDCA::EventDrivenDCA(EventEngine& engine, double starting_amount, double recurrent_investment_amount, const std::vector<double>& allocations,
+                               const Schedule& rebalancing_schedule, RebalancingThreshold rebalancing_mode, double rebalancing_threshold,
+                               const Schedule& valuation_schedule)
+: engine(engine), starting_amount(starting_amount), recurrent_investment_amount(recurrent_investment_amount), allocations(allocations),
+  rebalancer(allocations, rebalancing_mode, rebalancing_threshold), net_investment(0.0), nb_rebalancings(0){
+    assert(allocations.size() == engine.get_nb_tickers() && "Error: one allocation per ticker of the engine is needed\n");
+    for (size_t t = 0; t < allocations.size(); ++t){
+        if (allocations[t] > 0)
+            engine.add_schedule({ScheduleCadence::MONTHS, 1}, t, [this, t](std::time_t){ this->contribute(t); });
+    }
+    engine.set_dividend_handler([this](size_t ticker_idx, std::time_t, double amount){ this->reinvest_dividend(ticker_idx, amount); });
+    engine.add_schedule(rebalancing_schedule, -1, [this](std::time_t){ this->rebalance(); });
+    engine.add_schedule(valuation_schedule, -1, [this](std::time_t time){ this->record_value(time); });
+}
+
+void EventDrivenDCA::run(){
+    size_t nb_tickers = this->allocations.size();
+    this->shares.assign(nb_tickers, 0.0);
+    this->pending_starting_amounts.resize(nb_tickers);
+    for (size_t t = 0; t < nb_tickers; ++t)
+        this->pending_starting_amounts[t] = this->allocations[t] * this->starting_amount;
+    this->net_investment = 0.0;
+    this->nb_rebalancings = 0;
+    this->value_dates.clear();
+    this->values.clear();
+    this->engine.run();
+}
+
+void EventDrivenDCA::contribute(size_t ticker_idx){
+    double amount = this->allocations[ticker_idx] * this->recurrent_investment_amount + this->pending_starting_amounts[ticker_idx];
+    this->pending_starting_amounts[ticker_idx] = 0.0;
+    double close = this->engine.get_last_closes()[ticker_idx];
+    double shares_amt = amount / close;
+    if (shares_amt > 0){
+        this->shares[ticker_idx] += shares_amt;
+        this->net_investment += shares_amt * close;
+    }
+}
+
+void EventDrivenDCA::reinvest_dividend(size_t ticker_idx, double amount){
+    double close = this->engine.get_last_closes()[ticker_idx];
+    if (!(close > 0))
+        return;
+    double shares_amt = DIVIDEND_REINVESTMENT_RATIO * amount * this->shares[ticker_idx] / close;
+    this->shares[ticker_idx] += shares_amt;
+    this->net_investment += shares_amt * close;
+}
+
+void EventDrivenDCA::rebalance(){
+    const double* closes = this->engine.get_last_closes();
+    if (this->rebalancer.compute_orders(this->shares.data(), closes) == 0)
+        return;
+    const std::vector<double>& orders = this->rebalancer.get_orders();
+    for (size_t t = 0; t < this->shares.size(); ++t){
+        this->shares[t] += orders[t];
+        this->net_investment += orders[t] * closes[t];
+    }
+    ++this->nb_rebalancings;
+}
+
+void EventDrivenDCA::record_value(std::time_t time){
+    const double* closes = this->engine.get_last_closes();
+    double value = 0.0;
+    for (size_t t = 0; t < this->shares.size(); ++t)
+        value += this->shares[t] * closes[t];
+    this->value_dates.push_back(time);
+    this->values.push_back(value);
+}
+
+const std::vector<std::time_t>& EventDrivenDCA::get_value_dates() const{
+    return this->value_dates;
+}
+
+const std::vector<double>& EventDrivenDCA::get_values() const{
+    return this->values;
+}
+
+const std::vector<double>& EventDrivenDCA::get_shares() const{
+    return this->shares;
+}
+
+double EventDrivenDCA::get_net_investment() const{
+    return this->net_investment;
+}
+
+size_t EventDrivenDCA::get_nb_rebalancings() const{
+    return this->nb_rebalancings;
+}
+
+EventDrivenDCA::~EventDrivenDCA(){}
@@ -1,7 +1,7 @@
 #include "../headers/yahoo_finance.hpp"
 #include "../headers/strategy.hpp"
 
-//g++ *.cpp -o main -lcurl
+//g++ *.cpp -o main -lcurl -pthread
 
 int main(){
     std::vector<std::string> tickers = {"CSSPX.MI", "EGLN.L"}; //"IDUS.L"
@@ -13,6 +13,7 @@ int main(){
     Strategy* strat = new DCA(tickers_ts_data, 81200, 2000.0, {{"CSSPX.MI", 0.75}, {"EGLN.L", 0.25}}, 30, 0.01, "DCA_SPGold_acc_2015_2024");
     strat->run_strategy();
     strat->save_end_portfolio();
+    //strat->set_montecarlo_config(42, 0, 0, false); // seed, nb threads (0 = all cores), start date (0 = today), one csv per path
     //strat->run_montecarlo_simulations(1000);
 
     
@@ -0,0 +1,59 @@
+#include "../headers/market_data.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <algorithm>
+#include <limits>
+
+std::vector<double> get_dense_values(const Timeseries& ts, const std::vector<std::time_t>& dates){
+    std::vector<double> values(dates.size(), 0.0);
+    std::map<std::time_t, double> ts_values = ts.get_ts_values();
+    auto it = ts_values.begin();
+    double last_value = 0.0;
+    for (size_t d = 0; d < dates.size(); ++d){
+        while (it != ts_values.end() && it->first <= dates[d]){
+            last_value = it->second;
+            ++it;
+        }
+        values[d] = last_value;
+    }
+    return values;
+}
+
+static std::vector<char> get_date_flags(const std::vector<std::time_t>& flagged_dates, const std::vector<std::time_t>& dates){
+    std::vector<char> flags(dates.size(), 0);
+    for (const auto& date: flagged_dates){
+        auto it = std::lower_bound(dates.begin(), dates.end(), date);
+        if (it != dates.end() && *it == date)
+            flags[it - dates.begin()] = 1;
+    }
+    return flags;
+}
+
+MarketData get_market_data(const std::vector<YahooTimeseries>& tickers_yt){
+    MarketData market_data;
+    market_data.dates = get_unique_dates(tickers_yt);
+    for (const auto& ticker_yt: tickers_yt){
+        market_data.tickers.push_back(ticker_yt.get_ticker());
+        market_data.closes.push_back(get_dense_values(ticker_yt.get_closes(), market_data.dates));
+
+        std::vector<double> dividends(market_data.dates.size(), 0.0);
+        for (const auto& pair: ticker_yt.get_dividends().get_ts_values()){
+            auto it = std::lower_bound(market_data.dates.begin(), market_data.dates.end(), pair.first);
+            if (it != market_data.dates.end() && *it == pair.first)
+                dividends[it - market_data.dates.begin()] = pair.second;
+        }
+        market_data.dividends.push_back(dividends);
+
+        const std::vector<std::time_t>& ticker_dates = ticker_yt.get_dates();
+        market_data.is_first_month_dates.push_back(get_date_flags(extract_first_dates_of_each_month(ticker_dates), market_data.dates));
+        market_data.is_last_month_dates.push_back(get_date_flags(extract_last_dates_of_each_month(ticker_dates), market_data.dates));
+        market_data.first_date_indices.push_back(std::lower_bound(market_data.dates.begin(), market_data.dates.end(), ticker_dates[0]) - market_data.dates.begin());
+    }
+    return market_data;
+}
+
+size_t get_ticker_index(const MarketData& market_data, std::string ticker){
+    auto it = std::find(market_data.tickers.begin(), market_data.tickers.end(), ticker);
+    if (it == market_data.tickers.end())
+        return std::numeric_limits<size_t>::max();
+    return it - market_data.tickers.begin();
+}
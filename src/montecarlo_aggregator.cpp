@@ -0,0 +1,355 @@
+#include "../headers/montecarlo_aggregator.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+TDigest::TDigest(double compression): compression(compression), count(0.0),
+                                      min_value(std::numeric_limits<double>::infinity()),
+                                      max_value(-std::numeric_limits<double>::infinity()){
+    assert(compression > 0 && "Error: the t-digest compression must be > 0\n");
+}
+
+void TDigest::add(double value){
+    this->buffer.push_back({value, 1.0});
+    this->count += 1.0;
+    this->min_value = std::min(this->min_value, value);
+    this->max_value = std::max(this->max_value, value);
+    if (this->buffer.size() >= 5 * size_t(this->compression))
+        this->compress();
+}
+
+void TDigest::merge(const TDigest& other){
+    this->buffer.insert(this->buffer.end(), other.centroids.begin(), other.centroids.end());
+    this->buffer.insert(this->buffer.end(), other.buffer.begin(), other.buffer.end());
+    this->count += other.count;
+    this->min_value = std::min(this->min_value, other.min_value);
+    this->max_value = std::max(this->max_value, other.max_value);
+    this->compress();
+}
+
+void TDigest::reset(){
+    this->centroids.clear();
+    this->buffer.clear();
+    this->count = 0.0;
+    this->min_value = std::numeric_limits<double>::infinity();
+    this->max_value = -std::numeric_limits<double>::infinity();
+}
+
+void TDigest::write(ByteWriter& writer) const{
+    writer.put(this->compression);
+    writer.put_vector(this->centroids);
+    writer.put_vector(this->buffer);
+    writer.put(this->count);
+    writer.put(this->min_value);
+    writer.put(this->max_value);
+}
+
+void TDigest::read(ByteReader& reader){
+    this->compression = reader.get<double>();
+    this->centroids = reader.get_vector<Centroid>();
+    this->buffer = reader.get_vector<Centroid>();
+    this->count = reader.get<double>();
+    this->min_value = reader.get<double>();
+    this->max_value = reader.get<double>();
+}
+
+void TDigest::compress(){
+    if (this->buffer.empty())
+        return;
+    std::vector<Centroid> points = this->centroids;
+    points.insert(points.end(), this->buffer.begin(), this->buffer.end());
+    this->buffer.clear();
+    std::stable_sort(points.begin(), points.end(), [](const Centroid& a, const Centroid& b){ return a.mean < b.mean; });
+
+    // k1 scale function: centroids are small near q = 0 and q = 1 and can grow in the middle
+    auto get_k = [this](double q){ return this->compression / (2.0 * M_PI) * std::asin(2.0 * std::min(1.0, std::max(0.0, q)) - 1.0); };
+    this->centroids.clear();
+    Centroid current = points[0];
+    double weight_so_far = 0.0;
+    for (size_t i = 1; i < points.size(); ++i){
+        double proposed_weight = current.weight + points[i].weight;
+        if (get_k((weight_so_far + proposed_weight) / this->count) - get_k(weight_so_far / this->count) <= 1.0){
+            current.mean += (points[i].mean - current.mean) * points[i].weight / proposed_weight;
+            current.weight = proposed_weight;
+        }
+        else {
+            weight_so_far += current.weight;
+            this->centroids.push_back(current);
+            current = points[i];
+        }
+    }
+    this->centroids.push_back(current);
+}
+
+const TDigest& TDigest::get_compressed(TDigest& copy) const{
+    if (this->buffer.empty())
+        return *this;
+    copy = *this;
+    copy.compress();
+    return copy;
+}
+
+double TDigest::get_quantile(double q) const{
+    TDigest copy(this->compression);
+    const std::vector<Centroid>& centroids = this->get_compressed(copy).centroids;
+    if (centroids.empty())
+        return std::numeric_limits<double>::quiet_NaN();
+    if (centroids.size() == 1)
+        return centroids[0].mean;
+
+    // Interpolation between centroid centers, the extremes are anchored on the exact min and max
+    double index = std::min(1.0, std::max(0.0, q)) * this->count;
+    if (index < centroids[0].weight / 2.0)
+        return this->min_value + (centroids[0].mean - this->min_value) * index / (centroids[0].weight / 2.0);
+    double left_position = centroids[0].weight / 2.0;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i){
+        double right_position = left_position + (centroids[i].weight + centroids[i+1].weight) / 2.0;
+        if (index < right_position)
+            return centroids[i].mean + (centroids[i+1].mean - centroids[i].mean) * (index - left_position) / (right_position - left_position);
+        left_position = right_position;
+    }
+    double last_half_weight = centroids.back().weight / 2.0;
+    return centroids.back().mean + (this->max_value - centroids.back().mean) * std::min(1.0, (index - left_position) / last_half_weight);
+}
+
+double TDigest::get_cdf(double value) const{
+    TDigest copy(this->compression);
+    const std::vector<Centroid>& centroids = this->get_compressed(copy).centroids;
+    if (centroids.empty())
+        return std::numeric_limits<double>::quiet_NaN();
+    if (value <= this->min_value)
+        return 0.0;
+    if (value >= this->max_value)
+        return 1.0;
+
+    // Inverse of get_quantile: linear between (min, 0), the centroid centers and (max, count)
+    double previous_mean = this->min_value;
+    double previous_position = 0.0;
+    double cumulative_weight = 0.0;
+    for (const auto& centroid: centroids){
+        double center_position = cumulative_weight + centroid.weight / 2.0;
+        if (value < centroid.mean)
+            return (previous_position + (center_position - previous_position) * (value - previous_mean) / (centroid.mean - previous_mean)) / this->count;
+        previous_mean = centroid.mean;
+        previous_position = center_position;
+        cumulative_weight += centroid.weight;
+    }
+    return (previous_position + (this->count - previous_position) * (value - previous_mean) / (this->max_value - previous_mean)) / this->count;
+}
+
+double TDigest::get_count() const{
+    return this->count;
+}
+
+const std::vector<Centroid>& TDigest::get_centroids() const{
+    return this->centroids;
+}
+
+TDigest::~TDigest(){}
+
+void RunningMoments::add(double value){
+    this->count += 1.0;
+    double delta = value - this->mean;
+    this->mean += delta / this->count;
+    this->m2 += delta * (value - this->mean);
+}
+
+void RunningMoments::merge(const RunningMoments& other){
+    if (other.count == 0)
+        return;
+    double total_count = this->count + other.count;
+    double delta = other.mean - this->mean;
+    this->mean += delta * other.count / total_count;
+    this->m2 += other.m2 + delta * delta * this->count * other.count / total_count;
+    this->count = total_count;
+}
+
+double RunningMoments::get_std() const{
+    return (this->count > 1) ? std::sqrt(this->m2 / (this->count - 1)) : 0.0;
+}
+
+MonteCarloAggregator::MonteCarloAggregator(const std::vector<std::time_t>& dates, double compression)
+: dates(dates), digests(dates.size(), TDigest(compression)), moments(dates.size(), RunningMoments{0.0, 0.0, 0.0}), nb_paths(0){}
+
+void MonteCarloAggregator::add_path(const double* values){
+    for (size_t d = 0; d < this->dates.size(); ++d){
+        this->digests[d].add(values[d]);
+        this->moments[d].add(values[d]);
+    }
+    this->nb_paths++;
+}
+
+void MonteCarloAggregator::merge(const MonteCarloAggregator& other){
+    assert(other.dates == this->dates && "Error: only aggregators of the same dates can be merged\n");
+    for (size_t d = 0; d < this->dates.size(); ++d){
+        this->digests[d].merge(other.digests[d]);
+        this->moments[d].merge(other.moments[d]);
+    }
+    this->nb_paths += other.nb_paths;
+}
+
+void MonteCarloAggregator::reset(){
+    for (size_t d = 0; d < this->dates.size(); ++d){
+        this->digests[d].reset();
+        this->moments[d] = {0.0, 0.0, 0.0};
+    }
+    this->nb_paths = 0;
+}
+
+void MonteCarloAggregator::write(ByteWriter& writer) const{
+    writer.put_vector(this->dates);
+    for (const auto& digest: this->digests)
+        digest.write(writer);
+    writer.put_vector(this->moments);
+    writer.put<uint64_t>(this->nb_paths);
+}
+
+void MonteCarloAggregator::read(ByteReader& reader){
+    this->dates = reader.get_vector<std::time_t>();
+    this->digests.assign(this->dates.size(), TDigest(100.0));
+    for (auto& digest: this->digests)
+        digest.read(reader);
+    this->moments = reader.get_vector<RunningMoments>();
+    this->nb_paths = reader.get<uint64_t>();
+}
+
+size_t MonteCarloAggregator::get_nb_paths() const{
+    return this->nb_paths;
+}
+
+const std::vector<std::time_t>& MonteCarloAggregator::get_dates() const{
+    return this->dates;
+}
+
+double MonteCarloAggregator::get_quantile(size_t date_idx, double q) const{
+    return this->digests[date_idx].get_quantile(q);
+}
+
+double MonteCarloAggregator::get_mean(size_t date_idx) const{
+    return this->moments[date_idx].mean;
+}
+
+double MonteCarloAggregator::get_std(size_t date_idx) const{
+    return this->moments[date_idx].get_std();
+}
+
+std::vector<HistogramBin> MonteCarloAggregator::get_end_value_histogram(size_t nb_bins) const{
+    std::vector<HistogramBin> histogram;
+    if (this->nb_paths == 0 || nb_bins == 0)
+        return histogram;
+    const TDigest& end_digest = this->digests.back();
+    double lower_bound = end_digest.get_quantile(0.0);
+    double bin_width = (end_digest.get_quantile(1.0) - lower_bound) / nb_bins;
+    double previous_cdf = 0.0;
+    for (size_t i = 0; i < nb_bins; ++i){
+        double upper_bound = lower_bound + bin_width;
+        double cdf = (i + 1 == nb_bins) ? 1.0 : end_digest.get_cdf(upper_bound);
+        histogram.push_back({lower_bound, upper_bound, (cdf - previous_cdf) * this->nb_paths});
+        previous_cdf = cdf;
+        lower_bound = upper_bound;
+    }
+    return histogram;
+}
+
+void MonteCarloAggregator::save(std::string filename, size_t nb_bins) const{
+    std::ofstream summary_file("../strat_outputs/"+filename+".csv");
+    if (summary_file.is_open()){
+        summary_file << "# paths;" << this->nb_paths << "\n";
+        summary_file << "# end value histogram;lower bound;upper bound;paths\n";
+        for (const auto& bin: this->get_end_value_histogram(nb_bins))
+            summary_file << "# bin;" << bin.lower_bound << ";" << bin.upper_bound << ";" << bin.nb_paths << "\n";
+        summary_file << "Date;Mean;Std;P5;P25;P50;P75;P95\n";
+        for (size_t d = 0; d < this->dates.size(); ++d){
+            summary_file << unix_timestamp_to_date_string(this->dates[d]) << ";" << this->get_mean(d) << ";" << this->get_std(d);
+            for (double q: {0.05, 0.25, 0.5, 0.75, 0.95})
+                summary_file << ";" << this->get_quantile(d, q);
+            summary_file << "\n";
+        }
+        summary_file.close();
+    }
+}
+
+MonteCarloAggregator::~MonteCarloAggregator(){}
+
+static double get_sorted_quantile(const std::vector<double>& sorted_values, double q){
+    double position = q * (sorted_values.size() - 1);
+    size_t idx = std::min(size_t(position), sorted_values.size() - 1);
+    size_t next_idx = std::min(idx + 1, sorted_values.size() - 1);
+    return sorted_values[idx] + (position - idx) * (sorted_values[next_idx] - sorted_values[idx]);
+}
+
+// Standard error of the mean of the replicate estimates
+static double get_replicates_standard_error(const std::vector<double>& replicate_estimates){
+    if (replicate_estimates.size() < 2)
+        return std::numeric_limits<double>::quiet_NaN();
+    RunningMoments moments = {0.0, 0.0, 0.0};
+    for (double estimate: replicate_estimates)
+        moments.add(estimate);
+    return moments.get_std() / std::sqrt(double(replicate_estimates.size()));
+}
+
+MonteCarloEstimates get_montecarlo_estimates(const std::vector<double>& end_values, const std::vector<size_t>& replicates, size_t nb_replicates,
+                                             const std::vector<double>* control_values, double control_expectation, const std::vector<double>& quantile_levels,
+                                             const std::vector<double>* net_investments){
+    assert(replicates.size() == end_values.size() && "Error: every end value needs a replicate\n");
+    assert((control_values == nullptr || control_values->size() == end_values.size()) && "Error: every end value needs a control value\n");
+    assert((net_investments == nullptr || net_investments->size() == end_values.size()) && "Error: every end value needs a net investment\n");
+    size_t n = end_values.size();
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    MonteCarloEstimates estimates = {0, 0.0, 0.0, quantile_levels, {}, {}, nan, nan};
+    if (n == 0)
+        return estimates;
+
+    std::vector<double> adjusted_values = end_values;
+    if (control_values != nullptr){
+        double mean_x = std::accumulate(control_values->begin(), control_values->end(), 0.0) / n;
+        double mean_y = std::accumulate(end_values.begin(), end_values.end(), 0.0) / n;
+        double covariance = 0.0, variance = 0.0;
+        for (size_t i = 0; i < n; ++i){
+            covariance += ((*control_values)[i] - mean_x) * (end_values[i] - mean_y);
+            variance += ((*control_values)[i] - mean_x) * ((*control_values)[i] - mean_x);
+        }
+        double beta = (variance > 0) ? covariance / variance : 0.0;
+        for (size_t i = 0; i < n; ++i)
+            adjusted_values[i] -= beta * ((*control_values)[i] - control_expectation);
+    }
+    estimates.mean = std::accumulate(adjusted_values.begin(), adjusted_values.end(), 0.0) / n;
+
+    std::vector<std::vector<double>> replicate_values(nb_replicates), replicate_adjusted_values(nb_replicates);
+    std::vector<double> replicate_nb_losses(nb_replicates, 0.0);
+    for (size_t i = 0; i < n; ++i){
+        replicate_values[replicates[i]].push_back(end_values[i]);
+        replicate_adjusted_values[replicates[i]].push_back(adjusted_values[i]);
+        if (net_investments != nullptr && end_values[i] < (*net_investments)[i])
+            replicate_nb_losses[replicates[i]] += 1.0;
+    }
+    std::vector<double> replicate_means, replicate_probabilities_of_loss;
+    std::vector<std::vector<double>> replicate_quantiles(quantile_levels.size());
+    for (size_t r = 0; r < nb_replicates; ++r){
+        if (replicate_values[r].empty())
+            continue;
+        replicate_means.push_back(std::accumulate(replicate_adjusted_values[r].begin(), replicate_adjusted_values[r].end(), 0.0) / replicate_values[r].size());
+        replicate_probabilities_of_loss.push_back(replicate_nb_losses[r] / replicate_values[r].size());
+        std::sort(replicate_values[r].begin(), replicate_values[r].end());
+        for (size_t j = 0; j < quantile_levels.size(); ++j)
+            replicate_quantiles[j].push_back(get_sorted_quantile(replicate_values[r], quantile_levels[j]));
+    }
+    estimates.nb_replicates = replicate_means.size();
+    estimates.mean_standard_error = get_replicates_standard_error(replicate_means);
+    if (net_investments != nullptr){
+        estimates.probability_of_loss = std::accumulate(replicate_nb_losses.begin(), replicate_nb_losses.end(), 0.0) / n;
+        estimates.probability_of_loss_standard_error = get_replicates_standard_error(replicate_probabilities_of_loss);
+    }
+
+    std::vector<double> sorted_values = end_values;
+    std::sort(sorted_values.begin(), sorted_values.end());
+    for (size_t j = 0; j < quantile_levels.size(); ++j){
+        estimates.quantiles.push_back(get_sorted_quantile(sorted_values, quantile_levels[j]));
+        estimates.quantile_standard_errors.push_back(get_replicates_standard_error(replicate_quantiles[j]));
+    }
+    return estimates;
+}
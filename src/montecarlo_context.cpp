@@ -0,0 +1,35 @@
+#include "../headers/montecarlo_context.hpp"
+
+MonteCarloPathContext::MonteCarloPathContext(size_t nb_assets, size_t chunk_size, size_t nb_steps)
+: nb_steps(nb_steps), paths(nb_assets, std::vector<double>(chunk_size * nb_steps)), values(chunk_size * nb_steps), nb_engine_constructions(0){
+    for (auto& path: this->paths){
+        this->asset_paths.push_back(path.data());
+        this->const_asset_paths.push_back(path.data());
+    }
+}
+
+const std::vector<double*>& MonteCarloPathContext::get_asset_paths(){
+    return this->asset_paths;
+}
+
+const std::vector<const double*>& MonteCarloPathContext::get_const_asset_paths() const{
+    return this->const_asset_paths;
+}
+
+double* MonteCarloPathContext::get_values(){
+    return this->values.data();
+}
+
+BatchEngine& MonteCarloPathContext::get_engine(const BatchPortfolio& portfolio, size_t nb_paths, RebalancingThreshold rebalancing_mode){
+    if (this->engine == nullptr || this->engine->get_nb_portfolios() != nb_paths){
+        this->engine.reset(new BatchEngine(portfolio, nb_paths, rebalancing_mode));
+        this->nb_engine_constructions++;
+    }
+    return *this->engine;
+}
+
+size_t MonteCarloPathContext::get_nb_engine_constructions() const{
+    return this->nb_engine_constructions;
+}
+
+MonteCarloPathContext::~MonteCarloPathContext(){}
@@ -0,0 +1,433 @@
+#include "../headers/montecarlo_runner.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include "../headers/thread_pool.hpp"
+#include "../headers/path_generator.hpp"
+#include "../headers/multi_asset_simulator.hpp"
+#include "../headers/montecarlo_context.hpp"
+#include "../headers/checkpoint.hpp"
+#include <cassert>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cstdio>
+
+static MonteCarloEstimates get_samples_estimates(const MonteCarloSamples& samples){
+    return get_montecarlo_estimates(samples.end_values, samples.replicates, PathNormalSource::NB_REPLICATES, samples.has_control ? &samples.control_values : nullptr,
+                                    samples.control_expectation, {0.05, 0.25, 0.5, 0.75, 0.95}, &samples.net_investments);
+}
+
+MonteCarloRunner::MonteCarloRunner(): config{42, 0, 0, false, MonteCarloModel::PORTFOLIO_PRICE, BootstrapScheme::STATIONARY_BLOCKS, 20.0, VarianceReduction::NONE,
+                                             {{}, 0.95, 1024, 0.0}, "", 0.0, 0, false},
+                                      samples{0, {}, {}, 0.0, {}, {}, false},
+                                      aggregator(nullptr),
+                                      throughput{0, 0, 0.0, 0.0},
+                                      estimates{0, 0.0, 0.0, {}, {}, {}, 0.0, 0.0},
+                                      convergence{0, 0, 0.0, MonteCarloStopReason::PATH_BUDGET, {}, {}}{}
+
+MonteCarloConfig& MonteCarloRunner::get_config(){
+    return this->config;
+}
+
+const MonteCarloConfig& MonteCarloRunner::get_config() const{
+    return this->config;
+}
+
+const MonteCarloSamples& MonteCarloRunner::get_samples() const{
+    return this->samples;
+}
+
+const MonteCarloAggregator* MonteCarloRunner::get_aggregator() const{
+    return this->aggregator;
+}
+
+const MonteCarloThroughput& MonteCarloRunner::get_throughput() const{
+    return this->throughput;
+}
+
+const MonteCarloEstimates& MonteCarloRunner::get_estimates() const{
+    return this->estimates;
+}
+
+const MonteCarloConvergence& MonteCarloRunner::get_convergence() const{
+    return this->convergence;
+}
+
+
+void MonteCarloRunner::run(size_t nb_simu, std::string strategy_name, const std::vector<YahooTimeseries>& tickers_yt, const PortfolioBuilder& ptf,
+                           OutputFormat output_format, bool is_background_output, const MonteCarloPathStrategy& path_strategy){
+    std::time_t start = (this->config.start_date > 0) ? this->config.start_date : std::time(nullptr);
+    std::tm tm_end;
+    localtime_r(&start, &tm_end);
+    // Add 20 years to the start year
+    tm_end.tm_year += 20;
+    std::time_t end = std::mktime(&tm_end);
+    size_t count = 1 + 252 * 20;
+    std::vector<std::time_t> future_dates = generate_random_dates(count, start, end, this->config.seed);
+    future_dates.erase(std::unique(future_dates.begin(), future_dates.end()), future_dates.end());
+    size_t nb_steps = future_dates.size();
+
+    // The return distribution is estimated once for every path: either the portfolio price as one synthetic ticker,
+    // or every ticker with their correlations so the simulated strategy keeps its allocations and rebalancing
+    std::vector<std::string> path_tickers;
+    std::map<std::string, double> path_allocations;
+    PathGenerator* path_generator = nullptr;
+    MultiAssetSimulator* multi_asset_simulator = nullptr;
+    BlockBootstrapSimulator* bootstrap_simulator = nullptr;
+    VarianceReduction variance_reduction = this->config.variance_reduction;
+    std::vector<double> expected_growths; // per simulated ticker, for the control variate
+    if (this->config.model == MonteCarloModel::CORRELATED_ASSETS){
+        multi_asset_simulator = new MultiAssetSimulator(tickers_yt, PathModel::ARITHMETIC_RETURNS, this->config.seed);
+        multi_asset_simulator->set_variance_reduction(variance_reduction);
+        path_tickers = multi_asset_simulator->get_tickers();
+        path_allocations = path_strategy.assets_desired_pct_allocations;
+        Eigen::VectorXd growths = multi_asset_simulator->get_expected_growths(nb_steps);
+        expected_growths.assign(growths.data(), growths.data() + growths.size());
+    }
+    else if (this->config.model == MonteCarloModel::BLOCK_BOOTSTRAP){
+        if (variance_reduction != VarianceReduction::NONE){
+            fprintf(stderr, "Variance reduction is not available for the block bootstrap, plain resampling is used\n");
+            variance_reduction = VarianceReduction::NONE;
+        }
+        bootstrap_simulator = new BlockBootstrapSimulator(tickers_yt, this->config.bootstrap_scheme, this->config.mean_block_length, this->config.seed);
+        path_tickers = bootstrap_simulator->get_tickers();
+        path_allocations = path_strategy.assets_desired_pct_allocations;
+    }
+    else {
+        Timeseries portfolio_prices = ptf.get_ts_portfolio_prices();
+        double start_price = portfolio_prices.get_ts_values().rbegin()->second;
+        std::vector<double> pct_changes = portfolio_prices.get_pct_changes();
+        double ptf_mean_return = std::accumulate(pct_changes.begin(), pct_changes.end(), 0.0) / pct_changes.size();
+        double ptf_volatility = get_standard_deviation(pct_changes);
+        path_generator = new PathGenerator(PathModel::ARITHMETIC_RETURNS, start_price, ptf_mean_return, ptf_volatility, this->config.seed);
+        path_generator->set_variance_reduction(variance_reduction);
+        expected_growths = {path_generator->get_expected_growth(nb_steps)};
+        path_tickers = {"MonteCarloSimulationTicker"};
+        path_allocations = {{"MonteCarloSimulationTicker", 1.0}};
+    }
+    size_t nb_assets = path_tickers.size();
+    auto generate_paths = [&](size_t first_path, size_t nb_paths, const std::vector<double*>& asset_paths){
+        if (multi_asset_simulator != nullptr)
+            multi_asset_simulator->generate(first_path, nb_paths, nb_steps, asset_paths);
+        else if (bootstrap_simulator != nullptr)
+            bootstrap_simulator->generate(first_path, nb_paths, nb_steps, asset_paths);
+        else
+            path_generator->generate(first_path, nb_paths, nb_steps, asset_paths[0]);
+    };
+
+    delete this->aggregator;
+    this->aggregator = new MonteCarloAggregator(future_dates, 100.0);
+    // Control variate: growth of a lump sum of 1 split by the allocations and never rebalanced, E[x] is analytic
+    bool has_control = variance_reduction == VarianceReduction::CONTROL_VARIATE;
+    MonteCarloSamples& samples = this->samples;
+    samples = {this->config.shard_first_path, {}, {}, 0.0, {}, {}, has_control};
+
+    // Binary saved paths are the value columns of one result file, which the batched engine gives as well
+    bool is_binary_paths = this->config.save_paths && output_format == OutputFormat::BINARY;
+    bool is_batched = path_strategy.batch_portfolio != nullptr && (!this->config.save_paths || is_binary_paths);
+    BatchPortfolio path_batch_portfolio = is_batched ? *path_strategy.batch_portfolio : BatchPortfolio();
+    path_batch_portfolio.allocations.clear();
+    for (const auto& ticker: path_tickers)
+        path_batch_portfolio.allocations.push_back(path_allocations.count(ticker) ? path_allocations.at(ticker) : 0.0);
+    for (size_t a = 0; a < nb_assets && !expected_growths.empty(); ++a)
+        samples.control_expectation += path_batch_portfolio.allocations[a] * expected_growths[a];
+    std::vector<std::vector<char>> is_contribution_dates(nb_assets, std::vector<char>(nb_steps, 0));
+    if (path_strategy.batch_contribution == BatchContribution::MONTHLY){
+        for (const auto& date: extract_first_dates_of_each_month(future_dates)){
+            size_t date_idx = std::lower_bound(future_dates.begin(), future_dates.end(), date) - future_dates.begin();
+            for (auto& asset_contribution_dates: is_contribution_dates)
+                asset_contribution_dates[date_idx] = 1;
+        }
+    }
+    else {
+        for (auto& asset_contribution_dates: is_contribution_dates)
+            asset_contribution_dates[0] = 1;
+    }
+
+    // Paths are aggregated by fixed chunks, and the chunks merged in order: the summary does not depend on the thread count.
+    // Chunks are processed by waves so only a few chunk aggregators are alive at once.
+    // With a stopping rule, paths run by batches (whole chunks and antithetic pairs) until the target precision is met.
+    const size_t chunk_size = 16;
+    const MonteCarloStoppingRule& stopping_rule = this->config.stopping_rule;
+    bool is_adaptive = !stopping_rule.targets.empty() && !this->config.is_shard;
+    size_t batch_granularity = 2 * PathNormalSource::NB_REPLICATES;
+    size_t batch_size = is_adaptive ? (std::max<size_t>(stopping_rule.batch_size, 1) + batch_granularity - 1) / batch_granularity * batch_granularity : nb_simu;
+    MonteCarloConvergence convergence = {0, 0, 0.0, MonteCarloStopReason::PATH_BUDGET, {}, {}};
+    ThreadPool pool(this->config.nb_threads);
+    size_t wave_size = 4 * pool.get_nb_threads();
+    // Buffers, engines and chunk aggregators are allocated once per run and reset between chunks
+    std::vector<MonteCarloPathContext> contexts;
+    contexts.reserve(pool.get_nb_threads());
+    for (size_t t = 0; t < pool.get_nb_threads(); ++t)
+        contexts.emplace_back(nb_assets, chunk_size, nb_steps);
+    std::vector<MonteCarloAggregator> chunk_aggregators(wave_size, MonteCarloAggregator(future_dates, 100.0));
+    auto start_time = std::chrono::steady_clock::now();
+    size_t nb_done_paths = 0;   // paths of the completed batches
+    size_t nb_merged_paths = 0; // paths already merged in the aggregator, the current batch included
+    size_t resumed_batch_end = 0;
+
+    // A checkpoint holds the run settings, the progress, the per-path samples and the aggregator: path i always draws
+    // from the Philox stream (seed, i) and chunks are merged in order, so a resumed run ends with the results of an uninterrupted one
+    bool has_checkpoint = !this->config.checkpoint_filename.empty() && !this->config.is_shard;
+    ByteWriter checkpoint_settings;
+    checkpoint_settings.put_string(strategy_name);
+    checkpoint_settings.put<uint64_t>(nb_simu);
+    checkpoint_settings.put(this->config.seed);
+    checkpoint_settings.put(this->config.model);
+    checkpoint_settings.put(variance_reduction);
+    checkpoint_settings.put(this->config.bootstrap_scheme);
+    checkpoint_settings.put(this->config.mean_block_length);
+    checkpoint_settings.put<uint64_t>(batch_size);
+    checkpoint_settings.put(is_batched);
+    checkpoint_settings.put(path_batch_portfolio.starting_amount);
+    checkpoint_settings.put(path_batch_portfolio.recurrent_investment_amount);
+    checkpoint_settings.put(path_batch_portfolio.rebalancing_freq);
+    checkpoint_settings.put(path_batch_portfolio.rebalancing_threshold);
+    checkpoint_settings.put_vector(path_batch_portfolio.allocations);
+    checkpoint_settings.put(path_strategy.rebalancing_mode);
+    checkpoint_settings.put_vector(future_dates);
+    std::string checkpoint;
+    if (has_checkpoint && read_checkpoint(this->config.checkpoint_filename, checkpoint)){
+        ByteReader reader(checkpoint);
+        if (reader.get_string() != checkpoint_settings.get_bytes())
+            fprintf(stderr, "The checkpoint %s belongs to another run, starting over\n", this->config.checkpoint_filename.c_str());
+        else {
+            nb_done_paths = reader.get<uint64_t>();
+            nb_merged_paths = reader.get<uint64_t>();
+            resumed_batch_end = reader.get<uint64_t>();
+            convergence.nb_batches = reader.get<uint64_t>();
+            samples.end_values = reader.get_vector<double>();
+            samples.control_values = reader.get_vector<double>();
+            samples.net_investments = reader.get_vector<double>();
+            samples.replicates = reader.get_vector<size_t>();
+            this->aggregator->read(reader);
+            std::cout << "Monte Carlo " << strategy_name << " resumed from " << this->config.checkpoint_filename << " after " << nb_merged_paths << " paths" << std::endl;
+        }
+    }
+    // A resumed run appends to the paths it had written
+    ResultFileWriter* paths_file = nullptr;
+    std::vector<double> wave_path_values;
+    if (is_binary_paths){
+        std::string paths_filename = strategy_name + "_MonteCarloPaths" + (this->config.is_shard ? "_" + std::to_string(samples.first_path) : "");
+        paths_file = new ResultFileWriter("../strat_outputs/" + paths_filename + ".res", future_dates, std::max(nb_done_paths, nb_merged_paths));
+        wave_path_values.resize(wave_size * chunk_size * nb_steps);
+    }
+    auto last_checkpoint_time = std::chrono::steady_clock::now();
+    auto save_checkpoint = [&](size_t batch_end){
+        ByteWriter writer;
+        writer.put_string(checkpoint_settings.get_bytes());
+        writer.put<uint64_t>(nb_done_paths);
+        writer.put<uint64_t>(nb_merged_paths);
+        writer.put<uint64_t>(batch_end);
+        writer.put<uint64_t>(convergence.nb_batches);
+        writer.put_vector(samples.end_values);
+        writer.put_vector(samples.control_values);
+        writer.put_vector(samples.net_investments);
+        writer.put_vector(samples.replicates);
+        this->aggregator->write(writer);
+        write_checkpoint(this->config.checkpoint_filename, writer.get_bytes());
+        last_checkpoint_time = std::chrono::steady_clock::now();
+    };
+
+    while (nb_done_paths < nb_simu){
+        size_t batch_end = (resumed_batch_end > nb_done_paths) ? resumed_batch_end : std::min(nb_simu, nb_done_paths + batch_size);
+        samples.end_values.resize(batch_end, 0.0);
+        samples.control_values.resize(batch_end, 0.0);
+        samples.net_investments.resize(batch_end, 0.0);
+        size_t nb_chunks = (batch_end + chunk_size - 1) / chunk_size;
+        for (size_t first_chunk = std::max(nb_done_paths, nb_merged_paths) / chunk_size; first_chunk < nb_chunks; first_chunk += wave_size){
+            size_t nb_wave_chunks = std::min(wave_size, nb_chunks - first_chunk);
+            pool.parallel_for(nb_wave_chunks, [&](size_t c){
+                size_t first_path = (first_chunk + c) * chunk_size;
+                size_t nb_chunk_paths = std::min(batch_end, first_path + chunk_size) - first_path;
+                MonteCarloPathContext& context = contexts[ThreadPool::get_worker_index()];
+                const std::vector<const double*>& paths = context.get_const_asset_paths();
+                generate_paths(samples.first_path + first_path, nb_chunk_paths, context.get_asset_paths());
+                for (size_t p = 0; p < nb_chunk_paths; ++p){
+                    for (size_t a = 0; a < nb_assets; ++a)
+                        samples.control_values[first_path + p] += path_batch_portfolio.allocations[a] * paths[a][p * nb_steps + nb_steps - 1] / paths[a][p * nb_steps];
+                }
+                if (is_batched){
+                    double* values = context.get_values();
+                    BatchEngine& engine = context.get_engine(path_batch_portfolio, nb_chunk_paths, path_strategy.rebalancing_mode);
+                    engine.run_paths(paths, nb_steps, is_contribution_dates, values);
+                    for (size_t p = 0; p < nb_chunk_paths; ++p){
+                        chunk_aggregators[c].add_path(&values[p * nb_steps]);
+                        if (paths_file != nullptr)
+                            std::copy(&values[p * nb_steps], &values[(p + 1) * nb_steps], &wave_path_values[(c * chunk_size + p) * nb_steps]);
+                        samples.end_values[first_path + p] = values[p * nb_steps + nb_steps - 1];
+                        samples.net_investments[first_path + p] = engine.get_net_investments()[p];
+                    }
+                    return;
+                }
+                // Saved paths keep one full strategy per path: its portfolio ledger is what gets written
+                std::vector<double> values;
+                for (size_t p = 0; p < nb_chunk_paths; ++p){
+                    size_t i = first_path + p;
+                    std::vector<YahooTimeseries> path_tickers_yt;
+                    for (size_t a = 0; a < nb_assets; ++a){
+                        std::vector<double> prices(paths[a] + p * nb_steps, paths[a] + (p + 1) * nb_steps);
+                        path_tickers_yt.emplace_back(path_tickers[a], future_dates, prices, prices, prices, prices, prices);
+                    }
+                    Strategy* strat = path_strategy.path_strategy_factory(path_tickers_yt, path_allocations, strategy_name + "_MonteCarloSimu_n" + std::to_string(samples.first_path + i + 1));
+                    strat->run_strategy();
+                    if (this->config.save_paths && !is_binary_paths){
+                        strat->set_background_output(is_background_output);
+                        strat->save_end_portfolio();
+                    }
+                    values.clear();
+                    for (const auto& pair: strat->get_strategy_values())
+                        values.push_back(pair.second);
+                    assert(values.size() == nb_steps && "Error: every Monte Carlo path must cover the simulated dates\n");
+                    chunk_aggregators[c].add_path(values.data());
+                    if (paths_file != nullptr)
+                        std::copy(values.begin(), values.end(), &wave_path_values[(c * chunk_size + p) * nb_steps]);
+                    samples.end_values[i] = values.back();
+                    for (const auto& pair: strat->get_portfolio().get_portfolio_historical_cash_flow())
+                        samples.net_investments[i] -= pair.second;
+                    delete strat;
+                }
+            });
+            if (paths_file != nullptr){
+                size_t first_wave_path = first_chunk * chunk_size;
+                std::vector<std::string> names;
+                for (size_t i = first_wave_path; i < std::min(batch_end, (first_chunk + nb_wave_chunks) * chunk_size); ++i)
+                    names.push_back(strategy_name + "_MonteCarloSimu_n" + std::to_string(samples.first_path + i + 1));
+                paths_file->append_columns(names, wave_path_values.data());
+            }
+            for (size_t c = 0; c < nb_wave_chunks; ++c){
+                this->aggregator->merge(chunk_aggregators[c]);
+                chunk_aggregators[c].reset();
+            }
+            nb_merged_paths = std::min(batch_end, (first_chunk + nb_wave_chunks) * chunk_size);
+            std::chrono::duration<double> checkpoint_age = std::chrono::steady_clock::now() - last_checkpoint_time;
+            if (has_checkpoint && nb_merged_paths < batch_end && checkpoint_age.count() >= this->config.checkpoint_interval)
+                save_checkpoint(batch_end);
+        }
+        for (size_t i = nb_done_paths; i < batch_end; ++i)
+            samples.replicates.push_back(PathNormalSource::get_replicate(variance_reduction, samples.first_path + i));
+        nb_done_paths = batch_end;
+        ++convergence.nb_batches;
+        std::chrono::duration<double> checkpoint_age = std::chrono::steady_clock::now() - last_checkpoint_time;
+        if (has_checkpoint && nb_done_paths < nb_simu && checkpoint_age.count() >= this->config.checkpoint_interval)
+            save_checkpoint(batch_end);
+        if (!is_adaptive)
+            continue;
+
+        MonteCarloEstimates estimates = get_samples_estimates(samples);
+        bool has_converged = false;
+        MonteCarloConvergence batch_convergence = ::get_montecarlo_convergence(estimates, stopping_rule, has_converged);
+        convergence.estimates = batch_convergence.estimates;
+        convergence.half_widths = batch_convergence.half_widths;
+        std::chrono::duration<double> batch_elapsed = std::chrono::steady_clock::now() - start_time;
+        if (has_converged){
+            convergence.stop_reason = MonteCarloStopReason::PRECISION_MET;
+            break;
+        }
+        if (stopping_rule.max_seconds > 0 && batch_elapsed.count() >= stopping_rule.max_seconds){
+            convergence.stop_reason = MonteCarloStopReason::TIME_BUDGET;
+            break;
+        }
+    }
+    delete path_generator;
+    delete multi_asset_simulator;
+    delete bootstrap_simulator;
+    delete paths_file;
+    if (has_checkpoint)
+        remove_checkpoint(this->config.checkpoint_filename);
+
+    this->estimates = get_samples_estimates(samples);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    convergence.nb_paths = nb_done_paths;
+    convergence.elapsed_seconds = elapsed.count();
+    this->convergence = convergence;
+    this->throughput = {pool.get_nb_threads(), nb_done_paths, elapsed.count(), nb_done_paths / elapsed.count()};
+    if (!this->config.is_shard)
+        this->report_results(strategy_name);
+}
+
+void MonteCarloRunner::run_distributed(size_t nb_simu, std::string strategy_name, LocalCluster& cluster, size_t shard_size, const std::function<void(size_t)>& run_shard){
+    assert(nb_simu > 0 && "Error: at least one path must be simulated\n");
+    std::vector<std::string> shards = cluster.run(nb_simu, shard_size, [this, &run_shard](size_t first_path, size_t nb_paths){
+        this->config.shard_first_path = first_path;
+        this->config.is_shard = true;
+        run_shard(nb_paths);
+        const MonteCarloSamples& samples = this->samples;
+        ByteWriter writer;
+        writer.put(samples.control_expectation);
+        writer.put(samples.has_control);
+        writer.put_vector(samples.end_values);
+        writer.put_vector(samples.control_values);
+        writer.put_vector(samples.net_investments);
+        writer.put_vector(samples.replicates);
+        this->aggregator->write(writer);
+        return writer.get_bytes();
+    });
+    // Shards run by the coordinator itself (lost workers) left it in shard mode
+    this->config.shard_first_path = 0;
+    this->config.is_shard = false;
+
+    MonteCarloSamples samples = {0, {}, {}, 0.0, {}, {}, false};
+    MonteCarloAggregator aggregator({}, 100.0);
+    for (size_t shard_idx = 0; shard_idx < shards.size(); ++shard_idx){
+        ByteReader reader(shards[shard_idx]);
+        samples.control_expectation = reader.get<double>();
+        samples.has_control = reader.get<bool>();
+        for (std::vector<double>* values: {&samples.end_values, &samples.control_values, &samples.net_investments}){
+            std::vector<double> shard_values = reader.get_vector<double>();
+            values->insert(values->end(), shard_values.begin(), shard_values.end());
+        }
+        std::vector<size_t> replicates = reader.get_vector<size_t>();
+        samples.replicates.insert(samples.replicates.end(), replicates.begin(), replicates.end());
+        MonteCarloAggregator shard_aggregator({}, 100.0);
+        shard_aggregator.read(reader);
+        if (shard_idx == 0)
+            aggregator = shard_aggregator;
+        else
+            aggregator.merge(shard_aggregator);
+    }
+    const DistributedThroughput& throughput = cluster.get_throughput();
+    this->set_results(strategy_name, samples, aggregator, {throughput.nb_workers, nb_simu, throughput.elapsed_seconds, throughput.items_per_second});
+}
+
+void MonteCarloRunner::set_results(std::string strategy_name, const MonteCarloSamples& samples, const MonteCarloAggregator& aggregator, const MonteCarloThroughput& throughput){
+    this->samples = samples;
+    delete this->aggregator;
+    this->aggregator = new MonteCarloAggregator(aggregator);
+    this->estimates = get_samples_estimates(samples);
+    this->throughput = throughput;
+    this->convergence = {samples.end_values.size(), 1, throughput.elapsed_seconds, MonteCarloStopReason::PATH_BUDGET, {}, {}};
+    this->report_results(strategy_name);
+}
+
+void MonteCarloRunner::report_results(std::string strategy_name) const{
+    const MonteCarloThroughput& throughput = this->throughput;
+    std::cout << "Monte Carlo " << strategy_name << ": " << throughput.nb_paths << " paths on " << throughput.nb_threads << " threads in "
+              << throughput.elapsed_seconds << "s (" << throughput.paths_per_second << " paths/s)" << std::endl;
+    size_t end_idx = this->aggregator->get_dates().size() - 1;
+    std::cout << "End values 5%: " << this->aggregator->get_quantile(end_idx, 0.05) << " - 25%: " << this->aggregator->get_quantile(end_idx, 0.25)
+              << " - 50%: " << this->aggregator->get_quantile(end_idx, 0.5) << " - 75%: " << this->aggregator->get_quantile(end_idx, 0.75)
+              << " - 95%: " << this->aggregator->get_quantile(end_idx, 0.95) << std::endl;
+    const MonteCarloEstimates& estimates = this->estimates;
+    std::cout << "End value mean: " << estimates.mean << " (standard error " << estimates.mean_standard_error << ")";
+    for (size_t j = 0; j < estimates.quantile_levels.size(); ++j)
+        std::cout << " - " << 100 * estimates.quantile_levels[j] << "%: " << estimates.quantiles[j] << " (" << estimates.quantile_standard_errors[j] << ")";
+    std::cout << " - probability of loss: " << estimates.probability_of_loss << " (" << estimates.probability_of_loss_standard_error << ")"
+              << " over " << estimates.nb_replicates << " replicates" << std::endl;
+    const MonteCarloConvergence& convergence = this->convergence;
+    const MonteCarloStoppingRule& stopping_rule = this->config.stopping_rule;
+    if (!convergence.half_widths.empty()){
+        std::string stop_reasons[] = {"target precision met", "path budget used", "time budget spent"};
+        std::cout << "Adaptive Monte Carlo: " << stop_reasons[int(convergence.stop_reason)] << " after " << convergence.nb_batches << " batches";
+        for (size_t j = 0; j < stopping_rule.targets.size(); ++j)
+            std::cout << " - " << get_statistic_name(stopping_rule.targets[j].statistic) << ": " << convergence.estimates[j] << " +- " << convergence.half_widths[j]
+                      << (stopping_rule.targets[j].statistic == MonteCarloStatistic::PROBABILITY_OF_LOSS ? "" : " (relative)") << " for " << stopping_rule.targets[j].max_half_width;
+        std::cout << std::endl;
+    }
+    this->aggregator->save(strategy_name + "_MonteCarloSummary", 30);
+}
+
+MonteCarloRunner::~MonteCarloRunner(){
+    delete this->aggregator;
+}
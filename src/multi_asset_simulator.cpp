@@ -0,0 +1,137 @@
+#include "../headers/multi_asset_simulator.hpp"
+#include <cassert>
+#include <cmath>
+#include <set>
+#include <algorithm>
+
+Eigen::MatrixXd get_common_dates_returns(const std::vector<YahooTimeseries>& tickers_yt, Eigen::VectorXd& last_prices){
+    assert(!tickers_yt.empty() && "Error: at least one ticker is needed\n");
+
+    std::set<std::time_t> common_dates(tickers_yt[0].get_dates().begin(), tickers_yt[0].get_dates().end());
+    for (const auto& ticker_yt: tickers_yt){
+        std::set<std::time_t> ticker_dates(ticker_yt.get_dates().begin(), ticker_yt.get_dates().end());
+        std::set<std::time_t> intersection;
+        std::set_intersection(common_dates.begin(), common_dates.end(), ticker_dates.begin(), ticker_dates.end(), std::inserter(intersection, intersection.end()));
+        common_dates = intersection;
+    }
+    assert(common_dates.size() > 2 && "Error: tickers must share at least 3 dates\n");
+
+    size_t nb_assets = tickers_yt.size();
+    Eigen::MatrixXd returns(common_dates.size() - 1, nb_assets);
+    last_prices.resize(nb_assets);
+    for (size_t j = 0; j < nb_assets; ++j){
+        const Timeseries& closes = tickers_yt[j].get_closes();
+        double previous_price = closes.get_ts_value(*common_dates.begin());
+        size_t i = 0;
+        for (auto it = std::next(common_dates.begin()); it != common_dates.end(); ++it, ++i){
+            double price = closes.get_ts_value(*it);
+            returns(i, j) = (price - previous_price) / previous_price;
+            previous_price = price;
+        }
+        last_prices(j) = closes.get_ts_values().rbegin()->second;
+    }
+    return returns;
+}
+
+MultiAssetSimulator::MultiAssetSimulator(const std::vector<YahooTimeseries>& tickers_yt, PathModel model, uint64_t seed)
+: model(model), seed(seed), variance_reduction(VarianceReduction::NONE){
+    for (const auto& ticker_yt: tickers_yt)
+        this->tickers.push_back(ticker_yt.get_ticker());
+    size_t nb_assets = tickers_yt.size();
+    Eigen::MatrixXd returns = get_common_dates_returns(tickers_yt, this->start_prices);
+
+    Eigen::RowVectorXd mean_returns = returns.colwise().mean();
+    Eigen::MatrixXd centered_returns = returns.rowwise() - mean_returns;
+    this->mean_returns = mean_returns.transpose();
+    this->covariance = (centered_returns.transpose() * centered_returns) / double(returns.rows() - 1);
+
+    // Collinear tickers make C only semi-definite: a growing diagonal jitter keeps the factorization possible
+    Eigen::MatrixXd jittered_covariance = this->covariance;
+    double jitter = 1e-12 * std::max(1e-12, this->covariance.trace() / nb_assets);
+    Eigen::LLT<Eigen::MatrixXd> llt(jittered_covariance);
+    while (llt.info() != Eigen::Success){
+        jittered_covariance.diagonal().array() += jitter;
+        jitter *= 10.0;
+        llt.compute(jittered_covariance);
+    }
+    this->cholesky_factor = llt.matrixL();
+}
+
+void MultiAssetSimulator::set_variance_reduction(VarianceReduction variance_reduction){
+    this->variance_reduction = variance_reduction;
+}
+
+void MultiAssetSimulator::generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps, const std::vector<double*>& asset_paths) const{
+    size_t nb_assets = this->tickers.size();
+    assert(asset_paths.size() == nb_assets && "Error: one path buffer per asset is needed\n");
+    if (nb_steps == 0 || nb_paths == 0)
+        return;
+
+    // Column-major [assets x (paths * (steps - 1))]: the normals of path p are contiguous and drawn from its own stream
+    size_t nb_shocks = nb_steps - 1;
+    Eigen::MatrixXd normals(nb_assets, nb_paths * nb_shocks);
+    PathNormalSource normal_source(this->variance_reduction, this->seed, nb_assets, nb_shocks);
+    for (size_t p = 0; p < nb_paths; ++p)
+        normal_source.fill(first_path_idx + p, normals.data() + p * nb_assets * nb_shocks);
+    Eigen::MatrixXd shocks = this->cholesky_factor.triangularView<Eigen::Lower>() * normals;
+
+    for (size_t a = 0; a < nb_assets; ++a){
+        double mean_return = this->mean_returns(a);
+        double drift = mean_return - 0.5 * this->covariance(a, a);
+        for (size_t p = 0; p < nb_paths; ++p){
+            double* path = asset_paths[a] + p * nb_steps;
+            const double* path_shocks = shocks.data() + p * nb_assets * nb_shocks + a;
+            path[0] = this->start_prices(a);
+            if (this->model == PathModel::GEOMETRIC_BROWNIAN_MOTION){
+                double log_price = std::log(path[0]);
+                for (size_t s = 1; s < nb_steps; ++s){
+                    log_price += drift + path_shocks[(s - 1) * nb_assets];
+                    path[s] = std::exp(log_price);
+                }
+            }
+            else {
+                for (size_t s = 1; s < nb_steps; ++s)
+                    path[s] = path[s - 1] * (1.0 + mean_return + path_shocks[(s - 1) * nb_assets]);
+            }
+        }
+    }
+}
+
+std::vector<std::vector<double>> MultiAssetSimulator::generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps) const{
+    std::vector<std::vector<double>> paths(this->tickers.size(), std::vector<double>(nb_paths * nb_steps));
+    std::vector<double*> asset_paths;
+    for (auto& asset_path: paths)
+        asset_paths.push_back(asset_path.data());
+    this->generate(first_path_idx, nb_paths, nb_steps, asset_paths);
+    return paths;
+}
+
+Eigen::VectorXd MultiAssetSimulator::get_expected_growths(size_t nb_steps) const{
+    double horizon = (nb_steps > 0) ? nb_steps - 1.0 : 0.0;
+    Eigen::VectorXd expected_growths(this->tickers.size());
+    for (size_t a = 0; a < this->tickers.size(); ++a){
+        if (this->model == PathModel::GEOMETRIC_BROWNIAN_MOTION)
+            expected_growths(a) = std::exp(this->mean_returns(a) * horizon);
+        else
+            expected_growths(a) = std::pow(1.0 + this->mean_returns(a), horizon);
+    }
+    return expected_growths;
+}
+
+const std::vector<std::string>& MultiAssetSimulator::get_tickers() const{
+    return this->tickers;
+}
+
+const Eigen::VectorXd& MultiAssetSimulator::get_mean_returns() const{
+    return this->mean_returns;
+}
+
+const Eigen::MatrixXd& MultiAssetSimulator::get_covariance() const{
+    return this->covariance;
+}
+
+const Eigen::MatrixXd& MultiAssetSimulator::get_cholesky_factor() const{
+    return this->cholesky_factor;
+}
+
+MultiAssetSimulator::~MultiAssetSimulator(){}
@@ -0,0 +1,301 @@
+#include "../headers/parameter_sweep.hpp"
+#include "../headers/thread_pool.hpp"
+#include "../headers/checkpoint.hpp"
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <algorithm>
+#include <set>
+#include <cstdio>
+
+static double get_parameter(const std::map<std::string, double>& parameters, std::string name, double default_value){
+    auto it = parameters.find(name);
+    return (it != parameters.end()) ? it->second : default_value;
+}
+
+std::map<std::string, double> get_swept_allocations(const std::map<std::string, double>& default_allocations, const std::map<std::string, double>& parameters){
+    const std::string weight_prefix = "weight:";
+    std::map<std::string, double> allocations = default_allocations;
+    for (const auto& pair: parameters)
+        if (pair.first.compare(0, weight_prefix.size(), weight_prefix) == 0)
+            allocations[pair.first.substr(weight_prefix.size())] = pair.second;
+
+    // Weights swept down to 0 stay as explicit 0.0 entries: the strategies look every ticker up
+    double sum = 0.0;
+    for (auto& pair: allocations){
+        pair.second = std::max(pair.second, 0.0);
+        sum += pair.second;
+    }
+    assert(sum > 0 && "Error: at least one allocation weight must be > 0\n");
+    for (auto& pair: allocations)
+        pair.second /= sum;
+    return allocations;
+}
+
+StrategyFactory get_dca_factory(double starting_amount, double recurrent_investment_amount, const std::map<std::string, double>& assets_desired_pct_allocations, int rebalancing_freq, double rebalancing_threshold){
+    return [=](SharedTickers tickers_yt, const std::map<std::string, double>& parameters) -> Strategy* {
+        return new DCA(tickers_yt,
+                       starting_amount,
+                       recurrent_investment_amount,
+                       get_swept_allocations(assets_desired_pct_allocations, parameters),
+                       (int)get_parameter(parameters, "rebalancing_freq", rebalancing_freq),
+                       get_parameter(parameters, "rebalancing_threshold", rebalancing_threshold),
+                       "DCA_Sweep");
+    };
+}
+
+StrategyFactory get_sma_optimized_dca_factory(double starting_amount, double recurrent_investment_amount, const std::map<std::string, double>& assets_desired_pct_allocations, int rebalancing_freq, double rebalancing_threshold, int sma_window_size){
+    return [=](SharedTickers tickers_yt, const std::map<std::string, double>& parameters) -> Strategy* {
+        return new SmaOptimizedDCA(tickers_yt,
+                                   starting_amount,
+                                   recurrent_investment_amount,
+                                   get_swept_allocations(assets_desired_pct_allocations, parameters),
+                                   (int)get_parameter(parameters, "rebalancing_freq", rebalancing_freq),
+                                   get_parameter(parameters, "rebalancing_threshold", rebalancing_threshold),
+                                   (int)get_parameter(parameters, "sma_window_size", sma_window_size),
+                                   "SmaOptimizedDCA_Sweep");
+    };
+}
+
+StrategyFactory get_lump_sum_factory(double initial_investment_amount, const std::map<std::string, double>& assets_desired_pct_allocations, int rebalancing_freq, double rebalancing_threshold){
+    return [=](SharedTickers tickers_yt, const std::map<std::string, double>& parameters) -> Strategy* {
+        return new LumpSum(tickers_yt,
+                           initial_investment_amount,
+                           get_swept_allocations(assets_desired_pct_allocations, parameters),
+                           (int)get_parameter(parameters, "rebalancing_freq", rebalancing_freq),
+                           get_parameter(parameters, "rebalancing_threshold", rebalancing_threshold),
+                           "LumpSum_Sweep");
+    };
+}
+
+// Only the metrics are written: the parameters of a result are those of its parameter set
+static void write_metrics(ByteWriter& writer, const SweepResult& result){
+    writer.put(result.total_return);
+    writer.put(result.xirr);
+    writer.put(result.volatility);
+    writer.put(result.max_drawdown);
+}
+
+static SweepResult read_metrics(ByteReader& reader, const std::map<std::string, double>& parameters){
+    SweepResult result = {parameters, 0.0, 0.0, 0.0, 0.0};
+    result.total_return = reader.get<double>();
+    result.xirr = reader.get<double>();
+    result.volatility = reader.get<double>();
+    result.max_drawdown = reader.get<double>();
+    return result;
+}
+
+ParameterSweep::ParameterSweep(const std::vector<YahooTimeseries>& tickers_yt, StrategyFactory strategy_factory, const std::vector<ParameterRange>& parameter_ranges)
+: tickers_yt(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt)), strategy_factory(strategy_factory), parameter_ranges(parameter_ranges), throughput({0, 0, 0.0, 0.0}),
+  checkpoint_filename(""), checkpoint_interval(0.0){
+    for (const auto& range: parameter_ranges)
+        assert(range.min_value <= range.max_value && "Error: parameter range min value must be <= max value\n");
+}
+
+std::vector<std::map<std::string, double>> ParameterSweep::get_parameter_sets(SweepSampling sampling, size_t nb_samples, unsigned int seed) const{
+    std::vector<std::vector<double>> sampled_values; // [sample][parameter]
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> uniform_dist(0.0, 1.0);
+    size_t nb_parameters = this->parameter_ranges.size();
+
+    if (sampling == SweepSampling::CARTESIAN){
+        sampled_values.push_back({});
+        for (const auto& range: this->parameter_ranges){
+            std::vector<std::vector<double>> product;
+            for (const auto& partial_values: sampled_values)
+                for (size_t i = 0; i < std::max<size_t>(1, range.nb_values); ++i){
+                    double step = (range.nb_values > 1) ? (range.max_value - range.min_value) / (range.nb_values - 1) : 0.0;
+                    std::vector<double> values = partial_values;
+                    values.push_back(range.min_value + i * step);
+                    product.push_back(values);
+                }
+            sampled_values = product;
+        }
+    }
+    else if (sampling == SweepSampling::RANDOM){
+        sampled_values.assign(nb_samples, std::vector<double>(nb_parameters));
+        for (size_t s = 0; s < nb_samples; ++s)
+            for (size_t p = 0; p < nb_parameters; ++p){
+                const ParameterRange& range = this->parameter_ranges[p];
+                sampled_values[s][p] = range.min_value + uniform_dist(generator) * (range.max_value - range.min_value);
+            }
+    }
+    else {
+        // Latin hypercube: every parameter range is cut in nb_samples strata and each stratum is drawn exactly once
+        sampled_values.assign(nb_samples, std::vector<double>(nb_parameters));
+        std::vector<size_t> strata(nb_samples);
+        for (size_t p = 0; p < nb_parameters; ++p){
+            const ParameterRange& range = this->parameter_ranges[p];
+            std::iota(strata.begin(), strata.end(), 0);
+            std::shuffle(strata.begin(), strata.end(), generator);
+            for (size_t s = 0; s < nb_samples; ++s)
+                sampled_values[s][p] = range.min_value + (strata[s] + uniform_dist(generator)) / nb_samples * (range.max_value - range.min_value);
+        }
+    }
+
+    std::vector<std::map<std::string, double>> parameter_sets;
+    std::set<std::map<std::string, double>> unique_parameter_sets;
+    for (const auto& values: sampled_values){
+        std::map<std::string, double> parameters;
+        for (size_t p = 0; p < nb_parameters; ++p){
+            const ParameterRange& range = this->parameter_ranges[p];
+            parameters[range.name] = range.is_integer ? std::round(values[p]) : values[p];
+        }
+        if (unique_parameter_sets.insert(parameters).second)
+            parameter_sets.push_back(parameters);
+    }
+    return parameter_sets;
+}
+
+SweepResult ParameterSweep::run_backtest(const std::map<std::string, double>& parameters) const{
+    Strategy* strat = this->strategy_factory(this->tickers_yt, parameters);
+    strat->run_strategy();
+    SweepResult result = {parameters,
+                          strat->get_strategy_total_returns(),
+                          strat->get_strategy_extended_internal_return_rate(1e-3, 1000),
+                          strat->get_strategy_volatility(),
+                          strat->get_strategy_max_drawdown()};
+    delete strat;
+    return result;
+}
+
+void ParameterSweep::set_checkpoint(std::string filename, double interval_seconds){
+    this->checkpoint_filename = filename;
+    this->checkpoint_interval = interval_seconds;
+}
+
+const std::vector<SweepResult>& ParameterSweep::run(const std::vector<std::map<std::string, double>>& parameter_sets, size_t nb_threads){
+    std::vector<SweepResult> results(parameter_sets.size());
+    ThreadPool pool(nb_threads);
+
+    auto start = std::chrono::steady_clock::now();
+    if (this->checkpoint_filename.empty()){
+        pool.parallel_for(parameter_sets.size(), [&](size_t i){
+            results[i] = this->run_backtest(parameter_sets[i]);
+        });
+    }
+    else {
+        // Backtests run by waves; the metrics of the completed prefix of parameter_sets are checkpointed
+        ByteWriter settings;
+        settings.put<uint64_t>(parameter_sets.size());
+        for (const auto& parameters: parameter_sets){
+            settings.put<uint64_t>(parameters.size());
+            for (const auto& pair: parameters){
+                settings.put_string(pair.first);
+                settings.put(pair.second);
+            }
+        }
+        size_t nb_done_sets = 0;
+        std::string checkpoint;
+        if (read_checkpoint(this->checkpoint_filename, checkpoint)){
+            ByteReader reader(checkpoint);
+            if (reader.get_string() != settings.get_bytes())
+                fprintf(stderr, "The checkpoint %s belongs to another sweep, starting over\n", this->checkpoint_filename.c_str());
+            else {
+                nb_done_sets = reader.get<uint64_t>();
+                for (size_t i = 0; i < nb_done_sets; ++i)
+                    results[i] = read_metrics(reader, parameter_sets[i]);
+                std::cout << "Sweep resumed from " << this->checkpoint_filename << " after " << nb_done_sets << " backtests" << std::endl;
+            }
+        }
+        size_t wave_size = 16 * pool.get_nb_threads();
+        auto last_checkpoint_time = std::chrono::steady_clock::now();
+        while (nb_done_sets < parameter_sets.size()){
+            size_t nb_wave_sets = std::min(wave_size, parameter_sets.size() - nb_done_sets);
+            pool.parallel_for(nb_wave_sets, [&](size_t i){
+                results[nb_done_sets + i] = this->run_backtest(parameter_sets[nb_done_sets + i]);
+            });
+            nb_done_sets += nb_wave_sets;
+            std::chrono::duration<double> checkpoint_age = std::chrono::steady_clock::now() - last_checkpoint_time;
+            if (nb_done_sets < parameter_sets.size() && checkpoint_age.count() >= this->checkpoint_interval){
+                ByteWriter writer;
+                writer.put_string(settings.get_bytes());
+                writer.put<uint64_t>(nb_done_sets);
+                for (size_t i = 0; i < nb_done_sets; ++i)
+                    write_metrics(writer, results[i]);
+                write_checkpoint(this->checkpoint_filename, writer.get_bytes());
+                last_checkpoint_time = std::chrono::steady_clock::now();
+            }
+        }
+        remove_checkpoint(this->checkpoint_filename);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    this->results = results;
+    this->throughput = {pool.get_nb_threads(), parameter_sets.size(), elapsed.count(), parameter_sets.size() / elapsed.count()};
+    return this->results;
+}
+
+const std::vector<SweepResult>& ParameterSweep::run_distributed(const std::vector<std::map<std::string, double>>& parameter_sets, LocalCluster& cluster, size_t shard_size){
+    std::vector<std::string> shards = cluster.run(parameter_sets.size(), shard_size, [&](size_t first_set, size_t nb_sets){
+        ByteWriter writer;
+        for (size_t i = first_set; i < first_set + nb_sets; ++i)
+            write_metrics(writer, this->run_backtest(parameter_sets[i]));
+        return writer.get_bytes();
+    });
+
+    std::vector<SweepResult> results;
+    for (const auto& shard: shards){
+        ByteReader reader(shard);
+        while (!reader.is_done())
+            results.push_back(read_metrics(reader, parameter_sets[results.size()]));
+    }
+    const DistributedThroughput& throughput = cluster.get_throughput();
+    this->results = results;
+    this->throughput = {throughput.nb_workers, throughput.nb_items, throughput.elapsed_seconds, throughput.items_per_second};
+    return this->results;
+}
+
+std::vector<SweepThroughput> ParameterSweep::benchmark_scaling(const std::vector<std::map<std::string, double>>& parameter_sets, size_t max_threads){
+    if (max_threads == 0)
+        max_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (size_t nb_threads = 1; nb_threads < max_threads; nb_threads *= 2)
+        thread_counts.push_back(nb_threads);
+    thread_counts.push_back(max_threads);
+
+    std::vector<SweepThroughput> throughputs;
+    for (size_t nb_threads: thread_counts){
+        this->run(parameter_sets, nb_threads);
+        throughputs.push_back(this->throughput);
+        this->print_throughput();
+    }
+    for (const auto& throughput: throughputs)
+        std::cout << "Sweep scaling: " << throughput.nb_threads << " threads - speedup x" << throughput.backtests_per_second / throughputs[0].backtests_per_second
+                  << " - efficiency " << 100 * throughput.backtests_per_second / throughputs[0].backtests_per_second / throughput.nb_threads << "%" << std::endl;
+    return throughputs;
+}
+
+const std::vector<SweepResult>& ParameterSweep::get_results() const{
+    return this->results;
+}
+
+const SweepThroughput& ParameterSweep::get_throughput() const{
+    return this->throughput;
+}
+
+void ParameterSweep::save_results(std::string filename) const{
+    std::ofstream results_file("../strat_outputs/"+filename+".csv");
+    if (results_file.is_open()){
+        for (const auto& range: this->parameter_ranges)
+            results_file << range.name << ";";
+        results_file << "TR;XIRR;Volatility;MaxDrawdown\n";
+        for (const auto& result: this->results){
+            for (const auto& range: this->parameter_ranges)
+                results_file << result.parameters.at(range.name) << ";";
+            results_file << result.total_return << ";" << result.xirr << ";" << result.volatility << ";" << result.max_drawdown << "\n";
+        }
+        results_file.close();
+    }
+}
+
+void ParameterSweep::print_throughput() const{
+    std::cout << "Sweep: " << this->throughput.nb_backtests << " backtests on " << this->throughput.nb_threads << " threads in "
+              << this->throughput.elapsed_seconds << "s (" << this->throughput.backtests_per_second << " backtests/s)" << std::endl;
+}
+
+ParameterSweep::~ParameterSweep(){}
@@ -0,0 +1,121 @@
+#include "../headers/path_generator.hpp"
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+
+void fill_normals(Philox4x32& generator, double* normals, size_t nb_normals){
+    size_t i = 0;
+    if (nb_normals > 0 && generator.has_cached_normal())
+        normals[i++] = generator.next_normal();
+
+    const size_t block_size = 256;
+    double radius_uniforms[block_size];
+    double angle_uniforms[block_size];
+    while (nb_normals - i >= 2){
+        size_t nb_pairs = std::min(block_size, (nb_normals - i) / 2);
+        for (size_t j = 0; j < nb_pairs; ++j){
+            radius_uniforms[j] = generator.next_uniform();
+            angle_uniforms[j] = generator.next_uniform();
+        }
+        double* block_normals = normals + i;
+        for (size_t j = 0; j < nb_pairs; ++j){
+            double radius = std::sqrt(-2.0 * std::log(radius_uniforms[j]));
+            double angle = 2.0 * M_PI * angle_uniforms[j];
+            block_normals[2 * j] = radius * std::cos(angle);
+            block_normals[2 * j + 1] = radius * std::sin(angle);
+        }
+        i += 2 * nb_pairs;
+    }
+    if (i < nb_normals)
+        normals[i] = generator.next_normal();
+}
+
+PathNormalSource::PathNormalSource(VarianceReduction variance_reduction, uint64_t seed, size_t nb_series, size_t nb_increments)
+: variance_reduction(variance_reduction), seed(seed), nb_series(nb_series), nb_increments(nb_increments),
+  sobol_sequence(variance_reduction == VarianceReduction::SOBOL_BROWNIAN_BRIDGE ? std::min(SobolSequence::MAX_DIMENSIONS, nb_series * nb_increments) : 0),
+  brownian_bridge(variance_reduction == VarianceReduction::SOBOL_BROWNIAN_BRIDGE ? nb_increments : 0){
+    // The scramblings come from streams past every path stream index
+    Philox4x32 generator(seed, ~uint64_t(0));
+    for (size_t i = 0; i < NB_REPLICATES * this->sobol_sequence.get_nb_dimensions(); ++i)
+        this->digital_shifts.push_back(generator.next_uint32());
+}
+
+size_t PathNormalSource::get_replicate(VarianceReduction variance_reduction, uint64_t path_idx){
+    // Antithetic pairs stay in the same replicate
+    return (variance_reduction == VarianceReduction::ANTITHETIC_VARIATES ? path_idx / 2 : path_idx) % NB_REPLICATES;
+}
+
+void PathNormalSource::fill(uint64_t path_idx, double* normals) const{
+    size_t nb_normals = this->nb_series * this->nb_increments;
+    if (this->variance_reduction == VarianceReduction::ANTITHETIC_VARIATES){
+        Philox4x32 generator(this->seed, path_idx & ~uint64_t(1));
+        fill_normals(generator, normals, nb_normals);
+        if (path_idx & 1)
+            std::transform(normals, normals + nb_normals, normals, [](double z){ return -z; });
+        return;
+    }
+    Philox4x32 generator(this->seed, path_idx);
+    if (this->variance_reduction != VarianceReduction::SOBOL_BROWNIAN_BRIDGE){
+        fill_normals(generator, normals, nb_normals);
+        return;
+    }
+    // Construction order normals: the j-th bridge normal of series s is bridge_normals[j * nb_series + s]
+    std::vector<double> bridge_normals(nb_normals);
+    fill_normals(generator, bridge_normals.data(), nb_normals);
+    size_t replicate = get_replicate(this->variance_reduction, path_idx);
+    size_t nb_dimensions = this->sobol_sequence.get_nb_dimensions();
+    this->sobol_sequence.get_point(path_idx / NB_REPLICATES, this->digital_shifts.data() + replicate * nb_dimensions, bridge_normals.data());
+    std::transform(bridge_normals.begin(), bridge_normals.begin() + nb_dimensions, bridge_normals.begin(), get_inverse_normal_cdf);
+    for (size_t s = 0; s < this->nb_series; ++s)
+        this->brownian_bridge.build(bridge_normals.data() + s, normals + s, this->nb_series);
+}
+
+PathNormalSource::~PathNormalSource(){}
+
+PathGenerator::PathGenerator(PathModel model, double start_price, double mean_return, double volatility, uint64_t seed)
+: model(model), start_price(start_price), mean_return(mean_return), volatility(volatility), seed(seed), variance_reduction(VarianceReduction::NONE){
+    assert(volatility >= 0 && "Error: the volatility must be >= 0\n");
+}
+
+void PathGenerator::set_variance_reduction(VarianceReduction variance_reduction){
+    this->variance_reduction = variance_reduction;
+}
+
+void PathGenerator::generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps, double* paths) const{
+    if (nb_steps == 0)
+        return;
+    PathNormalSource normal_source(this->variance_reduction, this->seed, 1, nb_steps - 1);
+    for (size_t p = 0; p < nb_paths; ++p){
+        double* path = paths + p * nb_steps;
+        path[0] = 0.0;
+        normal_source.fill(first_path_idx + p, path + 1);
+        if (this->model == PathModel::GEOMETRIC_BROWNIAN_MOTION){
+            double drift = this->mean_return - 0.5 * this->volatility * this->volatility;
+            std::transform(path + 1, path + nb_steps, path + 1, [drift, this](double z){ return drift + this->volatility * z; });
+            std::partial_sum(path, path + nb_steps, path);
+            std::transform(path, path + nb_steps, path, [this](double log_return){ return this->start_price * std::exp(log_return); });
+        }
+        else {
+            path[0] = this->start_price;
+            std::transform(path + 1, path + nb_steps, path + 1, [this](double z){ return 1.0 + this->mean_return + this->volatility * z; });
+            std::partial_sum(path, path + nb_steps, path, std::multiplies<double>());
+        }
+    }
+}
+
+std::vector<double> PathGenerator::generate(size_t first_path_idx, size_t nb_paths, size_t nb_steps) const{
+    std::vector<double> paths(nb_paths * nb_steps);
+    this->generate(first_path_idx, nb_paths, nb_steps, paths.data());
+    return paths;
+}
+
+double PathGenerator::get_expected_growth(size_t nb_steps) const{
+    double horizon = (nb_steps > 0) ? nb_steps - 1.0 : 0.0;
+    if (this->model == PathModel::GEOMETRIC_BROWNIAN_MOTION)
+        return std::exp(this->mean_return * horizon);
+    return std::pow(1.0 + this->mean_return, horizon);
+}
+
+PathGenerator::~PathGenerator(){}
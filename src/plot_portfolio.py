@@ -1,22 +1,76 @@
 import os
+import glob
 import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
 
+RESULT_FILE_MAGIC = 0x3153544C55534552   # "RESULTS1"
+RESULT_RECORD_MAGIC = 0x31534E4D554C4F43 # "COLUMNS1"
+
+def read_results(filepath):
+    """Binary result file (headers/result_file.hpp) mapped in place: dates (datetime64[s]) and {name: column} of float64 memmaps"""
+    header = np.memmap(filepath, dtype='<u8', mode='r', shape=(2,))
+    if header[0] != RESULT_FILE_MAGIC:
+        raise ValueError(filepath + ' is not a result file')
+    nb_rows = int(header[1])
+    size = os.path.getsize(filepath)
+    dates = np.memmap(filepath, dtype='<i8', mode='r', offset=16, shape=(nb_rows,)).view('datetime64[s]')
+    columns = {}
+    offset = 16 + 8 * nb_rows
+    # Records cut by an interruption are ignored
+    while offset + 24 <= size:
+        record_magic, nb_columns, names_size = (int(v) for v in np.memmap(filepath, dtype='<u8', mode='r', offset=offset, shape=(3,)))
+        data_offset = offset + 24 + names_size
+        end = data_offset + 8 * nb_columns * nb_rows
+        if record_magic != RESULT_RECORD_MAGIC or end > size:
+            break
+        with open(filepath, 'rb') as f:
+            f.seek(offset + 24)
+            names = f.read(names_size).split(b'\0')[:nb_columns]
+        values = np.memmap(filepath, dtype='<f8', mode='r', offset=data_offset, shape=(nb_columns, nb_rows))
+        for name, column in zip(names, values):
+            columns[name.decode()] = column
+        offset = end
+    return dates, columns
+
+def get_montecarlo_summary_path(strat_name):
+    """Summary of strat_name, or the latest summary whose strategy name contains strat_name"""
+    filepath = '../strat_outputs/'+strat_name+'_MonteCarloSummary.csv'
+    if os.path.exists(filepath):
+        return filepath
+    filepaths = glob.glob('../strat_outputs/*'+glob.escape(strat_name)+'*_MonteCarloSummary.csv')
+    if len(filepaths) == 0:
+        raise FileNotFoundError('no Monte Carlo summary for ' + strat_name)
+    return max(filepaths, key=os.path.getmtime)
+
+def read_montecarlo_summary(strat_name):
+    filepath = get_montecarlo_summary_path(strat_name)
+    histogram = []
+    with open(filepath) as f:
+        for line in f:
+            if not line.startswith('#'):
+                break
+            fields = line[1:].strip().split(';')
+            if fields[0] == 'bin':
+                histogram.append([float(v) for v in fields[1:]])
+    df = pd.read_csv(filepath, sep=';', comment='#')
+    return df, np.array(histogram)
+
 def plot_montecarlo_simu_df(strat_name):
-    files = os.listdir("../strat_outputs/")
-    end_values = []
-    for f in files:
-        if 'MonteCarloSimu_' in f and strat_name in f:
-            df = pd.read_csv('../strat_outputs/'+f, usecols=['Value'], sep=';')
-            end_values.append(df.Value.values[-1])
-            plt.plot(df.Value)
-    print(f'Modes on end values: 25% : {np.quantile(end_values, 0.25)} - 50% : {np.quantile(end_values, 0.5)} - 75% : {np.quantile(end_values, 0.75)}')
+    df, histogram = read_montecarlo_summary(strat_name)
+    end = df.iloc[-1]
+    print(f'Modes on end values: 25% : {end.P25} - 50% : {end.P50} - 75% : {end.P75}')
+    plt.fill_between(df.index, df.P5, df.P95, alpha=0.2, label='5% - 95%')
+    plt.fill_between(df.index, df.P25, df.P75, alpha=0.4, label='25% - 75%')
+    plt.plot(df.P50, label='Median')
+    plt.plot(df.Mean, linestyle='--', label='Mean')
+    plt.legend(loc='upper left')
     plt.xlabel('Days')
     plt.ylabel('Portfolio Value')
 
     ax_hist = plt.gca().inset_axes([0.4, 0.5, 0.25, 0.35])  # Inset histogram
-    ax_hist.hist(end_values, bins=30, color='green', alpha=0.7)
+    if len(histogram) > 0:
+        ax_hist.bar(histogram[:, 0], histogram[:, 2], width=histogram[:, 1] - histogram[:, 0], align='edge', color='green', alpha=0.7)
     ax_hist.set_title('End Value Distribution')
     ax_hist.set_xlabel('Final Value')
     ax_hist.set_ylabel('Frequency')
@@ -24,14 +78,25 @@ def plot_montecarlo_simu_df(strat_name):
     plt.show()
 
 def plot_strategy_df(filepath):
-    
-    df = pd.read_csv(filepath, usecols=['Value'], sep=';')
-    plt.plot(df.Value)
+    if filepath.endswith('.res'):
+        values = read_results(filepath)[1]['Value']
+    else:
+        values = pd.read_csv(filepath, usecols=['Value'], sep=';').Value
+    plt.plot(values)
+    plt.xlabel('Days')
+    plt.ylabel('Portfolio Value')
+    plt.show()
+
+def plot_montecarlo_paths(strat_name, nb_paths):
+    """First nb_paths paths saved with OutputFormat::BINARY"""
+    _, columns = read_results('../strat_outputs/'+strat_name+'_MonteCarloPaths.res')
+    for column in list(columns.values())[:nb_paths]:
+        plt.plot(column, linewidth=0.5, alpha=0.5)
     plt.xlabel('Days')
     plt.ylabel('Portfolio Value')
     plt.show()
     
 if __name__ == '__main__':
-    stratname = 'DCA_SPGold'
+    stratname = 'DCA_SPGold_acc_2015_2024'
     plot_montecarlo_simu_df(stratname)
     plot_strategy_df('../strat_outputs/DCA_SPGold_acc_2015_2024.csv')
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include "../headers/portfolio_builder.hpp"
 #include "../headers/yahoo_utils.hpp"
+#include "../headers/csv_writer.hpp"
+#include "../headers/result_file.hpp"
 #include <eigen3/Eigen/Dense>
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <cassert>
+#include <algorithm>
 
 struct AssetHolding* PortfolioBuilder::get_asset(std::string ticker) {
     for (auto& asset : this->assets)
@@ -70,6 +74,84 @@ void PortfolioBuilder::sell(const YahooTimeseries& ticker_yt, double shares_amt,
         fprintf(stderr, "ticker not in portfolio\n");
 }
 
+std::vector<int> PortfolioBuilder::get_asset_indices(const std::vector<YahooTimeseries>& tickers_yt) const{
+    std::vector<int> asset_indices(tickers_yt.size(), -1);
+    for (size_t a = 0; a < tickers_yt.size(); ++a)
+        for (size_t i = 0; i < this->assets.size(); ++i)
+            if (this->assets[i].ticker_yt.get_ticker() == tickers_yt[a].get_ticker())
+                asset_indices[a] = i;
+    return asset_indices;
+}
+
+void PortfolioBuilder::get_last_shares(const std::vector<int>& asset_indices, double* shares) const{
+    for (size_t a = 0; a < asset_indices.size(); ++a)
+        shares[a] = (asset_indices[a] >= 0) ? this->assets[asset_indices[a]].historical_cumulative_ticker_shares.rbegin()->second : 0.0;
+}
+
+void PortfolioBuilder::apply_orders(const std::vector<int>& asset_indices, const double* orders, const double* prices, std::time_t date){
+    double cash_flow = 0.0;
+    double total_shares = 0.0;
+    for (size_t a = 0; a < asset_indices.size(); ++a){
+        if (orders[a] == 0.0)
+            continue;
+        assert(asset_indices[a] >= 0 && "Error: orders can only be applied to held assets\n");
+        struct AssetHolding& asset = this->assets[asset_indices[a]];
+        double expense = orders[a] * prices[a];
+        asset.historical_cumulative_ticker_shares[date] = asset.historical_cumulative_ticker_shares.rbegin()->second + orders[a];
+        asset.historical_cumulative_ticker_expenses[date] = asset.historical_cumulative_ticker_expenses.rbegin()->second + expense;
+        cash_flow -= expense;
+        total_shares += orders[a];
+    }
+    if (total_shares == 0.0 && cash_flow == 0.0)
+        return;
+    this->historical_cash_flow[date] += cash_flow;
+    this->portfolio_total_shares[date] = this->portfolio_total_shares.rbegin()->second + total_shares;
+}
+
+static std::map<std::time_t, double> get_values_before(const std::map<std::time_t, double>& values, std::time_t end_date){
+    return std::map<std::time_t, double>(values.begin(), values.lower_bound(end_date));
+}
+
+void PortfolioBuilder::write(ByteWriter& writer, std::time_t end_date) const{
+    // Entries are only added at the date of the transaction, which never decreases: the ledger before end_date is a prefix
+    // of every map, and the assets first bought from end_date on are the last ones
+    size_t nb_assets = std::count_if(this->assets.begin(), this->assets.end(), [end_date](const struct AssetHolding& asset){
+        return asset.historical_cumulative_ticker_shares.begin()->first < end_date;
+    });
+    writer.put<uint64_t>(nb_assets);
+    for (size_t i = 0; i < nb_assets; ++i){
+        writer.put_string(this->assets[i].ticker_yt.get_ticker());
+        writer.put_map(get_values_before(this->assets[i].historical_cumulative_ticker_shares, end_date));
+        writer.put_map(get_values_before(this->assets[i].historical_cumulative_ticker_expenses, end_date));
+    }
+    writer.put_map(get_values_before(this->historical_cash_flow, end_date));
+    writer.put_map(get_values_before(this->portfolio_values, end_date));
+    writer.put_map(get_values_before(this->portfolio_total_shares, end_date));
+    writer.put_map(get_values_before(this->portfolio_prices, end_date));
+}
+
+bool PortfolioBuilder::read(ByteReader& reader, const std::vector<YahooTimeseries>& tickers_yt){
+    std::vector<struct AssetHolding> assets;
+    size_t nb_assets = reader.get<uint64_t>();
+    for (size_t i = 0; i < nb_assets; ++i){
+        std::string ticker = reader.get_string();
+        auto it = std::find_if(tickers_yt.begin(), tickers_yt.end(), [&](const YahooTimeseries& ticker_yt){ return ticker_yt.get_ticker() == ticker; });
+        if (it == tickers_yt.end()){
+            fprintf(stderr, "Error: the ticker %s of the portfolio is missing\n", ticker.c_str());
+            return false;
+        }
+        std::map<std::time_t, double> shares = reader.get_map<std::time_t, double>();
+        std::map<std::time_t, double> expenses = reader.get_map<std::time_t, double>();
+        assets.push_back({*it, shares, expenses});
+    }
+    this->assets = assets;
+    this->historical_cash_flow = reader.get_map<std::time_t, double>();
+    this->portfolio_values = reader.get_map<std::time_t, double>();
+    this->portfolio_total_shares = reader.get_map<std::time_t, double>();
+    this->portfolio_prices = reader.get_map<std::time_t, double>();
+    return true;
+}
+
 void PortfolioBuilder::set_portfolio_values_and_prices(){
     std::map<std::time_t, double> ptf_values = this->get_ts_portfolio_values().get_ts_values();
     this->portfolio_values = ptf_values;
@@ -80,25 +162,66 @@ void PortfolioBuilder::set_portfolio_values_and_prices(){
     }
 }
 
-void PortfolioBuilder::save_portfolio(std::string filename) const{
-    std::map<std::time_t, double> ptf_ts_values = this->get_portfolio_values();
+void PortfolioBuilder::update_portfolio_values_and_prices(std::time_t first_date){
+    for (const auto& date: this->get_unique_portfolio_dates()){
+        if (date < first_date && this->portfolio_values.count(date) > 0)
+            continue;
+        double ptf_value = this->get_portfolio_value(date);
+        this->portfolio_values[date] = ptf_value;
+        this->portfolio_prices[date] = ptf_value / this->get_portfolio_total_shares(date);
+    }
+}
+
+void PortfolioBuilder::get_saved_columns(std::vector<std::time_t>& dates, std::vector<double>& columns) const{
     std::map<std::time_t, double> ptf_pls_ts_values = this->get_portfolio_profits_and_losses().get_ts_values();
-    
-    std::ofstream ptf_file("../strat_outputs/"+filename+".csv");
+    size_t nb_dates = this->portfolio_values.size();
+    dates.clear();
+    columns.assign(3 * nb_dates, 0.0);
     double last_pls = 0.0;
+    // Both maps are walked in date order, a date without P&L counting as 0
+    auto pls_it = ptf_pls_ts_values.begin();
+    for (const auto& pair: this->portfolio_values){
+        while (pls_it != ptf_pls_ts_values.end() && pls_it->first < pair.first)
+            ++pls_it;
+        double pls = (pls_it != ptf_pls_ts_values.end() && pls_it->first == pair.first) ? pls_it->second : 0.0;
+        double row_pls = (pls == 0) ? last_pls : pls;
+        size_t d = dates.size();
+        columns[d] = pair.second;
+        columns[nb_dates + d] = row_pls;
+        columns[2 * nb_dates + d] = pair.second - row_pls;
+        dates.push_back(pair.first);
+        last_pls = pls;
+    }
+}
+
+void PortfolioBuilder::save_portfolio(std::string filename, bool is_background_writer) const{
+    std::vector<std::time_t> dates;
+    std::vector<double> columns;
+    this->get_saved_columns(dates, columns);
+    
+    CsvWriter ptf_file("../strat_outputs/"+filename+".csv", 1 << 16, is_background_writer);
     if (ptf_file.is_open()){
-        ptf_file << "Date;Value;P&L;Investments" << std::endl;
-        for (const auto& pair: ptf_ts_values){
-            if (ptf_pls_ts_values[pair.first] == 0)
-                ptf_file << unix_timestamp_to_date_string(pair.first) << ";" << pair.second << ";" << last_pls << ";" << pair.second - last_pls << std::endl;
-            else
-                ptf_file << unix_timestamp_to_date_string(pair.first) << ";" << pair.second << ";" << ptf_pls_ts_values[pair.first] << ";" << pair.second - ptf_pls_ts_values[pair.first] << std::endl;
-            last_pls = ptf_pls_ts_values[pair.first];
+        ptf_file.write_line("Date;Value;P&L;Investments");
+        for (size_t d = 0; d < dates.size(); ++d){
+            double row[3] = {columns[d], columns[dates.size() + d], columns[2 * dates.size() + d]};
+            ptf_file.write_row(dates[d], row, 3);
         }
         ptf_file.close();
     }
 }
 
+void PortfolioBuilder::save_portfolio_results(std::string filename) const{
+    std::vector<std::time_t> dates;
+    std::vector<double> columns;
+    this->get_saved_columns(dates, columns);
+
+    ResultFileWriter ptf_file("../strat_outputs/"+filename+".res", dates, 0);
+    if (ptf_file.is_open()){
+        ptf_file.append_columns({"Value", "P&L", "Investments"}, columns.data());
+        ptf_file.close();
+    }
+}
+
 double PortfolioBuilder::get_ticker_value(std::string ticker, std::time_t date) const {
     const struct AssetHolding* asset = this->get_asset(ticker);
     
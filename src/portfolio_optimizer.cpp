@@ -0,0 +1,179 @@
+#include "../headers/portfolio_optimizer.hpp"
+#include "../headers/thread_pool.hpp"
+#include <cassert>
+#include <cmath>
+#include <set>
+#include <algorithm>
+#include <numeric>
+
+Eigen::VectorXd project_on_simplex(const Eigen::VectorXd& weights){
+    // Euclidean projection on {w >= 0, sum(w) = 1}
+    std::vector<double> sorted_weights(weights.data(), weights.data() + weights.size());
+    std::sort(sorted_weights.begin(), sorted_weights.end(), std::greater<double>());
+    double cumulative_sum = 0.0;
+    double theta = 0.0;
+    for (size_t i = 0; i < sorted_weights.size(); ++i){
+        cumulative_sum += sorted_weights[i];
+        double candidate_theta = (cumulative_sum - 1.0) / (i + 1);
+        if (sorted_weights[i] - candidate_theta > 0)
+            theta = candidate_theta;
+    }
+    return (weights.array() - theta).max(0.0).matrix();
+}
+
+static Eigen::VectorXd project_on_positive_orthant(const Eigen::VectorXd& weights){
+    return weights.cwiseMax(0.0);
+}
+
+PortfolioOptimizer::PortfolioOptimizer(const std::vector<YahooTimeseries>& tickers_yt, double risk_free_rate): risk_free_rate(risk_free_rate){
+    assert(!tickers_yt.empty() && "Error: at least one ticker is needed\n");
+
+    // Returns are computed on the dates shared by every ticker so that the covariance is estimated on aligned observations
+    std::set<std::time_t> common_dates(tickers_yt[0].get_dates().begin(), tickers_yt[0].get_dates().end());
+    for (const auto& ticker_yt: tickers_yt){
+        std::set<std::time_t> ticker_dates(ticker_yt.get_dates().begin(), ticker_yt.get_dates().end());
+        std::set<std::time_t> intersection;
+        std::set_intersection(common_dates.begin(), common_dates.end(), ticker_dates.begin(), ticker_dates.end(), std::inserter(intersection, intersection.end()));
+        common_dates = intersection;
+        this->tickers.push_back(ticker_yt.get_ticker());
+    }
+    assert(common_dates.size() > 2 && "Error: tickers must share at least 3 dates\n");
+
+    size_t nb_assets = tickers_yt.size();
+    Eigen::MatrixXd returns(common_dates.size() - 1, nb_assets);
+    for (size_t j = 0; j < nb_assets; ++j){
+        const Timeseries& adjcloses = tickers_yt[j].get_adjcloses();
+        double previous_price = adjcloses.get_ts_value(*common_dates.begin());
+        size_t i = 0;
+        for (auto it = std::next(common_dates.begin()); it != common_dates.end(); ++it, ++i){
+            double price = adjcloses.get_ts_value(*it);
+            returns(i, j) = (price - previous_price) / previous_price;
+            previous_price = price;
+        }
+    }
+
+    Eigen::RowVectorXd mean_returns = returns.colwise().mean();
+    Eigen::MatrixXd centered_returns = returns.rowwise() - mean_returns;
+    this->expected_returns = 252.0 * mean_returns.transpose();
+    this->covariance = 252.0 * (centered_returns.transpose() * centered_returns) / double(returns.rows() - 1);
+
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen_solver(this->covariance, Eigen::EigenvaluesOnly);
+    this->covariance_max_eigenvalue = std::max(eigen_solver.eigenvalues().maxCoeff(), 1e-12);
+}
+
+const Eigen::VectorXd& PortfolioOptimizer::get_expected_returns() const{
+    return this->expected_returns;
+}
+
+const Eigen::MatrixXd& PortfolioOptimizer::get_covariance() const{
+    return this->covariance;
+}
+
+void PortfolioOptimizer::solve_constrained_min_variance(const Eigen::VectorXd& constraint, double target,
+                                                        const std::function<Eigen::VectorXd(const Eigen::VectorXd&)>& projection,
+                                                        Eigen::VectorXd& weights, double& multiplier) const{
+    // Augmented Lagrangian on the linear constraint, accelerated projected gradient (FISTA) on the rest:
+    // min w'Cw  s.t.  constraint'w = target,  w in projection's set
+    double constraint_norm = constraint.squaredNorm();
+    double penalty = (constraint_norm > 0) ? 20.0 * this->covariance_max_eigenvalue / constraint_norm : 0.0;
+    double step = 1.0 / (2.0 * this->covariance_max_eigenvalue + penalty * constraint_norm);
+
+    for (int outer = 0; outer < 200; ++outer){
+        Eigen::VectorXd momentum_weights = weights;
+        double t = 1.0;
+        for (int inner = 0; inner < 5000; ++inner){
+            double residual = constraint.dot(momentum_weights) - target;
+            Eigen::VectorXd gradient = 2.0 * this->covariance * momentum_weights + (multiplier + penalty * residual) * constraint;
+            Eigen::VectorXd next_weights = projection(momentum_weights - step * gradient);
+            double next_t = (1.0 + std::sqrt(1.0 + 4.0 * t * t)) / 2.0;
+            momentum_weights = next_weights + ((t - 1.0) / next_t) * (next_weights - weights);
+            double change = (next_weights - weights).norm();
+            weights = next_weights;
+            t = next_t;
+            if (change < 1e-14)
+                break;
+        }
+        double residual = constraint.dot(weights) - target;
+        multiplier += penalty * residual;
+        if (std::fabs(residual) < 1e-10)
+            break;
+    }
+}
+
+Eigen::VectorXd PortfolioOptimizer::get_min_variance_weights() const{
+    size_t nb_assets = this->tickers.size();
+    Eigen::VectorXd weights = Eigen::VectorXd::Constant(nb_assets, 1.0 / nb_assets);
+    double multiplier = 0.0;
+    this->solve_constrained_min_variance(Eigen::VectorXd::Zero(nb_assets), 0.0, project_on_simplex, weights, multiplier);
+    return weights;
+}
+
+Eigen::VectorXd PortfolioOptimizer::get_max_sharpe_weights() const{
+    // Long-only tangency portfolio: min y'Cy s.t. (mu - rf)'y = 1, y >= 0, then w = y / sum(y)
+    Eigen::VectorXd excess_returns = this->expected_returns.array() - this->risk_free_rate;
+    Eigen::Index best_asset;
+    double best_excess_return = excess_returns.maxCoeff(&best_asset);
+    if (best_excess_return <= 0)
+        return this->get_min_variance_weights();
+
+    Eigen::VectorXd scaled_weights = Eigen::VectorXd::Zero(this->tickers.size());
+    scaled_weights(best_asset) = 1.0 / best_excess_return;
+    double multiplier = 0.0;
+    this->solve_constrained_min_variance(excess_returns, 1.0, project_on_positive_orthant, scaled_weights, multiplier);
+    return scaled_weights / scaled_weights.sum();
+}
+
+std::map<std::string, double> PortfolioOptimizer::get_min_variance_allocations() const{
+    return this->get_allocations(this->get_min_variance_weights());
+}
+
+std::map<std::string, double> PortfolioOptimizer::get_max_sharpe_allocations() const{
+    return this->get_allocations(this->get_max_sharpe_weights());
+}
+
+std::vector<FrontierPoint> PortfolioOptimizer::get_efficient_frontier(size_t nb_points, size_t nb_threads) const{
+    assert(nb_points > 1 && "Error: the efficient frontier needs at least 2 points\n");
+    Eigen::VectorXd min_variance_weights = this->get_min_variance_weights();
+    double min_return = this->expected_returns.dot(min_variance_weights);
+    double max_return = this->expected_returns.maxCoeff();
+
+    // Contiguous target returns are solved in order inside each chunk so every solve is warm-started from its neighbour
+    std::vector<FrontierPoint> frontier(nb_points);
+    ThreadPool pool(nb_threads);
+    size_t nb_chunks = std::min(nb_points, pool.get_nb_threads());
+    pool.parallel_for(nb_chunks, [&](size_t chunk){
+        size_t first_point = chunk * nb_points / nb_chunks;
+        size_t last_point = (chunk + 1) * nb_points / nb_chunks;
+        Eigen::VectorXd weights = min_variance_weights;
+        double multiplier = 0.0;
+        for (size_t i = first_point; i < last_point; ++i){
+            double target_return = min_return + (max_return - min_return) * i / (nb_points - 1);
+            this->solve_constrained_min_variance(this->expected_returns, target_return, project_on_simplex, weights, multiplier);
+            frontier[i] = this->get_frontier_point(weights);
+        }
+    });
+    return frontier;
+}
+
+FrontierPoint PortfolioOptimizer::get_frontier_point(const Eigen::VectorXd& weights) const{
+    double expected_return = this->expected_returns.dot(weights);
+    double volatility = std::sqrt(std::max(0.0, weights.dot(this->covariance * weights)));
+    double sharpe_ratio = (volatility > 0) ? (expected_return - this->risk_free_rate) / volatility : 0.0;
+    return {expected_return, volatility, sharpe_ratio, this->get_allocations(weights)};
+}
+
+std::map<std::string, double> PortfolioOptimizer::get_allocations(const Eigen::VectorXd& weights) const{
+    // Every ticker, negligible weights set to 0.0 (the strategies look every ticker up), summing to 1
+    std::map<std::string, double> allocations;
+    double sum = 0.0;
+    for (size_t i = 0; i < this->tickers.size(); ++i){
+        double weight = (weights(i) > 1e-6) ? weights(i) : 0.0;
+        allocations[this->tickers[i]] = weight;
+        sum += weight;
+    }
+    for (auto& pair: allocations)
+        pair.second /= sum;
+    return allocations;
+}
+
+PortfolioOptimizer::~PortfolioOptimizer(){}
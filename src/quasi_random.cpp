@@ -0,0 +1,124 @@
+#include "../headers/quasi_random.hpp"
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <utility>
+
+// Degree s, coefficients a and initial direction numbers m_1..m_s of the primitive polynomials of dimensions 2 to 21
+static const struct { unsigned int s; unsigned int a; unsigned int m[7]; } SOBOL_POLYNOMIALS[SobolSequence::MAX_DIMENSIONS - 1] = {
+    {1, 0, {1}}, {2, 1, {1, 3}}, {3, 1, {1, 3, 1}}, {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}}, {4, 4, {1, 3, 5, 13}}, {5, 2, {1, 1, 5, 5, 17}}, {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}}, {5, 11, {1, 1, 5, 1, 1}}, {5, 13, {1, 1, 1, 3, 11}}, {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}}, {6, 13, {1, 1, 1, 15, 21, 21}}, {6, 16, {1, 3, 1, 13, 27, 49}}, {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}}, {6, 25, {1, 1, 5, 5, 19, 61}}, {7, 1, {1, 3, 7, 11, 23, 15, 103}}, {7, 4, {1, 3, 7, 13, 13, 15, 69}}
+};
+
+SobolSequence::SobolSequence(size_t nb_dimensions): nb_dimensions(nb_dimensions), direction_numbers(nb_dimensions * 32){
+    assert(nb_dimensions <= MAX_DIMENSIONS && "Error: too many Sobol dimensions\n");
+    for (size_t d = 0; d < nb_dimensions; ++d){
+        uint32_t* v = this->direction_numbers.data() + d * 32;
+        if (d == 0){
+            for (unsigned int k = 0; k < 32; ++k)
+                v[k] = uint32_t(1) << (31 - k);
+            continue;
+        }
+        unsigned int s = SOBOL_POLYNOMIALS[d - 1].s, a = SOBOL_POLYNOMIALS[d - 1].a;
+        for (unsigned int k = 0; k < 32; ++k){
+            if (k < s){
+                v[k] = SOBOL_POLYNOMIALS[d - 1].m[k] << (31 - k);
+                continue;
+            }
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (unsigned int j = 1; j < s; ++j)
+                if ((a >> (s - 1 - j)) & 1)
+                    v[k] ^= v[k - j];
+        }
+    }
+}
+
+void SobolSequence::get_point(uint64_t index, const uint32_t* digital_shifts, double* point) const{
+    uint64_t gray_code = index ^ (index >> 1);
+    for (size_t d = 0; d < this->nb_dimensions; ++d){
+        const uint32_t* v = this->direction_numbers.data() + d * 32;
+        uint32_t bits = (digital_shifts != nullptr) ? digital_shifts[d] : 0;
+        for (unsigned int k = 0; k < 32 && (gray_code >> k) != 0; ++k)
+            if ((gray_code >> k) & 1)
+                bits ^= v[k];
+        point[d] = (bits + 0.5) * (1.0 / 4294967296.0);
+    }
+}
+
+size_t SobolSequence::get_nb_dimensions() const{
+    return this->nb_dimensions;
+}
+
+SobolSequence::~SobolSequence(){}
+
+double get_inverse_normal_cdf(double p){
+    assert(p > 0 && p < 1 && "Error: the probability must be in (0, 1)\n");
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+    const double p_low = 0.02425;
+    double x;
+    if (p < p_low){
+        double q = std::sqrt(-2.0 * std::log(p));
+        x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    else if (p <= 1.0 - p_low){
+        double q = p - 0.5;
+        double r = q * q;
+        x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    }
+    else {
+        double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    double error = 0.5 * std::erfc(-x / std::sqrt(2.0)) - p;
+    double u = error * std::sqrt(2.0 * M_PI) * std::exp(0.5 * x * x);
+    return x - u / (1.0 + 0.5 * x * u);
+}
+
+BrownianBridge::BrownianBridge(size_t nb_increments): nb_increments(nb_increments){
+    if (nb_increments == 0)
+        return;
+    this->point_indices.push_back(nb_increments);
+    this->left_indices.push_back(0);
+    this->right_indices.push_back(0);
+    this->left_weights.push_back(0.0);
+    this->right_weights.push_back(0.0);
+    this->std_devs.push_back(std::sqrt(double(nb_increments)));
+    // Breadth first: all the midpoints of a level before the next level
+    std::deque<std::pair<size_t, size_t>> intervals = {{0, nb_increments}};
+    while (!intervals.empty()){
+        size_t left = intervals.front().first, right = intervals.front().second;
+        intervals.pop_front();
+        if (right - left < 2)
+            continue;
+        size_t middle = left + (right - left) / 2;
+        this->point_indices.push_back(middle);
+        this->left_indices.push_back(left);
+        this->right_indices.push_back(right);
+        this->left_weights.push_back(double(right - middle) / (right - left));
+        this->right_weights.push_back(double(middle - left) / (right - left));
+        this->std_devs.push_back(std::sqrt(double(middle - left) * (right - middle) / (right - left)));
+        intervals.push_back({left, middle});
+        intervals.push_back({middle, right});
+    }
+}
+
+void BrownianBridge::build(const double* normals, double* increments, size_t stride) const{
+    std::vector<double> points(this->nb_increments + 1, 0.0);
+    for (size_t j = 0; j < this->nb_increments; ++j)
+        points[this->point_indices[j]] = this->left_weights[j] * points[this->left_indices[j]] + this->right_weights[j] * points[this->right_indices[j]]
+                                       + this->std_devs[j] * normals[j * stride];
+    for (size_t k = 0; k < this->nb_increments; ++k)
+        increments[k * stride] = points[k + 1] - points[k];
+}
+
+size_t BrownianBridge::get_nb_increments() const{
+    return this->nb_increments;
+}
+
+BrownianBridge::~BrownianBridge(){}
@@ -0,0 +1,63 @@
+#include "../headers/rebalancer.hpp"
+#include <cassert>
+#include <algorithm>
+
+Rebalancer::Rebalancer(const std::vector<double>& target_weights, RebalancingThreshold mode, double threshold)
+: target_weights(target_weights), mode(mode), threshold(threshold),
+  weights(target_weights.size(), 0.0), drifts(target_weights.size(), 0.0), orders(target_weights.size(), 0.0){
+    for (double target_weight: target_weights)
+        assert(target_weight >= 0 && "Error: target weights must be >= 0\n");
+}
+
+void Rebalancer::set_threshold(RebalancingThreshold mode, double threshold){
+    this->mode = mode;
+    this->threshold = threshold;
+}
+
+size_t Rebalancer::compute_orders(const double* shares, const double* prices){
+    size_t nb_assets = this->target_weights.size();
+    double ptf_value = 0.0;
+    for (size_t a = 0; a < nb_assets; ++a)
+        ptf_value += shares[a] * prices[a];
+    std::fill(this->orders.begin(), this->orders.end(), 0.0);
+    if (!(ptf_value > 0))
+        return 0;
+
+    bool is_band_breached = false;
+    for (size_t a = 0; a < nb_assets; ++a){
+        double weight = shares[a] * prices[a] / ptf_value;
+        double drift = get_weight_drift(weight, this->target_weights[a], this->mode);
+        this->weights[a] = weight;
+        this->drifts[a] = drift;
+        bool is_drifted = drift > this->threshold || (weight > 0 && -drift > this->threshold);
+        is_band_breached |= is_drifted;
+        this->orders[a] = is_drifted ? shares[a] * this->target_weights[a] / weight - shares[a] : 0.0;
+    }
+    if (this->mode == RebalancingThreshold::BAND && is_band_breached){
+        for (size_t a = 0; a < nb_assets; ++a)
+            this->orders[a] = (this->weights[a] > 0) ? shares[a] * this->target_weights[a] / this->weights[a] - shares[a] : 0.0;
+    }
+    return nb_assets - std::count(this->orders.begin(), this->orders.end(), 0.0);
+}
+
+size_t Rebalancer::get_nb_assets() const{
+    return this->target_weights.size();
+}
+
+RebalancingThreshold Rebalancer::get_mode() const{
+    return this->mode;
+}
+
+const std::vector<double>& Rebalancer::get_weights() const{
+    return this->weights;
+}
+
+const std::vector<double>& Rebalancer::get_drifts() const{
+    return this->drifts;
+}
+
+const std::vector<double>& Rebalancer::get_orders() const{
+    return this->orders;
+}
+
+Rebalancer::~Rebalancer(){}
@@ -0,0 +1,210 @@
+#include "../headers/result_file.hpp"
+#include "../headers/csv_writer.hpp"
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(sizeof(std::time_t) == sizeof(int64_t), "Result files store 64-bit times");
+
+static const uint64_t RESULT_FILE_MAGIC = 0x3153544C55534552; // "RESULTS1"
+static const uint64_t RESULT_RECORD_MAGIC = 0x31534E4D554C4F43; // "COLUMNS1"
+static const size_t HEADER_SIZE = 2 * sizeof(uint64_t);
+
+ResultFileWriter::ResultFileWriter(std::string filename, const std::vector<std::time_t>& dates, size_t nb_kept_columns)
+: filename(filename), nb_rows(dates.size()), nb_columns(0), file(nullptr), is_written(true){
+    if (nb_kept_columns > 0 && !this->reopen(dates, nb_kept_columns))
+        fprintf(stderr, "Error: the result file %s does not hold %zu columns, starting over\n", filename.c_str(), nb_kept_columns);
+    if (this->file == nullptr)
+        this->create(dates);
+}
+
+void ResultFileWriter::create(const std::vector<std::time_t>& dates){
+    this->file = fopen(this->filename.c_str(), "wb");
+    if (this->file == nullptr){
+        fprintf(stderr, "Error: can't write the result file %s\n", this->filename.c_str());
+        this->is_written = false;
+        return;
+    }
+    uint64_t header[2] = {RESULT_FILE_MAGIC, this->nb_rows};
+    this->is_written = fwrite(header, sizeof(uint64_t), 2, this->file) == 2
+                       && fwrite(dates.data(), sizeof(std::time_t), dates.size(), this->file) == dates.size();
+}
+
+bool ResultFileWriter::reopen(const std::vector<std::time_t>& dates, size_t nb_kept_columns){
+    size_t end_offset = 0;
+    {
+        ResultFile existing(this->filename);
+        if (!existing.is_open() || existing.get_nb_rows() != dates.size()
+            || std::memcmp(existing.get_dates(), dates.data(), dates.size() * sizeof(std::time_t)) != 0)
+            return false;
+        auto it = std::find(existing.record_end_columns.begin(), existing.record_end_columns.end(), nb_kept_columns);
+        if (it == existing.record_end_columns.end())
+            return false;
+        end_offset = existing.record_end_offsets[it - existing.record_end_columns.begin()];
+    }
+    // Records written after the kept columns are dropped
+    if (truncate(this->filename.c_str(), end_offset) != 0)
+        return false;
+    this->file = fopen(this->filename.c_str(), "ab");
+    if (this->file == nullptr)
+        return false;
+    this->nb_columns = nb_kept_columns;
+    return true;
+}
+
+bool ResultFileWriter::is_open() const{
+    return this->file != nullptr;
+}
+
+size_t ResultFileWriter::get_nb_rows() const{
+    return this->nb_rows;
+}
+
+size_t ResultFileWriter::get_nb_columns() const{
+    return this->nb_columns;
+}
+
+void ResultFileWriter::append_columns(const std::vector<std::string>& names, const double* columns){
+    if (this->file == nullptr || !this->is_written || names.empty())
+        return;
+    std::string names_bytes;
+    for (const auto& name: names){
+        assert(!name.empty() && name.find('\0') == std::string::npos && "Error: column names must be non-empty without '\\0'\n");
+        names_bytes += name;
+        names_bytes += '\0';
+    }
+    names_bytes.resize((names_bytes.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t), '\0');
+    uint64_t record_header[3] = {RESULT_RECORD_MAGIC, names.size(), names_bytes.size()};
+    size_t nb_values = names.size() * this->nb_rows;
+    this->is_written = fwrite(record_header, sizeof(uint64_t), 3, this->file) == 3
+                       && fwrite(names_bytes.data(), 1, names_bytes.size(), this->file) == names_bytes.size()
+                       && fwrite(columns, sizeof(double), nb_values, this->file) == nb_values
+                       && fflush(this->file) == 0; // whole records on disk for a resumed run
+    this->nb_columns += names.size();
+}
+
+bool ResultFileWriter::close(){
+    if (this->file == nullptr)
+        return false;
+    this->is_written = (fclose(this->file) == 0) && this->is_written;
+    this->file = nullptr;
+    if (!this->is_written)
+        fprintf(stderr, "Error: can't write the result file %s\n", this->filename.c_str());
+    return this->is_written;
+}
+
+ResultFileWriter::~ResultFileWriter(){
+    if (this->file != nullptr)
+        this->close();
+}
+
+
+ResultFile::ResultFile(std::string filename): nb_rows(0), mapping(nullptr), mapping_size(0){
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd < 0 || fstat(fd, &file_stat) != 0 || file_stat.st_size < off_t(HEADER_SIZE)){
+        fprintf(stderr, "Error: can't read the result file %s\n", filename.c_str());
+        if (fd >= 0)
+            ::close(fd);
+        return;
+    }
+    void* mapping = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED){
+        fprintf(stderr, "Error: can't map the result file %s\n", filename.c_str());
+        return;
+    }
+    this->mapping = static_cast<char*>(mapping);
+    this->mapping_size = file_stat.st_size;
+
+    const uint64_t* header = reinterpret_cast<const uint64_t*>(this->mapping);
+    if (header[0] != RESULT_FILE_MAGIC || header[1] > (this->mapping_size - HEADER_SIZE) / sizeof(std::time_t)){
+        fprintf(stderr, "Error: the result file %s is corrupted\n", filename.c_str());
+        munmap(this->mapping, this->mapping_size);
+        this->mapping = nullptr;
+        return;
+    }
+    this->nb_rows = header[1];
+    size_t offset = HEADER_SIZE + this->nb_rows * sizeof(std::time_t);
+    this->record_end_offsets.push_back(offset);
+    this->record_end_columns.push_back(0);
+    // Complete records only: an interrupted append leaves a partial one at the end
+    while (offset + 3 * sizeof(uint64_t) <= this->mapping_size){
+        const uint64_t* record_header = reinterpret_cast<const uint64_t*>(this->mapping + offset);
+        size_t nb_columns = record_header[1], names_size = record_header[2];
+        size_t names_offset = offset + 3 * sizeof(uint64_t);
+        if (record_header[0] != RESULT_RECORD_MAGIC || names_size > this->mapping_size - names_offset
+            || (this->nb_rows > 0 && nb_columns > (this->mapping_size - names_offset - names_size) / (this->nb_rows * sizeof(double))))
+            break;
+        size_t data_offset = names_offset + names_size;
+        const char* name = this->mapping + names_offset;
+        const char* names_end = name + names_size;
+        for (size_t c = 0; c < nb_columns; ++c){
+            size_t name_size = strnlen(name, names_end - name);
+            this->column_names.emplace_back(name, name_size);
+            this->columns.push_back(reinterpret_cast<const double*>(this->mapping + data_offset) + c * this->nb_rows);
+            name = std::min(name + name_size + 1, names_end);
+        }
+        offset = data_offset + nb_columns * this->nb_rows * sizeof(double);
+        this->record_end_offsets.push_back(offset);
+        this->record_end_columns.push_back(this->columns.size());
+    }
+}
+
+bool ResultFile::is_open() const{
+    return this->mapping != nullptr;
+}
+
+size_t ResultFile::get_nb_rows() const{
+    return this->nb_rows;
+}
+
+size_t ResultFile::get_nb_columns() const{
+    return this->columns.size();
+}
+
+const std::time_t* ResultFile::get_dates() const{
+    return reinterpret_cast<const std::time_t*>(this->mapping + HEADER_SIZE);
+}
+
+const std::vector<std::string>& ResultFile::get_column_names() const{
+    return this->column_names;
+}
+
+const double* ResultFile::get_column(size_t column_idx) const{
+    assert(column_idx < this->columns.size() && "Error: column index out of range\n");
+    return this->columns[column_idx];
+}
+
+int ResultFile::get_column_index(std::string name) const{
+    auto it = std::find(this->column_names.begin(), this->column_names.end(), name);
+    return (it != this->column_names.end()) ? int(it - this->column_names.begin()) : -1;
+}
+
+bool ResultFile::export_csv(std::string filename) const{
+    if (this->mapping == nullptr)
+        return false;
+    std::string header = "Date";
+    for (const auto& name: this->column_names)
+        header += ";" + name;
+    size_t nb_columns = this->columns.size();
+    CsvWriter csv_file(filename, std::max<size_t>(1 << 16, 2 * (header.size() + 32 * nb_columns)), false);
+    csv_file.write_line(header);
+    std::vector<double> row(nb_columns);
+    const std::time_t* dates = this->get_dates();
+    for (size_t r = 0; r < this->nb_rows; ++r){
+        for (size_t c = 0; c < nb_columns; ++c)
+            row[c] = this->columns[c][r];
+        csv_file.write_row(dates[r], row.data(), nb_columns);
+    }
+    return csv_file.close();
+}
+
+ResultFile::~ResultFile(){
+    if (this->mapping != nullptr)
+        munmap(this->mapping, this->mapping_size);
+}
@@ -1,23 +1,154 @@
 #include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
 #include "../headers/yahoo_utils.hpp"
+#include "../headers/xirr_solver.hpp"
+#include "../headers/checkpoint.hpp"
 #include <cassert>
 #include <iostream>
 #include <algorithm>
-#include <numeric>
 #include <limits>
-#include <random>
+#include <cmath>
+#include <sstream>
+#include <cstdio>
+
+// Target weights in tickers_yt order, 0 for the tickers without allocation
+static std::vector<double> get_target_weights(const std::vector<YahooTimeseries>& tickers_yt, const std::map<std::string, double>& allocations){
+    std::vector<double> target_weights;
+    for (const auto& ticker_yt: tickers_yt){
+        auto it = allocations.find(ticker_yt.get_ticker());
+        target_weights.push_back((it != allocations.end()) ? it->second : 0.0);
+    }
+    return target_weights;
+}
+
+Strategy::Strategy(const std::vector<YahooTimeseries>& tickers_yt, std::string strategy_name)
+: Strategy(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt), strategy_name){}
 
-Strategy::Strategy(const std::vector<YahooTimeseries>& tickers_yt, std::string strategy_name) : tickers_yt(tickers_yt), 
-                                                                                                strategy_name(strategy_name){
+Strategy::Strategy(SharedTickers tickers_yt, std::string strategy_name) : strategy_name(strategy_name),
+                                                                          shared_tickers_yt(tickers_yt),
+                                                                          tickers_yt(*this->shared_tickers_yt),
+                                                                          last_processed_date(std::numeric_limits<std::time_t>::min()),
+                                                                          is_background_output(false),
+                                                                          output_format(OutputFormat::CSV),
+                                                                          montecarlo_runner(new MonteCarloRunner()){
     PortfolioBuilder* ptf = new PortfolioBuilder();
     this->ptf = ptf;
 }
 
 void Strategy::run_strategy(){
     std::vector<std::time_t> dates = get_unique_dates(this->tickers_yt);
-    for (const auto& date: dates)
-        this->make_transactions(date);
-    this->ptf->set_portfolio_values_and_prices();
+    // After a snapshot only the new dates are processed and valued
+    auto first_date = std::upper_bound(dates.begin(), dates.end(), this->last_processed_date);
+    if (first_date == dates.end())
+        return;
+    for (auto it = first_date; it != dates.end(); ++it){
+        if (it + 1 == dates.end()){
+            ByteWriter writer;
+            this->write_state(writer);
+            this->last_date_state = writer.get_bytes();
+        }
+        this->make_transactions(*it);
+    }
+    if (first_date == dates.begin())
+        this->ptf->set_portfolio_values_and_prices();
+    else
+        this->ptf->update_portfolio_values_and_prices(*first_date);
+    this->last_processed_date = dates.back();
+}
+
+bool Strategy::save_snapshot(std::string filename) const{
+    std::string snapshot_tag = this->get_snapshot_tag();
+    if (snapshot_tag.empty()){
+        fprintf(stderr, "Error: %s does not support snapshots\n", this->strategy_name.c_str());
+        return false;
+    }
+    ByteWriter writer;
+    writer.put_string(snapshot_tag);
+    writer.put_string(this->strategy_name);
+    ByteWriter settings_writer;
+    this->write_settings(settings_writer);
+    writer.put_string(settings_writer.get_bytes());
+    writer.put<uint64_t>(this->tickers_yt.size());
+    for (const auto& ticker_yt: this->tickers_yt)
+        writer.put_string(ticker_yt.get_ticker());
+    writer.put(this->last_processed_date);
+    this->ptf->write(writer, this->last_processed_date);
+    if (this->last_processed_date == std::numeric_limits<std::time_t>::min()){
+        ByteWriter state_writer;
+        this->write_state(state_writer);
+        writer.put_string(state_writer.get_bytes());
+    }
+    else
+        writer.put_string(this->last_date_state);
+    if (!write_checkpoint(filename, writer.get_bytes())){
+        fprintf(stderr, "Error: could not write the snapshot %s\n", filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Strategy::load_snapshot(std::string filename){
+    std::string snapshot_tag = this->get_snapshot_tag();
+    if (snapshot_tag.empty()){
+        fprintf(stderr, "Error: %s does not support snapshots\n", this->strategy_name.c_str());
+        return false;
+    }
+    std::string payload;
+    if (!read_checkpoint(filename, payload)){
+        fprintf(stderr, "Error: no valid snapshot %s\n", filename.c_str());
+        return false;
+    }
+    ByteReader reader(payload);
+    std::string type_tag = reader.get_string();
+    std::string strategy_name = reader.get_string();
+    if (type_tag != snapshot_tag || strategy_name != this->strategy_name){
+        fprintf(stderr, "Error: the snapshot %s is not one of %s\n", filename.c_str(), this->strategy_name.c_str());
+        return false;
+    }
+    ByteWriter settings_writer;
+    this->write_settings(settings_writer);
+    if (reader.get_string() != settings_writer.get_bytes()){
+        fprintf(stderr, "Error: the snapshot %s was taken with other settings\n", filename.c_str());
+        return false;
+    }
+    bool is_same_tickers = reader.get<uint64_t>() == this->tickers_yt.size();
+    for (size_t t = 0; is_same_tickers && t < this->tickers_yt.size(); ++t)
+        is_same_tickers = reader.get_string() == this->tickers_yt[t].get_ticker();
+    if (!is_same_tickers){
+        fprintf(stderr, "Error: the snapshot %s was taken on other tickers\n", filename.c_str());
+        return false;
+    }
+    std::time_t last_processed_date = reader.get<std::time_t>();
+    PortfolioBuilder* ptf = new PortfolioBuilder();
+    if (!ptf->read(reader, this->tickers_yt)){
+        delete ptf;
+        return false;
+    }
+    std::string last_date_state = reader.get_string();
+    // The state is read in place: the current one is restored when the snapshot is short or too long
+    ByteWriter current_state_writer;
+    this->write_state(current_state_writer);
+    ByteReader state_reader(last_date_state);
+    this->read_state(state_reader);
+    if (reader.is_truncated() || !reader.is_done() || state_reader.is_truncated() || !state_reader.is_done()){
+        fprintf(stderr, "Error: the snapshot %s does not match the strategy state\n", filename.c_str());
+        ByteReader current_state_reader(current_state_writer.get_bytes());
+        this->read_state(current_state_reader);
+        delete ptf;
+        return false;
+    }
+    delete this->ptf;
+    this->ptf = ptf;
+    // The next run_strategy starts again from the last date of the snapshot
+    bool is_run = last_processed_date != std::numeric_limits<std::time_t>::min();
+    this->last_processed_date = is_run ? last_processed_date - 1 : last_processed_date;
+    this->last_date_state = last_date_state;
+    this->rebalancing_asset_indices.clear();
+    return true;
+}
+
+const PortfolioBuilder& Strategy::get_portfolio() const{
+    return *this->ptf;
 }
 
 const std::map<std::time_t, double> Strategy::get_strategy_values() const{
@@ -39,72 +170,177 @@ double Strategy::get_strategy_extended_internal_return_rate(double tolerance, in
     std::vector<double> ptf_cash_flow;
     std::vector<time_t> ptf_cash_flow_dates;
     for (const auto& pair: this->ptf->get_portfolio_historical_cash_flow())
-        if (abs(pair.second) > 1e-3){
+        if (std::fabs(pair.second) > 1e-3){
             ptf_cash_flow_dates.push_back(pair.first);
             ptf_cash_flow.push_back(pair.second);
         }
     ptf_cash_flow.push_back(this->ptf->get_portfolio_value(dates.back()));
     ptf_cash_flow_dates.push_back(dates.back());
 
-    double lower_bound = -1.0;
-    double upper_bound = 1.0;
-    double rate = 0.0;
-    std::time_t first_date = ptf_cash_flow_dates[0];
-
-    for (int i = 0; i < max_iterations; ++i) {
-        double npv = 0.0;
-        rate = (lower_bound + upper_bound) / 2.0;
-        for (size_t i = 0; i < ptf_cash_flow.size(); ++i) {
-            double days = std::difftime(ptf_cash_flow_dates[i], first_date) / (60 * 60 * 24);
-            npv += ptf_cash_flow[i] / pow(1.0 + rate, days / 365.0);
-        }
-
-        if (fabs(npv) < tolerance) {
-            return rate;
-        }
+    XirrSolver solver(tolerance, max_iterations);
+    return solver.solve(ptf_cash_flow, get_year_fractions(ptf_cash_flow_dates));
+}
 
-        if (npv > 0)
-            lower_bound = rate;
-        else
-            upper_bound = rate;        
+double Strategy::get_strategy_volatility() const{
+    std::vector<double> pct_changes;
+    double previous_price = std::numeric_limits<double>::quiet_NaN();
+    for (const auto& pair: this->ptf->get_ts_portfolio_prices().get_ts_values()){
+        if (std::isfinite(previous_price) && std::isfinite(pair.second) && previous_price > 0)
+            pct_changes.push_back((pair.second - previous_price) / previous_price);
+        previous_price = pair.second;
     }
+    if (pct_changes.size() < 2)
+        return 0.0;
+    return get_standard_deviation(pct_changes) * std::sqrt(252.0);
+}
 
-    return rate;
+double Strategy::get_strategy_max_drawdown() const{
+    double peak_price = 0.0;
+    double max_drawdown = 0.0;
+    for (const auto& pair: this->ptf->get_ts_portfolio_prices().get_ts_values()){
+        if (!std::isfinite(pair.second))
+            continue;
+        peak_price = std::max(peak_price, pair.second);
+        if (peak_price > 0)
+            max_drawdown = std::max(max_drawdown, 1.0 - pair.second / peak_price);
+    }
+    return max_drawdown;
 }
 
 void Strategy::save_end_portfolio(){
-    this->ptf->save_portfolio(this->strategy_name);
+    if (this->output_format == OutputFormat::BINARY)
+        this->ptf->save_portfolio_results(this->strategy_name);
+    else
+        this->ptf->save_portfolio(this->strategy_name, this->is_background_output);
     double tr = 100 * this->get_strategy_total_returns();
     double xirr = 100 * this->get_strategy_extended_internal_return_rate(1e-3, 1000);
     double ptf_end_value = this->ptf->get_portfolio_values().rbegin()->second;
-    std::cout << "Strategy "+ this->strategy_name+" Total Returns: " << std::ceil(tr * 100.0) / 100.0 << "% - Internal Rate of Return: " << std::ceil(xirr * 100.0) / 100.0 << "%" << " Portfolio End Value: " << ptf_end_value << std::endl;
+    // One write per line: Monte Carlo paths are saved from several threads
+    std::ostringstream line;
+    line << "Strategy "+ this->strategy_name+" Total Returns: " << std::ceil(tr * 100.0) / 100.0 << "% - Internal Rate of Return: " << std::ceil(xirr * 100.0) / 100.0 << "%" << " Portfolio End Value: " << ptf_end_value << "\n";
+    std::cout << line.str() << std::flush;
 }
 
-const YahooTimeseries Strategy::montecarlo_simulation(const std::vector<std::time_t>& future_dates){
-    Timeseries portfolio_prices = this->ptf->get_ts_portfolio_prices();
-    std::vector<double> pct_changes = portfolio_prices.get_pct_changes();
-    double ptf_mean_return = std::accumulate(pct_changes.begin(), pct_changes.end(), 0.0) / pct_changes.size();
-    double ptf_volatility = get_standard_deviation(pct_changes);
-    
-    std::random_device rd;
-    std::mt19937 generator(rd());
-    std::normal_distribution<double> normal_dist(ptf_mean_return, ptf_volatility);
-
-    std::vector<double> future_prices(future_dates.size());
-    future_prices[0] = portfolio_prices.get_ts_values().rbegin()->second;
-    for (size_t i=1; i < future_dates.size(); ++i){
-        future_prices[i] = future_prices[i-1] + (future_prices[i-1] * normal_dist(generator));
-    }
+void Strategy::set_background_output(bool is_background_output){
+    this->is_background_output = is_background_output;
+}
+
+void Strategy::set_output_format(OutputFormat output_format){
+    this->output_format = output_format;
+}
+
+const YahooTimeseries Strategy::montecarlo_simulation(const std::vector<std::time_t>& future_dates, double start_price, double mean_return, double volatility, uint64_t seed, uint64_t path_idx) const{
+    PathGenerator path_generator(PathModel::ARITHMETIC_RETURNS, start_price, mean_return, volatility, seed);
+    std::vector<double> future_prices = path_generator.generate(path_idx, 1, future_dates.size());
     return YahooTimeseries("MonteCarloSimulationTicker", future_dates, future_prices, future_prices, future_prices, future_prices, future_prices);
 }
 
+void Strategy::set_montecarlo_config(uint64_t seed, size_t nb_threads, std::time_t start_date, bool save_paths){
+    MonteCarloConfig& config = this->montecarlo_runner->get_config();
+    config.seed = seed;
+    config.nb_threads = nb_threads;
+    config.start_date = start_date;
+    config.save_paths = save_paths;
+}
+
+void Strategy::set_montecarlo_model(MonteCarloModel model){
+    this->montecarlo_runner->get_config().model = model;
+}
+
+void Strategy::set_montecarlo_bootstrap(BootstrapScheme scheme, double mean_block_length){
+    this->montecarlo_runner->get_config().bootstrap_scheme = scheme;
+    this->montecarlo_runner->get_config().mean_block_length = mean_block_length;
+}
+
+void Strategy::set_montecarlo_variance_reduction(VarianceReduction variance_reduction){
+    this->montecarlo_runner->get_config().variance_reduction = variance_reduction;
+}
+
+void Strategy::set_montecarlo_stopping_rule(const MonteCarloStoppingRule& stopping_rule){
+    this->montecarlo_runner->get_config().stopping_rule = stopping_rule;
+}
+
+void Strategy::set_montecarlo_checkpoint(std::string filename, double interval_seconds){
+    this->montecarlo_runner->get_config().checkpoint_filename = filename;
+    this->montecarlo_runner->get_config().checkpoint_interval = interval_seconds;
+}
+
+const std::vector<double>& Strategy::get_montecarlo_end_values() const{
+    return this->montecarlo_runner->get_samples().end_values;
+}
+
+const MonteCarloSamples& Strategy::get_montecarlo_samples() const{
+    return this->montecarlo_runner->get_samples();
+}
+
+const MonteCarloAggregator* Strategy::get_montecarlo_aggregator() const{
+    return this->montecarlo_runner->get_aggregator();
+}
+
+const MonteCarloThroughput& Strategy::get_montecarlo_throughput() const{
+    return this->montecarlo_runner->get_throughput();
+}
+
+const MonteCarloEstimates& Strategy::get_montecarlo_estimates() const{
+    return this->montecarlo_runner->get_estimates();
+}
+
+const MonteCarloConvergence& Strategy::get_montecarlo_convergence() const{
+    return this->montecarlo_runner->get_convergence();
+}
+
+void Strategy::run_montecarlo_paths(size_t nb_simu, const MonteCarloPathStrategy& path_strategy){
+    this->montecarlo_runner->run(nb_simu, this->strategy_name, this->tickers_yt, *this->ptf, this->output_format, this->is_background_output, path_strategy);
+}
+
+void Strategy::run_distributed_montecarlo_simulations(size_t nb_simu, LocalCluster& cluster, size_t shard_size){
+    this->montecarlo_runner->run_distributed(nb_simu, this->strategy_name, cluster, shard_size, [this](size_t nb_paths){
+        this->run_montecarlo_simulations(nb_paths);
+    });
+}
+
+void Strategy::rebalance_to_targets(Rebalancer& rebalancer, std::time_t date){
+    size_t nb_assets = this->tickers_yt.size();
+    assert(rebalancer.get_nb_assets() == nb_assets && "Error: the rebalancer must have one target per ticker\n");
+    // Holding positions are looked up until every ticker is held, then cached
+    if (this->rebalancing_asset_indices.size() != nb_assets || std::count(this->rebalancing_asset_indices.begin(), this->rebalancing_asset_indices.end(), -1) > 0)
+        this->rebalancing_asset_indices = this->ptf->get_asset_indices(this->tickers_yt);
+    this->rebalancing_shares.resize(nb_assets);
+    this->rebalancing_prices.resize(nb_assets);
+    this->ptf->get_last_shares(this->rebalancing_asset_indices, this->rebalancing_shares.data());
+    for (size_t a = 0; a < nb_assets; ++a)
+        this->rebalancing_prices[a] = (this->rebalancing_asset_indices[a] >= 0) ? this->tickers_yt[a].get_closes().get_ts_value(date) : 0.0;
+    if (rebalancer.compute_orders(this->rebalancing_shares.data(), this->rebalancing_prices.data()) > 0)
+        this->ptf->apply_orders(this->rebalancing_asset_indices, rebalancer.get_orders().data(), this->rebalancing_prices.data(), date);
+}
+
+std::string Strategy::get_snapshot_tag() const{
+    return "";
+}
+
+void Strategy::write_settings(ByteWriter&) const{}
+
+void Strategy::write_state(ByteWriter&) const{}
+
+void Strategy::read_state(ByteReader&){}
+
 Strategy::~Strategy(){
     delete this->ptf;
+    delete this->montecarlo_runner;
 }
 
 
 
 DCA::DCA(const std::vector<YahooTimeseries>& tickers_yt,
+         double starting_amount,
+         double recurrent_investment_amount,
+         const std::map<std::string, double>& assets_desired_pct_allocations,
+         int rebalancing_freq,
+         double rebalancing_threshold,
+         std::string strategy_name):DCA(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt), starting_amount, recurrent_investment_amount,
+                                        assets_desired_pct_allocations, rebalancing_freq, rebalancing_threshold, strategy_name){}
+
+DCA::DCA(SharedTickers tickers_yt,
                            double starting_amount,
                            double recurrent_investment_amount,
                            const std::map<std::string, double>& assets_desired_pct_allocations,
@@ -116,9 +352,10 @@ DCA::DCA(const std::vector<YahooTimeseries>& tickers_yt,
                                                         assets_desired_pct_allocations(assets_desired_pct_allocations),
                                                         rebalancing_freq(rebalancing_freq),
                                                         rebalancing_threshold(rebalancing_threshold),
-                                                        last_rebalancing_nb_days(0){
+                                                        last_rebalancing_nb_days(0),
+                                                        rebalancer(get_target_weights(*tickers_yt, assets_desired_pct_allocations), RebalancingThreshold::ABSOLUTE, rebalancing_threshold){
     std::vector<std::string> tickers;
-    for (auto& ticker_yt: tickers_yt){
+    for (auto& ticker_yt: this->tickers_yt){
         std::string ticker = ticker_yt.get_ticker();
         tickers.push_back(ticker);
         this->tickers_first_month_dates[ticker] = extract_first_dates_of_each_month(ticker_yt.get_dates());
@@ -127,7 +364,7 @@ DCA::DCA(const std::vector<YahooTimeseries>& tickers_yt,
     double sum = 0.0;
     for (const auto& pair : assets_desired_pct_allocations) {
         assert(std::find(tickers.begin(), tickers.end(), pair.first) != tickers.end() && "pct allocation ticker name not in the passed YahooTimeries tickers list\n");
-        assert(pair.second > 0 && "Each percentage allocation must be > 0!\n");
+        assert(pair.second >= 0 && "Each percentage allocation must be >= 0!\n");
         sum += pair.second;
         this->assets_starting_amounts[pair.first] = assets_desired_pct_allocations.at(pair.first) * starting_amount;
     }
@@ -135,22 +372,12 @@ DCA::DCA(const std::vector<YahooTimeseries>& tickers_yt,
     assert(std::fabs(sum - 1.0) < 1e-9 && "The sum of percentages is not equal to 1!\n");
 }
 
+void DCA::set_rebalancing_mode(RebalancingThreshold rebalancing_mode){
+    this->rebalancer.set_threshold(rebalancing_mode, this->rebalancing_threshold);
+}
+
 void DCA::rebalance_portfolio(std::time_t date){
-    std::map<std::string, double> ptf_alloc = this->ptf->get_portfolio_percentage_allocations(date);
-    for (auto& ticker_yt: this->tickers_yt){
-        std::string ticker = ticker_yt.get_ticker();
-        double ticker_shares = ptf->get_ticker_shares(ticker, date);
-        double target_alloc = this->assets_desired_pct_allocations[ticker];
-        double ticker_alloc = ptf_alloc[ticker];
-        if (ticker_alloc - target_alloc > this->rebalancing_threshold){
-            ticker_shares -= ticker_shares * target_alloc / ticker_alloc;
-            this->ptf->sell(ticker_yt, ticker_shares, date);
-        }
-        if (target_alloc - ticker_alloc > this->rebalancing_threshold && ticker_alloc > 0){
-            ticker_shares = (ticker_shares * target_alloc / ticker_alloc) - ticker_shares;
-            this->ptf->buy(ticker_yt, ticker_shares, date);
-        }
-    }
+    this->rebalance_to_targets(this->rebalancer, date);
 }
 
 void DCA::make_transaction(const YahooTimeseries& ticker_yt, std::time_t date) {
@@ -175,7 +402,7 @@ void DCA::make_transaction(const YahooTimeseries& ticker_yt, std::time_t date) {
     std::map<std::time_t, double> dividends = ticker_yt.get_dividends().get_ts_values();
 
     if (dividends.size() > 0 && dividends.find(date) != dividends.end()){
-        shares_amt = 0.7 * dividends[date] * this->ptf->get_ticker_shares(ticker, date) / ticker_value;
+        shares_amt = DIVIDEND_REINVESTMENT_RATIO * dividends[date] * this->ptf->get_ticker_shares(ticker, date) / ticker_value;
         this->ptf->buy(ticker_yt, shares_amt, date);
     }
 }
@@ -193,42 +420,66 @@ void DCA::make_transactions(std::time_t date){
 }
 
 
+std::string DCA::get_snapshot_tag() const{
+    return "DCA";
+}
+
+void DCA::write_settings(ByteWriter& writer) const{
+    writer.put(this->starting_amount);
+    writer.put(this->recurrent_investment_amount);
+    writer.put_map(this->assets_desired_pct_allocations);
+    writer.put(this->rebalancing_freq);
+    writer.put(this->rebalancing_threshold);
+    writer.put(this->rebalancer.get_mode());
+}
+
+void DCA::write_state(ByteWriter& writer) const{
+    writer.put_map(this->assets_starting_amounts);
+    writer.put(this->last_rebalancing_nb_days);
+}
+
+void DCA::read_state(ByteReader& reader){
+    this->assets_starting_amounts = reader.get_map<std::string, double>();
+    this->last_rebalancing_nb_days = reader.get<int>();
+}
+
 void DCA::run_montecarlo_simulations(size_t nb_simu){
-    std::time_t currentTime = std::time(nullptr); // get current date
-    std::tm* tm_start = std::localtime(&currentTime);
-    std::tm tm_end = *tm_start;
-    // Add 20 years to the current year
-    tm_end.tm_year += 20;
-
-    std::time_t start = std::mktime(tm_start);
-    std::time_t end = std::mktime(&tm_end);
-    size_t count = 1 + 252 * 20;
-    std::vector<std::time_t> future_dates = generate_random_dates(count, start, end);
-    for (size_t i=0; i<nb_simu; ++i){
-        const YahooTimeseries yt = this->montecarlo_simulation(future_dates);
-        Strategy* strat = new DCA({yt}, 
-                                  this->starting_amount, 
-                                  this->recurrent_investment_amount,  
-                                  {{"MonteCarloSimulationTicker", 1.0}}, 
-                                  this->rebalancing_threshold, 
-                                  this->rebalancing_freq, 
-                                  this->strategy_name+ "_MonteCarloSimu_n" + std::to_string(i+1));
-        strat->run_strategy();
-        strat->save_end_portfolio();
-        delete strat;
-    }
+    BatchPortfolio batch_portfolio = {this->starting_amount, this->recurrent_investment_amount, {}, this->rebalancing_freq, this->rebalancing_threshold};
+    MonteCarloStrategyFactory path_strategy_factory = [this](const std::vector<YahooTimeseries>& path_tickers_yt, const std::map<std::string, double>& allocations, std::string strategy_name) -> Strategy* {
+        DCA* path_dca = new DCA(path_tickers_yt, 
+                                this->starting_amount, 
+                                this->recurrent_investment_amount,  
+                                allocations, 
+                                this->rebalancing_freq, 
+                                this->rebalancing_threshold, 
+                                strategy_name);
+        path_dca->set_rebalancing_mode(this->rebalancer.get_mode());
+        return path_dca;
+    };
+    this->run_montecarlo_paths(nb_simu, {path_strategy_factory, this->assets_desired_pct_allocations, &batch_portfolio, BatchContribution::MONTHLY, this->rebalancer.get_mode()});
 }
 
 
-SmaOptimizedDCA::SmaOptimizedDCA(const std::vector<YahooTimeseries>& tickers_yt, 
+SmaOptimizedDCA::SmaOptimizedDCA(const std::vector<YahooTimeseries>& tickers_yt,
+                 double starting_amount,
+                 double recurrent_investment_amount,
+                 const std::map<std::string, double>& assets_desired_pct_allocations,
+                 int rebalancing_freq,
+                 double rebalancing_threshold,
+                 int sma_window_size,
+                 std::string strategy_name):SmaOptimizedDCA(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt), starting_amount, recurrent_investment_amount,
+                                                            assets_desired_pct_allocations, rebalancing_freq, rebalancing_threshold, sma_window_size, strategy_name){}
+
+SmaOptimizedDCA::SmaOptimizedDCA(SharedTickers tickers_yt,
                  double starting_amount,
                  double recurrent_investment_amount,
                  const std::map<std::string, double>& assets_desired_pct_allocations, 
                  int rebalancing_freq,
                  double rebalancing_threshold,
                  int sma_window_size,
-                 std::string strategy_name):DCA(tickers_yt, starting_amount, recurrent_investment_amount, assets_desired_pct_allocations, rebalancing_freq, rebalancing_threshold, strategy_name){
-    for (auto& ticker_yt: tickers_yt){
+                 std::string strategy_name):DCA(tickers_yt, starting_amount, recurrent_investment_amount, assets_desired_pct_allocations, rebalancing_freq, rebalancing_threshold, strategy_name),
+                                            sma_window_size(sma_window_size){
+    for (auto& ticker_yt: this->tickers_yt){
         std::string ticker = ticker_yt.get_ticker();
         this->tickers_last_month_dates[ticker] = extract_last_dates_of_each_month(ticker_yt.get_dates());
         this->current_tickers_remaining_investment_amount[ticker] = 0.0;
@@ -266,7 +517,7 @@ void SmaOptimizedDCA::make_transaction(const YahooTimeseries& ticker_yt, std::ti
 
     std::map<std::time_t, double> dividends = ticker_yt.get_dividends().get_ts_values();
     if (dividends.size() > 0 && dividends.find(date) != dividends.end()){
-        shares_amt = 0.7 * dividends[date] * this->ptf->get_ticker_shares(ticker, date) / ticker_value;
+        shares_amt = DIVIDEND_REINVESTMENT_RATIO * dividends[date] * this->ptf->get_ticker_shares(ticker, date) / ticker_value;
         this->ptf->buy(ticker_yt, shares_amt, date);
     }
 }
@@ -283,8 +534,35 @@ void SmaOptimizedDCA::make_transactions(std::time_t date){
         this->last_rebalancing_nb_days++;
 }
 
+std::string SmaOptimizedDCA::get_snapshot_tag() const{
+    return "SmaOptimizedDCA";
+}
+
+void SmaOptimizedDCA::write_settings(ByteWriter& writer) const{
+    DCA::write_settings(writer);
+    writer.put(this->sma_window_size);
+}
+
+void SmaOptimizedDCA::write_state(ByteWriter& writer) const{
+    DCA::write_state(writer);
+    writer.put_map(this->current_tickers_remaining_investment_amount);
+}
+
+void SmaOptimizedDCA::read_state(ByteReader& reader){
+    DCA::read_state(reader);
+    this->current_tickers_remaining_investment_amount = reader.get_map<std::string, double>();
+}
+
 
 LumpSum::LumpSum(const std::vector<YahooTimeseries>& tickers_yt,
+                 double initial_investment_amount,
+                 const std::map<std::string, double>& assets_desired_pct_allocations,
+                 int rebalancing_freq,
+                 double rebalancing_threshold,
+                 std::string strategy_name):LumpSum(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt), initial_investment_amount,
+                                                    assets_desired_pct_allocations, rebalancing_freq, rebalancing_threshold, strategy_name){}
+
+LumpSum::LumpSum(SharedTickers tickers_yt,
                                 double initial_investment_amount,
                                 const std::map<std::string, double>& assets_desired_pct_allocations,
                                 int rebalancing_freq,
@@ -293,9 +571,10 @@ LumpSum::LumpSum(const std::vector<YahooTimeseries>& tickers_yt,
                                                                 initial_investment_amount(initial_investment_amount),
                                                                 assets_desired_pct_allocations(assets_desired_pct_allocations),
                                                                 rebalancing_freq(rebalancing_freq),
-                                                                rebalancing_threshold(rebalancing_threshold){
+                                                                rebalancing_threshold(rebalancing_threshold),
+                                                                rebalancer(get_target_weights(*tickers_yt, assets_desired_pct_allocations), RebalancingThreshold::RELATIVE, rebalancing_threshold){
     std::vector<std::string> tickers;
-    for (auto& ticker_yt: tickers_yt){
+    for (auto& ticker_yt: this->tickers_yt){
         std::string ticker = ticker_yt.get_ticker();
         tickers.push_back(ticker);
         this->tickers_first_date[ticker] = ticker_yt.get_dates()[0];
@@ -303,7 +582,7 @@ LumpSum::LumpSum(const std::vector<YahooTimeseries>& tickers_yt,
     double sum = 0.0;
     for (const auto& pair : assets_desired_pct_allocations) {
         assert(std::find(tickers.begin(), tickers.end(), pair.first) != tickers.end() && "pct allocation ticker name not in the passed YahooTimeries tickers list\n");
-        assert(pair.second > 0 && "Each percentage allocation must be > 0!\n");
+        assert(pair.second >= 0 && "Each percentage allocation must be >= 0!\n");
         sum += pair.second;
     }
 
@@ -316,25 +595,16 @@ void LumpSum::make_transaction(const YahooTimeseries& ticker_yt, std::time_t dat
     double alloc_pct = this->assets_desired_pct_allocations[ticker];
     double ticker_value = ticker_yt.get_closes().get_ts_value(date);
     double shares_amt = alloc_pct * this->initial_investment_amount / ticker_value;
-    this->ptf->buy(ticker_yt, shares_amt, date);
+    if (shares_amt > 0)
+        this->ptf->buy(ticker_yt, shares_amt, date);
+}
+
+void LumpSum::set_rebalancing_mode(RebalancingThreshold rebalancing_mode){
+    this->rebalancer.set_threshold(rebalancing_mode, this->rebalancing_threshold);
 }
 
 void LumpSum::rebalance_portfolio(std::time_t date){
-    std::map<std::string, double> ptf_alloc = this->ptf->get_portfolio_percentage_allocations(date);
-    for (auto& ticker_yt: this->tickers_yt){
-        std::string ticker = ticker_yt.get_ticker();
-        double ticker_shares = ptf->get_ticker_shares(ticker, date);
-        double target_alloc = this->assets_desired_pct_allocations[ticker];
-        double ticker_alloc = ptf_alloc[ticker];
-        if ((ticker_alloc - target_alloc) / target_alloc > this->rebalancing_threshold){
-            ticker_shares -= ticker_shares * target_alloc / ticker_alloc;
-            this->ptf->sell(ticker_yt, ticker_shares, date);
-        }
-        if (ticker_alloc > 0 && (target_alloc - ticker_alloc) / target_alloc > this->rebalancing_threshold ){
-            ticker_shares = (ticker_shares * target_alloc / ticker_alloc) - ticker_shares;
-            this->ptf->buy(ticker_yt, ticker_shares, date);
-        }
-    }
+    this->rebalance_to_targets(this->rebalancer, date);
 }
 
 void LumpSum::make_transactions(std::time_t date){
@@ -345,7 +615,7 @@ void LumpSum::make_transactions(std::time_t date){
         
         std::map<std::time_t, double> dividends = ticker_yt.get_dividends().get_ts_values();
         if (dividends.size() > 0 && dividends.find(date) != dividends.end()){
-            double shares_amt = 0.7 * dividends[date] * this->ptf->get_ticker_shares(ticker, date) / ticker_yt.get_closes().get_ts_value(date);
+            double shares_amt = DIVIDEND_REINVESTMENT_RATIO * dividends[date] * this->ptf->get_ticker_shares(ticker, date) / ticker_yt.get_closes().get_ts_value(date);
             this->ptf->buy(ticker_yt, shares_amt, date);
         }
     }
@@ -355,4 +625,39 @@ void LumpSum::make_transactions(std::time_t date){
     }
     else
         this->last_rebalancing_nb_days++;
-}
\ No newline at end of file
+}
+
+std::string LumpSum::get_snapshot_tag() const{
+    return "LumpSum";
+}
+
+void LumpSum::write_settings(ByteWriter& writer) const{
+    writer.put(this->initial_investment_amount);
+    writer.put_map(this->assets_desired_pct_allocations);
+    writer.put(this->rebalancing_freq);
+    writer.put(this->rebalancing_threshold);
+    writer.put(this->rebalancer.get_mode());
+}
+
+void LumpSum::write_state(ByteWriter& writer) const{
+    writer.put(this->last_rebalancing_nb_days);
+}
+
+void LumpSum::read_state(ByteReader& reader){
+    this->last_rebalancing_nb_days = reader.get<int>();
+}
+
+void LumpSum::run_montecarlo_simulations(size_t nb_simu){
+    BatchPortfolio batch_portfolio = {this->initial_investment_amount, 0.0, {}, this->rebalancing_freq, this->rebalancing_threshold};
+    MonteCarloStrategyFactory path_strategy_factory = [this](const std::vector<YahooTimeseries>& path_tickers_yt, const std::map<std::string, double>& allocations, std::string strategy_name) -> Strategy* {
+        LumpSum* path_lump_sum = new LumpSum(path_tickers_yt,
+                                             this->initial_investment_amount,
+                                             allocations,
+                                             this->rebalancing_freq,
+                                             this->rebalancing_threshold,
+                                             strategy_name);
+        path_lump_sum->set_rebalancing_mode(this->rebalancer.get_mode());
+        return path_lump_sum;
+    };
+    this->run_montecarlo_paths(nb_simu, {path_strategy_factory, this->assets_desired_pct_allocations, &batch_portfolio, BatchContribution::LUMP_SUM, this->rebalancer.get_mode()});
+}
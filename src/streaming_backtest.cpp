@@ -0,0 +1,125 @@
+#include "../headers/streaming_backtest.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+IncrementalSma::IncrementalSma(size_t window_size): window(window_size, 0.0){
+    assert(window_size > 0 && "Error: the window size must be > 0\n");
+    this->reset();
+}
+
+void IncrementalSma::reset(){
+    std::fill(this->window.begin(), this->window.end(), 0.0);
+    this->position = 0;
+    this->nb_values = 0;
+    this->sum = 0.0;
+}
+
+void IncrementalSma::add(double value){
+    if (this->nb_values < this->window.size()){
+        this->sum += value;
+        ++this->nb_values;
+    }
+    else
+        this->sum += value - this->window[this->position];
+    this->window[this->position] = value;
+    this->position = (this->position + 1) % this->window.size();
+}
+
+double IncrementalSma::get_value() const{
+    return (this->nb_values == this->window.size()) ? this->sum / this->window.size() : 0.0;
+}
+
+// Local midnight of the first day of the month after time
+static std::time_t get_next_month_start(std::time_t time){
+    std::tm time_info;
+    localtime_r(&time, &time_info);
+    time_info.tm_mday = 1;
+    time_info.tm_mon += 1;
+    time_info.tm_hour = 0;
+    time_info.tm_min = 0;
+    time_info.tm_sec = 0;
+    time_info.tm_isdst = -1;
+    return std::mktime(&time_info);
+}
+
+StreamingBacktest::StreamingBacktest(const std::vector<BatchPortfolio>& portfolios, BatchContribution contribution, RebalancingThreshold rebalancing_mode, size_t sma_window_size)
+: engine(portfolios, rebalancing_mode), contribution(contribution), sma_window_size(sma_window_size), nb_bars(0){}
+
+void StreamingBacktest::set_row_handler(const std::function<void(const StreamingRow&)>& handler){
+    this->row_handler = handler;
+}
+
+void StreamingBacktest::reset(size_t nb_tickers){
+    assert(nb_tickers == this->engine.get_nb_assets() && "Error: the portfolios must have one allocation per ticker\n");
+    size_t n = this->engine.get_nb_portfolios();
+    this->engine.reset();
+    this->nb_bars = 0;
+    this->last_closes.assign(nb_tickers, 0.0);
+    this->asset_prices.resize(nb_tickers);
+    for (size_t t = 0; t < nb_tickers; ++t)
+        this->asset_prices[t] = &this->last_closes[t];
+    this->row_dividends.assign(nb_tickers, 0.0);
+    this->is_contribution_dates.assign(nb_tickers, 0);
+    this->next_contribution_times.assign(nb_tickers, std::numeric_limits<std::time_t>::min());
+    this->smas.assign(nb_tickers, IncrementalSma(this->sma_window_size));
+    this->sma_values.assign(nb_tickers, 0.0);
+    this->values.assign(n, 0.0);
+    this->peak_values.assign(n, 0.0);
+    this->max_drawdowns.assign(n, 0.0);
+}
+
+void StreamingBacktest::process_chunk(const BarChunk& chunk){
+    size_t nb_tickers = this->last_closes.size();
+    size_t n = this->engine.get_nb_portfolios();
+    assert(chunk.closes.size() == nb_tickers && "Error: reset the backtest with the number of tickers of the source\n");
+    for (size_t r = 0; r < chunk.nb_bars; ++r){
+        std::time_t time = chunk.times[r];
+        for (size_t t = 0; t < nb_tickers; ++t){
+            double close = chunk.closes[t][r];
+            bool has_bar = !std::isnan(close);
+            this->is_contribution_dates[t] = has_bar && time >= this->next_contribution_times[t];
+            if (this->is_contribution_dates[t])
+                this->next_contribution_times[t] = (this->contribution == BatchContribution::MONTHLY) ? get_next_month_start(time) : std::numeric_limits<std::time_t>::max();
+            if (has_bar){
+                this->last_closes[t] = close;
+                this->sma_values[t] = this->smas[t].get_value();
+                this->smas[t].add(close);
+            }
+            this->row_dividends[t] = chunk.dividends[t][r];
+        }
+        this->engine.step(this->asset_prices.data(), 0, this->row_dividends.data(), this->is_contribution_dates.data());
+        this->engine.get_portfolio_values(this->asset_prices.data(), 0, this->values.data());
+        for (size_t p = 0; p < n; ++p){
+            this->peak_values[p] = std::max(this->peak_values[p], this->values[p]);
+            if (this->peak_values[p] > 0)
+                this->max_drawdowns[p] = std::max(this->max_drawdowns[p], 1.0 - this->values[p] / this->peak_values[p]);
+        }
+        if (this->row_handler)
+            this->row_handler({time, this->last_closes.data(), this->sma_values.data(), this->values.data()});
+    }
+    this->nb_bars += chunk.nb_bars;
+}
+
+void StreamingBacktest::run(const BarSource& source){
+    this->reset(source.get_tickers().size());
+    source.stream([this](const BarChunk& chunk){ this->process_chunk(chunk); });
+}
+
+size_t StreamingBacktest::get_nb_bars() const{
+    return this->nb_bars;
+}
+
+const std::vector<double>& StreamingBacktest::get_values() const{
+    return this->values;
+}
+
+const std::vector<double>& StreamingBacktest::get_max_drawdowns() const{
+    return this->max_drawdowns;
+}
+
+const BatchEngine& StreamingBacktest::get_engine() const{
+    return this->engine;
+}
+
+StreamingBacktest::~StreamingBacktest(){}
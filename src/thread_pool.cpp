@@ -0,0 +1,114 @@
+#include "../headers/thread_pool.hpp"
+#include <cassert>
+
+static thread_local ThreadPool* current_pool = nullptr;
+static thread_local size_t current_worker_index = 0;
+
+ThreadPool::ThreadPool(size_t nb_threads): nb_pending_tasks(0), nb_queued_tasks(0), stopping(false), next_queue(0){
+    if (nb_threads == 0)
+        nb_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < nb_threads; ++i)
+        this->queues.emplace_back(new WorkerQueue());
+    for (size_t i = 0; i < nb_threads; ++i)
+        this->workers.emplace_back(&ThreadPool::worker_loop, this, i);
+}
+
+void ThreadPool::submit(std::function<void()> task){
+    // Tasks spawned by a worker stay on its own queue, others are spread round-robin
+    size_t queue_index = (current_pool == this) ? current_worker_index : this->next_queue++ % this->queues.size();
+    this->nb_pending_tasks++;
+    {
+        std::lock_guard<std::mutex> lock(this->queues[queue_index]->mutex);
+        this->queues[queue_index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->nb_queued_tasks++;
+    }
+    this->tasks_available.notify_one();
+}
+
+void ThreadPool::wait(){
+    assert(current_pool != this && "Error: ThreadPool::wait can't be called from one of its tasks\n");
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->tasks_done.wait(lock, [this]{ return this->nb_pending_tasks == 0; });
+    if (this->task_exception){
+        std::exception_ptr task_exception = this->task_exception;
+        this->task_exception = nullptr;
+        std::rethrow_exception(task_exception);
+    }
+}
+
+void ThreadPool::parallel_for(size_t nb_tasks, const std::function<void(size_t)>& task){
+    for (size_t i = 0; i < nb_tasks; ++i)
+        this->submit([&task, i]{ task(i); });
+    this->wait();
+}
+
+size_t ThreadPool::get_nb_threads() const{
+    return this->workers.size();
+}
+
+size_t ThreadPool::get_worker_index(){
+    assert(current_pool != nullptr && "Error: get_worker_index must be called from a ThreadPool task\n");
+    return current_worker_index;
+}
+
+bool ThreadPool::pop_task(size_t worker_index, std::function<void()>& task){
+    {
+        WorkerQueue& own_queue = *this->queues[worker_index];
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+        if (!own_queue.tasks.empty()){
+            task = std::move(own_queue.tasks.back());
+            own_queue.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < this->queues.size(); ++i){
+        WorkerQueue& victim_queue = *this->queues[(worker_index + i) % this->queues.size()];
+        std::lock_guard<std::mutex> lock(victim_queue.mutex);
+        if (!victim_queue.tasks.empty()){
+            task = std::move(victim_queue.tasks.front());
+            victim_queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(size_t worker_index){
+    current_pool = this;
+    current_worker_index = worker_index;
+    while (true){
+        std::function<void()> task;
+        if (!this->pop_task(worker_index, task)){
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->tasks_available.wait(lock, [this]{ return this->stopping || this->nb_queued_tasks > 0; });
+            if (this->stopping && this->nb_queued_tasks == 0)
+                return;
+            continue;
+        }
+        this->nb_queued_tasks--;
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (!this->task_exception)
+                this->task_exception = std::current_exception();
+        }
+        if (--this->nb_pending_tasks == 0){
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->tasks_done.notify_all();
+        }
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->tasks_available.notify_all();
+    for (auto& worker: this->workers)
+        worker.join();
+}
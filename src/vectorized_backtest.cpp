@@ -0,0 +1,155 @@
+#include "../headers/vectorized_backtest.hpp"
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+
+VectorizedBacktest::VectorizedBacktest(const std::vector<YahooTimeseries>& tickers_yt,
+                                       const std::map<std::string, double>& assets_desired_pct_allocations,
+                                       int rebalancing_freq,
+                                       double rebalancing_threshold)
+: market_data(::get_market_data(tickers_yt)), rebalancing_freq(rebalancing_freq), rebalancing_threshold(rebalancing_threshold){
+    this->allocations.assign(this->market_data.tickers.size(), 0.0);
+    for (const auto& pair: assets_desired_pct_allocations){
+        size_t ticker_idx = get_ticker_index(this->market_data, pair.first);
+        assert(ticker_idx < this->market_data.tickers.size() && "pct allocation ticker name not in the passed YahooTimeries tickers list\n");
+        this->allocations[ticker_idx] = pair.second;
+    }
+}
+
+const MarketData& VectorizedBacktest::get_market_data() const{
+    return this->market_data;
+}
+
+VectorizedBacktestResult VectorizedBacktest::run_dca(double starting_amount, double recurrent_investment_amount) const{
+    return this->run_dca(starting_amount, recurrent_investment_amount, RebalancingThreshold::ABSOLUTE);
+}
+
+VectorizedBacktestResult VectorizedBacktest::run_dca(double starting_amount, double recurrent_investment_amount, RebalancingThreshold rebalancing_mode) const{
+    std::vector<std::vector<double>> contributions(this->market_data.tickers.size());
+    for (size_t k = 0; k < contributions.size(); ++k){
+        contributions[k].assign(this->market_data.dates.size(), 0.0);
+        double amount = this->allocations[k] * recurrent_investment_amount;
+        double starting_ticker_amount = this->allocations[k] * starting_amount;
+        for (size_t d = 0; d < contributions[k].size(); ++d)
+            if (this->market_data.is_first_month_dates[k][d]){
+                contributions[k][d] = amount + starting_ticker_amount;
+                starting_ticker_amount = 0.0;
+            }
+    }
+    return this->run(contributions, rebalancing_mode);
+}
+
+VectorizedBacktestResult VectorizedBacktest::run_lump_sum(double initial_investment_amount) const{
+    return this->run_lump_sum(initial_investment_amount, RebalancingThreshold::RELATIVE);
+}
+
+VectorizedBacktestResult VectorizedBacktest::run_lump_sum(double initial_investment_amount, RebalancingThreshold rebalancing_mode) const{
+    std::vector<std::vector<double>> contributions(this->market_data.tickers.size());
+    for (size_t k = 0; k < contributions.size(); ++k){
+        contributions[k].assign(this->market_data.dates.size(), 0.0);
+        contributions[k][this->market_data.first_date_indices[k]] = this->allocations[k] * initial_investment_amount;
+    }
+    return this->run(contributions, rebalancing_mode);
+}
+
+VectorizedBacktestResult VectorizedBacktest::run(const std::vector<std::vector<double>>& contributions, RebalancingThreshold rebalancing_mode) const{
+    size_t nb_tickers = this->market_data.tickers.size();
+    size_t nb_dates = this->market_data.dates.size();
+    assert(nb_dates > 0 && "Error: the tickers have no dates\n");
+
+    VectorizedBacktestResult result;
+    result.dates = this->market_data.dates;
+    result.shares.assign(nb_tickers, std::vector<double>(nb_dates, 0.0));
+    result.expenses.assign(nb_tickers, std::vector<double>(nb_dates, 0.0));
+    result.values.assign(nb_dates, 0.0);
+    result.profits_and_losses.assign(nb_dates, 0.0);
+    result.cash_flows.assign(nb_dates, 0.0);
+
+    // Column kernels: bought shares, dividend growth factor and invested cash per ticker and date
+    std::vector<std::vector<double>> bought(nb_tickers, std::vector<double>(nb_dates, 0.0));
+    std::vector<std::vector<double>> growths(nb_tickers, std::vector<double>(nb_dates, 1.0));
+    std::vector<std::vector<double>> invested(nb_tickers, std::vector<double>(nb_dates, 0.0));
+    for (size_t k = 0; k < nb_tickers; ++k){
+        const std::vector<double>& closes = this->market_data.closes[k];
+        const std::vector<double>& dividends = this->market_data.dividends[k];
+        for (size_t d = 0; d < nb_dates; ++d){
+            bool is_bought = contributions[k][d] > 0 && closes[d] > 0;
+            bought[k][d] = is_bought ? contributions[k][d] / closes[d] : 0.0;
+            invested[k][d] = is_bought ? contributions[k][d] : 0.0;
+            growths[k][d] = (dividends[d] > 0) ? 1.0 + DIVIDEND_REINVESTMENT_RATIO * dividends[d] / closes[d] : 1.0;
+        }
+    }
+
+    // The rebalancing counter does not depend on the holdings: the rebalancing dates are known upfront
+    std::vector<size_t> segment_ends;
+    if (this->rebalancing_freq >= 0)
+        for (size_t d = this->rebalancing_freq; d < nb_dates; d += this->rebalancing_freq + 1)
+            segment_ends.push_back(d);
+    if (segment_ends.empty() || segment_ends.back() != nb_dates - 1)
+        segment_ends.push_back(nb_dates - 1);
+
+    std::vector<double> cumulative_growths(nb_dates);
+    std::vector<double> scaled_bought(nb_dates);
+    Rebalancer rebalancer(this->allocations, rebalancing_mode, this->rebalancing_threshold);
+    std::vector<double> end_shares(nb_tickers);
+    std::vector<double> end_prices(nb_tickers);
+    std::vector<double> initial_shares(nb_tickers, 0.0);
+    std::vector<double> initial_expenses(nb_tickers, 0.0);
+    size_t begin = 0;
+    for (size_t end: segment_ends){
+        for (size_t k = 0; k < nb_tickers; ++k){
+            // s_d = (s_d-1 + b_d) * g_d  <=>  s_d = G_d * (s_begin-1 + sum_i b_i / G_i-1)  with G the cumulative product of g
+            const std::vector<double>& closes = this->market_data.closes[k];
+            std::vector<double>& shares = result.shares[k];
+            std::vector<double>& expenses = result.expenses[k];
+            std::partial_sum(growths[k].begin() + begin, growths[k].begin() + end + 1, cumulative_growths.begin() + begin, std::multiplies<double>());
+            scaled_bought[begin] = bought[k][begin];
+            for (size_t d = begin + 1; d <= end; ++d)
+                scaled_bought[d] = bought[k][d] / cumulative_growths[d - 1];
+            std::partial_sum(scaled_bought.begin() + begin, scaled_bought.begin() + end + 1, shares.begin() + begin);
+            for (size_t d = begin; d <= end; ++d){
+                shares[d] = cumulative_growths[d] * (initial_shares[k] + shares[d]);
+                // Reinvested dividends are bought with the share count held after the date's contribution
+                double dividend_shares = shares[d] - shares[d] / growths[k][d];
+                expenses[d] = invested[k][d] + dividend_shares * closes[d];
+                result.cash_flows[d] -= expenses[d];
+            }
+            std::partial_sum(expenses.begin() + begin, expenses.begin() + end + 1, expenses.begin() + begin);
+            std::transform(expenses.begin() + begin, expenses.begin() + end + 1, expenses.begin() + begin,
+                           [&](double expense){ return expense + initial_expenses[k]; });
+        }
+
+        if (this->rebalancing_freq >= 0 && (end + 1) % (this->rebalancing_freq + 1) == 0){
+            for (size_t k = 0; k < nb_tickers; ++k){
+                end_shares[k] = result.shares[k][end];
+                end_prices[k] = this->market_data.closes[k][end];
+            }
+            if (rebalancer.compute_orders(end_shares.data(), end_prices.data()) > 0){
+                const std::vector<double>& orders = rebalancer.get_orders();
+                for (size_t k = 0; k < nb_tickers; ++k){
+                    double delta_expense = orders[k] * end_prices[k];
+                    result.shares[k][end] += orders[k];
+                    result.expenses[k][end] += delta_expense;
+                    result.cash_flows[end] -= delta_expense;
+                }
+            }
+        }
+
+        for (size_t k = 0; k < nb_tickers; ++k){
+            initial_shares[k] = result.shares[k][end];
+            initial_expenses[k] = result.expenses[k][end];
+        }
+        begin = end + 1;
+    }
+
+    for (size_t k = 0; k < nb_tickers; ++k)
+        for (size_t d = 0; d < nb_dates; ++d){
+            result.values[d] += result.shares[k][d] * this->market_data.closes[k][d];
+            result.profits_and_losses[d] -= result.expenses[k][d];
+        }
+    std::transform(result.values.begin(), result.values.end(), result.profits_and_losses.begin(), result.profits_and_losses.begin(), std::plus<double>());
+    return result;
+}
+
+VectorizedBacktest::~VectorizedBacktest(){}
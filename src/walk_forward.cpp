@@ -0,0 +1,148 @@
+#include "../headers/walk_forward.hpp"
+#include "../headers/thread_pool.hpp"
+#include "../headers/xirr_solver.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <fstream>
+
+WalkForwardOptimizer::WalkForwardOptimizer(const std::vector<YahooTimeseries>& tickers_yt,
+                                           StrategyFactory strategy_factory,
+                                           const std::vector<std::map<std::string, double>>& parameter_sets,
+                                           size_t in_sample_nb_days,
+                                           size_t out_of_sample_nb_days,
+                                           bool anchored)
+: tickers_yt(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt)), strategy_factory(strategy_factory), parameter_sets(parameter_sets),
+  in_sample_nb_days(in_sample_nb_days), out_of_sample_nb_days(out_of_sample_nb_days), anchored(anchored){
+    assert(!parameter_sets.empty() && "Error: at least one parameter set is needed\n");
+    assert(in_sample_nb_days > 1 && out_of_sample_nb_days > 0 && "Error: fold windows must not be empty\n");
+    this->dates = get_unique_dates(tickers_yt);
+    this->year_fractions = get_year_fractions(this->dates);
+}
+
+WalkForwardOptimizer::Ledger WalkForwardOptimizer::run_ledger(const std::map<std::string, double>& parameters) const{
+    Strategy* strat = this->strategy_factory(this->tickers_yt, parameters);
+    strat->run_strategy();
+    const PortfolioBuilder& ptf = strat->get_portfolio();
+    std::map<std::time_t, double> ptf_values = ptf.get_portfolio_values();
+    const std::map<std::time_t, double>& ptf_cash_flow = ptf.get_portfolio_historical_cash_flow();
+
+    Ledger ledger = {std::vector<double>(this->dates.size(), 0.0), std::vector<double>(this->dates.size(), 0.0)};
+    for (size_t i = 0; i < this->dates.size(); ++i){
+        auto value_it = ptf_values.find(this->dates[i]);
+        if (value_it != ptf_values.end())
+            ledger.values[i] = value_it->second;
+        else if (i > 0)
+            ledger.values[i] = ledger.values[i-1];
+        auto cash_flow_it = ptf_cash_flow.find(this->dates[i]);
+        if (cash_flow_it != ptf_cash_flow.end())
+            ledger.cash_flows[i] = cash_flow_it->second;
+    }
+    delete strat;
+    return ledger;
+}
+
+double WalkForwardOptimizer::get_window_xirr(const Ledger& ledger, size_t start_idx, size_t end_idx) const{
+    // The holdings at the window start are treated as the initial investment
+    std::vector<double> cash_flows = {-ledger.values[start_idx]};
+    std::vector<double> cash_flows_year_fractions = {this->year_fractions[start_idx]};
+    for (size_t i = start_idx + 1; i <= end_idx; ++i)
+        if (std::fabs(ledger.cash_flows[i]) > 1e-3){
+            cash_flows.push_back(ledger.cash_flows[i]);
+            cash_flows_year_fractions.push_back(this->year_fractions[i]);
+        }
+    cash_flows.push_back(ledger.values[end_idx]);
+    cash_flows_year_fractions.push_back(this->year_fractions[end_idx]);
+    for (auto& year_fraction: cash_flows_year_fractions)
+        year_fraction -= this->year_fractions[start_idx];
+
+    XirrSolver solver(1e-3, 1000);
+    return solver.solve(cash_flows, cash_flows_year_fractions);
+}
+
+const std::vector<WalkForwardFold>& WalkForwardOptimizer::run(size_t nb_threads){
+    ThreadPool pool(nb_threads);
+
+    this->ledgers.assign(this->parameter_sets.size(), Ledger());
+    pool.parallel_for(this->parameter_sets.size(), [this](size_t i){
+        this->ledgers[i] = this->run_ledger(this->parameter_sets[i]);
+    });
+
+    std::vector<size_t> in_sample_start_indices;
+    for (size_t in_sample_end_idx = this->in_sample_nb_days - 1; in_sample_end_idx + 1 < this->dates.size(); in_sample_end_idx += this->out_of_sample_nb_days)
+        in_sample_start_indices.push_back(this->anchored ? 0 : in_sample_end_idx + 1 - this->in_sample_nb_days);
+
+    this->folds.assign(in_sample_start_indices.size(), WalkForwardFold());
+    std::vector<size_t> chosen_parameter_indices(this->folds.size(), 0);
+    pool.parallel_for(this->folds.size(), [&](size_t k){
+        size_t in_sample_end_idx = this->in_sample_nb_days - 1 + k * this->out_of_sample_nb_days;
+        size_t out_of_sample_start_idx = in_sample_end_idx + 1;
+        size_t out_of_sample_end_idx = std::min(in_sample_end_idx + this->out_of_sample_nb_days, this->dates.size() - 1);
+
+        double best_xirr = -std::numeric_limits<double>::infinity();
+        for (size_t p = 0; p < this->parameter_sets.size(); ++p){
+            double xirr = this->get_window_xirr(this->ledgers[p], in_sample_start_indices[k], in_sample_end_idx);
+            if (std::isfinite(xirr) && xirr > best_xirr){
+                best_xirr = xirr;
+                chosen_parameter_indices[k] = p;
+            }
+        }
+        const Ledger& chosen_ledger = this->ledgers[chosen_parameter_indices[k]];
+        this->folds[k] = {this->dates[in_sample_start_indices[k]],
+                          this->dates[in_sample_end_idx],
+                          this->dates[out_of_sample_start_idx],
+                          this->dates[out_of_sample_end_idx],
+                          this->parameter_sets[chosen_parameter_indices[k]],
+                          best_xirr,
+                          this->get_window_xirr(chosen_ledger, in_sample_end_idx, out_of_sample_end_idx)};
+    });
+
+    // Time-weighted returns strip the external cash flows so the out of sample windows can be chained
+    this->out_of_sample_equity.clear();
+    double equity = 1.0;
+    for (size_t k = 0; k < this->folds.size(); ++k){
+        const Ledger& chosen_ledger = this->ledgers[chosen_parameter_indices[k]];
+        size_t in_sample_end_idx = this->in_sample_nb_days - 1 + k * this->out_of_sample_nb_days;
+        size_t out_of_sample_end_idx = std::min(in_sample_end_idx + this->out_of_sample_nb_days, this->dates.size() - 1);
+        for (size_t i = in_sample_end_idx + 1; i <= out_of_sample_end_idx; ++i){
+            if (chosen_ledger.values[i-1] > 0)
+                equity *= (chosen_ledger.values[i] + chosen_ledger.cash_flows[i]) / chosen_ledger.values[i-1];
+            this->out_of_sample_equity[this->dates[i]] = equity;
+        }
+    }
+    return this->folds;
+}
+
+const std::vector<WalkForwardFold>& WalkForwardOptimizer::get_folds() const{
+    return this->folds;
+}
+
+const std::map<std::time_t, double>& WalkForwardOptimizer::get_out_of_sample_equity() const{
+    return this->out_of_sample_equity;
+}
+
+void WalkForwardOptimizer::save_results(std::string filename) const{
+    std::ofstream folds_file("../strat_outputs/"+filename+"_folds.csv");
+    if (folds_file.is_open()){
+        folds_file << "InSampleStart;InSampleEnd;OutOfSampleStart;OutOfSampleEnd;Parameters;InSampleXIRR;OutOfSampleXIRR\n";
+        for (const auto& fold: this->folds){
+            folds_file << unix_timestamp_to_date_string(fold.in_sample_start) << ";" << unix_timestamp_to_date_string(fold.in_sample_end) << ";"
+                       << unix_timestamp_to_date_string(fold.out_of_sample_start) << ";" << unix_timestamp_to_date_string(fold.out_of_sample_end) << ";";
+            for (const auto& pair: fold.chosen_parameters)
+                folds_file << pair.first << "=" << pair.second << " ";
+            folds_file << ";" << fold.in_sample_xirr << ";" << fold.out_of_sample_xirr << "\n";
+        }
+        folds_file.close();
+    }
+
+    std::ofstream equity_file("../strat_outputs/"+filename+"_oos_equity.csv");
+    if (equity_file.is_open()){
+        equity_file << "Date;Equity\n";
+        for (const auto& pair: this->out_of_sample_equity)
+            equity_file << unix_timestamp_to_date_string(pair.first) << ";" << pair.second << "\n";
+        equity_file.close();
+    }
+}
+
+WalkForwardOptimizer::~WalkForwardOptimizer(){}
@@ -0,0 +1,216 @@
+#include "../headers/xirr_solver.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// The solvers work on x = log(1 + rate): NPV(x) = sum(cf_i * exp(-t_i * x)) is smooth on the whole real line
+// and every x maps to a valid rate in (-1, +inf), so no rate range has to be assumed.
+
+static double get_npv(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows, double log_rate){
+    double npv = 0.0;
+    for (size_t i = 0; i < nb_cash_flows; ++i)
+        npv += cash_flows[i] * std::exp(-year_fractions[i] * log_rate);
+    return npv;
+}
+
+std::vector<double> get_year_fractions(const std::vector<std::time_t>& dates){
+    std::vector<double> year_fractions(dates.size());
+    if (dates.empty())
+        return year_fractions;
+    std::time_t first_date = dates[0];
+    for (size_t i = 0; i < dates.size(); ++i)
+        year_fractions[i] = std::difftime(dates[i], first_date) / (60 * 60 * 24) / 365.0;
+    return year_fractions;
+}
+
+XirrSolver::XirrSolver(double tolerance, int max_iterations): tolerance(tolerance), max_iterations(max_iterations){
+    assert(tolerance > 0 && "Error: tolerance must be > 0\n");
+    assert(max_iterations > 0 && "Error: max_iterations must be > 0\n");
+}
+
+double XirrSolver::solve(const std::vector<double>& cash_flows, const std::vector<double>& year_fractions) const{
+    assert(cash_flows.size() == year_fractions.size() && "cash flows and year fractions must have the same length");
+    return this->solve(cash_flows.data(), year_fractions.data(), cash_flows.size());
+}
+
+double XirrSolver::solve(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows) const{
+    bool converged = false;
+    double log_rate = this->solve_newton(cash_flows, year_fractions, nb_cash_flows, 0.0, converged);
+    if (converged)
+        return std::expm1(log_rate);
+    return this->solve_brent(cash_flows, year_fractions, nb_cash_flows);
+}
+
+double XirrSolver::solve_newton(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows, double log_rate, bool& converged) const{
+    converged = false;
+    for (int it = 0; it < this->max_iterations; ++it){
+        double npv = 0.0;
+        double npv_derivative = 0.0;
+        for (size_t i = 0; i < nb_cash_flows; ++i){
+            double discounted_cash_flow = cash_flows[i] * std::exp(-year_fractions[i] * log_rate);
+            npv += discounted_cash_flow;
+            npv_derivative -= year_fractions[i] * discounted_cash_flow;
+        }
+        if (!std::isfinite(npv) || !std::isfinite(npv_derivative) || npv_derivative == 0.0)
+            return log_rate;
+        if (std::fabs(npv) < this->tolerance){
+            converged = true;
+            return log_rate;
+        }
+        // Damped step: a full Newton step far from the root can overflow the exponentials
+        double step = std::clamp(npv / npv_derivative, -1.0, 1.0);
+        log_rate -= step;
+        if (std::fabs(step) < 1e-12 * (1.0 + std::fabs(log_rate))){
+            converged = true;
+            return log_rate;
+        }
+    }
+    return log_rate;
+}
+
+double XirrSolver::solve_brent(const double* cash_flows, const double* year_fractions, size_t nb_cash_flows) const{
+    // Bracket a sign change starting from a 0% rate and widening on both sides
+    double a = 0.0;
+    double fa = get_npv(cash_flows, year_fractions, nb_cash_flows, a);
+    if (fa == 0.0)
+        return 0.0;
+    double b = 0.0;
+    double fb = fa;
+    for (double width = 0.125; width <= 64.0 && (fb > 0) == (fa > 0); width *= 2){
+        for (double candidate: {width, -width}){
+            double f_candidate = get_npv(cash_flows, year_fractions, nb_cash_flows, candidate);
+            if (std::isfinite(f_candidate) && (f_candidate > 0) != (fa > 0)){
+                b = candidate;
+                fb = f_candidate;
+                break;
+            }
+        }
+    }
+    if ((fb > 0) == (fa > 0))
+        return std::numeric_limits<double>::quiet_NaN();
+
+    double c = a, fc = fa, d = b - a, e = d;
+    for (int it = 0; it < this->max_iterations; ++it){
+        if ((fb > 0) == (fc > 0)){
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (std::fabs(fc) < std::fabs(fb)){
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+        double tol = 2.0 * std::numeric_limits<double>::epsilon() * std::fabs(b) + 1e-14;
+        double m = 0.5 * (c - b);
+        if (std::fabs(fb) < this->tolerance || std::fabs(m) <= tol)
+            return std::expm1(b);
+        if (std::fabs(e) >= tol && std::fabs(fa) > std::fabs(fb)){
+            double p, q, r;
+            double s = fb / fa;
+            if (a == c){
+                p = 2.0 * m * s;
+                q = 1.0 - s;
+            }
+            else {
+                q = fa / fc;
+                r = fb / fc;
+                p = s * (2.0 * m * q * (q - r) - (b - a) * (r - 1.0));
+                q = (q - 1.0) * (r - 1.0) * (s - 1.0);
+            }
+            if (p > 0)
+                q = -q;
+            else
+                p = -p;
+            if (2.0 * p < std::min(3.0 * m * q - std::fabs(tol * q), std::fabs(e * q))){
+                e = d;
+                d = p / q;
+            }
+            else {
+                d = m;
+                e = m;
+            }
+        }
+        else {
+            d = m;
+            e = m;
+        }
+        a = b;
+        fa = fb;
+        b += (std::fabs(d) > tol) ? d : (m > 0 ? tol : -tol);
+        fb = get_npv(cash_flows, year_fractions, nb_cash_flows, b);
+    }
+    return std::expm1(b);
+}
+
+std::vector<double> XirrSolver::solve_batch(const std::vector<double>& cash_flows, const std::vector<double>& year_fractions, size_t nb_streams) const{
+    size_t nb_cash_flows = year_fractions.size();
+    assert(cash_flows.size() == nb_streams * nb_cash_flows && "cash flows buffer must be nb_streams x nb_cash_flows");
+
+    // Transposed copy so that the inner loop runs over contiguous streams
+    std::vector<double> cash_flows_by_date(cash_flows.size());
+    for (size_t s = 0; s < nb_streams; ++s)
+        for (size_t i = 0; i < nb_cash_flows; ++i)
+            cash_flows_by_date[i * nb_streams + s] = cash_flows[s * nb_cash_flows + i];
+
+    // The streams still iterating are kept compacted at the front of active_streams, so finished ones cost nothing
+    std::vector<double> log_rates(nb_streams, 0.0);
+    std::vector<double> npvs(nb_streams);
+    std::vector<double> npv_derivatives(nb_streams);
+    std::vector<size_t> active_streams(nb_streams);
+    for (size_t s = 0; s < nb_streams; ++s)
+        active_streams[s] = s;
+    std::vector<char> converged(nb_streams, 0);
+    size_t nb_active = nb_streams;
+
+    for (int it = 0; it < this->max_iterations && nb_active > 0; ++it){
+        for (size_t j = 0; j < nb_active; ++j){
+            npvs[active_streams[j]] = 0.0;
+            npv_derivatives[active_streams[j]] = 0.0;
+        }
+        for (size_t i = 0; i < nb_cash_flows; ++i){
+            const double t = year_fractions[i];
+            const double* date_cash_flows = &cash_flows_by_date[i * nb_streams];
+            for (size_t j = 0; j < nb_active; ++j){
+                size_t s = active_streams[j];
+                double discounted_cash_flow = date_cash_flows[s] * std::exp(-t * log_rates[s]);
+                npvs[s] += discounted_cash_flow;
+                npv_derivatives[s] -= t * discounted_cash_flow;
+            }
+        }
+        size_t j = 0;
+        while (j < nb_active){
+            size_t s = active_streams[j];
+            bool is_done = false;
+            if (!std::isfinite(npvs[s]) || !std::isfinite(npv_derivatives[s]) || npv_derivatives[s] == 0.0)
+                is_done = true;
+            else if (std::fabs(npvs[s]) < this->tolerance){
+                converged[s] = 1;
+                is_done = true;
+            }
+            else {
+                double step = std::clamp(npvs[s] / npv_derivatives[s], -1.0, 1.0);
+                log_rates[s] -= step;
+                if (std::fabs(step) < 1e-12 * (1.0 + std::fabs(log_rates[s]))){
+                    converged[s] = 1;
+                    is_done = true;
+                }
+            }
+            if (is_done)
+                active_streams[j] = active_streams[--nb_active];
+            else
+                ++j;
+        }
+    }
+
+    std::vector<double> rates(nb_streams);
+    for (size_t s = 0; s < nb_streams; ++s){
+        if (converged[s])
+            rates[s] = std::expm1(log_rates[s]);
+        else
+            rates[s] = this->solve_brent(&cash_flows[s * nb_cash_flows], year_fractions.data(), nb_cash_flows);
+    }
+    return rates;
+}
+
+XirrSolver::~XirrSolver(){}
@@ -1,23 +1,37 @@
 #include "../headers/yahoo_utils.hpp"
+#include "../headers/data_pipeline.hpp"
 
 #include <curl/curl.h>
 #include <iostream>
+#include <stdexcept>
+#include <cstdio>
 
 YahooFinance::YahooFinance(const std::vector<std::string>& ticker_list, std::string start_date, std::string end_date, std::string freq)
 : ticker_list(ticker_list), start_date(start_date), end_date(end_date), freq(freq){}
 
 std::vector<YahooTimeseries> YahooFinance::get_tickers_ts_data() const{
+    // Concurrent downloads, each parsed as soon as it completes. The result matches ticker_list one to one: a ticker that
+    // could not be loaded throws instead of shifting the others
+    size_t nb_fetch_threads = std::max(std::min(this->ticker_list.size(), (size_t)8), (size_t)1);
+    DataPipeline pipeline(get_yahoo_fetcher(this->start_date, this->end_date, this->freq), nb_fetch_threads, 1, 1, 16);
+    std::vector<TickerData> tickers_data = pipeline.run(this->ticker_list);
     std::vector<YahooTimeseries> tickers_yt_data;
-    for (size_t i = 0; i < this->ticker_list.size(); ++i){
-        std::string ticker_str_data = get_ticker_str_data(this->ticker_list[i], this->start_date, this->end_date, this->freq);
-        YahooTimeseries ticker_yt_data = get_ticker_ts_data(ticker_str_data);
-        tickers_yt_data.emplace_back(ticker_yt_data);
+    std::string failed_tickers;
+    for (auto& ticker_data: tickers_data){
+        if (ticker_data.ticker_yt)
+            tickers_yt_data.emplace_back(std::move(*ticker_data.ticker_yt));
+        else
+            failed_tickers += (failed_tickers.empty() ? "" : ", ") + ticker_data.ticker;
+    }
+    if (!failed_tickers.empty()){
+        fprintf(stderr, "Error: can't load the data of %s\n", failed_tickers.c_str());
+        throw std::runtime_error("can't load the data of " + failed_tickers);
     }
     return tickers_yt_data;
 }
 
 void YahooFinance::print_tickers_ts_data(const std::vector<YahooTimeseries>& tickers_yt_data) const{
-    for (size_t i = 0; i < this->ticker_list.size(); ++i){
+    for (size_t i = 0; i < tickers_yt_data.size(); ++i){
         std::vector<time_t> dates = tickers_yt_data[i].get_dates();
         std::vector<std::string> tickers_dates =  unix_timestamps_to_date_strings(dates);
         std::cout << "TICKER:" << tickers_yt_data[i].get_ticker() << std::endl;
@@ -36,6 +36,14 @@ std::map<std::time_t, double> Timeseries::get_ts_values() const{
    return this->ts_values;
 }
 
+const std::vector<std::time_t>& Timeseries::get_dates() const{
+    return this->dates;
+}
+
+const std::vector<double>& Timeseries::get_values() const{
+    return this->values;
+}
+
 double Timeseries::get_ts_value(std::time_t date) const{
     double ts_value = 0.0;
     try {
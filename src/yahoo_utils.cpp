@@ -6,6 +6,7 @@
 #include <nlohmann/json.hpp>
 #include <vector>
 #include <random>
+#include <mutex>
 
 size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp){
     ((std::string*)userp)->append((char*)contents, size * nmemb);
@@ -58,8 +59,9 @@ std::vector<std::string> unix_timestamps_to_date_strings(std::vector<time_t> ts_
 }
 
 bool is_first_day_of_month(std::time_t date){
-    std::tm* time_info = std::localtime(&date);
-    return (time_info->tm_mday == 1);
+    std::tm time_info;
+    localtime_r(&date, &time_info);
+    return (time_info.tm_mday == 1);
 }
 
 std::vector<std::time_t> get_unique_dates(std::vector<YahooTimeseries> tickers_yt){
@@ -90,6 +92,9 @@ std::string get_ticker_str_data(std::string ticker, std::string start_date, std:
 
     std::cout << url << std::endl;
 
+    // curl_easy_init would otherwise initialize libcurl on first use, which is not thread-safe
+    static std::once_flag curl_init_flag;
+    std::call_once(curl_init_flag, []{ curl_global_init(CURL_GLOBAL_DEFAULT); });
     CURL* curl = curl_easy_init();
     std::string response_buffer;
     if (curl) {
@@ -118,25 +123,47 @@ YahooTimeseries get_ticker_ts_data(std::string ticker_str_data){
     nlohmann::json json_object = nlohmann::json::parse(ticker_str_data);
 
     // Accessing values
-    std::string ticker = json_object["chart"]["result"][0]["meta"]["symbol"];
-    std::vector<std::time_t> dates = json_object["chart"]["result"][0]["timestamp"];
-    std::vector<double> opens = json_object["chart"]["result"][0]["indicators"]["quote"][0]["open"];
-    std::vector<double> lows = json_object["chart"]["result"][0]["indicators"]["quote"][0]["low"];
-    std::vector<double> highs = json_object["chart"]["result"][0]["indicators"]["quote"][0]["high"];
-    std::vector<double> closes = json_object["chart"]["result"][0]["indicators"]["quote"][0]["close"];
-    std::vector<double> adjcloses = json_object["chart"]["result"][0]["indicators"]["adjclose"][0]["adjclose"];
-
-    YahooTimeseries yt = {ticker, dates, opens, lows, highs, closes, adjcloses};
+    nlohmann::json& result = json_object["chart"]["result"][0];
+    std::string ticker = result["meta"]["symbol"];
+    std::vector<std::time_t> dates = result["timestamp"];
+    std::vector<double> opens = result["indicators"]["quote"][0]["open"];
+    std::vector<double> lows = result["indicators"]["quote"][0]["low"];
+    std::vector<double> highs = result["indicators"]["quote"][0]["high"];
+    std::vector<double> closes = result["indicators"]["quote"][0]["close"];
+    std::vector<double> adjcloses = result["indicators"]["adjclose"][0]["adjclose"];
+
+    // The timeseries is built once, with its dividends
     std::map<std::time_t, double> dividend_map;
-    if (json_object["chart"]["result"][0].contains("events")){
-        const auto& dividends = json_object["chart"]["result"][0]["events"]["dividends"];
+    if (result.contains("events")){
+        const auto& dividends = result["events"]["dividends"];
         for (auto it = dividends.begin(); it != dividends.end(); ++it) {
             std::time_t date = std::stol(it.key());
             dividend_map[date] = it.value()["amount"];
         }
-        return yt = {ticker, dates, opens, lows, highs, closes, adjcloses, dividend_map};
     }
-    return yt;
+    return YahooTimeseries(ticker, dates, opens, lows, highs, closes, adjcloses, dividend_map);
+}
+
+std::string get_ticker_chart_json(const YahooTimeseries& ticker_yt){
+    nlohmann::json result;
+    result["meta"]["symbol"] = ticker_yt.get_ticker();
+    result["timestamp"] = ticker_yt.get_dates();
+    nlohmann::json quote;
+    quote["open"] = ticker_yt.get_opens().get_values();
+    quote["low"] = ticker_yt.get_lows().get_values();
+    quote["high"] = ticker_yt.get_highs().get_values();
+    quote["close"] = ticker_yt.get_closes().get_values();
+    nlohmann::json adjclose;
+    adjclose["adjclose"] = ticker_yt.get_adjcloses().get_values();
+    result["indicators"]["quote"] = nlohmann::json::array({quote});
+    result["indicators"]["adjclose"] = nlohmann::json::array({adjclose});
+    const std::vector<std::time_t>& dividend_dates = ticker_yt.get_dividends().get_dates();
+    const std::vector<double>& dividends = ticker_yt.get_dividends().get_values();
+    for (size_t i = 0; i < dividend_dates.size(); ++i)
+        result["events"]["dividends"][std::to_string(dividend_dates[i])] = {{"amount", dividends[i]}, {"date", dividend_dates[i]}};
+    nlohmann::json json_object;
+    json_object["chart"]["result"] = nlohmann::json::array({result});
+    return json_object.dump();
 }
 
 std::vector<double> get_exponential_moving_average(std::vector<double> prices, double alpha){
@@ -173,11 +200,15 @@ size_t get_date_index(std::time_t date, std::vector<std::time_t> dates){
 
 // Function to generate a random vector of std::time_t dates
 std::vector<std::time_t> generate_random_dates(size_t count, std::time_t start, std::time_t end) {
+    std::random_device rd;
+    return generate_random_dates(count, start, end, rd());
+}
+
+std::vector<std::time_t> generate_random_dates(size_t count, std::time_t start, std::time_t end, uint64_t seed) {
     std::vector<std::time_t> dates;
     dates.reserve(count);
 
-    std::random_device rd;
-    std::mt19937 generator(rd());
+    std::mt19937_64 generator(seed);
     std::uniform_int_distribution<std::time_t> distribution(start, end);
 
     for (size_t i = 0; i < count; ++i) {
@@ -190,16 +221,17 @@ std::vector<std::time_t> generate_random_dates(size_t count, std::time_t start,
 std::vector<std::time_t> extract_first_dates_of_each_month(const std::vector<std::time_t>& dates){
     std::vector<std::time_t> first_dates;
     first_dates.push_back(dates[0]);
-    std::tm* time_info = std::localtime(&dates[0]);
-    int current_year = time_info->tm_year;
-    int current_month = time_info->tm_mon;
+    std::tm time_info;
+    localtime_r(&dates[0], &time_info);
+    int current_year = time_info.tm_year;
+    int current_month = time_info.tm_mon;
     for (const auto& date : dates) {
-        time_info = std::localtime(&date);
+        localtime_r(&date, &time_info);
 
-        if (time_info->tm_year > current_year || time_info->tm_mon > current_month){
+        if (time_info.tm_year > current_year || time_info.tm_mon > current_month){
             first_dates.push_back(date);
-            current_year = time_info->tm_year;
-            current_month = time_info->tm_mon;
+            current_year = time_info.tm_year;
+            current_month = time_info.tm_mon;
         }
 
     }
@@ -210,17 +242,18 @@ std::vector<std::time_t> extract_last_dates_of_each_month(const std::vector<std:
     std::vector<std::time_t> copy_of_dates = dates;
     std::reverse(copy_of_dates.begin(), copy_of_dates.end());
     std::vector<std::time_t> last_dates;
-    std::tm* time_info = std::localtime(&copy_of_dates[0]);
+    std::tm time_info;
+    localtime_r(&copy_of_dates[0], &time_info);
     last_dates.push_back(copy_of_dates[0]);
-    int current_year = time_info->tm_year;
-    int current_month = time_info->tm_mon;
+    int current_year = time_info.tm_year;
+    int current_month = time_info.tm_mon;
     for (const auto& date : copy_of_dates) {
-        time_info = std::localtime(&date);
+        localtime_r(&date, &time_info);
 
-        if (time_info->tm_year < current_year || time_info->tm_mon < current_month){
+        if (time_info.tm_year < current_year || time_info.tm_mon < current_month){
             last_dates.push_back(date);
-            current_year = time_info->tm_year;
-            current_month = time_info->tm_mon;
+            current_year = time_info.tm_year;
+            current_month = time_info.tm_mon;
         }
 
     }
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+#include "../headers/adaptive_montecarlo.hpp"
+#include "../headers/strategy.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+static std::vector<YahooTimeseries> get_adaptive_tickers_yt(){
+    return {get_test_ticker_yt("TEST_TICKER", 300, [](int i){ return 100.0 * std::pow(1.0002, i) * (1.0 + 0.01 * std::sin(i)); })};
+}
+
+TEST(AdaptiveMonteCarlo, student_t_quantile){
+    EXPECT_NEAR(2.131449546, get_student_t_quantile(0.975, 15.0), 1e-4);
+    EXPECT_NEAR(2.570581836, get_student_t_quantile(0.975, 5.0), 1e-3);
+    EXPECT_NEAR(-1.753050356, get_student_t_quantile(0.05, 15.0), 1e-4);
+    EXPECT_NEAR(1.959963985, get_student_t_quantile(0.975, 1e9), 1e-8);
+}
+
+TEST(AdaptiveMonteCarlo, precision_met){
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    DCA dca(get_adaptive_tickers_yt(), 1000.0, 100.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    MonteCarloStoppingRule stopping_rule = {{{MonteCarloStatistic::MEDIAN_END_VALUE, 0.05}, {MonteCarloStatistic::PROBABILITY_OF_LOSS, 0.05}}, 0.95, 60, 0.0};
+    dca.set_montecarlo_stopping_rule(stopping_rule);
+    dca.run_montecarlo_simulations(4096);
+    MonteCarloConvergence convergence = dca.get_montecarlo_convergence();
+    std::vector<double> end_values = dca.get_montecarlo_end_values();
+
+    EXPECT_EQ(MonteCarloStopReason::PRECISION_MET, convergence.stop_reason);
+    EXPECT_LT(convergence.nb_paths, 4096);
+    EXPECT_EQ(0, convergence.nb_paths % 64); // batches of whole replicates of antithetic pairs
+    EXPECT_EQ(convergence.nb_paths / 64, convergence.nb_batches);
+    EXPECT_EQ(convergence.nb_paths, end_values.size());
+    EXPECT_EQ(convergence.nb_paths, dca.get_montecarlo_aggregator()->get_nb_paths());
+    ASSERT_EQ(2, convergence.half_widths.size());
+    EXPECT_LE(convergence.half_widths[0], 0.05);
+    EXPECT_LE(convergence.half_widths[1], 0.05);
+    EXPECT_EQ(dca.get_montecarlo_estimates().quantiles[2], convergence.estimates[0]);
+
+    // The paths of an adaptive run are the first paths of a fixed run
+    dca.set_montecarlo_stopping_rule({{}, 0.95, 0, 0.0});
+    dca.run_montecarlo_simulations(convergence.nb_paths);
+    EXPECT_EQ(end_values, dca.get_montecarlo_end_values());
+    EXPECT_EQ(1, dca.get_montecarlo_convergence().nb_batches);
+    std::remove("../strat_outputs/DCA_Test_MonteCarloSummary.csv");
+}
+
+TEST(AdaptiveMonteCarlo, budgets){
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    LumpSum lump_sum(get_adaptive_tickers_yt(), 1000.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "LumpSum_Test");
+    lump_sum.run_strategy();
+    lump_sum.set_montecarlo_config(5, 1, std::mktime(&tm_future), false);
+    lump_sum.set_montecarlo_stopping_rule({{{MonteCarloStatistic::P5_END_VALUE, 1e-9}}, 0.99, 64, 0.0});
+    lump_sum.run_montecarlo_simulations(150);
+    EXPECT_EQ(MonteCarloStopReason::PATH_BUDGET, lump_sum.get_montecarlo_convergence().stop_reason);
+    EXPECT_EQ(150, lump_sum.get_montecarlo_convergence().nb_paths);
+    EXPECT_EQ(3, lump_sum.get_montecarlo_convergence().nb_batches);
+    EXPECT_GT(lump_sum.get_montecarlo_convergence().half_widths[0], 1e-9);
+
+    lump_sum.set_montecarlo_stopping_rule({{{MonteCarloStatistic::P5_END_VALUE, 1e-9}}, 0.99, 64, 1e-9});
+    lump_sum.run_montecarlo_simulations(1000);
+    EXPECT_EQ(MonteCarloStopReason::TIME_BUDGET, lump_sum.get_montecarlo_convergence().stop_reason);
+    EXPECT_EQ(64, lump_sum.get_montecarlo_convergence().nb_paths);
+    std::remove("../strat_outputs/LumpSum_Test_MonteCarloSummary.csv");
+}
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+#include "../headers/bar_file.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+TEST(BarFile, write_read){
+    // 1200 rows in blocks of 512: two full chunks and a partial one
+    std::tm tm_start = {0, 30, 9, 2, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::string filename = "../strat_outputs/BarFile_Test.bin";
+    {
+        BarFileWriter writer(filename, {"TEST_TICKER", "TEST_TICKER2"}, 512);
+        for (size_t i = 0; i < 1200; ++i){
+            double closes[2] = {100.0 + i, (i % 3 == 0) ? std::numeric_limits<double>::quiet_NaN() : 50.0 - 0.01 * i};
+            double dividends[2] = {(i == 700) ? 1.5 : 0.0, 0.0};
+            writer.append(start + i * 60, closes, dividends);
+        }
+        EXPECT_TRUE(writer.close());
+    }
+
+    BarSource source(filename);
+    ASSERT_TRUE(source.is_open());
+    EXPECT_EQ(1200u, source.get_nb_bars());
+    EXPECT_EQ(512u, source.get_chunk_size());
+    EXPECT_EQ(3u, source.get_nb_chunks());
+    EXPECT_EQ(std::vector<std::string>({"TEST_TICKER", "TEST_TICKER2"}), source.get_tickers());
+
+    size_t nb_rows = 0;
+    source.stream([&](const BarChunk& chunk){
+        EXPECT_EQ(nb_rows, chunk.first_bar);
+        for (size_t r = 0; r < chunk.nb_bars; ++r){
+            size_t i = chunk.first_bar + r;
+            EXPECT_EQ(start + std::time_t(i * 60), chunk.times[r]);
+            EXPECT_EQ(100.0 + i, chunk.closes[0][r]);
+            if (i % 3 == 0)
+                EXPECT_TRUE(std::isnan(chunk.closes[1][r]));
+            else
+                EXPECT_EQ(50.0 - 0.01 * i, chunk.closes[1][r]);
+            EXPECT_EQ((i == 700) ? 1.5 : 0.0, chunk.dividends[0][r]);
+        }
+        nb_rows += chunk.nb_bars;
+    });
+    EXPECT_EQ(1200u, nb_rows);
+    EXPECT_EQ(176u, source.get_chunk(2).nb_bars);
+    std::remove(filename.c_str());
+}
+
+TEST(BarFile, yahoo_timeseries){
+    // Rows on the union calendar, NaN where a ticker has no quote
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates1 = {start, start + 86400, start + 3 * 86400};
+    std::vector<std::time_t> dates2 = {start + 86400, start + 2 * 86400};
+    std::vector<double> prices1 = {10.0, 11.0, 12.0}, prices2 = {20.0, 21.0};
+    std::vector<YahooTimeseries> tickers_yt = {YahooTimeseries("TEST_TICKER", dates1, prices1, prices1, prices1, prices1, prices1, {{start + 86400, 0.5}}),
+                                               YahooTimeseries("TEST_TICKER2", dates2, prices2, prices2, prices2, prices2, prices2)};
+    std::string filename = "../strat_outputs/BarFile_Test.bin";
+    ASSERT_TRUE(write_bar_file(filename, tickers_yt, 512));
+    BarSource source(filename);
+    ASSERT_EQ(4u, source.get_nb_bars());
+    BarChunk chunk = source.get_chunk(0);
+    EXPECT_EQ(start + 2 * 86400, chunk.times[2]);
+    EXPECT_TRUE(std::isnan(chunk.closes[0][2]));
+    EXPECT_TRUE(std::isnan(chunk.closes[1][0]));
+    EXPECT_EQ(21.0, chunk.closes[1][2]);
+    EXPECT_EQ(0.5, chunk.dividends[0][1]);
+    std::remove(filename.c_str());
+
+    BarSource missing_source(filename);
+    EXPECT_FALSE(missing_source.is_open());
+    EXPECT_EQ(0u, missing_source.get_nb_chunks());
+}
+
+static void write_test_bar_file(std::string filename, size_t nb_bars){
+    BarFileWriter writer(filename, {"TEST_TICKER"}, 512);
+    for (size_t i = 0; i < nb_bars; ++i){
+        double close = 100.0 + i;
+        writer.append(std::time_t(1577880000 + i * 60), &close, nullptr);
+    }
+    writer.close();
+}
+
+static void write_test_field(std::string filename, long offset, uint64_t value){
+    FILE* file = fopen(filename.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    fseek(file, offset, SEEK_SET);
+    fwrite(&value, sizeof(uint64_t), 1, file);
+    fclose(file);
+}
+
+TEST(BarFile, corrupted){
+    // The header sizes are checked against the file length before the tickers and blocks are read
+    std::string filename = "../strat_outputs/BarFile_Test.bin";
+    write_test_bar_file(filename, 1000);
+    {
+        BarSource source(filename);
+        ASSERT_TRUE(source.is_open());
+        EXPECT_EQ(2u, source.get_nb_chunks());
+    }
+    write_test_field(filename, 3 * sizeof(uint64_t), 8); // data offset inside the fixed fields
+    EXPECT_FALSE(BarSource(filename).is_open());
+
+    write_test_bar_file(filename, 1000);
+    write_test_field(filename, 4 * sizeof(uint64_t), uint64_t(1) << 60); // tickers past the header
+    EXPECT_FALSE(BarSource(filename).is_open());
+
+    write_test_bar_file(filename, 1000);
+    write_test_field(filename, 2 * sizeof(uint64_t), std::numeric_limits<uint64_t>::max()); // blocks past the end of the file
+    BarSource source(filename);
+    EXPECT_FALSE(source.is_open());
+    EXPECT_EQ(0u, source.get_nb_chunks());
+
+    write_test_bar_file(filename, 1000);
+    ASSERT_EQ(0, truncate(filename.c_str(), 4096 + 512 * 3 * sizeof(double))); // last block missing
+    EXPECT_FALSE(BarSource(filename).is_open());
+    std::remove(filename.c_str());
+}
+
+TEST(BarFile, consumer_exception){
+    // The prefetch thread is stopped when the consumer throws
+    std::string filename = "../strat_outputs/BarFile_Test.bin";
+    write_test_bar_file(filename, 3000);
+    BarSource source(filename);
+    size_t nb_chunks = 0;
+    EXPECT_THROW(source.stream([&](const BarChunk&){
+        if (++nb_chunks == 3)
+            throw std::runtime_error("consumer error");
+    }), std::runtime_error);
+    EXPECT_EQ(3u, nb_chunks);
+    nb_chunks = 0;
+    source.stream([&](const BarChunk&){ ++nb_chunks; });
+    EXPECT_EQ(6u, nb_chunks);
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "../headers/batch_engine.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <algorithm>
+
+static void expect_same_values(const Strategy& strat, const MarketData& market_data, const std::vector<double>& values, size_t nb_portfolios, size_t portfolio_idx){
+    std::map<std::time_t, double> expected_values = strat.get_strategy_values();
+    ASSERT_EQ(expected_values.size(), market_data.dates.size());
+    for (size_t d = 0; d < market_data.dates.size(); ++d){
+        double value = values[d * nb_portfolios + portfolio_idx];
+        ASSERT_NEAR(expected_values.at(market_data.dates[d]), value, 1e-6 * (1.0 + value));
+    }
+}
+
+TEST(BatchEngine, dca_sweep){
+    // Portfolios with different parameters on the same historical prices
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    MarketData market_data = get_market_data(tickers_yt);
+    std::vector<BatchPortfolio> portfolios = {{5000.0, 300.0, {0.7, 0.3}, 30, 0.01},
+                                              {1000.0, 500.0, {0.2, 0.8}, 5, 0.05},
+                                              {0.0, 100.0, {0.5, 0.5}, 60, 0.0}};
+    BatchEngine engine(portfolios, RebalancingThreshold::ABSOLUTE);
+    std::vector<double> values;
+    engine.run(market_data, BatchContribution::MONTHLY, values);
+    for (size_t p = 0; p < portfolios.size(); ++p){
+        const BatchPortfolio& portfolio = portfolios[p];
+        DCA dca(tickers_yt, portfolio.starting_amount, portfolio.recurrent_investment_amount,
+                {{"TEST_TICKER", portfolio.allocations[0]}, {"TEST_TICKER2", portfolio.allocations[1]}},
+                portfolio.rebalancing_freq, portfolio.rebalancing_threshold, "DCA_Test");
+        dca.run_strategy();
+        expect_same_values(dca, market_data, values, portfolios.size(), p);
+    }
+}
+
+TEST(BatchEngine, lump_sum){
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    MarketData market_data = get_market_data(tickers_yt);
+    BatchEngine engine({10000.0, 0.0, {0.6, 0.4}, 40, 0.05}, 2, RebalancingThreshold::RELATIVE);
+    std::vector<double> values;
+    engine.run(market_data, BatchContribution::LUMP_SUM, values);
+    LumpSum lump_sum(tickers_yt, 10000.0, {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}}, 40, 0.05, "LumpSum_Test");
+    lump_sum.run_strategy();
+    expect_same_values(lump_sum, market_data, values, 2, 0);
+    expect_same_values(lump_sum, market_data, values, 2, 1);
+}
+
+TEST(BatchEngine, price_paths){
+    // One path per portfolio in a [portfolio][date] buffer, as produced by a Monte Carlo simulation
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    std::vector<std::time_t> dates = tickers_yt[0].get_dates();
+    size_t nb_dates = dates.size();
+    size_t nb_paths = 3;
+    std::vector<double> paths(nb_paths * nb_dates);
+    for (size_t p = 0; p < nb_paths; ++p)
+        for (size_t d = 0; d < nb_dates; ++d)
+            paths[p * nb_dates + d] = 100.0 + (p + 1) * 10.0 * std::sin(d / (10.0 + p));
+
+    std::vector<std::time_t> first_month_dates = extract_first_dates_of_each_month(dates);
+    BatchEngine engine({5000.0, 300.0, {1.0}, 20, 0.0}, nb_paths, RebalancingThreshold::ABSOLUTE);
+    for (size_t d = 0; d < nb_dates; ++d){
+        const double* asset_prices[] = {&paths[d]};
+        char is_contribution_date = std::find(first_month_dates.begin(), first_month_dates.end(), dates[d]) != first_month_dates.end();
+        engine.step(asset_prices, nb_dates, nullptr, &is_contribution_date);
+    }
+
+    std::vector<double> end_values(nb_paths);
+    const double* end_prices[] = {&paths[nb_dates - 1]};
+    engine.get_portfolio_values(end_prices, nb_dates, end_values.data());
+    for (size_t p = 0; p < nb_paths; ++p){
+        std::vector<double> prices(paths.begin() + p * nb_dates, paths.begin() + (p + 1) * nb_dates);
+        DCA dca({YahooTimeseries("PATH", dates, prices, prices, prices, prices, prices)}, 5000.0, 300.0, {{"PATH", 1.0}}, 20, 0.0, "DCA_Test");
+        dca.run_strategy();
+        EXPECT_NEAR(dca.get_strategy_values().rbegin()->second, end_values[p], 1e-6 * end_values[p]);
+        // Rebalancing sales and purchases cancel out: only the contributions are invested
+        EXPECT_NEAR(5000.0 + 300.0 * first_month_dates.size(), engine.get_net_investments()[p], 1e-6);
+    }
+}
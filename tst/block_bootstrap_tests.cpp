@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "../headers/block_bootstrap.hpp"
+#include "../headers/static_strategy.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+static std::vector<YahooTimeseries> get_bootstrap_tickers_yt(){
+    return {get_test_ticker_yt("TICKER_A", 200, [](int i){ return 100.0 + 10.0 * std::sin(i / 7.0) + 0.2 * i; }),
+            get_test_ticker_yt("TICKER_B", 200, [](int i){ return 50.0 + 3.0 * std::cos(i / 11.0) + 0.05 * i; })};
+}
+
+TEST(BlockBootstrap, fixed_blocks){
+    BlockBootstrapSimulator simulator(get_bootstrap_tickers_yt(), BootstrapScheme::FIXED_BLOCKS, 10.0, 3);
+    size_t n = simulator.get_nb_historical_returns();
+    EXPECT_EQ(199, n);
+    std::vector<size_t> indices = simulator.get_resampled_indices(4, 95);
+    for (size_t s = 0; s < indices.size(); ++s){
+        EXPECT_LT(indices[s], n);
+        if (s % 10 != 0){
+            EXPECT_EQ((indices[s - 1] + 1) % n, indices[s]);
+        }
+    }
+}
+
+TEST(BlockBootstrap, stationary_blocks){
+    BlockBootstrapSimulator simulator(get_bootstrap_tickers_yt(), BootstrapScheme::STATIONARY_BLOCKS, 8.0, 3);
+    size_t n = simulator.get_nb_historical_returns();
+    std::vector<size_t> indices = simulator.get_resampled_indices(0, 100000);
+    size_t nb_breaks = 0;
+    for (size_t s = 1; s < indices.size(); ++s)
+        nb_breaks += indices[s] != (indices[s - 1] + 1) % n;
+    // Geometric block lengths of mean 8 (a new block may start at the next date by chance)
+    EXPECT_NEAR(8.0, double(indices.size()) / nb_breaks, 0.5);
+}
+
+TEST(BlockBootstrap, cross_sectional_returns){
+    // Every step of every asset replays the return of the same historical date
+    std::vector<YahooTimeseries> tickers_yt = get_bootstrap_tickers_yt();
+    BlockBootstrapSimulator simulator(tickers_yt, BootstrapScheme::STATIONARY_BLOCKS, 5.0, 9);
+    size_t nb_paths = 3, nb_steps = 60;
+    std::vector<std::vector<double>> paths = simulator.generate(2, nb_paths, nb_steps);
+    for (size_t p = 0; p < nb_paths; ++p){
+        std::vector<size_t> indices = simulator.get_resampled_indices(2 + p, nb_steps - 1);
+        for (size_t a = 0; a < 2; ++a){
+            std::vector<double> closes;
+            for (const auto& pair: tickers_yt[a].get_closes().get_ts_values())
+                closes.push_back(pair.second);
+            EXPECT_EQ(closes.back(), paths[a][p * nb_steps]);
+            for (size_t s = 1; s < nb_steps; ++s){
+                double historical_return = closes[indices[s - 1] + 1] / closes[indices[s - 1]] - 1.0;
+                double path_return = paths[a][p * nb_steps + s] / paths[a][p * nb_steps + s - 1] - 1.0;
+                EXPECT_NEAR(historical_return, path_return, 1e-12);
+            }
+        }
+    }
+    // A path does not depend on the chunk it is generated in
+    std::vector<std::vector<double>> path = simulator.generate(3, 1, nb_steps);
+    for (size_t s = 0; s < nb_steps; ++s)
+        EXPECT_EQ(paths[1][nb_steps + s], path[1][s]);
+}
+
+TEST(BlockBootstrap, batched_montecarlo){
+    std::vector<YahooTimeseries> tickers_yt = get_bootstrap_tickers_yt();
+    std::map<std::string, double> allocations = {{"TICKER_A", 0.6}, {"TICKER_B", 0.4}};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+
+    DCA dca(tickers_yt, 1000.0, 100.0, allocations, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    dca.set_montecarlo_model(MonteCarloModel::BLOCK_BOOTSTRAP);
+    dca.set_montecarlo_bootstrap(BootstrapScheme::FIXED_BLOCKS, 15.0);
+    dca.run_montecarlo_simulations(20);
+    CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, allocations, MonthlyContribution(1000.0, 100.0), NoDipBuy(), "CompiledDCA_Test");
+    compiled_dca.run_strategy();
+    compiled_dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    compiled_dca.set_montecarlo_model(MonteCarloModel::BLOCK_BOOTSTRAP);
+    compiled_dca.set_montecarlo_bootstrap(BootstrapScheme::FIXED_BLOCKS, 15.0);
+    compiled_dca.run_montecarlo_simulations(20);
+    std::remove("../strat_outputs/DCA_Test_MonteCarloSummary.csv");
+    std::remove("../strat_outputs/CompiledDCA_Test_MonteCarloSummary.csv");
+
+    const std::vector<double>& end_values = dca.get_montecarlo_end_values();
+    const std::vector<double>& expected_end_values = compiled_dca.get_montecarlo_end_values();
+    ASSERT_EQ(expected_end_values.size(), end_values.size());
+    for (size_t i = 0; i < end_values.size(); ++i)
+        EXPECT_NEAR(expected_end_values[i], end_values[i], 1e-6 * expected_end_values[i]);
+}
@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+#include "../headers/checkpoint.hpp"
+#include "../headers/parameter_sweep.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static bool is_file(const std::string& filename){
+    return std::ifstream(filename).good();
+}
+
+// Runs job in a child process killed as soon as it has written a checkpoint, true when the checkpoint is left
+static bool run_interrupted(const std::string& checkpoint_filename, const std::function<void()>& job){
+    std::remove(checkpoint_filename.c_str());
+    pid_t pid = fork();
+    if (pid == 0){
+        job();
+        _exit(0);
+    }
+    while (!is_file(checkpoint_filename) && waitpid(pid, nullptr, WNOHANG) == 0)
+        usleep(200);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+    std::remove((checkpoint_filename + ".tmp").c_str());
+    return is_file(checkpoint_filename);
+}
+
+TEST(Checkpoint, write_read){
+    std::string filename = "../strat_outputs/Checkpoint_Test.ckpt";
+    std::string payload("checkpoint\0payload", 18);
+    ASSERT_TRUE(write_checkpoint(filename, payload));
+    EXPECT_FALSE(is_file(filename + ".tmp"));
+    std::string read_payload;
+    ASSERT_TRUE(read_checkpoint(filename, read_payload));
+    EXPECT_EQ(payload, read_payload);
+
+    // A flipped byte is detected
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(30);
+    file.put('X');
+    file.close();
+    EXPECT_FALSE(read_checkpoint(filename, read_payload));
+    remove_checkpoint(filename);
+    EXPECT_FALSE(read_checkpoint(filename, read_payload));
+}
+
+TEST(Checkpoint, montecarlo_resume){
+    // A run killed after a checkpoint resumes with the paths, estimates and summary of an uninterrupted run
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(400);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    std::string checkpoint_filename = "../strat_outputs/DCA_Checkpoint_Test.ckpt";
+    DCA dca(tickers_yt, 1000.0, 100.0, allocations, 30, 0.01, "DCA_Checkpoint_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(3, 1, std::mktime(&tm_future), false);
+    dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    dca.set_montecarlo_variance_reduction(VarianceReduction::ANTITHETIC_VARIATES);
+    dca.run_montecarlo_simulations(640);
+    MonteCarloAggregator aggregator = *dca.get_montecarlo_aggregator();
+    MonteCarloSamples samples = dca.get_montecarlo_samples();
+    MonteCarloEstimates estimates = dca.get_montecarlo_estimates();
+
+    dca.set_montecarlo_checkpoint(checkpoint_filename, 0.0);
+    ASSERT_TRUE(run_interrupted(checkpoint_filename, [&]{ dca.run_montecarlo_simulations(640); }));
+    dca.run_montecarlo_simulations(640);
+    std::remove("../strat_outputs/DCA_Checkpoint_Test_MonteCarloSummary.csv");
+    EXPECT_FALSE(is_file(checkpoint_filename));
+
+    EXPECT_EQ(samples.end_values, dca.get_montecarlo_samples().end_values);
+    EXPECT_EQ(samples.net_investments, dca.get_montecarlo_samples().net_investments);
+    EXPECT_EQ(samples.replicates, dca.get_montecarlo_samples().replicates);
+    EXPECT_EQ(estimates.mean, dca.get_montecarlo_estimates().mean);
+    EXPECT_EQ(estimates.quantiles, dca.get_montecarlo_estimates().quantiles);
+    const MonteCarloAggregator& resumed_aggregator = *dca.get_montecarlo_aggregator();
+    ASSERT_EQ(640u, resumed_aggregator.get_nb_paths());
+    for (size_t d = 0; d < aggregator.get_dates().size(); d += 100){
+        EXPECT_EQ(aggregator.get_mean(d), resumed_aggregator.get_mean(d));
+        for (double q: {0.05, 0.5, 0.95})
+            EXPECT_EQ(aggregator.get_quantile(d, q), resumed_aggregator.get_quantile(d, q));
+    }
+}
+
+TEST(Checkpoint, sweep_resume){
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(400);
+    ParameterSweep sweep(tickers_yt, get_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05),
+                         {{"rebalancing_freq", 5, 60, 8, true}, {"rebalancing_threshold", 0.01, 0.2, 8, false}});
+    std::vector<std::map<std::string, double>> parameter_sets = sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1);
+    std::vector<SweepResult> results = sweep.run(parameter_sets, 1);
+
+    std::string checkpoint_filename = "../strat_outputs/Sweep_Checkpoint_Test.ckpt";
+    sweep.set_checkpoint(checkpoint_filename, 0.0);
+    ASSERT_TRUE(run_interrupted(checkpoint_filename, [&]{ sweep.run(parameter_sets, 1); }));
+    const std::vector<SweepResult>& resumed_results = sweep.run(parameter_sets, 1);
+    EXPECT_FALSE(is_file(checkpoint_filename));
+    ASSERT_EQ(results.size(), resumed_results.size());
+    for (size_t i = 0; i < results.size(); ++i){
+        EXPECT_EQ(results[i].parameters, resumed_results[i].parameters);
+        EXPECT_EQ(results[i].total_return, resumed_results[i].total_return);
+        EXPECT_EQ(results[i].xirr, resumed_results[i].xirr);
+        EXPECT_EQ(results[i].max_drawdown, resumed_results[i].max_drawdown);
+    }
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "../headers/csv_writer.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/yahoo_utils.hpp"
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <ctime>
+#include <cmath>
+#include <limits>
+#include <cstdio>
+
+static std::string get_file_content(std::string filename){
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(CsvWriter, ostream_format){
+    // Same text as ostream << on every kind of double, across many flushes of a small buffer
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<double> values = {0.0, -0.0, 1.0, -1.5, 0.1, 1.0 / 3.0, 123456.0, 1234567.0, 1e-5, 1.25e-4, -9.999995e5, 1e300, -2e-300,
+                                  5e-324, std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+    for (int i = 0; i < 2000; ++i)
+        values.push_back(std::pow(10.0, i % 25 - 12) * std::sin(i * 0.37));
+
+    std::ostringstream expected;
+    expected << "Date;A;B;C" << std::endl;
+    for (size_t i = 0; i + 3 <= values.size(); ++i)
+        expected << unix_timestamp_to_date_string(start + i * 86400) << ";" << values[i] << ";" << values[i + 1] << ";" << values[i + 2] << std::endl;
+
+    std::string filename = "../strat_outputs/CsvWriter_Test.csv";
+    for (bool is_background_writer: {false, true}){
+        CsvWriter writer(filename, 1024, is_background_writer);
+        ASSERT_TRUE(writer.is_open());
+        writer.write_line("Date;A;B;C");
+        for (size_t i = 0; i + 3 <= values.size(); ++i)
+            writer.write_row(start + i * 86400, &values[i], 3);
+        EXPECT_TRUE(writer.close());
+        EXPECT_EQ(expected.str(), get_file_content(filename));
+    }
+    std::remove(filename.c_str());
+
+    CsvWriter missing_writer("../strat_outputs/missing_folder/CsvWriter_Test.csv", 1024, false);
+    EXPECT_FALSE(missing_writer.is_open());
+    EXPECT_FALSE(missing_writer.close());
+}
+
+TEST(CsvWriter, save_portfolio){
+    // Rows of the former ostream implementation of save_portfolio
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices1, prices2;
+    std::map<std::time_t, double> dividends1;
+    for (int i = 0; i < 800; ++i){
+        if (i % 7 == 5 || i % 7 == 6)
+            continue;
+        dates.push_back(start + i * 86400);
+        prices1.push_back(100.0 + 15.0 * std::sin(i / 25.0) + 0.05 * i);
+        prices2.push_back(50.0 + 8.0 * std::cos(i / 40.0));
+        if (i % 90 == 45)
+            dividends1[dates.back()] = 1.5;
+    }
+    DCA dca({YahooTimeseries("TEST_TICKER", dates, prices1, prices1, prices1, prices1, prices1, dividends1),
+             YahooTimeseries("TEST_TICKER2", dates, prices2, prices2, prices2, prices2, prices2)},
+            5000.0, 300.0, {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}}, 20, 0.01, "CsvWriter_DCA_Test");
+    dca.run_strategy();
+
+    std::map<std::time_t, double> ptf_pls_ts_values = dca.get_portfolio().get_portfolio_profits_and_losses().get_ts_values();
+    std::ostringstream expected;
+    expected << "Date;Value;P&L;Investments" << std::endl;
+    double last_pls = 0.0;
+    for (const auto& pair: dca.get_portfolio().get_portfolio_values()){
+        if (ptf_pls_ts_values[pair.first] == 0)
+            expected << unix_timestamp_to_date_string(pair.first) << ";" << pair.second << ";" << last_pls << ";" << pair.second - last_pls << std::endl;
+        else
+            expected << unix_timestamp_to_date_string(pair.first) << ";" << pair.second << ";" << ptf_pls_ts_values[pair.first] << ";" << pair.second - ptf_pls_ts_values[pair.first] << std::endl;
+        last_pls = ptf_pls_ts_values[pair.first];
+    }
+
+    std::string filename = "../strat_outputs/CsvWriter_DCA_Test.csv";
+    for (bool is_background_writer: {false, true}){
+        dca.get_portfolio().save_portfolio("CsvWriter_DCA_Test", is_background_writer);
+        EXPECT_EQ(expected.str(), get_file_content(filename));
+    }
+    std::remove(filename.c_str());
+}
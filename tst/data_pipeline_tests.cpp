@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "../headers/data_pipeline.hpp"
+#include "../headers/yahoo_utils.hpp"
+
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <ctime>
+#include <cmath>
+#include <stdexcept>
+
+static std::vector<YahooTimeseries> get_test_tickers_yt(size_t nb_tickers, size_t nb_dates){
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<YahooTimeseries> tickers_yt;
+    for (size_t k = 0; k < nb_tickers; ++k){
+        std::vector<std::time_t> dates;
+        std::vector<double> opens, closes;
+        std::map<std::time_t, double> dividends;
+        for (size_t i = 0; i < nb_dates; ++i){
+            dates.push_back(start + i * 86400);
+            opens.push_back(100.0 + k + 10.0 * std::sin(i * 0.1 + k));
+            closes.push_back(100.0 + k + 10.0 * std::sin(i * 0.1 + k + 0.05) + 1.0 / 3.0);
+            if (k % 2 == 0 && i % 60 == 30)
+                dividends[dates.back()] = 0.37 + k * 0.01;
+        }
+        tickers_yt.emplace_back("TEST_TICKER" + std::to_string(k), dates, opens, opens, closes, closes, closes, dividends);
+    }
+    return tickers_yt;
+}
+
+static void expect_same_ticker_yt(const YahooTimeseries& expected, const YahooTimeseries& ticker_yt){
+    EXPECT_EQ(expected.get_ticker(), ticker_yt.get_ticker());
+    EXPECT_EQ(expected.get_dates(), ticker_yt.get_dates());
+    EXPECT_EQ(expected.get_opens().get_values(), ticker_yt.get_opens().get_values());
+    EXPECT_EQ(expected.get_closes().get_values(), ticker_yt.get_closes().get_values());
+    EXPECT_EQ(expected.get_adjcloses().get_values(), ticker_yt.get_adjcloses().get_values());
+    EXPECT_EQ(expected.get_dividends().get_ts_values(), ticker_yt.get_dividends().get_ts_values());
+}
+
+TEST(DataPipeline, chart_json){
+    // The chart json of a timeseries is parsed back to the same values
+    for (const auto& ticker_yt: get_test_tickers_yt(2, 200))
+        expect_same_ticker_yt(ticker_yt, get_ticker_ts_data(get_ticker_chart_json(ticker_yt)));
+}
+
+TEST(DataPipeline, run){
+    std::vector<YahooTimeseries> tickers_yt = get_test_tickers_yt(40, 300);
+    std::map<std::string, std::string> chart_jsons;
+    std::vector<std::string> tickers;
+    for (const auto& ticker_yt: tickers_yt){
+        chart_jsons[ticker_yt.get_ticker()] = get_ticker_chart_json(ticker_yt);
+        tickers.push_back(ticker_yt.get_ticker());
+    }
+    tickers.insert(tickers.begin() + 7, "MISSING_TICKER"); // empty download
+
+    size_t queue_capacity = 3;
+    DataPipeline pipeline([&chart_jsons](const std::string& ticker){
+        auto it = chart_jsons.find(ticker);
+        return (it != chart_jsons.end()) ? it->second : std::string();
+    }, 4, 2, 2, queue_capacity);
+    pipeline.add_indicator("SMA20", [](const YahooTimeseries& ticker_yt){
+        return Timeseries(ticker_yt.get_closes().get_ts_simple_moving_averages(20));
+    });
+    std::mutex consumed_mutex;
+    std::multiset<size_t> consumed_indices;
+    pipeline.set_consumer([&](size_t ticker_idx, const TickerData& ticker_data){
+        EXPECT_EQ(1u, ticker_data.indicators.count("SMA20"));
+        std::lock_guard<std::mutex> lock(consumed_mutex);
+        consumed_indices.insert(ticker_idx);
+    });
+    std::vector<TickerData> tickers_data = pipeline.run(tickers);
+
+    ASSERT_EQ(tickers.size(), tickers_data.size());
+    for (size_t i = 0; i < tickers.size(); ++i){
+        EXPECT_EQ(tickers[i], tickers_data[i].ticker);
+        if (i == 7){
+            EXPECT_FALSE(tickers_data[i].ticker_yt.has_value());
+            EXPECT_TRUE(tickers_data[i].indicators.empty());
+            EXPECT_EQ(0u, consumed_indices.count(i));
+            continue;
+        }
+        const YahooTimeseries& expected = tickers_yt[i < 7 ? i : i - 1];
+        ASSERT_TRUE(tickers_data[i].ticker_yt.has_value());
+        expect_same_ticker_yt(expected, *tickers_data[i].ticker_yt);
+        EXPECT_EQ(expected.get_closes().get_ts_simple_moving_averages(20), tickers_data[i].indicators.at("SMA20").get_ts_values());
+        EXPECT_EQ(1u, consumed_indices.count(i));
+    }
+    const DataPipelineStats& stats = pipeline.get_stats();
+    EXPECT_EQ(tickers.size(), stats.nb_tickers);
+    EXPECT_EQ(1u, stats.nb_failed_tickers);
+    EXPECT_LE(stats.max_fetched_queue_size, queue_capacity);
+    EXPECT_LE(stats.max_parsed_queue_size, queue_capacity);
+
+    EXPECT_TRUE(pipeline.run({}).empty());
+}
+
+TEST(DataPipeline, stage_exception){
+    // A throwing fetcher or consumer stops every stage, including the parse stage blocked on a full queue, and run rethrows
+    std::vector<YahooTimeseries> tickers_yt = get_test_tickers_yt(1, 50);
+    std::string chart_json = get_ticker_chart_json(tickers_yt[0]);
+    std::vector<std::string> tickers(50, tickers_yt[0].get_ticker());
+    tickers[20] = "THROWING_TICKER";
+
+    DataPipeline fetch_pipeline([&chart_json](const std::string& ticker){
+        if (ticker == "THROWING_TICKER")
+            throw std::runtime_error("fetch error");
+        return chart_json;
+    }, 2, 1, 1, 1);
+    EXPECT_THROW(fetch_pipeline.run(tickers), std::runtime_error);
+
+    std::atomic<size_t> nb_consumed(0);
+    DataPipeline compute_pipeline([&chart_json](const std::string& ticker){ return chart_json; }, 2, 2, 1, 1);
+    compute_pipeline.set_consumer([&nb_consumed](size_t ticker_idx, const TickerData& ticker_data){
+        if (++nb_consumed == 3)
+            throw std::runtime_error("consumer error");
+    });
+    EXPECT_THROW(compute_pipeline.run(tickers), std::runtime_error);
+    EXPECT_EQ(3u, nb_consumed);
+
+    // The pipeline can run again after a failure
+    compute_pipeline.set_consumer([](size_t ticker_idx, const TickerData& ticker_data){});
+    EXPECT_EQ(tickers.size(), compute_pipeline.run(tickers).size());
+}
+
+TEST(DataPipeline, overlap_and_backpressure){
+    // 10 ms downloads and 10 ms of computation per ticker overlap; the fast parse stage does not get ahead of the
+    // consumer by more than the queues
+    std::vector<YahooTimeseries> tickers_yt = get_test_tickers_yt(1, 50);
+    std::string chart_json = get_ticker_chart_json(tickers_yt[0]);
+    std::vector<std::string> tickers(30, tickers_yt[0].get_ticker());
+    size_t queue_capacity = 2;
+    std::atomic<int> nb_in_flight(0);
+    std::atomic<int> max_in_flight(0);
+
+    DataPipeline pipeline([&](const std::string& ticker){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        int in_flight = ++nb_in_flight;
+        int max_value = max_in_flight;
+        while (in_flight > max_value && !max_in_flight.compare_exchange_weak(max_value, in_flight)){}
+        return chart_json;
+    }, 2, 1, 1, queue_capacity);
+    pipeline.set_consumer([&](size_t ticker_idx, const TickerData& ticker_data){
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        nb_in_flight--;
+    });
+    std::vector<TickerData> tickers_data = pipeline.run(tickers);
+
+    const DataPipelineStats& stats = pipeline.get_stats();
+    EXPECT_EQ(0u, stats.nb_failed_tickers);
+    EXPECT_EQ(0, nb_in_flight);
+    // Fetched, queued twice, parsed or computed: bounded whatever the number of tickers
+    EXPECT_LE(max_in_flight, (int)(2 * queue_capacity + 2 + 1 + 1));
+    EXPECT_LT(stats.elapsed_seconds, 0.8 * (stats.fetch_seconds + stats.parse_seconds + stats.compute_seconds));
+}
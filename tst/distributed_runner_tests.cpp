@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+#include "../headers/distributed_runner.hpp"
+#include "../headers/serialization.hpp"
+#include "../headers/parameter_sweep.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <cstdio>
+#include <cmath>
+#include <stdexcept>
+#include <unistd.h>
+
+TEST(LocalCluster, ordered_shards){
+    // Every item is run once, by the workers or by the coordinator when a worker is lost or throws
+    pid_t coordinator_pid = getpid();
+    LocalCluster cluster(3);
+    std::vector<std::string> shards = cluster.run(50, 8, [coordinator_pid](size_t first_item, size_t nb_items){
+        if (first_item == 16 && getpid() != coordinator_pid)
+            _exit(1);
+        if (first_item == 32 && getpid() != coordinator_pid)
+            throw std::runtime_error("worker error");
+        ByteWriter writer;
+        for (size_t i = first_item; i < first_item + nb_items; ++i)
+            writer.put<uint64_t>(i * i);
+        return writer.get_bytes();
+    });
+    ASSERT_EQ(7u, shards.size());
+    size_t i = 0;
+    for (const auto& shard: shards){
+        ByteReader reader(shard);
+        while (!reader.is_done()){
+            EXPECT_EQ(i * i, reader.get<uint64_t>());
+            ++i;
+        }
+    }
+    EXPECT_EQ(50u, i);
+    EXPECT_EQ(50u, cluster.get_throughput().nb_items);
+}
+
+TEST(LocalCluster, distributed_montecarlo){
+    // Shards of paths run by 3 workers give the paths and summary of the single process run
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(300);
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    DCA dca(tickers_yt, 1000.0, 100.0, {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}}, 30, 0.01, "DCA_Distributed_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(5, 1, std::mktime(&tm_future), false);
+    dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    dca.set_montecarlo_variance_reduction(VarianceReduction::CONTROL_VARIATE);
+    dca.run_montecarlo_simulations(100);
+    MonteCarloAggregator aggregator = *dca.get_montecarlo_aggregator();
+    std::vector<double> end_values = dca.get_montecarlo_end_values();
+    MonteCarloEstimates estimates = dca.get_montecarlo_estimates();
+
+    LocalCluster cluster(3);
+    dca.run_distributed_montecarlo_simulations(100, cluster, 32);
+    std::remove("../strat_outputs/DCA_Distributed_Test_MonteCarloSummary.csv");
+
+    const MonteCarloAggregator& distributed_aggregator = *dca.get_montecarlo_aggregator();
+    EXPECT_EQ(end_values, dca.get_montecarlo_end_values());
+    EXPECT_EQ(estimates.nb_replicates, dca.get_montecarlo_estimates().nb_replicates);
+    EXPECT_DOUBLE_EQ(estimates.mean, dca.get_montecarlo_estimates().mean);
+    EXPECT_DOUBLE_EQ(estimates.probability_of_loss, dca.get_montecarlo_estimates().probability_of_loss);
+    ASSERT_EQ(100u, distributed_aggregator.get_nb_paths());
+    size_t end_idx = aggregator.get_dates().size() - 1;
+    EXPECT_NEAR(aggregator.get_mean(end_idx), distributed_aggregator.get_mean(end_idx), 1e-9 * aggregator.get_mean(end_idx));
+    EXPECT_NEAR(aggregator.get_std(end_idx), distributed_aggregator.get_std(end_idx), 1e-9 * aggregator.get_std(end_idx));
+    for (double q: {0.05, 0.5, 0.95})
+        EXPECT_NEAR(aggregator.get_quantile(end_idx, q), distributed_aggregator.get_quantile(end_idx, q), 0.01 * aggregator.get_quantile(end_idx, q));
+}
+
+TEST(LocalCluster, distributed_sweep){
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(300);
+    ParameterSweep sweep(tickers_yt, get_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05),
+                         {{"rebalancing_freq", 10, 50, 5, true}, {"rebalancing_threshold", 0.01, 0.1, 4, false}});
+    std::vector<std::map<std::string, double>> parameter_sets = sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1);
+    std::vector<SweepResult> results = sweep.run(parameter_sets, 1);
+
+    LocalCluster cluster(2);
+    const std::vector<SweepResult>& distributed_results = sweep.run_distributed(parameter_sets, cluster, 3);
+    ASSERT_EQ(results.size(), distributed_results.size());
+    for (size_t i = 0; i < results.size(); ++i){
+        EXPECT_EQ(results[i].parameters, distributed_results[i].parameters);
+        EXPECT_EQ(results[i].total_return, distributed_results[i].total_return);
+        EXPECT_EQ(results[i].xirr, distributed_results[i].xirr);
+        EXPECT_EQ(results[i].max_drawdown, distributed_results[i].max_drawdown);
+    }
+    EXPECT_EQ(2u, sweep.get_throughput().nb_threads);
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "../headers/event_engine.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/market_data.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+static std::time_t get_event_start(){
+    std::tm tm_start = {0, 0, 12, 1, 0, 120}; // Jan 1, 2020
+    return std::mktime(&tm_start);
+}
+
+TEST(EventEngine, merge_order){
+    // Interleaved bars of two tickers and a dividend sharing a bar timestamp
+    std::time_t start = get_event_start();
+    std::vector<std::time_t> times1 = {start, start + 60, start + 180};
+    std::vector<double> closes1 = {10.0, 11.0, 12.0};
+    std::vector<std::time_t> times2 = {start + 60, start + 120};
+    std::vector<double> closes2 = {20.0, 21.0};
+    std::vector<std::time_t> dividend_times = {start + 60};
+    std::vector<double> dividends = {0.5};
+
+    EventEngine engine;
+    engine.add_ticker("TEST_TICKER", times1.data(), closes1.data(), times1.size());
+    engine.add_ticker("TEST_TICKER2", times2.data(), closes2.data(), times2.size());
+    engine.add_dividends(1, dividend_times.data(), dividends.data(), dividend_times.size());
+    std::vector<std::pair<size_t, std::time_t>> bars;
+    std::vector<double> dividend_closes;
+    engine.set_bar_handler([&](size_t ticker_idx, std::time_t time, double){ bars.push_back({ticker_idx, time}); });
+    engine.set_dividend_handler([&](size_t ticker_idx, std::time_t, double amount){
+        EXPECT_EQ(1u, ticker_idx);
+        EXPECT_EQ(0.5, amount);
+        dividend_closes.push_back(engine.get_last_closes()[ticker_idx]);
+    });
+    engine.run();
+
+    std::vector<std::pair<size_t, std::time_t>> expected_bars = {{0, start}, {0, start + 60}, {1, start + 60}, {1, start + 120}, {0, start + 180}};
+    EXPECT_EQ(expected_bars, bars);
+    EXPECT_EQ(std::vector<double>({20.0}), dividend_closes);
+    EXPECT_EQ(12.0, engine.get_last_closes()[0]);
+    EXPECT_EQ(21.0, engine.get_last_closes()[1]);
+    EXPECT_EQ(6u, engine.get_throughput().nb_events);
+
+    // A second run starts over
+    bars.clear();
+    engine.run();
+    EXPECT_EQ(expected_bars, bars);
+}
+
+TEST(EventEngine, schedules){
+    // Hourly bars from 8:00 to 16:00 on weekdays, January to March 2020
+    std::tm tm_start = {0, 0, 8, 1, 0, 120};
+    std::vector<std::time_t> times;
+    std::vector<double> closes;
+    for (int day = 0; day < 91; ++day){
+        for (int hour = 0; hour < 9; ++hour){
+            std::tm tm_bar = tm_start;
+            tm_bar.tm_mday += day;
+            tm_bar.tm_hour += hour;
+            tm_bar.tm_isdst = -1;
+            std::time_t time = std::mktime(&tm_bar);
+            std::tm time_info;
+            localtime_r(&time, &time_info);
+            if (time_info.tm_wday == 0 || time_info.tm_wday == 6)
+                continue;
+            times.push_back(time);
+            closes.push_back(100.0 + day + 0.1 * hour);
+        }
+    }
+    EventEngine engine;
+    engine.add_ticker("TEST_TICKER", times.data(), closes.data(), times.size());
+    std::vector<std::time_t> monthly, daily, six_hours;
+    size_t nb_ticks = 0;
+    engine.add_schedule({ScheduleCadence::MONTHS, 1}, 0, [&](std::time_t time){ monthly.push_back(time); });
+    engine.add_schedule({ScheduleCadence::DAYS, 1}, -1, [&](std::time_t time){ daily.push_back(time); });
+    engine.add_schedule({ScheduleCadence::SECONDS, 6 * 3600}, -1, [&](std::time_t time){ six_hours.push_back(time); });
+    engine.add_schedule({ScheduleCadence::TICKS, 9}, -1, [&](std::time_t){ ++nb_ticks; });
+    engine.run();
+
+    std::vector<std::time_t> trading_days;
+    std::vector<std::time_t> first_month_bars;
+    int last_day = -1, last_month = -1;
+    for (std::time_t time: times){
+        std::tm time_info;
+        localtime_r(&time, &time_info);
+        if (time_info.tm_yday != last_day)
+            trading_days.push_back(time);
+        if (time_info.tm_mon != last_month)
+            first_month_bars.push_back(time);
+        last_day = time_info.tm_yday;
+        last_month = time_info.tm_mon;
+    }
+    EXPECT_EQ(first_month_bars, monthly);
+    EXPECT_EQ(trading_days, daily);
+    EXPECT_EQ(times.size() / 9, nb_ticks);
+    // 8:00 and 14:00 on each trading day, the overnight boundaries falling on the next opening bar
+    EXPECT_EQ(2 * trading_days.size(), six_hours.size());
+    EXPECT_EQ(times.size() + monthly.size() + daily.size() + six_hours.size() + nb_ticks, engine.get_throughput().nb_events);
+}
+
+TEST(EventEngine, dca_daily){
+    // On daily bars, the event-driven DCA reproduces DCA::run_strategy (contributions on each ticker's calendar,
+    // dividends reinvested, rebalancing every rebalancing_freq + 1 dates)
+    std::time_t start = get_event_start();
+    std::vector<std::time_t> dates1, dates2;
+    std::vector<double> prices1, prices2;
+    std::map<std::time_t, double> dividends1;
+    for (int i = 0; i < 600; ++i){
+        std::time_t date = start + i * 86400;
+        if (i % 7 != 5){
+            dates1.push_back(date);
+            prices1.push_back(100.0 + 15.0 * std::sin(i / 25.0) + 0.05 * i);
+            if (i % 90 == 45)
+                dividends1[date] = 1.5;
+        }
+        if (i >= 20 && i % 7 != 6){
+            dates2.push_back(date);
+            prices2.push_back(50.0 + 8.0 * std::cos(i / 40.0) + 0.02 * i);
+        }
+    }
+    std::vector<YahooTimeseries> tickers_yt = {YahooTimeseries("TEST_TICKER", dates1, prices1, prices1, prices1, prices1, prices1, dividends1),
+                                               YahooTimeseries("TEST_TICKER2", dates2, prices2, prices2, prices2, prices2, prices2)};
+    DCA dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 10, 0.01, "DCA_Test");
+    dca.run_strategy();
+
+    std::vector<std::time_t> dividend_dates;
+    std::vector<double> dividend_amounts;
+    for (const auto& pair: dividends1){
+        dividend_dates.push_back(pair.first);
+        dividend_amounts.push_back(pair.second);
+    }
+    EventEngine engine;
+    engine.add_ticker("TEST_TICKER", dates1.data(), prices1.data(), dates1.size());
+    engine.add_ticker("TEST_TICKER2", dates2.data(), prices2.data(), dates2.size());
+    engine.add_dividends(0, dividend_dates.data(), dividend_amounts.data(), dividend_dates.size());
+    EventDrivenDCA event_dca(engine, 5000.0, 300.0, {0.7, 0.3}, {ScheduleCadence::TICKS, 11}, RebalancingThreshold::ABSOLUTE, 0.01,
+                             {ScheduleCadence::TICKS, 1});
+    event_dca.run();
+
+    std::map<std::time_t, double> expected_values = dca.get_strategy_values();
+    ASSERT_EQ(expected_values.size(), event_dca.get_values().size());
+    for (size_t d = 0; d < event_dca.get_values().size(); ++d){
+        double value = event_dca.get_values()[d];
+        ASSERT_NEAR(expected_values.at(event_dca.get_value_dates()[d]), value, 1e-6 * (1.0 + value));
+    }
+    EXPECT_GT(event_dca.get_nb_rebalancings(), 0u);
+    std::time_t last_date = dates1.back();
+    EXPECT_NEAR(dca.get_portfolio().get_ticker_shares("TEST_TICKER", last_date), event_dca.get_shares()[0], 1e-9);
+    EXPECT_NEAR(dca.get_portfolio().get_ticker_shares("TEST_TICKER2", last_date), event_dca.get_shares()[1], 1e-9);
+}
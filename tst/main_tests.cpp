@@ -1,6 +1,6 @@
 #include "gtest/gtest.h"
 
-//g++ -g *.cpp ../src/yahoo_timeseries.cpp ../src/portfolio_builder.cpp ../src/yahoo_utils.cpp -o main -lgtest -lcurl
+//g++ -g *.cpp $(ls ../src/*.cpp | grep -v main.cpp) -o main -lgtest -lcurl -pthread
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,149 @@
+#include "gtest/gtest.h"
+#include "../headers/montecarlo_aggregator.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/philox.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+static double get_exact_quantile(std::vector<double> values, double q){
+    std::sort(values.begin(), values.end());
+    return values[size_t(q * (values.size() - 1))];
+}
+
+TEST(TDigest, quantiles){
+    Philox4x32 generator(1, 0);
+    std::vector<double> values(20000);
+    TDigest digest(100.0);
+    for (auto& value: values){
+        value = std::exp(generator.next_normal());
+        digest.add(value);
+    }
+    EXPECT_EQ(20000.0, digest.get_count());
+    EXPECT_LT(digest.get_centroids().size(), 200u);
+    for (double q: {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99})
+        EXPECT_NEAR(get_exact_quantile(values, q), digest.get_quantile(q), 0.02 * get_exact_quantile(values, q));
+    EXPECT_EQ(*std::min_element(values.begin(), values.end()), digest.get_quantile(0.0));
+    EXPECT_EQ(*std::max_element(values.begin(), values.end()), digest.get_quantile(1.0));
+    EXPECT_NEAR(0.5, digest.get_cdf(digest.get_quantile(0.5)), 1e-9);
+}
+
+TEST(TDigest, merge){
+    Philox4x32 generator(2, 0);
+    std::vector<double> values(10000);
+    std::vector<TDigest> digests(10, TDigest(100.0));
+    for (size_t i = 0; i < values.size(); ++i){
+        values[i] = generator.next_normal();
+        digests[i % digests.size()].add(values[i]);
+    }
+    TDigest merged(100.0);
+    for (const auto& digest: digests)
+        merged.merge(digest);
+    EXPECT_EQ(10000.0, merged.get_count());
+    for (double q: {0.05, 0.25, 0.5, 0.75, 0.95})
+        EXPECT_NEAR(get_exact_quantile(values, q), merged.get_quantile(q), 0.03);
+}
+
+TEST(RunningMoments, merge){
+    RunningMoments whole = {0.0, 0.0, 0.0}, first = {0.0, 0.0, 0.0}, second = {0.0, 0.0, 0.0};
+    for (int i = 0; i < 100; ++i){
+        double value = std::sin(i) * 10.0 + i;
+        whole.add(value);
+        (i < 37 ? first : second).add(value);
+    }
+    first.merge(second);
+    EXPECT_NEAR(whole.mean, first.mean, 1e-12);
+    EXPECT_NEAR(whole.get_std(), first.get_std(), 1e-12);
+}
+
+TEST(MonteCarloAggregator, thread_count_independent){
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    for (int i = 0; i < 300; ++i){
+        dates.push_back(start + i * 86400);
+        prices.push_back(100.0 + 10.0 * std::sin(i / 20.0) + 0.1 * i);
+    }
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    LumpSum lump_sum({YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices)}, 1000.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "LumpSum_Test");
+    lump_sum.run_strategy();
+
+    lump_sum.set_montecarlo_config(7, 1, std::mktime(&tm_future), false);
+    lump_sum.run_montecarlo_simulations(40);
+    MonteCarloAggregator serial_aggregator = *lump_sum.get_montecarlo_aggregator();
+    std::vector<double> serial_end_values = lump_sum.get_montecarlo_end_values();
+    lump_sum.set_montecarlo_config(7, 3, std::mktime(&tm_future), false);
+    lump_sum.run_montecarlo_simulations(40);
+    const MonteCarloAggregator& parallel_aggregator = *lump_sum.get_montecarlo_aggregator();
+    std::remove("../strat_outputs/LumpSum_Test_MonteCarloSummary.csv");
+
+    ASSERT_EQ(40u, parallel_aggregator.get_nb_paths());
+    EXPECT_EQ(serial_end_values, lump_sum.get_montecarlo_end_values());
+    size_t end_idx = parallel_aggregator.get_dates().size() - 1;
+    for (double q: {0.05, 0.5, 0.95})
+        EXPECT_EQ(serial_aggregator.get_quantile(end_idx, q), parallel_aggregator.get_quantile(end_idx, q));
+    EXPECT_EQ(serial_aggregator.get_mean(end_idx), parallel_aggregator.get_mean(end_idx));
+    EXPECT_NEAR(get_exact_quantile(serial_end_values, 0.5), parallel_aggregator.get_quantile(end_idx, 0.5), 0.05 * parallel_aggregator.get_quantile(end_idx, 0.5));
+
+    double nb_histogram_paths = 0.0;
+    for (const auto& bin: parallel_aggregator.get_end_value_histogram(10))
+        nb_histogram_paths += bin.nb_paths;
+    EXPECT_NEAR(40.0, nb_histogram_paths, 1e-9);
+}
+
+TEST(MonteCarloAggregator, write_read){
+    // The binary copy answers like the original, pending buffer included
+    std::vector<std::time_t> dates = {0, 86400, 2 * 86400};
+    MonteCarloAggregator aggregator(dates, 100.0);
+    Philox4x32 generator(3, 0);
+    for (int p = 0; p < 1234; ++p){
+        double values[3] = {100.0, 100.0 + generator.next_normal(), 100.0 + 2.0 * generator.next_normal()};
+        aggregator.add_path(values);
+    }
+    ByteWriter writer;
+    aggregator.write(writer);
+    MonteCarloAggregator copy({}, 100.0);
+    ByteReader reader(writer.get_bytes());
+    copy.read(reader);
+    EXPECT_TRUE(reader.is_done());
+
+    ASSERT_EQ(dates, copy.get_dates());
+    EXPECT_EQ(1234u, copy.get_nb_paths());
+    for (size_t d = 0; d < dates.size(); ++d){
+        EXPECT_EQ(aggregator.get_mean(d), copy.get_mean(d));
+        EXPECT_EQ(aggregator.get_std(d), copy.get_std(d));
+        for (double q: {0.05, 0.5, 0.95})
+            EXPECT_EQ(aggregator.get_quantile(d, q), copy.get_quantile(d, q));
+    }
+}
+
+TEST(MonteCarloAggregator, estimates){
+    // y = 3x + noise: the control variate mean keeps only the noise variance
+    Philox4x32 generator(4, 0);
+    size_t n = 1600;
+    std::vector<double> end_values(n), control_values(n);
+    std::vector<size_t> replicates(n);
+    for (size_t i = 0; i < n; ++i){
+        control_values[i] = 1.0 + generator.next_normal();
+        end_values[i] = 3.0 * control_values[i] + 0.01 * generator.next_normal();
+        replicates[i] = i % 16;
+    }
+    std::vector<double> net_investments(n, 3.0);
+    MonteCarloEstimates plain = get_montecarlo_estimates(end_values, replicates, 16, nullptr, 1.0, {0.5}, &net_investments);
+    MonteCarloEstimates controlled = get_montecarlo_estimates(end_values, replicates, 16, &control_values, 1.0, {0.5}, nullptr);
+    EXPECT_EQ(16, plain.nb_replicates);
+    EXPECT_NEAR(3.0, plain.mean, 4.0 * plain.mean_standard_error);
+    EXPECT_NEAR(3.0 / std::sqrt(double(n)), plain.mean_standard_error, 1.5 / std::sqrt(double(n)));
+    EXPECT_NEAR(3.0, controlled.mean, 4.0 * controlled.mean_standard_error);
+    EXPECT_LT(controlled.mean_standard_error, 0.02 / std::sqrt(double(n)));
+    std::vector<double> sorted_values = end_values;
+    std::sort(sorted_values.begin(), sorted_values.end());
+    EXPECT_NEAR(0.5 * (sorted_values[n / 2 - 1] + sorted_values[n / 2]), plain.quantiles[0], 1e-12);
+    EXPECT_GT(plain.quantile_standard_errors[0], 0.0);
+    EXPECT_NEAR(0.5, plain.probability_of_loss, 4.0 * plain.probability_of_loss_standard_error);
+    EXPECT_NEAR(0.5 / std::sqrt(double(n)), plain.probability_of_loss_standard_error, 0.3 / std::sqrt(double(n)));
+    EXPECT_TRUE(std::isnan(controlled.probability_of_loss));
+}
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "../headers/montecarlo_context.hpp"
+#include "../headers/path_generator.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+
+#include <vector>
+#include <string>
+#include <cstdio>
+
+TEST(MonteCarloPathContext, engine_reuse){
+    // A reused engine gives the values of a fresh one, and is only rebuilt when the chunk size changes
+    size_t nb_steps = 60;
+    MonteCarloPathContext context(1, 8, nb_steps);
+    PathGenerator path_generator(PathModel::GEOMETRIC_BROWNIAN_MOTION, 100.0, 0.0003, 0.01, 5);
+    BatchPortfolio portfolio = {1000.0, 100.0, {1.0}, 30, 0.01};
+    std::vector<std::vector<char>> is_contribution_dates(1, std::vector<char>(nb_steps, 0));
+    for (size_t s = 0; s < nb_steps; s += 20)
+        is_contribution_dates[0][s] = 1;
+
+    for (size_t first_path = 0; first_path < 24; first_path += 8){
+        path_generator.generate(first_path, 8, nb_steps, context.get_asset_paths()[0]);
+        BatchEngine& engine = context.get_engine(portfolio, 8, RebalancingThreshold::ABSOLUTE);
+        engine.run_paths(context.get_const_asset_paths(), nb_steps, is_contribution_dates, context.get_values());
+
+        std::vector<double> paths = path_generator.generate(first_path, 8, nb_steps);
+        std::vector<double> expected_values(8 * nb_steps);
+        BatchEngine fresh_engine(portfolio, 8, RebalancingThreshold::ABSOLUTE);
+        fresh_engine.run_paths({paths.data()}, nb_steps, is_contribution_dates, expected_values.data());
+        for (size_t i = 0; i < expected_values.size(); ++i)
+            EXPECT_DOUBLE_EQ(expected_values[i], context.get_values()[i]);
+    }
+    EXPECT_EQ(1, context.get_nb_engine_constructions());
+    context.get_engine(portfolio, 3, RebalancingThreshold::ABSOLUTE);
+    EXPECT_EQ(2, context.get_nb_engine_constructions());
+}
+
+TEST(MonteCarloPathContext, saved_paths_match_batched_paths){
+    // Saved paths run one DCA per path, which must keep the rebalancing frequency and threshold of the batched route
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices_a, prices_b;
+    double price_a = 100.0, price_b = 50.0;
+    Philox4x32 generator(11, 0);
+    for (int i = 0; i < 300; ++i){
+        dates.push_back(start + i * 86400);
+        prices_a.push_back(price_a);
+        prices_b.push_back(price_b);
+        price_a *= 1.0 + 0.0005 + 0.02 * generator.next_normal();
+        price_b *= 1.0 + 0.0001 + 0.005 * generator.next_normal();
+    }
+    std::vector<YahooTimeseries> tickers_yt = {YahooTimeseries("TICKER_A", dates, prices_a, prices_a, prices_a, prices_a, prices_a),
+                                               YahooTimeseries("TICKER_B", dates, prices_b, prices_b, prices_b, prices_b, prices_b)};
+    std::map<std::string, double> allocations = {{"TICKER_A", 0.6}, {"TICKER_B", 0.4}};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    size_t nb_simu = 3;
+
+    DCA batched_dca(tickers_yt, 1000.0, 100.0, allocations, 30, 0.01, "DCA_Batched_Test");
+    batched_dca.run_strategy();
+    batched_dca.set_montecarlo_config(9, 2, std::mktime(&tm_future), false);
+    batched_dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    batched_dca.run_montecarlo_simulations(nb_simu);
+    DCA saved_dca(tickers_yt, 1000.0, 100.0, allocations, 30, 0.01, "DCA_Saved_Test");
+    saved_dca.run_strategy();
+    saved_dca.set_montecarlo_config(9, 2, std::mktime(&tm_future), true);
+    saved_dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    saved_dca.run_montecarlo_simulations(nb_simu);
+    std::remove("../strat_outputs/DCA_Batched_Test_MonteCarloSummary.csv");
+    std::remove("../strat_outputs/DCA_Saved_Test_MonteCarloSummary.csv");
+    for (size_t i = 1; i <= nb_simu; ++i)
+        std::remove(("../strat_outputs/DCA_Saved_Test_MonteCarloSimu_n" + std::to_string(i) + ".csv").c_str());
+
+    const std::vector<double>& end_values = saved_dca.get_montecarlo_end_values();
+    const std::vector<double>& expected_end_values = batched_dca.get_montecarlo_end_values();
+    ASSERT_EQ(expected_end_values.size(), end_values.size());
+    for (size_t i = 0; i < end_values.size(); ++i)
+        EXPECT_NEAR(expected_end_values[i], end_values[i], 1e-6 * expected_end_values[i]);
+}
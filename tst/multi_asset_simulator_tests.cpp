@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "../headers/multi_asset_simulator.hpp"
+#include "../headers/static_strategy.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+static std::vector<YahooTimeseries> get_correlated_tickers_yt(){
+    // Two tickers driven by a common factor, the third one independent
+    std::vector<double> prices_a, prices_b, prices_c;
+    double price_a = 100.0, price_b = 50.0, price_c = 20.0;
+    Philox4x32 generator(7, 0);
+    for (int i = 0; i < 500; ++i){
+        prices_a.push_back(price_a);
+        prices_b.push_back(price_b);
+        prices_c.push_back(price_c);
+        double market = generator.next_normal();
+        price_a *= 1.0 + 0.0005 + 0.01 * market;
+        price_b *= 1.0 + 0.0002 + 0.008 * market + 0.006 * generator.next_normal();
+        price_c *= 1.0 + 0.0001 + 0.015 * generator.next_normal();
+    }
+    return {get_test_ticker_yt("TICKER_A", 500, [&prices_a](int i){ return prices_a[i]; }),
+            get_test_ticker_yt("TICKER_B", 500, [&prices_b](int i){ return prices_b[i]; }),
+            get_test_ticker_yt("TICKER_C", 500, [&prices_c](int i){ return prices_c[i]; })};
+}
+
+TEST(MultiAssetSimulator, cholesky_factor){
+    MultiAssetSimulator simulator(get_correlated_tickers_yt(), PathModel::ARITHMETIC_RETURNS, 1);
+    const Eigen::MatrixXd& factor = simulator.get_cholesky_factor();
+    const Eigen::MatrixXd& covariance = simulator.get_covariance();
+    EXPECT_TRUE((factor * factor.transpose()).isApprox(covariance, 1e-9));
+    EXPECT_GT(covariance(0, 1) / std::sqrt(covariance(0, 0) * covariance(1, 1)), 0.6);
+    EXPECT_NEAR(0.0, covariance(0, 2) / std::sqrt(covariance(0, 0) * covariance(2, 2)), 0.15);
+}
+
+TEST(MultiAssetSimulator, generated_covariance){
+    // The returns of the generated paths have the estimated mean and covariance
+    MultiAssetSimulator simulator(get_correlated_tickers_yt(), PathModel::ARITHMETIC_RETURNS, 3);
+    size_t nb_paths = 200, nb_steps = 101;
+    std::vector<std::vector<double>> paths = simulator.generate(0, nb_paths, nb_steps);
+    Eigen::MatrixXd returns(nb_paths * (nb_steps - 1), 3);
+    for (size_t a = 0; a < 3; ++a){
+        for (size_t p = 0; p < nb_paths; ++p)
+            for (size_t s = 1; s < nb_steps; ++s)
+                returns(p * (nb_steps - 1) + s - 1, a) = paths[a][p * nb_steps + s] / paths[a][p * nb_steps + s - 1] - 1.0;
+    }
+    Eigen::RowVectorXd mean_returns = returns.colwise().mean();
+    Eigen::MatrixXd centered_returns = returns.rowwise() - mean_returns;
+    Eigen::MatrixXd covariance = (centered_returns.transpose() * centered_returns) / double(returns.rows() - 1);
+    for (size_t i = 0; i < 3; ++i){
+        EXPECT_NEAR(simulator.get_mean_returns()(i), mean_returns(i), 3e-4);
+        for (size_t j = 0; j < 3; ++j)
+            EXPECT_NEAR(simulator.get_covariance()(i, j), covariance(i, j), 0.05 * simulator.get_covariance()(i, i));
+    }
+}
+
+TEST(MultiAssetSimulator, batched_montecarlo){
+    // The batched multi-asset DCA paths match CompiledDCA run with one Strategy per correlated path
+    std::vector<YahooTimeseries> tickers_yt = get_correlated_tickers_yt();
+    std::map<std::string, double> allocations = {{"TICKER_A", 0.5}, {"TICKER_B", 0.3}, {"TICKER_C", 0.2}};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+
+    DCA dca(tickers_yt, 1000.0, 100.0, allocations, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    dca.run_montecarlo_simulations(20);
+    CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, allocations, MonthlyContribution(1000.0, 100.0), NoDipBuy(), "CompiledDCA_Test");
+    compiled_dca.run_strategy();
+    compiled_dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    compiled_dca.set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+    compiled_dca.run_montecarlo_simulations(20);
+    std::remove("../strat_outputs/DCA_Test_MonteCarloSummary.csv");
+    std::remove("../strat_outputs/CompiledDCA_Test_MonteCarloSummary.csv");
+
+    const std::vector<double>& end_values = dca.get_montecarlo_end_values();
+    const std::vector<double>& expected_end_values = compiled_dca.get_montecarlo_end_values();
+    ASSERT_EQ(expected_end_values.size(), end_values.size());
+    for (size_t i = 0; i < end_values.size(); ++i)
+        EXPECT_NEAR(expected_end_values[i], end_values[i], 1e-6 * expected_end_values[i]);
+}
@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include "../headers/parameter_sweep.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <set>
+#include <mutex>
+
+TEST(ParameterSweep, get_parameter_sets){
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(400);
+    ParameterSweep sweep(tickers_yt, get_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05),
+                         {{"rebalancing_freq", 10, 50, 5, true}, {"rebalancing_threshold", 0.01, 0.1, 4, false}});
+
+    std::vector<std::map<std::string, double>> cartesian_sets = sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1);
+    ASSERT_EQ(20, cartesian_sets.size());
+    EXPECT_DOUBLE_EQ(10, cartesian_sets.front().at("rebalancing_freq"));
+    EXPECT_DOUBLE_EQ(0.01, cartesian_sets.front().at("rebalancing_threshold"));
+    EXPECT_DOUBLE_EQ(50, cartesian_sets.back().at("rebalancing_freq"));
+    EXPECT_DOUBLE_EQ(0.1, cartesian_sets.back().at("rebalancing_threshold"));
+
+    // Each of the 8 strata of every parameter is drawn exactly once
+    std::vector<std::map<std::string, double>> lhs_sets = sweep.get_parameter_sets(SweepSampling::LATIN_HYPERCUBE, 8, 42);
+    ASSERT_EQ(8, lhs_sets.size());
+    std::vector<int> strata_counts(8, 0);
+    for (const auto& parameters: lhs_sets)
+        strata_counts[(int)((parameters.at("rebalancing_threshold") - 0.01) / (0.09 / 8))]++;
+    EXPECT_EQ(std::vector<int>(8, 1), strata_counts);
+
+    std::vector<std::map<std::string, double>> random_sets = sweep.get_parameter_sets(SweepSampling::RANDOM, 16, 42);
+    for (const auto& parameters: random_sets){
+        EXPECT_GE(parameters.at("rebalancing_freq"), 10);
+        EXPECT_LE(parameters.at("rebalancing_freq"), 50);
+        EXPECT_DOUBLE_EQ(std::round(parameters.at("rebalancing_freq")), parameters.at("rebalancing_freq"));
+    }
+}
+
+TEST(ParameterSweep, get_swept_allocations){
+    std::map<std::string, double> allocations = get_swept_allocations({{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, {{"weight:TEST_TICKER", 3.0}, {"rebalancing_freq", 20}});
+    EXPECT_DOUBLE_EQ(3.0 / 3.5, allocations.at("TEST_TICKER"));
+    EXPECT_DOUBLE_EQ(0.5 / 3.5, allocations.at("TEST_TICKER2"));
+
+    allocations = get_swept_allocations({{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, {{"weight:TEST_TICKER2", 0.0}});
+    std::map<std::string, double> expected = {{"TEST_TICKER", 1.0}, {"TEST_TICKER2", 0.0}};
+    EXPECT_EQ(expected, allocations);
+}
+
+TEST(ParameterSweep, zero_weights){
+    // Weights swept down to 0 keep their ticker in the allocations looked up by the strategies
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(400);
+    for (StrategyFactory factory: {get_sma_optimized_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05, 20),
+                                   get_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05),
+                                   get_lump_sum_factory(1000.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05)}){
+        ParameterSweep sweep(tickers_yt, factory, {{"weight:TEST_TICKER", 0.0, 1.0, 3, false}});
+        std::vector<SweepResult> results = sweep.run(sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1), 2);
+        ASSERT_EQ(3u, results.size());
+        for (const auto& result: results)
+            EXPECT_TRUE(std::isfinite(result.total_return));
+    }
+}
+
+TEST(ParameterSweep, run){
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(400);
+    ParameterSweep sweep(tickers_yt, get_sma_optimized_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05, 20),
+                         {{"sma_window_size", 10, 40, 3, true}, {"weight:TEST_TICKER", 0.2, 0.8, 2, false}});
+    std::vector<std::map<std::string, double>> parameter_sets = sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1);
+
+    std::vector<SweepResult> sequential_results = sweep.run(parameter_sets, 1);
+    std::vector<SweepResult> parallel_results = sweep.run(parameter_sets, 3);
+    ASSERT_EQ(parameter_sets.size(), parallel_results.size());
+    ASSERT_EQ(parameter_sets.size(), sweep.get_throughput().nb_backtests);
+    for (size_t i = 0; i < parameter_sets.size(); ++i){
+        EXPECT_EQ(parameter_sets[i], parallel_results[i].parameters);
+        EXPECT_DOUBLE_EQ(sequential_results[i].total_return, parallel_results[i].total_return);
+        EXPECT_DOUBLE_EQ(sequential_results[i].xirr, parallel_results[i].xirr);
+        EXPECT_DOUBLE_EQ(sequential_results[i].volatility, parallel_results[i].volatility);
+        EXPECT_DOUBLE_EQ(sequential_results[i].max_drawdown, parallel_results[i].max_drawdown);
+        EXPECT_GE(parallel_results[i].max_drawdown, 0.0);
+        EXPECT_LE(parallel_results[i].max_drawdown, 1.0);
+    }
+}
+
+TEST(ParameterSweep, shared_tickers){
+    // Every backtest is built on the one copy of the tickers held by the sweep
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(400);
+    StrategyFactory dca_factory = get_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05);
+    std::mutex mutex;
+    std::set<const std::vector<YahooTimeseries>*> shared_tickers;
+    StrategyFactory factory = [&](SharedTickers strategy_tickers_yt, const std::map<std::string, double>& parameters){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shared_tickers.insert(strategy_tickers_yt.get());
+        }
+        return dca_factory(strategy_tickers_yt, parameters);
+    };
+    ParameterSweep sweep(tickers_yt, factory, {{"rebalancing_freq", 10, 50, 5, true}});
+    sweep.run(sweep.get_parameter_sets(SweepSampling::CARTESIAN, 0, 1), 3);
+    ASSERT_EQ(1u, shared_tickers.size());
+    EXPECT_NE(&tickers_yt, *shared_tickers.begin());
+    EXPECT_EQ(tickers_yt.size(), (*shared_tickers.begin())->size());
+}
@@ -0,0 +1,129 @@
+#include "gtest/gtest.h"
+#include "../headers/path_generator.hpp"
+#include "../headers/static_strategy.hpp"
+
+#include <vector>
+#include <cstdio>
+#include <cmath>
+#include <map>
+
+TEST(PathGenerator, fill_normals){
+    // Same values, in the same order, as one next_normal call per value, whatever the cached Box-Muller state
+    Philox4x32 block_generator(3, 5), sequential_generator(3, 5);
+    block_generator.next_normal();
+    sequential_generator.next_normal();
+    std::vector<double> normals(1001);
+    fill_normals(block_generator, normals.data(), normals.size());
+    for (size_t i = 0; i < normals.size(); ++i)
+        ASSERT_EQ(sequential_generator.next_normal(), normals[i]);
+    EXPECT_EQ(sequential_generator.next_normal(), block_generator.next_normal());
+}
+
+TEST(PathGenerator, arithmetic_returns){
+    PathGenerator path_generator(PathModel::ARITHMETIC_RETURNS, 100.0, 0.0004, 0.01, 11);
+    size_t nb_steps = 50;
+    std::vector<double> paths = path_generator.generate(3, 2, nb_steps);
+    for (size_t p = 0; p < 2; ++p){
+        Philox4x32 generator(11, 3 + p);
+        double price = 100.0;
+        EXPECT_EQ(price, paths[p * nb_steps]);
+        for (size_t s = 1; s < nb_steps; ++s){
+            price *= 1.0 + 0.0004 + 0.01 * generator.next_normal();
+            EXPECT_NEAR(price, paths[p * nb_steps + s], 1e-9);
+        }
+    }
+}
+
+TEST(PathGenerator, geometric_brownian_motion){
+    double mean_return = 0.0003, volatility = 0.012;
+    size_t nb_paths = 4000, nb_steps = 253;
+    PathGenerator path_generator(PathModel::GEOMETRIC_BROWNIAN_MOTION, 50.0, mean_return, volatility, 1);
+    std::vector<double> paths = path_generator.generate(0, nb_paths, nb_steps);
+    double sum = 0.0, sum_squares = 0.0;
+    for (size_t p = 0; p < nb_paths; ++p){
+        EXPECT_EQ(50.0, paths[p * nb_steps]);
+        double log_return = std::log(paths[p * nb_steps + nb_steps - 1] / 50.0);
+        sum += log_return;
+        sum_squares += log_return * log_return;
+    }
+    double horizon = nb_steps - 1;
+    double mean = sum / nb_paths;
+    double variance = sum_squares / nb_paths - mean * mean;
+    EXPECT_NEAR((mean_return - 0.5 * volatility * volatility) * horizon, mean, 4.0 * volatility * std::sqrt(horizon / nb_paths));
+    EXPECT_NEAR(volatility * volatility * horizon, variance, 0.1 * volatility * volatility * horizon);
+}
+
+TEST(PathGenerator, batched_montecarlo){
+    // DCA simulates its Monte Carlo paths with the BatchEngine on generated buffers, CompiledDCA with one Strategy per path
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    for (int i = 0; i < 300; ++i){
+        dates.push_back(start + i * 86400);
+        prices.push_back(100.0 + 10.0 * std::sin(i / 20.0) + 0.1 * i);
+    }
+    std::vector<YahooTimeseries> tickers_yt = {YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices)};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+
+    DCA dca(tickers_yt, 1000.0, 100.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    dca.run_montecarlo_simulations(20);
+    CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, {{"TEST_TICKER", 1.0}}, MonthlyContribution(1000.0, 100.0), NoDipBuy(), "CompiledDCA_Test");
+    compiled_dca.run_strategy();
+    compiled_dca.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+    compiled_dca.run_montecarlo_simulations(20);
+    std::remove("../strat_outputs/DCA_Test_MonteCarloSummary.csv");
+    std::remove("../strat_outputs/CompiledDCA_Test_MonteCarloSummary.csv");
+
+    const std::vector<double>& end_values = dca.get_montecarlo_end_values();
+    const std::vector<double>& expected_end_values = compiled_dca.get_montecarlo_end_values();
+    ASSERT_EQ(expected_end_values.size(), end_values.size());
+    for (size_t i = 0; i < end_values.size(); ++i)
+        EXPECT_NEAR(expected_end_values[i], end_values[i], 1e-6 * expected_end_values[i]);
+}
+
+TEST(PathGenerator, antithetic_variates){
+    PathNormalSource normal_source(VarianceReduction::ANTITHETIC_VARIATES, 8, 2, 31);
+    std::vector<double> normals(62), antithetic_normals(62);
+    normal_source.fill(6, normals.data());
+    normal_source.fill(7, antithetic_normals.data());
+    for (size_t i = 0; i < normals.size(); ++i)
+        EXPECT_EQ(-normals[i], antithetic_normals[i]);
+    EXPECT_EQ(PathNormalSource::get_replicate(VarianceReduction::ANTITHETIC_VARIATES, 6), PathNormalSource::get_replicate(VarianceReduction::ANTITHETIC_VARIATES, 7));
+}
+
+TEST(PathGenerator, variance_reduction){
+    // On a lump sum the end value is the control itself, and is driven by the end point of the Brownian path
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    for (int i = 0; i < 300; ++i){
+        dates.push_back(start + i * 86400);
+        prices.push_back(100.0 * std::pow(1.0003, i) * (1.0 + 0.01 * std::sin(i)));
+    }
+    std::vector<YahooTimeseries> tickers_yt = {YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices)};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    LumpSum lump_sum(tickers_yt, 1000.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "LumpSum_Test");
+    lump_sum.run_strategy();
+    lump_sum.set_montecarlo_config(5, 2, std::mktime(&tm_future), false);
+
+    std::map<VarianceReduction, MonteCarloEstimates> estimates;
+    for (VarianceReduction variance_reduction: {VarianceReduction::NONE, VarianceReduction::ANTITHETIC_VARIATES, VarianceReduction::CONTROL_VARIATE, VarianceReduction::SOBOL_BROWNIAN_BRIDGE}){
+        lump_sum.set_montecarlo_variance_reduction(variance_reduction);
+        lump_sum.run_montecarlo_simulations(256);
+        estimates[variance_reduction] = lump_sum.get_montecarlo_estimates();
+    }
+    std::remove("../strat_outputs/LumpSum_Test_MonteCarloSummary.csv");
+
+    const MonteCarloEstimates& plain = estimates[VarianceReduction::NONE];
+    EXPECT_EQ(16, plain.nb_replicates);
+    EXPECT_LT(estimates[VarianceReduction::ANTITHETIC_VARIATES].mean_standard_error, plain.mean_standard_error);
+    EXPECT_LT(estimates[VarianceReduction::CONTROL_VARIATE].mean_standard_error, 1e-6 * plain.mean);
+    EXPECT_LT(estimates[VarianceReduction::SOBOL_BROWNIAN_BRIDGE].mean_standard_error, plain.mean_standard_error);
+    EXPECT_LT(estimates[VarianceReduction::SOBOL_BROWNIAN_BRIDGE].quantile_standard_errors[2], 0.5 * plain.quantile_standard_errors[2]);
+    for (const auto& pair: estimates)
+        EXPECT_NEAR(plain.mean, pair.second.mean, 4.0 * plain.mean_standard_error);
+}
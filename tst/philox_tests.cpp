@@ -0,0 +1,60 @@
+#include "gtest/gtest.h"
+#include "../headers/philox.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/thread_pool.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+TEST(Philox4x32, known_answers){
+    // Reference vectors of the Random123 distribution (kat_vectors, philox4x32 10 rounds)
+    Philox4x32::Counter expected_zero = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+    EXPECT_EQ(expected_zero, Philox4x32::get_block({0, 0, 0, 0}, {0, 0}));
+    Philox4x32::Counter expected_ones = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+    EXPECT_EQ(expected_ones, Philox4x32::get_block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}));
+    Philox4x32::Counter expected_pi = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+    EXPECT_EQ(expected_pi, Philox4x32::get_block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}));
+}
+
+TEST(Philox4x32, normal_moments){
+    Philox4x32 generator(42, 7);
+    size_t nb_draws = 200000;
+    double sum = 0.0, sum_squares = 0.0;
+    for (size_t i = 0; i < nb_draws; ++i){
+        double z = generator.next_normal();
+        sum += z;
+        sum_squares += z * z;
+    }
+    EXPECT_NEAR(0.0, sum / nb_draws, 0.01);
+    EXPECT_NEAR(1.0, sum_squares / nb_draws, 0.01);
+
+    Philox4x32 other_stream(42, 8);
+    Philox4x32 same_stream(42, 7);
+    EXPECT_NE(other_stream.next_uint32(), same_stream.next_uint32());
+}
+
+TEST(Philox4x32, montecarlo_paths_thread_independent){
+    // A path only depends on (seed, path index): drawing it alone or among others, on any thread, gives the same prices
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    for (int i = 0; i < 300; ++i){
+        dates.push_back(start + i * 86400);
+        prices.push_back(100.0 + 10.0 * std::sin(i / 20.0) + 0.1 * i);
+    }
+    DCA dca({YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices)}, 1000.0, 100.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+
+    size_t nb_paths = 16;
+    std::vector<std::map<std::time_t, double>> serial_paths(nb_paths), parallel_paths(nb_paths);
+    for (size_t i = 0; i < nb_paths; ++i)
+        serial_paths[i] = dca.montecarlo_simulation(dates, 100.0, 0.0005, 0.01, 42, i).get_closes().get_ts_values();
+    ThreadPool pool(4);
+    pool.parallel_for(nb_paths, [&](size_t i){
+        parallel_paths[nb_paths - 1 - i] = dca.montecarlo_simulation(dates, 100.0, 0.0005, 0.01, 42, nb_paths - 1 - i).get_closes().get_ts_values();
+    });
+    EXPECT_EQ(serial_paths, parallel_paths);
+    EXPECT_NE(serial_paths[0], serial_paths[1]);
+}
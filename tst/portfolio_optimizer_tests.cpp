@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "../headers/portfolio_optimizer.hpp"
+#include "../headers/strategy.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+static YahooTimeseries get_optimizer_ticker_yt(std::string ticker, const std::vector<double>& returns_pattern, double drift){
+    std::tm tm_start = {0, 0, 12, 1, 0, 120}; // Jan 1, 2020
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates = {start};
+    std::vector<double> prices = {100.0};
+    for (int i = 0; i < 400; ++i){
+        dates.push_back(start + (i + 1) * 86400);
+        prices.push_back(prices.back() * (1.0 + drift + returns_pattern[i % returns_pattern.size()]));
+    }
+    return YahooTimeseries(ticker, dates, prices, prices, prices, prices, prices);
+}
+
+TEST(PortfolioOptimizer, get_min_variance_allocations){
+    // Uncorrelated assets with equal variances: the minimum variance portfolio is equally weighted
+    std::vector<YahooTimeseries> tickers_yt = {get_optimizer_ticker_yt("TEST_TICKER", {0.01, 0.01, -0.01, -0.01}, 0.0),
+                                               get_optimizer_ticker_yt("TEST_TICKER2", {0.01, -0.01, 0.01, -0.01}, 0.0)};
+    PortfolioOptimizer optimizer(tickers_yt, 0.0);
+    EXPECT_NEAR(0.0, optimizer.get_covariance()(0, 1), 1e-12);
+
+    std::map<std::string, double> allocations = optimizer.get_min_variance_allocations();
+    EXPECT_NEAR(0.5, allocations.at("TEST_TICKER"), 1e-6);
+    EXPECT_NEAR(0.5, allocations.at("TEST_TICKER2"), 1e-6);
+
+    // With variances 1 and 4, the weights are 4/5 and 1/5
+    tickers_yt = {get_optimizer_ticker_yt("TEST_TICKER", {0.01, 0.01, -0.01, -0.01}, 0.0),
+                  get_optimizer_ticker_yt("TEST_TICKER2", {0.02, -0.02, 0.02, -0.02}, 0.0)};
+    allocations = PortfolioOptimizer(tickers_yt, 0.0).get_min_variance_allocations();
+    EXPECT_NEAR(0.8, allocations.at("TEST_TICKER"), 1e-6);
+    EXPECT_NEAR(0.2, allocations.at("TEST_TICKER2"), 1e-6);
+}
+
+TEST(PortfolioOptimizer, get_efficient_frontier){
+    std::vector<YahooTimeseries> tickers_yt = {get_optimizer_ticker_yt("TEST_TICKER", {0.01, 0.01, -0.01, -0.01}, 0.0002),
+                                               get_optimizer_ticker_yt("TEST_TICKER2", {0.02, -0.02, 0.02, -0.02}, 0.0008),
+                                               get_optimizer_ticker_yt("TEST_TICKER3", {0.015, -0.01, -0.015, 0.01}, 0.0005)};
+    PortfolioOptimizer optimizer(tickers_yt, 0.01);
+    std::vector<FrontierPoint> frontier = optimizer.get_efficient_frontier(12, 3);
+    ASSERT_EQ(12, frontier.size());
+    std::vector<FrontierPoint> sequential_frontier = optimizer.get_efficient_frontier(12, 1);
+    for (size_t i = 0; i < frontier.size(); ++i){
+        EXPECT_NEAR(sequential_frontier[i].expected_return, frontier[i].expected_return, 1e-8);
+        EXPECT_NEAR(sequential_frontier[i].volatility, frontier[i].volatility, 1e-6);
+    }
+
+    for (size_t i = 0; i < frontier.size(); ++i){
+        double sum = 0.0;
+        EXPECT_EQ(tickers_yt.size(), frontier[i].allocations.size());
+        for (const auto& pair: frontier[i].allocations){
+            EXPECT_GE(pair.second, 0.0);
+            sum += pair.second;
+        }
+        EXPECT_NEAR(1.0, sum, 1e-9);
+        if (i > 0){
+            EXPECT_GT(frontier[i].expected_return, frontier[i-1].expected_return);
+            EXPECT_GE(frontier[i].volatility + 1e-9, frontier[i-1].volatility);
+        }
+    }
+
+    // The tangency portfolio has the best Sharpe ratio of the frontier and plugs into the strategies
+    std::map<std::string, double> max_sharpe_allocations = optimizer.get_max_sharpe_allocations();
+    Eigen::VectorXd weights = Eigen::VectorXd::Zero(3);
+    for (size_t i = 0; i < tickers_yt.size(); ++i)
+        weights(i) = max_sharpe_allocations.at(tickers_yt[i].get_ticker());
+    double max_sharpe = (optimizer.get_expected_returns().dot(weights) - 0.01) / std::sqrt(weights.dot(optimizer.get_covariance() * weights));
+    for (const auto& point: frontier)
+        EXPECT_GE(max_sharpe + 1e-6, point.sharpe_ratio);
+
+    Strategy* strat = new DCA(tickers_yt, 1000.0, 100.0, max_sharpe_allocations, 30, 0.05, "DCA_MaxSharpe");
+    strat->run_strategy();
+    EXPECT_GT(strat->get_portfolio().get_portfolio_value(tickers_yt[0].get_dates().back()), 0.0);
+    delete strat;
+
+    // Frontier ends hold zero weights, still looked up by SmaOptimizedDCA
+    for (const auto& point: {frontier.front(), frontier.back()}){
+        SmaOptimizedDCA sma_dca(tickers_yt, 1000.0, 100.0, point.allocations, 30, 0.05, 10, "SmaDCA_Frontier");
+        sma_dca.run_strategy();
+        EXPECT_GT(sma_dca.get_portfolio().get_portfolio_value(tickers_yt[0].get_dates().back()), 0.0);
+    }
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+#include "../headers/quasi_random.hpp"
+#include "../headers/philox.hpp"
+
+#include <vector>
+#include <set>
+#include <cmath>
+
+TEST(QuasiRandom, sobol_first_points){
+    // Dimension 1 is the van der Corput sequence in Gray code order, dimension 2 starts 1/2, 1/4, 3/4
+    SobolSequence sobol_sequence(2);
+    std::vector<double> point(2);
+    sobol_sequence.get_point(1, nullptr, point.data());
+    EXPECT_NEAR(0.5, point[0], 1e-9);
+    EXPECT_NEAR(0.5, point[1], 1e-9);
+    sobol_sequence.get_point(2, nullptr, point.data());
+    EXPECT_NEAR(0.75, point[0], 1e-9);
+    EXPECT_NEAR(0.25, point[1], 1e-9);
+    sobol_sequence.get_point(3, nullptr, point.data());
+    EXPECT_NEAR(0.25, point[0], 1e-9);
+    EXPECT_NEAR(0.75, point[1], 1e-9);
+}
+
+TEST(QuasiRandom, sobol_stratification){
+    // Every block of 2^m points of a (scrambled) Sobol sequence has one point per 1D interval of length 2^-m,
+    // and the first two dimensions form a (0, m, 2)-net: one point per 2^-a x 2^-(m-a) box
+    size_t nb_dimensions = SobolSequence::MAX_DIMENSIONS;
+    SobolSequence sobol_sequence(nb_dimensions);
+    Philox4x32 generator(1, 0);
+    std::vector<uint32_t> digital_shifts(nb_dimensions);
+    for (auto& shift: digital_shifts)
+        shift = generator.next_uint32();
+    size_t nb_points = 64;
+    std::vector<std::vector<double>> points(nb_points, std::vector<double>(nb_dimensions));
+    for (size_t i = 0; i < nb_points; ++i)
+        sobol_sequence.get_point(64 + i, digital_shifts.data(), points[i].data());
+    for (size_t d = 0; d < nb_dimensions; ++d){
+        std::set<size_t> intervals;
+        for (const auto& point: points)
+            intervals.insert(size_t(point[d] * nb_points));
+        EXPECT_EQ(nb_points, intervals.size());
+    }
+    for (size_t a = 0; a <= 6; ++a){
+        std::set<std::pair<size_t, size_t>> boxes;
+        for (const auto& point: points)
+            boxes.insert({size_t(point[0] * (1 << a)), size_t(point[1] * (1 << (6 - a)))});
+        EXPECT_EQ(nb_points, boxes.size());
+    }
+}
+
+TEST(QuasiRandom, inverse_normal_cdf){
+    for (double p: {1e-12, 1e-6, 0.01, 0.02425, 0.1, 0.5, 0.7, 0.97575, 0.999, 1.0 - 1e-9}){
+        double x = get_inverse_normal_cdf(p);
+        EXPECT_NEAR(p, 0.5 * std::erfc(-x / std::sqrt(2.0)), 1e-13 * std::max(1.0, p / (1.0 - p)));
+    }
+    EXPECT_NEAR(0.0, get_inverse_normal_cdf(0.5), 1e-15);
+    EXPECT_NEAR(1.959963984540054, get_inverse_normal_cdf(0.975), 1e-12);
+}
+
+TEST(QuasiRandom, brownian_bridge){
+    // The first normal alone fixes the end point, and the increments are i.i.d. standard normals
+    size_t nb_increments = 13;
+    BrownianBridge brownian_bridge(nb_increments);
+    std::vector<double> normals(nb_increments), increments(nb_increments);
+    Philox4x32 generator(2, 0);
+    size_t nb_paths = 20000;
+    std::vector<double> sums(nb_increments, 0.0), sum_products(nb_increments * nb_increments, 0.0);
+    for (size_t p = 0; p < nb_paths; ++p){
+        for (auto& normal: normals)
+            normal = generator.next_normal();
+        brownian_bridge.build(normals.data(), increments.data(), 1);
+        double end_point = 0.0;
+        for (size_t k = 0; k < nb_increments; ++k){
+            end_point += increments[k];
+            sums[k] += increments[k];
+            for (size_t l = 0; l < nb_increments; ++l)
+                sum_products[k * nb_increments + l] += increments[k] * increments[l];
+        }
+        EXPECT_NEAR(std::sqrt(double(nb_increments)) * normals[0], end_point, 1e-12);
+    }
+    for (size_t k = 0; k < nb_increments; ++k){
+        EXPECT_NEAR(0.0, sums[k] / nb_paths, 0.03);
+        for (size_t l = 0; l < nb_increments; ++l)
+            EXPECT_NEAR(k == l ? 1.0 : 0.0, sum_products[k * nb_increments + l] / nb_paths, 0.05);
+    }
+}
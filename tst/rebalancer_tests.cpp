@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include "../headers/rebalancer.hpp"
+#include "../headers/batch_engine.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/yahoo_utils.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+static std::vector<YahooTimeseries> get_rebalancer_tickers_yt(){
+    return {get_test_ticker_yt("TEST_TICKER", 500, [](int i){ return 100.0 + 20.0 * std::sin(i / 30.0) + 0.05 * i; }),
+            get_test_ticker_yt("TEST_TICKER2", 500, [](int i){ return 50.0 + 10.0 * std::cos(i / 45.0); }),
+            get_test_ticker_yt("TEST_TICKER3", 500, [](int i){ return 20.0 + 0.03 * i; })};
+}
+
+TEST(Rebalancer, thresholds){
+    // Weights 0.55 / 0.30 / 0.15 against targets 0.5 / 0.3 / 0.2
+    std::vector<double> shares = {55.0, 30.0, 15.0};
+    std::vector<double> prices = {1.0, 1.0, 1.0};
+
+    Rebalancer absolute({0.5, 0.3, 0.2}, RebalancingThreshold::ABSOLUTE, 0.04);
+    EXPECT_EQ(2u, absolute.compute_orders(shares.data(), prices.data()));
+    EXPECT_NEAR(-5.0, absolute.get_orders()[0], 1e-12);
+    EXPECT_EQ(0.0, absolute.get_orders()[1]);
+    EXPECT_NEAR(5.0, absolute.get_orders()[2], 1e-12);
+    EXPECT_NEAR(0.05, absolute.get_drifts()[0], 1e-12);
+
+    // Relative drifts are 0.1 / 0 / -0.25
+    Rebalancer relative({0.5, 0.3, 0.2}, RebalancingThreshold::RELATIVE, 0.2);
+    EXPECT_EQ(1u, relative.compute_orders(shares.data(), prices.data()));
+    EXPECT_NEAR(5.0, relative.get_orders()[2], 1e-12);
+    relative.set_threshold(RebalancingThreshold::RELATIVE, 0.3);
+    EXPECT_EQ(0u, relative.compute_orders(shares.data(), prices.data()));
+
+    // One asset out of its band brings every held asset back to target
+    Rebalancer band({0.5, 0.3, 0.2}, RebalancingThreshold::BAND, 0.045);
+    std::vector<double> band_shares = {55.0, 29.0, 16.0};
+    EXPECT_EQ(3u, band.compute_orders(band_shares.data(), prices.data()));
+    EXPECT_NEAR(-5.0, band.get_orders()[0], 1e-12);
+    EXPECT_NEAR(1.0, band.get_orders()[1], 1e-12);
+    EXPECT_NEAR(4.0, band.get_orders()[2], 1e-12);
+    band.set_threshold(RebalancingThreshold::BAND, 0.06);
+    EXPECT_EQ(0u, band.compute_orders(band_shares.data(), prices.data()));
+}
+
+TEST(Rebalancer, unheld_assets){
+    // Assets not held are left to the contributions, an empty portfolio has no orders
+    Rebalancer rebalancer({0.5, 0.5}, RebalancingThreshold::BAND, 0.01);
+    std::vector<double> shares = {10.0, 0.0};
+    std::vector<double> prices = {2.0, 0.0};
+    EXPECT_EQ(1u, rebalancer.compute_orders(shares.data(), prices.data()));
+    EXPECT_NEAR(-5.0, rebalancer.get_orders()[0], 1e-12);
+    EXPECT_EQ(0.0, rebalancer.get_orders()[1]);
+    std::vector<double> no_shares = {0.0, 0.0};
+    EXPECT_EQ(0u, rebalancer.compute_orders(no_shares.data(), prices.data()));
+}
+
+TEST(Rebalancer, apply_orders){
+    std::vector<YahooTimeseries> tickers_yt = get_rebalancer_tickers_yt();
+    std::time_t first_date = tickers_yt[0].get_dates()[0];
+    std::time_t date = tickers_yt[0].get_dates()[10];
+    PortfolioBuilder ptf;
+    ptf.buy(tickers_yt[1], 10.0, first_date);
+    ptf.buy(tickers_yt[0], 5.0, first_date);
+
+    std::vector<int> asset_indices = ptf.get_asset_indices(tickers_yt);
+    EXPECT_EQ(std::vector<int>({1, 0, -1}), asset_indices);
+    std::vector<double> shares(3);
+    ptf.get_last_shares(asset_indices, shares.data());
+    EXPECT_EQ(std::vector<double>({5.0, 10.0, 0.0}), shares);
+
+    std::vector<double> orders = {-2.0, 3.0, 0.0};
+    std::vector<double> prices = {tickers_yt[0].get_closes().get_ts_value(date), tickers_yt[1].get_closes().get_ts_value(date), 0.0};
+    ptf.apply_orders(asset_indices, orders.data(), prices.data(), date);
+    EXPECT_DOUBLE_EQ(3.0, ptf.get_ticker_shares("TEST_TICKER", date));
+    EXPECT_DOUBLE_EQ(13.0, ptf.get_ticker_shares("TEST_TICKER2", date));
+    EXPECT_DOUBLE_EQ(16.0, ptf.get_portfolio_total_shares(date));
+    EXPECT_NEAR(2.0 * prices[0] - 3.0 * prices[1], ptf.get_portfolio_historical_cash_flow().at(date), 1e-9);
+}
+
+TEST(Rebalancer, dca_band){
+    // The per-path DCA and the batched engine agree on band rebalancing
+    std::vector<YahooTimeseries> tickers_yt = get_rebalancer_tickers_yt();
+    MarketData market_data = get_market_data(tickers_yt);
+    BatchPortfolio portfolio = {2000.0, 200.0, {0.5, 0.3, 0.2}, 20, 0.02};
+    BatchEngine engine(portfolio, 1, RebalancingThreshold::BAND);
+    std::vector<double> values;
+    engine.run(market_data, BatchContribution::MONTHLY, values);
+
+    DCA dca(tickers_yt, 2000.0, 200.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.3}, {"TEST_TICKER3", 0.2}}, 20, 0.02, "DCA_Test");
+    dca.set_rebalancing_mode(RebalancingThreshold::BAND);
+    dca.run_strategy();
+    std::map<std::time_t, double> expected_values = dca.get_strategy_values();
+    ASSERT_EQ(expected_values.size(), market_data.dates.size());
+    for (size_t d = 0; d < market_data.dates.size(); ++d)
+        ASSERT_NEAR(expected_values.at(market_data.dates[d]), values[d], 1e-6 * (1.0 + values[d]));
+
+    // Band rebalancing trades more often than the absolute threshold
+    DCA absolute_dca(tickers_yt, 2000.0, 200.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.3}, {"TEST_TICKER3", 0.2}}, 20, 0.02, "DCA_Test");
+    absolute_dca.run_strategy();
+    EXPECT_NE(absolute_dca.get_strategy_values().rbegin()->second, expected_values.rbegin()->second);
+}
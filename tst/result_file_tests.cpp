@@ -0,0 +1,159 @@
+#include "gtest/gtest.h"
+#include "../headers/result_file.hpp"
+#include "../headers/strategy.hpp"
+#include "../headers/montecarlo_runner.hpp"
+#include "../headers/philox.hpp"
+
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <ctime>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+static std::string get_file_content(std::string filename){
+    std::ifstream file(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static std::vector<double> get_test_columns(size_t nb_columns, size_t nb_rows, double offset){
+    std::vector<double> columns;
+    for (size_t c = 0; c < nb_columns; ++c)
+        for (size_t r = 0; r < nb_rows; ++r)
+            columns.push_back(offset + 1000.0 * c + std::sin(r * 0.1));
+    return columns;
+}
+
+TEST(ResultFile, write_read){
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    for (size_t r = 0; r < 301; ++r)
+        dates.push_back(start + r * 86400);
+    std::vector<double> first_columns = get_test_columns(2, dates.size(), 1.0);
+    std::vector<double> next_columns = get_test_columns(1, dates.size(), 7.0);
+    std::string filename = "../strat_outputs/ResultFile_Test.res";
+    {
+        ResultFileWriter writer(filename, dates, 0);
+        ASSERT_TRUE(writer.is_open());
+        writer.append_columns({"Value", "P&L"}, first_columns.data());
+        writer.append_columns({"Odd name with spaces"}, next_columns.data());
+        EXPECT_EQ(3u, writer.get_nb_columns());
+        EXPECT_TRUE(writer.close());
+    }
+    // An append cut by an interruption
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::app);
+        uint64_t record_header[3] = {0x31534E4D554C4F43, 4, 8};
+        file.write(reinterpret_cast<const char*>(record_header), sizeof(record_header));
+        file.write("Cut\0\0\0\0\0", 8);
+        file.write(reinterpret_cast<const char*>(first_columns.data()), 100 * sizeof(double));
+    }
+
+    {
+        ResultFile results(filename);
+        ASSERT_TRUE(results.is_open());
+        EXPECT_EQ(dates.size(), results.get_nb_rows());
+        EXPECT_EQ(std::vector<std::string>({"Value", "P&L", "Odd name with spaces"}), results.get_column_names());
+        EXPECT_EQ(dates, std::vector<std::time_t>(results.get_dates(), results.get_dates() + dates.size()));
+        for (size_t c = 0; c < 3; ++c){
+            const double* column = results.get_column(c);
+            EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(column) % sizeof(double));
+            const double* expected = (c < 2) ? &first_columns[c * dates.size()] : next_columns.data();
+            EXPECT_EQ(std::vector<double>(expected, expected + dates.size()), std::vector<double>(column, column + dates.size()));
+        }
+        EXPECT_EQ(1, results.get_column_index("P&L"));
+        EXPECT_EQ(-1, results.get_column_index("Cut"));
+    }
+
+    // A resumed run keeps the columns up to a record end and appends after them
+    {
+        ResultFileWriter writer(filename, dates, 2);
+        EXPECT_EQ(2u, writer.get_nb_columns());
+        writer.append_columns({"Resumed"}, next_columns.data());
+        EXPECT_TRUE(writer.close());
+        ResultFile results(filename);
+        EXPECT_EQ(std::vector<std::string>({"Value", "P&L", "Resumed"}), results.get_column_names());
+        EXPECT_EQ(first_columns[dates.size() + 5], results.get_column(1)[5]);
+        EXPECT_EQ(next_columns[5], results.get_column(2)[5]);
+    }
+    // Otherwise it starts over
+    {
+        ResultFileWriter writer(filename, dates, 1);
+        EXPECT_EQ(0u, writer.get_nb_columns());
+        EXPECT_TRUE(writer.close());
+        ResultFile results(filename);
+        EXPECT_TRUE(results.is_open());
+        EXPECT_EQ(0u, results.get_nb_columns());
+    }
+    std::remove(filename.c_str());
+
+    ResultFile missing_results(filename);
+    EXPECT_FALSE(missing_results.is_open());
+    EXPECT_FALSE(missing_results.export_csv("../strat_outputs/ResultFile_Test.csv"));
+}
+
+TEST(ResultFile, save_portfolio){
+    // The binary portfolio exported to csv is the csv output
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    for (int i = 0; i < 600; ++i){
+        dates.push_back(start + i * 86400);
+        prices.push_back(100.0 + 15.0 * std::sin(i / 25.0) + 0.05 * i);
+    }
+    DCA dca({YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices, {{dates[100], 1.5}})},
+            5000.0, 300.0, {{"TEST_TICKER", 1.0}}, 20, 0.01, "ResultFile_DCA_Test");
+    dca.run_strategy();
+    dca.save_end_portfolio();
+    dca.set_output_format(OutputFormat::BINARY);
+    dca.save_end_portfolio();
+
+    std::string filename = "../strat_outputs/ResultFile_DCA_Test";
+    ResultFile results(filename + ".res");
+    ASSERT_TRUE(results.is_open());
+    EXPECT_EQ(std::vector<std::string>({"Value", "P&L", "Investments"}), results.get_column_names());
+    EXPECT_EQ(dca.get_strategy_values().rbegin()->second, results.get_column(0)[results.get_nb_rows() - 1]);
+    ASSERT_TRUE(results.export_csv(filename + "_export.csv"));
+    EXPECT_EQ(get_file_content(filename + ".csv"), get_file_content(filename + "_export.csv"));
+    for (std::string extension: {".res", ".csv", "_export.csv"})
+        std::remove((filename + extension).c_str());
+}
+
+TEST(ResultFile, montecarlo_paths){
+    // Saved paths of a binary run: one value column per path, in path order
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    double price = 100.0;
+    Philox4x32 generator(5, 0);
+    for (int i = 0; i < 300; ++i){
+        dates.push_back(start + i * 86400);
+        prices.push_back(price);
+        price *= 1.0 + 0.0004 + 0.01 * generator.next_normal();
+    }
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    size_t nb_simu = 40;
+    DCA dca({YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices)}, 1000.0, 100.0, {{"TEST_TICKER", 1.0}}, 30, 0.01, "DCA_Binary_Test");
+    dca.run_strategy();
+    dca.set_montecarlo_config(3, 2, std::mktime(&tm_future), true);
+    dca.set_output_format(OutputFormat::BINARY);
+    dca.run_montecarlo_simulations(nb_simu);
+
+    std::string filename = "../strat_outputs/DCA_Binary_Test_MonteCarloPaths.res";
+    {
+        ResultFile paths(filename);
+        ASSERT_TRUE(paths.is_open());
+        ASSERT_EQ(nb_simu, paths.get_nb_columns());
+        EXPECT_EQ(dca.get_montecarlo_aggregator()->get_dates().size(), paths.get_nb_rows());
+        for (size_t i = 0; i < nb_simu; ++i){
+            EXPECT_EQ("DCA_Binary_Test_MonteCarloSimu_n" + std::to_string(i + 1), paths.get_column_names()[i]);
+            EXPECT_EQ(dca.get_montecarlo_end_values()[i], paths.get_column(i)[paths.get_nb_rows() - 1]);
+        }
+    }
+    std::remove(filename.c_str());
+    std::remove("../strat_outputs/DCA_Binary_Test_MonteCarloSummary.csv");
+}
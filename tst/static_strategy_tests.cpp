@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "../headers/static_strategy.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <cstdio>
+
+static void expect_same_portfolio_values(const Strategy& expected_strat, const Strategy& strat){
+    std::map<std::time_t, double> expected_values = expected_strat.get_strategy_values();
+    std::map<std::time_t, double> values = strat.get_strategy_values();
+    ASSERT_EQ(expected_values.size(), values.size());
+    for (const auto& pair: expected_values)
+        ASSERT_NEAR(pair.second, values.at(pair.first), 1e-6 * (1.0 + std::fabs(pair.second)));
+    EXPECT_NEAR(expected_strat.get_strategy_total_returns(), strat.get_strategy_total_returns(), 1e-9);
+}
+
+TEST(CompiledStrategy, dca){
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}};
+    DCA dca(tickers_yt, 5000.0, 300.0, allocations, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+    CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, allocations, MonthlyContribution(5000.0, 300.0), NoDipBuy(), "CompiledDCA_Test");
+    compiled_dca.run_strategy();
+    expect_same_portfolio_values(dca, compiled_dca);
+}
+
+TEST(CompiledStrategy, sma_optimized_dca){
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}};
+    SmaOptimizedDCA sma_dca(tickers_yt, 5000.0, 300.0, allocations, 20, 0.02, 15, "SmaOptimizedDCA_Test");
+    sma_dca.run_strategy();
+    CompiledSmaOptimizedDCA<20, std::ratio<2, 100>> compiled_sma_dca(tickers_yt, allocations, MonthlyContribution(5000.0, 300.0), SmaDipBuy<DefaultDipRatio>(15), "CompiledSmaOptimizedDCA_Test");
+    compiled_sma_dca.run_strategy();
+    expect_same_portfolio_values(sma_dca, compiled_sma_dca);
+}
+
+TEST(CompiledStrategy, lump_sum){
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}};
+    LumpSum lump_sum(tickers_yt, 10000.0, allocations, 40, 0.05, "LumpSum_Test");
+    lump_sum.run_strategy();
+    CompiledLumpSum<40, std::ratio<5, 100>> compiled_lump_sum(tickers_yt, allocations, InitialLumpSum(10000.0), NoDipBuy(), "CompiledLumpSum_Test");
+    compiled_lump_sum.run_strategy();
+    expect_same_portfolio_values(lump_sum, compiled_lump_sum);
+}
+
+TEST(CompiledStrategy, band_rebalancing){
+    // Same band rule as the Rebalancer of DCA: every held ticker is traded back to target once one leaves its band
+    // (three tickers, the band then differing from the absolute rule)
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    tickers_yt.push_back(get_test_ticker_yt("TEST_TICKER3", 600, [](int i){ return 20.0 + 0.03 * i; }));
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.3}, {"TEST_TICKER3", 0.2}};
+    DCA dca(tickers_yt, 5000.0, 300.0, allocations, 30, 0.03, "DCA_Band_Test");
+    dca.set_rebalancing_mode(RebalancingThreshold::BAND);
+    dca.run_strategy();
+    CompiledStrategy<MonthlyContribution, NoDipBuy, ReinvestDividends<DefaultDividendReinvestmentRatio>, PeriodicRebalancing<30, BandThreshold<std::ratio<3, 100>>>>
+        compiled_dca(tickers_yt, allocations, MonthlyContribution(5000.0, 300.0), NoDipBuy(), "CompiledDCA_Band_Test");
+    compiled_dca.run_strategy();
+    expect_same_portfolio_values(dca, compiled_dca);
+}
+
+TEST(CompiledStrategy, batched_montecarlo){
+    // The compiled DCA / LumpSum policies are simulated by the BatchEngine with the settings of DCA / LumpSum
+    std::vector<YahooTimeseries> tickers_yt = get_smooth_tickers_yt(300);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}};
+    std::tm tm_future = {0, 0, 12, 1, 0, 125};
+    LumpSum lump_sum(tickers_yt, 10000.0, allocations, 40, 0.05, "LumpSum_MonteCarlo_Test");
+    CompiledLumpSum<40, std::ratio<5, 100>> compiled_lump_sum(tickers_yt, allocations, InitialLumpSum(10000.0), NoDipBuy(), "CompiledLumpSum_MonteCarlo_Test");
+    for (Strategy* strat: std::vector<Strategy*>({&lump_sum, &compiled_lump_sum})){
+        strat->run_strategy();
+        strat->set_montecarlo_config(9, 2, std::mktime(&tm_future), false);
+        strat->set_montecarlo_model(MonteCarloModel::CORRELATED_ASSETS);
+        strat->run_montecarlo_simulations(16);
+    }
+    std::remove("../strat_outputs/LumpSum_MonteCarlo_Test_MonteCarloSummary.csv");
+    std::remove("../strat_outputs/CompiledLumpSum_MonteCarlo_Test_MonteCarloSummary.csv");
+    const std::vector<double>& expected_end_values = lump_sum.get_montecarlo_end_values();
+    const std::vector<double>& end_values = compiled_lump_sum.get_montecarlo_end_values();
+    ASSERT_EQ(16u, end_values.size());
+    for (size_t i = 0; i < end_values.size(); ++i)
+        EXPECT_NEAR(expected_end_values[i], end_values[i], 1e-9 * expected_end_values[i]);
+}
+
+TEST(CompiledStrategy, make_transactions){
+    // Driving the compiled strategy date by date through the virtual interface gives the same ledger
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}};
+    CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, allocations, MonthlyContribution(5000.0, 300.0), NoDipBuy(), "CompiledDCA_Test");
+    compiled_dca.run_strategy();
+    Strategy* strat = new CompiledDCA<30, std::ratio<1, 100>>(tickers_yt, allocations, MonthlyContribution(5000.0, 300.0), NoDipBuy(), "CompiledDCA_Test");
+    strat->Strategy::run_strategy();
+    expect_same_portfolio_values(compiled_dca, *strat);
+    delete strat;
+}
+
+TEST(CompiledStrategy, snapshot){
+    // run_strategy always replays the whole history: no snapshot is written nor loaded
+    std::string filename = "../strat_outputs/CompiledStrategySnapshot_Test.bin";
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(600);
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}};
+    CompiledDCA<30, std::ratio<1, 100>> compiled_dca(tickers_yt, allocations, MonthlyContribution(5000.0, 300.0), NoDipBuy(), "CompiledDCA_Test");
+    compiled_dca.run_strategy();
+    EXPECT_FALSE(compiled_dca.save_snapshot(filename));
+
+    DCA dca(tickers_yt, 5000.0, 300.0, allocations, 30, 0.01, "CompiledDCA_Test");
+    dca.run_strategy();
+    ASSERT_TRUE(dca.save_snapshot(filename));
+    EXPECT_FALSE(compiled_dca.load_snapshot(filename));
+    std::remove(filename.c_str());
+}
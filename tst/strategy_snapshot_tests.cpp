@@ -0,0 +1,124 @@
+#include "gtest/gtest.h"
+#include "../headers/strategy.hpp"
+#include "../headers/checkpoint.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <ctime>
+#include <cmath>
+#include <limits>
+
+typedef std::function<Strategy*(const std::vector<YahooTimeseries>&)> SnapshotStrategyFactory;
+
+// Two tickers on different calendars, with dividends, keeping the dates before end_date
+static std::vector<YahooTimeseries> get_snapshot_tickers_yt(std::time_t end_date){
+    int nb_days = 0;
+    while (nb_days < 1200 && get_test_start_date() + nb_days * 86400 < end_date)
+        ++nb_days;
+    return get_gapped_tickers_yt(nb_days);
+}
+
+static std::time_t get_local_date(int year, int month, int day){
+    std::tm tm_date = {0, 0, 0, day, month - 1, year - 1900};
+    tm_date.tm_isdst = -1;
+    return std::mktime(&tm_date);
+}
+
+// Run on the history before split_date, snapshot, then continue on the whole history from the snapshot:
+// same ledger and values as a run on the whole history
+static void check_snapshot_continuation(const SnapshotStrategyFactory& factory, std::time_t split_date){
+    std::string filename = "../strat_outputs/StrategySnapshot_Test.bin";
+    std::vector<YahooTimeseries> tickers_yt = get_snapshot_tickers_yt(std::numeric_limits<std::time_t>::max());
+    std::unique_ptr<Strategy> full_strategy(factory(tickers_yt));
+    full_strategy->run_strategy();
+
+    std::unique_ptr<Strategy> truncated_strategy(factory(get_snapshot_tickers_yt(split_date)));
+    truncated_strategy->run_strategy();
+    ASSERT_TRUE(truncated_strategy->save_snapshot(filename));
+
+    std::unique_ptr<Strategy> continued_strategy(factory(tickers_yt));
+    ASSERT_TRUE(continued_strategy->load_snapshot(filename));
+    continued_strategy->run_strategy();
+    remove_checkpoint(filename);
+
+    EXPECT_LT(truncated_strategy->get_strategy_values().size(), full_strategy->get_strategy_values().size());
+    EXPECT_EQ(full_strategy->get_strategy_values(), continued_strategy->get_strategy_values());
+    EXPECT_EQ(full_strategy->get_portfolio().get_portfolio_historical_cash_flow(), continued_strategy->get_portfolio().get_portfolio_historical_cash_flow());
+    for (const auto& ticker_yt: tickers_yt){
+        const AssetHolding* full_asset = full_strategy->get_portfolio().get_asset(ticker_yt.get_ticker());
+        const AssetHolding* continued_asset = continued_strategy->get_portfolio().get_asset(ticker_yt.get_ticker());
+        ASSERT_NE(nullptr, continued_asset);
+        EXPECT_EQ(full_asset->historical_cumulative_ticker_shares, continued_asset->historical_cumulative_ticker_shares);
+        EXPECT_EQ(full_asset->historical_cumulative_ticker_expenses, continued_asset->historical_cumulative_ticker_expenses);
+    }
+    EXPECT_EQ(full_strategy->get_strategy_volatility(), continued_strategy->get_strategy_volatility());
+    EXPECT_EQ(full_strategy->get_strategy_max_drawdown(), continued_strategy->get_strategy_max_drawdown());
+
+    // No new date: nothing to process
+    continued_strategy->run_strategy();
+    EXPECT_EQ(full_strategy->get_strategy_values(), continued_strategy->get_strategy_values());
+}
+
+TEST(StrategySnapshot, dca){
+    SnapshotStrategyFactory factory = [](const std::vector<YahooTimeseries>& tickers_yt) -> Strategy* {
+        return new DCA(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "DCA_Snapshot_Test");
+    };
+    check_snapshot_continuation(factory, get_local_date(2021, 7, 15));
+    check_snapshot_continuation(factory, get_local_date(2020, 2, 1));
+}
+
+TEST(StrategySnapshot, sma_optimized_dca){
+    // The last date of a history split mid-month is not a month end of the whole history: the pending amounts invested
+    // there by the truncated run are still waiting for a dip in the continued one
+    SnapshotStrategyFactory factory = [](const std::vector<YahooTimeseries>& tickers_yt) -> Strategy* {
+        return new SmaOptimizedDCA(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, 30, "SmaOptimizedDCA_Snapshot_Test");
+    };
+    check_snapshot_continuation(factory, get_local_date(2022, 3, 1));
+    check_snapshot_continuation(factory, get_local_date(2021, 7, 15));
+    check_snapshot_continuation(factory, get_local_date(2020, 11, 20));
+}
+
+TEST(StrategySnapshot, lump_sum){
+    SnapshotStrategyFactory factory = [](const std::vector<YahooTimeseries>& tickers_yt) -> Strategy* {
+        return new LumpSum(tickers_yt, 10000.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 23, 0.05, "LumpSum_Snapshot_Test");
+    };
+    check_snapshot_continuation(factory, get_local_date(2021, 11, 9));
+}
+
+TEST(StrategySnapshot, mismatch){
+    std::string filename = "../strat_outputs/StrategySnapshot_Test.bin";
+    std::vector<YahooTimeseries> tickers_yt = get_snapshot_tickers_yt(get_local_date(2021, 1, 1));
+    DCA dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "DCA_Snapshot_Test");
+    dca.run_strategy();
+    ASSERT_TRUE(dca.save_snapshot(filename));
+
+    DCA other_dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "Other_DCA_Snapshot_Test");
+    EXPECT_FALSE(other_dca.load_snapshot(filename));
+    LumpSum lump_sum(tickers_yt, 10000.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 23, 0.05, "DCA_Snapshot_Test");
+    EXPECT_FALSE(lump_sum.load_snapshot(filename));
+    DCA one_ticker_dca({tickers_yt[0]}, 5000.0, 300.0, {{"TEST_TICKER", 1.0}}, 17, 0.01, "DCA_Snapshot_Test");
+    EXPECT_FALSE(one_ticker_dca.load_snapshot(filename));
+    DCA other_settings_dca(tickers_yt, 5000.0, 400.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "DCA_Snapshot_Test");
+    EXPECT_FALSE(other_settings_dca.load_snapshot(filename));
+    DCA other_allocations_dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}}, 17, 0.01, "DCA_Snapshot_Test");
+    EXPECT_FALSE(other_allocations_dca.load_snapshot(filename));
+    DCA other_mode_dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "DCA_Snapshot_Test");
+    other_mode_dca.set_rebalancing_mode(RebalancingThreshold::RELATIVE);
+    EXPECT_FALSE(other_mode_dca.load_snapshot(filename));
+
+    // Valid checkpoints whose payload is longer or shorter than the strategy state
+    std::string payload;
+    ASSERT_TRUE(read_checkpoint(filename, payload));
+    for (const std::string& other_payload: {payload + "x", payload.substr(0, payload.size() - 4), payload.substr(0, payload.size() / 2)}){
+        ASSERT_TRUE(write_checkpoint(filename, other_payload));
+        DCA loaded_dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "DCA_Snapshot_Test");
+        EXPECT_FALSE(loaded_dca.load_snapshot(filename));
+    }
+    ASSERT_TRUE(write_checkpoint(filename, payload));
+    DCA loaded_dca(tickers_yt, 5000.0, 300.0, {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}}, 17, 0.01, "DCA_Snapshot_Test");
+    EXPECT_TRUE(loaded_dca.load_snapshot(filename));
+    remove_checkpoint(filename);
+    EXPECT_FALSE(dca.load_snapshot(filename));
+}
@@ -0,0 +1,73 @@
+#include "gtest/gtest.h"
+#include "../headers/streaming_backtest.hpp"
+#include "../headers/market_data.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <cstdio>
+
+TEST(IncrementalSma, simple_moving_averages){
+    std::vector<double> values;
+    for (int i = 0; i < 100; ++i)
+        values.push_back(10.0 + std::sin(i / 5.0));
+    IncrementalSma sma(20);
+    for (size_t i = 0; i < values.size(); ++i){
+        double expected = 0.0;
+        if (i >= 20){
+            for (size_t j = i - 20; j < i; ++j)
+                expected += values[j];
+            expected /= 20;
+        }
+        EXPECT_NEAR(expected, sma.get_value(), 1e-12);
+        sma.add(values[i]);
+    }
+    sma.reset();
+    EXPECT_EQ(0.0, sma.get_value());
+}
+
+TEST(StreamingBacktest, batch_engine){
+    // Streaming the bar file chunk by chunk gives the values of BatchEngine::run on the whole history in memory
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(1500);
+    MarketData market_data = get_market_data(tickers_yt);
+    std::string filename = "../strat_outputs/StreamingBacktest_Test.bin";
+    ASSERT_TRUE(write_bar_file(filename, tickers_yt, 512));
+    BarSource source(filename);
+    ASSERT_EQ(market_data.dates.size(), source.get_nb_bars());
+    ASSERT_EQ(3u, source.get_nb_chunks());
+
+    std::vector<BatchPortfolio> portfolios = {{5000.0, 300.0, {0.7, 0.3}, 30, 0.01},
+                                              {1000.0, 500.0, {0.2, 0.8}, 5, 0.05}};
+    for (BatchContribution contribution: {BatchContribution::MONTHLY, BatchContribution::LUMP_SUM}){
+        BatchEngine engine(portfolios, RebalancingThreshold::ABSOLUTE);
+        std::vector<double> expected_values;
+        engine.run(market_data, contribution, expected_values);
+
+        StreamingBacktest backtest(portfolios, contribution, RebalancingThreshold::ABSOLUTE, 50);
+        std::vector<double> values;
+        std::vector<std::vector<double>> smas(2);
+        backtest.set_row_handler([&](const StreamingRow& row){
+            values.insert(values.end(), row.values, row.values + portfolios.size());
+            smas[0].push_back(row.smas[0]);
+            smas[1].push_back(row.smas[1]);
+        });
+        backtest.run(source);
+        EXPECT_EQ(market_data.dates.size(), backtest.get_nb_bars());
+        ASSERT_EQ(expected_values.size(), values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            ASSERT_NEAR(expected_values[i], values[i], 1e-9 * (1.0 + expected_values[i]));
+        for (size_t p = 0; p < portfolios.size(); ++p){
+            EXPECT_EQ(values[values.size() - portfolios.size() + p], backtest.get_values()[p]);
+            EXPECT_GT(backtest.get_max_drawdowns()[p], 0.0);
+        }
+
+        // Same lagged averages as Timeseries::get_ts_simple_moving_averages on each ticker's calendar
+        for (size_t t = 0; t < 2; ++t){
+            std::vector<double> expected_smas = get_dense_values(Timeseries(tickers_yt[t].get_closes().get_ts_simple_moving_averages(50)), market_data.dates);
+            for (size_t d = 0; d < expected_smas.size(); ++d)
+                ASSERT_NEAR(expected_smas[d], smas[t][d], 1e-9);
+        }
+    }
+    std::remove(filename.c_str());
+}
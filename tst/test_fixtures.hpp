@@ -0,0 +1,59 @@
+#ifndef TEST_FIXTURES
+#define TEST_FIXTURES
+
+#include "../headers/yahoo_timeseries.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+#include <cmath>
+
+// Synthetic tickers shared by the tests, so they run without network access
+
+inline std::time_t get_test_start_date(){
+    std::tm tm_start = {0, 0, 12, 1, 0, 120}; // Jan 1, 2020
+    return std::mktime(&tm_start);
+}
+
+// Ticker quoted at price(i) (every column) on the days i < nb_days after get_test_start_date where is_quoted(i),
+// paying dividend(i) when it is not 0
+inline YahooTimeseries get_test_ticker_yt(std::string ticker, int nb_days, const std::function<double(int)>& price,
+                                          const std::function<bool(int)>& is_quoted, const std::function<double(int)>& dividend){
+    std::time_t start = get_test_start_date();
+    std::vector<std::time_t> dates;
+    std::vector<double> prices;
+    std::map<std::time_t, double> dividends;
+    for (int i = 0; i < nb_days; ++i){
+        if (!is_quoted(i))
+            continue;
+        std::time_t date = start + i * 86400;
+        dates.push_back(date);
+        prices.push_back(price(i));
+        if (dividend(i) != 0.0)
+            dividends[date] = dividend(i);
+    }
+    return YahooTimeseries(ticker, dates, prices, prices, prices, prices, prices, dividends);
+}
+
+// Quoted every day, without dividends
+inline YahooTimeseries get_test_ticker_yt(std::string ticker, int nb_days, const std::function<double(int)>& price){
+    return get_test_ticker_yt(ticker, nb_days, price, [](int){ return true; }, [](int){ return 0.0; });
+}
+
+// TEST_TICKER (no quote on day 5 of each week, 1.5 dividend every 90 days) and TEST_TICKER2 (quoted from day 20,
+// no quote on day 6 of each week): the tickers have different dates
+inline std::vector<YahooTimeseries> get_gapped_tickers_yt(int nb_days){
+    return {get_test_ticker_yt("TEST_TICKER", nb_days, [](int i){ return 100.0 + 15.0 * std::sin(i / 25.0) + 0.05 * i; },
+                               [](int i){ return i % 7 != 5; }, [](int i){ return (i % 90 == 45) ? 1.5 : 0.0; }),
+            get_test_ticker_yt("TEST_TICKER2", nb_days, [](int i){ return 50.0 + 8.0 * std::cos(i / 40.0) + 0.02 * i; },
+                               [](int i){ return i >= 20 && i % 7 != 6; }, [](int){ return 0.0; })};
+}
+
+// TEST_TICKER and TEST_TICKER2 quoted every day
+inline std::vector<YahooTimeseries> get_smooth_tickers_yt(int nb_days){
+    return {get_test_ticker_yt("TEST_TICKER", nb_days, [](int i){ return 100.0 + 10.0 * std::sin(i / 20.0) + 0.05 * i; }),
+            get_test_ticker_yt("TEST_TICKER2", nb_days, [](int i){ return 50.0 + 5.0 * std::cos(i / 35.0); })};
+}
+
+#endif
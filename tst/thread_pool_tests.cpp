@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include "../headers/thread_pool.hpp"
+
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+TEST(ThreadPool, parallel_for){
+    ThreadPool pool(4);
+    ASSERT_EQ(4, pool.get_nb_threads());
+
+    std::vector<int> visits(1000, 0);
+    pool.parallel_for(visits.size(), [&visits](size_t i){ visits[i]++; });
+    std::vector<int> expected(1000, 1);
+    EXPECT_EQ(expected, visits);
+}
+
+TEST(ThreadPool, submit_from_task){
+    ThreadPool pool(3);
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 10; ++i)
+        pool.submit([&pool, &counter]{
+            counter++;
+            for (int j = 0; j < 10; ++j)
+                pool.submit([&counter]{ counter++; });
+        });
+    pool.wait();
+    EXPECT_EQ(110, counter.load());
+}
+
+TEST(ThreadPool, task_exception){
+    // Rethrown by the wait once the other tasks are done, the pool staying usable
+    ThreadPool pool(3);
+    std::atomic<int> counter(0);
+    EXPECT_THROW(pool.parallel_for(100, [&counter](size_t i){
+        if (i % 10 == 3)
+            throw std::out_of_range("task " + std::to_string(i));
+        counter++;
+    }), std::out_of_range);
+    EXPECT_EQ(90, counter.load());
+
+    pool.parallel_for(10, [&counter](size_t i){ counter++; });
+    EXPECT_EQ(100, counter.load());
+}
+
+TEST(ThreadPool, fine_grained_tasks){
+    // Many tiny tasks submitted from several threads while the workers pop them: none is lost nor run twice
+    ThreadPool pool(4);
+    std::atomic<int> counter(0);
+    for (int round = 0; round < 20; ++round){
+        std::vector<std::thread> submitters;
+        for (int t = 0; t < 3; ++t)
+            submitters.emplace_back([&pool, &counter]{
+                for (int i = 0; i < 2000; ++i)
+                    pool.submit([&counter]{ counter++; });
+            });
+        for (auto& submitter: submitters)
+            submitter.join();
+        pool.wait();
+        EXPECT_EQ((round + 1) * 6000, counter.load());
+    }
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "../headers/vectorized_backtest.hpp"
+#include "../headers/strategy.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+// Two tickers on different calendars, with dividends, so the forward-filled lookups and the dividend scan are exercised
+static std::vector<YahooTimeseries> get_vectorized_backtest_tickers_yt(){
+    std::vector<YahooTimeseries> tickers_yt = get_gapped_tickers_yt(700);
+    tickers_yt[1] = get_test_ticker_yt("TEST_TICKER2", 700, [](int i){ return 50.0 + 8.0 * std::cos(i / 40.0) + 0.02 * i; },
+                                       [](int i){ return i >= 20 && i % 7 != 6; }, [](int i){ return (i % 120 == 60) ? 0.8 : 0.0; });
+    return tickers_yt;
+}
+
+static void expect_same_backtest(const Strategy& strat, const VectorizedBacktestResult& result){
+    std::map<std::time_t, double> expected_values = strat.get_strategy_values();
+    ASSERT_EQ(expected_values.size(), result.dates.size());
+    for (size_t d = 0; d < result.dates.size(); ++d)
+        ASSERT_NEAR(expected_values.at(result.dates[d]), result.values[d], 1e-6 * (1.0 + result.values[d]));
+
+    double expected_cash_flow = 0.0;
+    for (const auto& pair: strat.get_portfolio().get_portfolio_historical_cash_flow())
+        expected_cash_flow += pair.second;
+    double cash_flow = 0.0;
+    for (const auto& value: result.cash_flows)
+        cash_flow += value;
+    EXPECT_NEAR(expected_cash_flow, cash_flow, 1e-6 * std::fabs(expected_cash_flow));
+    EXPECT_NEAR(result.values.back() + cash_flow, result.profits_and_losses.back(), 1e-6 * std::fabs(cash_flow));
+}
+
+TEST(VectorizedBacktest, dca){
+    std::vector<YahooTimeseries> tickers_yt = get_vectorized_backtest_tickers_yt();
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.7}, {"TEST_TICKER2", 0.3}};
+    DCA dca(tickers_yt, 5000.0, 300.0, allocations, 30, 0.01, "DCA_Test");
+    dca.run_strategy();
+    VectorizedBacktest backtest(tickers_yt, allocations, 30, 0.01);
+    expect_same_backtest(dca, backtest.run_dca(5000.0, 300.0));
+}
+
+TEST(VectorizedBacktest, lump_sum){
+    std::vector<YahooTimeseries> tickers_yt = get_vectorized_backtest_tickers_yt();
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.6}, {"TEST_TICKER2", 0.4}};
+    LumpSum lump_sum(tickers_yt, 10000.0, allocations, 40, 0.05, "LumpSum_Test");
+    lump_sum.run_strategy();
+    VectorizedBacktest backtest(tickers_yt, allocations, 40, 0.05);
+    expect_same_backtest(lump_sum, backtest.run_lump_sum(10000.0));
+}
+
+TEST(VectorizedBacktest, band_rebalancing){
+    // The rebalancing orders come from the Rebalancer, so the band mode of DCA is supported too
+    std::vector<YahooTimeseries> tickers_yt = get_vectorized_backtest_tickers_yt();
+    tickers_yt.push_back(get_test_ticker_yt("TEST_TICKER3", 700, [](int i){ return 20.0 + 0.03 * i; }));
+    std::map<std::string, double> allocations = {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.3}, {"TEST_TICKER3", 0.2}};
+    DCA dca(tickers_yt, 5000.0, 300.0, allocations, 30, 0.03, "DCA_Band_Test");
+    dca.set_rebalancing_mode(RebalancingThreshold::BAND);
+    dca.run_strategy();
+    VectorizedBacktest backtest(tickers_yt, allocations, 30, 0.03);
+    expect_same_backtest(dca, backtest.run_dca(5000.0, 300.0, RebalancingThreshold::BAND));
+}
+
+TEST(VectorizedBacktest, holdings){
+    // Without rebalancing nor dividends the holdings are the cumulative contributions over the closes
+    std::tm tm_start = {0, 0, 12, 1, 0, 120};
+    std::time_t start = std::mktime(&tm_start);
+    std::vector<std::time_t> dates = {start, start + 86400, start + 32 * 86400, start + 61 * 86400};
+    std::vector<double> prices = {10.0, 12.0, 8.0, 20.0};
+    std::vector<YahooTimeseries> tickers_yt = {YahooTimeseries("TEST_TICKER", dates, prices, prices, prices, prices, prices)};
+    VectorizedBacktest backtest(tickers_yt, {{"TEST_TICKER", 1.0}}, -1, 0.0);
+    VectorizedBacktestResult result = backtest.run_dca(100.0, 40.0);
+    std::vector<double> expected_shares = {14.0, 14.0, 19.0, 21.0};
+    for (size_t d = 0; d < dates.size(); ++d){
+        EXPECT_NEAR(expected_shares[d], result.shares[0][d], 1e-12);
+        EXPECT_NEAR(expected_shares[d] * prices[d], result.values[d], 1e-9);
+    }
+    EXPECT_NEAR(220.0, result.expenses[0].back(), 1e-9);
+    EXPECT_NEAR(420.0 - 220.0, result.profits_and_losses.back(), 1e-9);
+}
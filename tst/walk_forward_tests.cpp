@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+#include "../headers/walk_forward.hpp"
+#include "../headers/xirr_solver.hpp"
+#include "./test_fixtures.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+// Tickers quoted every day in [first_day, nb_days), so a backtest can be restricted to a window of the calendar
+static std::vector<YahooTimeseries> get_walk_forward_tickers_yt(int first_day, int nb_days){
+    return {get_test_ticker_yt("TEST_TICKER", nb_days, [](int i){ return 100.0 + 15.0 * std::sin(i / 25.0) + 0.05 * i; },
+                               [=](int i){ return i >= first_day; }, [](int){ return 0.0; }),
+            get_test_ticker_yt("TEST_TICKER2", nb_days, [](int i){ return 50.0 + 5.0 * std::cos(i / 40.0) + 0.02 * i; },
+                               [=](int i){ return i >= first_day; }, [](int){ return 0.0; })};
+}
+
+static std::vector<YahooTimeseries> get_walk_forward_tickers_yt(){
+    return get_walk_forward_tickers_yt(0, 500);
+}
+
+// XIRR of a backtest over dates[start_idx..end_idx], its holdings at dates[start_idx] being the initial investment
+static double get_backtest_window_xirr(const Strategy& strat, const std::vector<std::time_t>& dates, size_t start_idx, size_t end_idx){
+    std::map<std::time_t, double> values = strat.get_portfolio().get_portfolio_values();
+    const std::map<std::time_t, double>& cash_flows = strat.get_portfolio().get_portfolio_historical_cash_flow();
+    std::vector<double> window_cash_flows = {-values.at(dates[start_idx])};
+    std::vector<std::time_t> window_dates = {dates[start_idx]};
+    for (size_t i = start_idx + 1; i <= end_idx; ++i)
+        if (cash_flows.count(dates[i]) && std::fabs(cash_flows.at(dates[i])) > 1e-3){
+            window_cash_flows.push_back(cash_flows.at(dates[i]));
+            window_dates.push_back(dates[i]);
+        }
+    window_cash_flows.push_back(values.at(dates[end_idx]));
+    window_dates.push_back(dates[end_idx]);
+    return XirrSolver(1e-3, 1000).solve(window_cash_flows, get_year_fractions(window_dates));
+}
+
+static double get_backtest_window_xirr(StrategyFactory factory, const std::vector<YahooTimeseries>& tickers_yt, const std::map<std::string, double>& parameters,
+                                       const std::vector<std::time_t>& dates, size_t start_idx, size_t end_idx){
+    Strategy* strat = factory(std::make_shared<const std::vector<YahooTimeseries>>(tickers_yt), parameters);
+    strat->run_strategy();
+    double xirr = get_backtest_window_xirr(*strat, dates, start_idx, end_idx);
+    delete strat;
+    return xirr;
+}
+
+TEST(WalkForwardOptimizer, run){
+    std::vector<YahooTimeseries> tickers_yt = get_walk_forward_tickers_yt();
+    std::vector<std::map<std::string, double>> parameter_sets = {{{"weight:TEST_TICKER", 0.2}, {"sma_window_size", 10}},
+                                                                 {{"weight:TEST_TICKER", 0.8}, {"sma_window_size", 10}},
+                                                                 {{"weight:TEST_TICKER", 0.5}, {"sma_window_size", 30}}};
+    StrategyFactory factory = get_sma_optimized_dca_factory(1000.0, 100.0, {{"TEST_TICKER", 0.5}, {"TEST_TICKER2", 0.5}}, 30, 0.05, 20);
+
+    WalkForwardOptimizer rolling(tickers_yt, factory, parameter_sets, 200, 60, false);
+    std::vector<WalkForwardFold> folds = rolling.run(2);
+    ASSERT_EQ(5, folds.size());
+    for (size_t k = 0; k < folds.size(); ++k){
+        EXPECT_EQ(tickers_yt[0].get_dates()[60 * k], folds[k].in_sample_start);
+        EXPECT_EQ(tickers_yt[0].get_dates()[60 * k + 199], folds[k].in_sample_end);
+        EXPECT_EQ(tickers_yt[0].get_dates()[60 * k + 200], folds[k].out_of_sample_start);
+        EXPECT_NE(parameter_sets.end(), std::find(parameter_sets.begin(), parameter_sets.end(), folds[k].chosen_parameters));
+        EXPECT_TRUE(std::isfinite(folds[k].in_sample_xirr));
+    }
+    EXPECT_EQ(tickers_yt[0].get_dates().back(), folds.back().out_of_sample_end);
+
+    // The stitched equity covers every out of sample date exactly once
+    const std::map<std::time_t, double>& equity = rolling.get_out_of_sample_equity();
+    ASSERT_EQ(300, equity.size());
+    EXPECT_EQ(folds.front().out_of_sample_start, equity.begin()->first);
+    EXPECT_EQ(folds.back().out_of_sample_end, equity.rbegin()->first);
+
+    // Each fold keeps the parameter set with the best in-sample XIRR, computed here from a backtest of every set
+    const std::vector<std::time_t>& dates = tickers_yt[0].get_dates();
+    for (size_t k = 0; k < folds.size(); ++k){
+        size_t best_p = 0;
+        double best_xirr = -std::numeric_limits<double>::infinity();
+        for (size_t p = 0; p < parameter_sets.size(); ++p){
+            double xirr = get_backtest_window_xirr(factory, tickers_yt, parameter_sets[p], dates, 60 * k, 60 * k + 199);
+            if (xirr > best_xirr){
+                best_xirr = xirr;
+                best_p = p;
+            }
+        }
+        EXPECT_EQ(parameter_sets[best_p], folds[k].chosen_parameters);
+        EXPECT_NEAR(best_xirr, folds[k].in_sample_xirr, 1e-9);
+    }
+
+    // Every window is a slice of a ledger started at the first date: the out of sample results of a fold are those
+    // of a standalone backtest of its parameters run from the first date to the end of its window
+    size_t in_sample_end_idx = 319;
+    size_t out_of_sample_end_idx = 379;
+    std::vector<YahooTimeseries> window_tickers_yt = get_walk_forward_tickers_yt(0, out_of_sample_end_idx + 1);
+    Strategy* strat = factory(std::make_shared<const std::vector<YahooTimeseries>>(window_tickers_yt), folds[2].chosen_parameters);
+    strat->run_strategy();
+    EXPECT_NEAR(get_backtest_window_xirr(*strat, dates, in_sample_end_idx, out_of_sample_end_idx), folds[2].out_of_sample_xirr, 1e-9);
+    std::map<std::time_t, double> values = strat->get_portfolio().get_portfolio_values();
+    const std::map<std::time_t, double>& cash_flows = strat->get_portfolio().get_portfolio_historical_cash_flow();
+    double window_equity = 1.0;
+    for (size_t i = in_sample_end_idx + 1; i <= out_of_sample_end_idx; ++i){
+        double cash_flow = cash_flows.count(dates[i]) ? cash_flows.at(dates[i]) : 0.0;
+        window_equity *= (values.at(dates[i]) + cash_flow) / values.at(dates[i-1]);
+        EXPECT_NEAR(window_equity, equity.at(dates[i]) / equity.at(dates[in_sample_end_idx]), 1e-9);
+    }
+    delete strat;
+
+    // and not those of a backtest started with the window, whose holdings are built from the window start
+    double window_start_xirr = get_backtest_window_xirr(factory, get_walk_forward_tickers_yt(in_sample_end_idx, out_of_sample_end_idx + 1), folds[2].chosen_parameters,
+                                                        dates, in_sample_end_idx, out_of_sample_end_idx);
+    EXPECT_GT(std::fabs(window_start_xirr - folds[2].out_of_sample_xirr), 0.05);
+
+    WalkForwardOptimizer anchored(tickers_yt, factory, parameter_sets, 200, 60, true);
+    std::vector<WalkForwardFold> anchored_folds = anchored.run(1);
+    ASSERT_EQ(folds.size(), anchored_folds.size());
+    for (const auto& fold: anchored_folds)
+        EXPECT_EQ(tickers_yt[0].get_dates()[0], fold.in_sample_start);
+    EXPECT_EQ(folds[0].chosen_parameters, anchored_folds[0].chosen_parameters);
+    EXPECT_DOUBLE_EQ(folds[0].out_of_sample_xirr, anchored_folds[0].out_of_sample_xirr);
+}
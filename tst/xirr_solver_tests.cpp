@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "../headers/xirr_solver.hpp"
+
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+TEST(XirrSolver, get_year_fractions){
+    std::time_t start = 1577836800; // Jan 1, 2020 UTC
+    std::vector<std::time_t> dates = {start, start + 365 * 86400, start + 730 * 86400};
+    std::vector<double> year_fractions = get_year_fractions(dates);
+    std::vector<double> expected = {0.0, 1.0, 2.0};
+    EXPECT_EQ(expected, year_fractions);
+}
+
+TEST(XirrSolver, solve){
+    XirrSolver solver(1e-9, 100);
+
+    EXPECT_NEAR(0.1, solver.solve({-100.0, 110.0}, {0.0, 1.0}), 1e-9);
+    EXPECT_NEAR(0.0, solver.solve({-100.0, 100.0}, {0.0, 3.0}), 1e-9);
+
+    // Rates outside of [-1, 1]
+    EXPECT_NEAR(2.0, solver.solve({-100.0, 300.0}, {0.0, 1.0}), 1e-9);
+    EXPECT_NEAR(9.0, solver.solve({-100.0, 10000.0}, {0.0, 2.0}), 1e-9);
+    EXPECT_NEAR(-0.95, solver.solve({-100.0, 5.0}, {0.0, 1.0}), 1e-9);
+
+    // Monthly DCA like cash flows: the returned rate must cancel the NPV
+    std::vector<double> cash_flows;
+    std::vector<double> year_fractions;
+    for (int month = 0; month < 120; ++month){
+        cash_flows.push_back(-1000.0);
+        year_fractions.push_back(month / 12.0);
+    }
+    cash_flows.push_back(180000.0);
+    year_fractions.push_back(10.0);
+    double rate = solver.solve(cash_flows, year_fractions);
+    double npv = 0.0;
+    for (size_t i = 0; i < cash_flows.size(); ++i)
+        npv += cash_flows[i] / std::pow(1.0 + rate, year_fractions[i]);
+    EXPECT_NEAR(0.0, npv, 1e-6);
+
+    // No sign change: no solution
+    EXPECT_TRUE(std::isnan(solver.solve({-100.0, -10.0}, {0.0, 1.0})));
+}
+
+TEST(XirrSolver, solve_batch){
+    XirrSolver solver(1e-9, 100);
+    std::vector<double> year_fractions = {0.0, 0.5, 1.0, 1.5, 2.0};
+    std::vector<double> end_values = {500.0, 50.0, 5000.0, 420.0, 0.01};
+    std::vector<double> cash_flows;
+    for (double end_value: end_values){
+        std::vector<double> stream = {-100.0, -100.0, -100.0, -100.0, end_value};
+        cash_flows.insert(cash_flows.end(), stream.begin(), stream.end());
+    }
+
+    std::vector<double> rates = solver.solve_batch(cash_flows, year_fractions, end_values.size());
+    ASSERT_EQ(end_values.size(), rates.size());
+    for (size_t s = 0; s < end_values.size(); ++s){
+        std::vector<double> stream(cash_flows.begin() + s * year_fractions.size(), cash_flows.begin() + (s + 1) * year_fractions.size());
+        EXPECT_NEAR(solver.solve(stream, year_fractions), rates[s], 1e-9);
+    }
+}
@@ -37,6 +37,20 @@ TEST(Timeseries, get_ts_simple_moving_averages) {
     delete ts;
 }
 
+TEST(Timeseries, get_dates_values) {
+    // Columns in construction order, date order for a map, read in place
+    std::vector<std::time_t> dates = {300, 100, 200};
+    std::vector<double> values = {3, 1, 2};
+    Timeseries ts(dates, values);
+    EXPECT_EQ(dates, ts.get_dates());
+    EXPECT_EQ(values, ts.get_values());
+
+    Timeseries map_ts(ts.get_ts_values());
+    EXPECT_EQ(std::vector<std::time_t>({100, 200, 300}), map_ts.get_dates());
+    EXPECT_EQ(std::vector<double>({1, 2, 3}), map_ts.get_values());
+    EXPECT_TRUE(Timeseries().get_dates().empty());
+}
+
 TEST(Timeseries, pget_simple_moving_averages) {
     std::tm tm_start = {0, 0, 0, 1, 0, 120}; // Jan 1, 2020
     std::tm tm_end = {0, 0, 0, 1, 0, 124};   // Jan 1, 2024